@@ -1,5 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string>
+#include <string_view>
+
 #include "bitbuf/traits.hpp"
 #include "bitbuf/iterator.hpp"
 
@@ -19,12 +25,23 @@ namespace px
         using container_type = typename traits_type::container_type;
 
         static constexpr bool is_dynamic_block = traits_type::is_dynamic_block;
+        static constexpr bool is_view = traits_type::is_view;
 
         static constexpr size_t bits_per_block = traits_type::bits_per_block;
         static constexpr size_t size_per_block = traits_type::size_per_block;
 
         static constexpr size_t npos = static_cast<size_t>(-1);
 
+        /// <summary>
+        /// Word-granular copies are only possible when each block is a single byte
+        /// </summary>
+        static constexpr bool is_byte_block = traits_type::size_of_block == 1;
+
+        /// <summary>
+        /// Largest run of bits moved in one 64-bit read-modify-write, leaves room for the in-byte offset
+        /// </summary>
+        static constexpr size_t bits_per_word_chunk = 56;
+
         constexpr bitbuf_t() = default;
 
         constexpr bitbuf_t(size_t capacity) noexcept
@@ -33,6 +50,22 @@ namespace px
                 m_Storage.resize(capacity);
         }
 
+        /// <summary>
+        /// Wrap external memory without taking ownership, 'view' must outlive the buffer
+        /// </summary>
+        constexpr bitbuf_t(container_type view) noexcept
+            requires (is_view) :
+            m_Storage(view)
+        { }
+
+        /// <summary>
+        /// Allocate the storage through 'alloc', eg: bitbuf_pmr{ bitbuf_arena::resource() }
+        /// </summary>
+        constexpr bitbuf_t(const typename traits_type::allocator_type& alloc) noexcept
+            requires (is_dynamic_block) :
+            m_Storage(alloc)
+        { }
+
         template<typename _OtherBuf_Traits>
         constexpr bitbuf_t(const bitbuf_t<_OtherBuf_Traits>& buf) noexcept :
             m_Storage(buf.m_Storage),
@@ -65,8 +98,8 @@ namespace px
             if (this != &buf)
             {
                 m_Storage = std::move(buf.m_Storage);
-                m_ReadPos = m_ReadPos;
-                m_WritePos = m_WritePos;
+                m_ReadPos = buf.m_ReadPos;
+                m_WritePos = buf.m_WritePos;
             }
             return *this;
         }
@@ -84,18 +117,22 @@ namespace px
             else if constexpr (std::is_integral_v<_Ty>)
             {
                 ensure_size(sizeof(_Ty) * bits_per_block);
-                for (size_t i = 0; i < sizeof(_Ty) * bits_per_block; i++)
-                    write_bit((data >> i) & 1 ? bit_type::one : bit_type::zero);
+                if constexpr (std::is_same_v<_Ty, bool>)
+                    write_ubits_nocheck(data ? 1 : 0, sizeof(_Ty) * bits_per_block);
+                else
+                {
+                    for (size_t i = 0; i < sizeof(_Ty); i += sizeof(uint64_t))
+                    {
+                        const size_t count = std::min(sizeof(_Ty) - i, sizeof(uint64_t));
+                        write_ubits_nocheck(static_cast<uint64_t>(static_cast<std::make_unsigned_t<_Ty>>(data) >> (i * bits_per_block)), count * bits_per_block);
+                    }
+                }
             }
             else if constexpr (std::is_floating_point_v<_Ty>)
             {
                 std::array bytes = std::bit_cast<std::array<unsigned char, sizeof(_Ty)>>(data);
                 ensure_size(sizeof(_Ty) * bits_per_block);
-                for (uint8_t byte : bytes)
-                {
-                    for (size_t i = 0; i < sizeof(uint8_t) * bits_per_block; i++)
-                        write_bit((byte >> i) & 1 ? bit_type::one : bit_type::zero);
-                }
+                write_bytes_nocheck(bytes.data(), bytes.size());
             }
             else if constexpr (
                 std::is_same_v<_Ty, char*>      || std::is_same_v<std::decay_t<_Ty>, char*> ||
@@ -116,17 +153,26 @@ namespace px
             )
             {
                 using value_type = _Ty::value_type;
-                ensure_size((data.size() + 1) * sizeof(_Ty::value_type) * bits_per_block);
+                using unsigned_type = std::make_unsigned_t<value_type>;
+                ensure_size((data.size() + 1) * sizeof(value_type) * bits_per_block);
 
-                for (auto c : data)
+                if constexpr (sizeof(value_type) == 1)
+                {
+                    if (std::is_constant_evaluated())
+                    {
+                        for (auto c : data)
+                            write_ubits_nocheck(static_cast<unsigned_type>(c), bits_per_block);
+                    }
+                    else write_bytes_nocheck(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+                }
+                else
                 {
-                    for (size_t i = 0; i < sizeof(value_type) * bits_per_block; i++)
-                        write_bit((c >> i) & 1 ? bit_type::one : bit_type::zero);
+                    for (auto c : data)
+                        write_ubits_nocheck(static_cast<unsigned_type>(c), sizeof(value_type) * bits_per_block);
                 }
 
                 // null terminator
-                for (size_t i = 0; i < sizeof(value_type) * bits_per_block; i++)
-                    write_bit(bit_type::zero);
+                write_ubits_nocheck(0, sizeof(value_type) * bits_per_block);
             }
             else if constexpr (
                 requires(const _Ty& v) { std::begin(v); std::end(v); }
@@ -141,8 +187,16 @@ namespace px
             requires (traits_type::is_write)
         constexpr bitbuf_t& operator<<(const bitbuf_t<_OtherBuf_Traits>& data)
         {
-            for (auto byte : data.m_Storage)
-                (*this) << byte;
+            if constexpr (bitbuf_t<_OtherBuf_Traits>::is_byte_block)
+            {
+                ensure_size(data.size() * bits_per_block);
+                write_bytes_nocheck(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+            }
+            else
+            {
+                for (auto byte : data.m_Storage)
+                    (*this) << byte;
+            }
             return *this;
         }
 
@@ -173,28 +227,24 @@ namespace px
                 data = read_bit();
             if constexpr (std::is_integral_v<_Ty>)
             {
-                for (size_t i = 0; i < sizeof(_Ty) * bits_per_block; i++)
+                if constexpr (std::is_same_v<_Ty, bool>)
+                    data = read_ubits_nocheck(sizeof(_Ty) * bits_per_block) != 0;
+                else
                 {
-                    if (read_bit() == bit_type::one)
-                        data |= static_cast<_Ty>(1ull << i);
-                    else
-                        data &= ~static_cast<_Ty>(1ull << i);
+                    using unsigned_type = std::make_unsigned_t<_Ty>;
+                    unsigned_type value{ };
+                    for (size_t i = 0; i < sizeof(_Ty); i += sizeof(uint64_t))
+                    {
+                        const size_t count = std::min(sizeof(_Ty) - i, sizeof(uint64_t));
+                        value |= static_cast<unsigned_type>(static_cast<unsigned_type>(read_ubits_nocheck(count * bits_per_block)) << (i * bits_per_block));
+                    }
+                    data = static_cast<_Ty>(value);
                 }
             }
             else if constexpr (std::is_floating_point_v<_Ty>)
             {
-                std::array<uint8_t, sizeof(_Ty)> bytes;
-                for (uint8_t& byte : bytes)
-                {
-                    for (size_t i = 0; i < sizeof(uint8_t) * bits_per_block; i++)
-                    {
-                        if (read_bit() == bit_type::one)
-                            byte |= static_cast<uint8_t>(1ull << i);
-                        else
-                            byte &= ~static_cast<uint8_t>(1ull << i);
-                    }
-                }
-
+                std::array<unsigned char, sizeof(_Ty)> bytes;
+                read_bytes_nocheck(bytes.data(), bytes.size());
                 data = std::bit_cast<_Ty>(bytes);
             }
             else if constexpr (
@@ -208,16 +258,26 @@ namespace px
                 using value_type = _Ty::value_type;
                 _Ty val;
 
-                while (true)
+                // Byte-aligned narrow strings can be scanned for the terminator and copied in one go
+                if constexpr (sizeof(value_type) == 1 && is_byte_block)
                 {
-                    value_type c{ };
-                    for (size_t i = 0; i < sizeof(value_type) * bits_per_block; i++)
+                    if (!std::is_constant_evaluated() && !(read_get() % bits_per_block) && read_get() / bits_per_block < size())
                     {
-                        if (read_bit() == bit_type::one)
-                            c |= static_cast<value_type>(1ull << i);
-                        else
-                            c &= ~static_cast<value_type>(1ull << i);
+                        const auto first = reinterpret_cast<const value_type*>(data_bytes() + read_get() / bits_per_block);
+                        const size_t left = size() - read_get() / bits_per_block;
+                        if (auto last = static_cast<const value_type*>(std::memchr(first, 0, left)))
+                        {
+                            val.assign(first, last + 1);
+                            m_ReadPos += val.size() * bits_per_block;
+                            data = std::move(val);
+                            return *this;
+                        }
                     }
+                }
+
+                while (true)
+                {
+                    const value_type c = static_cast<value_type>(read_ubits_nocheck(sizeof(value_type) * bits_per_block));
                     val.push_back(c);
                     if (!c)
                         break;
@@ -238,14 +298,7 @@ namespace px
 
                 for (size_t i = 0; i < size; i++)
                 {
-                    value_type c{ };
-                    for (size_t i = 0; i < sizeof(value_type) * bits_per_block; i++)
-                    {
-                        if (read_bit() == bit_type::one)
-                            c |= static_cast<value_type>(1ull << i);
-                        else
-                            c &= ~static_cast<value_type>(1ull << i);
-                    }
+                    const value_type c = static_cast<value_type>(read_ubits_nocheck(sizeof(value_type) * bits_per_block));
                     if (!(data[i] = c))
                         break;
                 }
@@ -263,8 +316,7 @@ namespace px
             requires (traits_type::is_read)
         constexpr const bitbuf_t& operator>>(bitbuf_t<_OtherBuf_Traits>& data)
         {
-            for (auto byte : m_Storage)
-                data << byte;
+            data << *this;
             return *this;
         }
 
@@ -304,10 +356,13 @@ namespace px
         {
             const size_t write_pos = write_get() / size_per_block;
 
+            using block_type = typename traits_type::block_type;
+            const size_t block = static_cast<size_t>(m_Storage[write_pos]);
+
             if (bit == bit_type::one)
-                m_Storage[write_pos] |= (1 << (write_get() % bits_per_block));
+                m_Storage[write_pos] = static_cast<block_type>(block | (1ull << (write_get() % bits_per_block)));
             else
-                m_Storage[write_pos] &= ~(1 << (write_get() % bits_per_block));
+                m_Storage[write_pos] = static_cast<block_type>(block & ~(1ull << (write_get() % bits_per_block)));
             ++m_WritePos;
         }
 
@@ -316,10 +371,223 @@ namespace px
             const size_t cur_pos = m_ReadPos++;
             const size_t read_pos = cur_pos / size_per_block;
 
-            return m_Storage[read_pos] & (1 << (cur_pos % bits_per_block)) ? bit_type::one : bit_type::zero;
+            return static_cast<size_t>(m_Storage[read_pos]) & (1ull << (cur_pos % bits_per_block)) ? bit_type::one : bit_type::zero;
+        }
+
+        /// <summary>
+        /// Write the lowest 'count' bits of 'value' (count <= 64), least significant bit first.
+        /// The caller made room for them
+        /// </summary>
+        constexpr void write_ubits_nocheck(uint64_t value, size_t count)
+            requires (traits_type::is_write)
+        {
+            if (std::is_constant_evaluated() || !is_byte_block)
+            {
+                for (size_t i = 0; i < count; i++)
+                    write_bit((value >> i) & 1 ? bit_type::one : bit_type::zero);
+                return;
+            }
+
+            while (count)
+            {
+                const size_t chunk = std::min(count, bits_per_word_chunk);
+                const size_t offset = write_get() % bits_per_block;
+                const size_t bytes = (offset + chunk + bits_per_block - 1) / bits_per_block;
+                unsigned char* dst = data_bytes() + write_get() / bits_per_block;
+
+                const uint64_t mask = ((uint64_t{ 1 } << chunk) - 1) << offset;
+                const uint64_t word = load_word(dst, bytes);
+                store_word(dst, bytes, (word & ~mask) | ((value << offset) & mask));
+
+                m_WritePos += chunk;
+                value = chunk < 64 ? value >> chunk : 0;
+                count -= chunk;
+            }
+        }
+
+        /// <summary>
+        /// Read 'count' bits (count <= 64), least significant bit first, bits past the end read as zero
+        /// </summary>
+        [[nodiscard]] constexpr uint64_t read_ubits_nocheck(size_t count) const
+            requires (traits_type::is_read)
+        {
+            uint64_t value{ };
+            if (std::is_constant_evaluated() || !is_byte_block)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (read_bit() == bit_type::one)
+                        value |= uint64_t{ 1 } << i;
+                }
+                return value;
+            }
+
+            for (size_t shift = 0; shift < count;)
+            {
+                const size_t chunk = std::min(count - shift, bits_per_word_chunk);
+                const size_t offset = read_get() % bits_per_block;
+                const size_t index = read_get() / bits_per_block;
+                const size_t bytes = std::min((offset + chunk + bits_per_block - 1) / bits_per_block, index < size() ? size() - index : 0);
+
+                const uint64_t word = bytes ? load_word(data_bytes() + index, bytes) : 0;
+                value |= ((word >> offset) & ((uint64_t{ 1 } << chunk) - 1)) << shift;
+
+                m_ReadPos += chunk;
+                shift += chunk;
+            }
+            return value;
+        }
+
+        /// <summary>
+        /// Write raw bytes, uses a plain memcpy when the write cursor is byte-aligned. The caller made room for them
+        /// </summary>
+        constexpr void write_bytes_nocheck(const unsigned char* src, size_t count)
+            requires (traits_type::is_write)
+        {
+            if constexpr (is_byte_block)
+            {
+                if (!std::is_constant_evaluated() && !(write_get() % bits_per_block))
+                {
+                    if (count)
+                        std::memcpy(data_bytes() + write_get() / bits_per_block, src, count);
+                    m_WritePos += count * bits_per_block;
+                    return;
+                }
+            }
+
+            constexpr size_t bytes_per_chunk = bits_per_word_chunk / bits_per_block;
+            for (size_t i = 0; i < count; i += bytes_per_chunk)
+            {
+                const size_t chunk = std::min(count - i, bytes_per_chunk);
+                uint64_t word{ };
+                for (size_t j = 0; j < chunk; j++)
+                    word |= static_cast<uint64_t>(src[i + j]) << (j * bits_per_block);
+                write_ubits_nocheck(word, chunk * bits_per_block);
+            }
+        }
+
+        /// <summary>
+        /// Read raw bytes, uses a plain memcpy when the read cursor is byte-aligned
+        /// </summary>
+        constexpr void read_bytes_nocheck(unsigned char* dst, size_t count) const
+            requires (traits_type::is_read)
+        {
+            if constexpr (is_byte_block)
+            {
+                if (!std::is_constant_evaluated() && !(read_get() % bits_per_block) && read_get() / bits_per_block + count <= size())
+                {
+                    if (count)
+                        std::memcpy(dst, data_bytes() + read_get() / bits_per_block, count);
+                    m_ReadPos += count * bits_per_block;
+                    return;
+                }
+            }
+
+            constexpr size_t bytes_per_chunk = bits_per_word_chunk / bits_per_block;
+            for (size_t i = 0; i < count; i += bytes_per_chunk)
+            {
+                const size_t chunk = std::min(count - i, bytes_per_chunk);
+                const uint64_t word = read_ubits_nocheck(chunk * bits_per_block);
+                for (size_t j = 0; j < chunk; j++)
+                    dst[i + j] = static_cast<unsigned char>(word >> (j * bits_per_block));
+            }
+        }
+
+    private:
+        [[nodiscard]] unsigned char* data_bytes() noexcept
+        {
+            return reinterpret_cast<unsigned char*>(m_Storage.data());
+        }
+
+        [[nodiscard]] const unsigned char* data_bytes() const noexcept
+        {
+            return reinterpret_cast<const unsigned char*>(m_Storage.data());
+        }
+
+        /// <summary>
+        /// Load up to 8 bytes as a little-endian word
+        /// </summary>
+        [[nodiscard]] static uint64_t load_word(const unsigned char* src, size_t bytes) noexcept
+        {
+            uint64_t word{ };
+            if constexpr (std::endian::native == std::endian::little)
+                std::memcpy(&word, src, bytes);
+            else
+            {
+                for (size_t i = 0; i < bytes; i++)
+                    word |= static_cast<uint64_t>(src[i]) << (i * 8);
+            }
+            return word;
+        }
+
+        /// <summary>
+        /// Store the lowest 'bytes' bytes of a word in little-endian order
+        /// </summary>
+        static void store_word(unsigned char* dst, size_t bytes, uint64_t word) noexcept
+        {
+            if constexpr (std::endian::native == std::endian::little)
+                std::memcpy(dst, &word, bytes);
+            else
+            {
+                for (size_t i = 0; i < bytes; i++)
+                    dst[i] = static_cast<unsigned char>(word >> (i * 8));
+            }
         }
 
     public:
+        /// <summary>
+        /// Write the lowest 'count' bits of 'value' (count <= 64), least significant bit first.
+        /// A dynamic buffer grows, a fixed-size or view buffer fails without writing anything when full
+        /// </summary>
+        [[nodiscard]] constexpr bool write_ubits(uint64_t value, size_t count)
+            requires (traits_type::is_write)
+        {
+            if (!make_room(count))
+                return false;
+            write_ubits_nocheck(value, count);
+            return true;
+        }
+
+        /// <summary>
+        /// Read 'count' bits (count <= 64) into 'value', least significant bit first.
+        /// Fails without moving the read cursor when fewer than 'count' bits are left
+        /// </summary>
+        [[nodiscard]] constexpr bool read_ubits(uint64_t& value, size_t count) const
+            requires (traits_type::is_read)
+        {
+            if (!can_read(count))
+            {
+                value = 0;
+                return false;
+            }
+            value = read_ubits_nocheck(count);
+            return true;
+        }
+
+        /// <summary>
+        /// Write raw bytes, fails like write_ubits()
+        /// </summary>
+        [[nodiscard]] constexpr bool write_bytes(const unsigned char* src, size_t count)
+            requires (traits_type::is_write)
+        {
+            if (!make_room(count * bits_per_block))
+                return false;
+            write_bytes_nocheck(src, count);
+            return true;
+        }
+
+        /// <summary>
+        /// Read raw bytes, fails like read_ubits()
+        /// </summary>
+        [[nodiscard]] constexpr bool read_bytes(unsigned char* dst, size_t count) const
+            requires (traits_type::is_read)
+        {
+            if (!can_read(count * bits_per_block))
+                return false;
+            read_bytes_nocheck(dst, count);
+            return true;
+        }
+
         [[nodiscard]] constexpr size_t size() const noexcept
         {
             return m_Storage.size();
@@ -378,12 +646,18 @@ namespace px
             return !((read_get() % bits_per_block) || read_get() & (alignment * bits_per_block - bits_per_block));
         }
 
+        /// <summary>
+        /// Reads are bounded by the stored blocks, dynamic buffers included
+        /// </summary>
         template<typename _Ty>
         [[nodiscard]] constexpr bool can_read() const noexcept
         {
-            if constexpr (is_dynamic_block)
-                return true;
-            else return size() >= (read_get() + sizeof(_Ty));
+            return can_read(sizeof(_Ty) * bits_per_block);
+        }
+
+        [[nodiscard]] constexpr bool can_read(size_t bits) const noexcept
+        {
+            return size() * bits_per_block >= (read_get() + bits);
         }
 
         [[nodiscard]] constexpr size_t write_get() const noexcept
@@ -429,40 +703,91 @@ namespace px
         {
             if constexpr (is_dynamic_block)
                 return true;
-            else return size() >= (write_get() + sizeof(_Ty));
+            else return size() * bits_per_block >= (write_get() + sizeof(_Ty) * bits_per_block);
+        }
+
+        [[nodiscard]] constexpr bool can_write(size_t bits) const noexcept
+        {
+            if constexpr (is_dynamic_block)
+                return true;
+            else return size() * bits_per_block >= (write_get() + bits);
+        }
+
+        [[nodiscard]] constexpr size_t capacity_bits() const noexcept
+        {
+            if constexpr (is_dynamic_block)
+                return m_Storage.capacity() * bits_per_block;
+            else return size() * bits_per_block;
         }
 
+        /// <summary>
+        /// Pre-allocate storage for at least 'bits_size' bits without changing the buffer's size
+        /// </summary>
+        constexpr void reserve_bits(size_t bits_size)
+            requires (is_dynamic_block)
+        {
+            m_Storage.reserve((bits_size + bits_per_block - 1) / bits_per_block);
+        }
+
+        /// <summary>
+        /// Release the capacity left over by geometric growth
+        /// </summary>
         constexpr void shrink_to_fit()
+            requires (is_dynamic_block)
         {
             m_Storage.shrink_to_fit();
         }
         
+        /// <summary>
+        /// Make room for 'bits_size' more bits past the write cursor, capacity grows geometrically
+        /// </summary>
         constexpr void ensure_size(size_t bits_size)
             requires (traits_type::is_write)
         {
             if constexpr (is_dynamic_block)
             {
-                if (const size_t count = write_get() + bits_size; size() * bits_per_block < count)
-                    m_Storage.resize((count % bits_per_block) + (count / bits_per_block));
+                const size_t blocks = (write_get() + bits_size + bits_per_block - 1) / bits_per_block;
+                if (size() < blocks)
+                {
+                    if (m_Storage.capacity() < blocks)
+                        m_Storage.reserve(std::max(blocks, m_Storage.capacity() * 2));
+                    m_Storage.resize(blocks);
+                }
             }
         }
 
+    private:
+        /// <summary>
+        /// Grow a dynamic buffer for 'bits_size' more bits, or check a fixed-size or view buffer has them
+        /// </summary>
+        constexpr bool make_room(size_t bits_size)
+            requires (traits_type::is_write)
+        {
+            if constexpr (is_dynamic_block)
+            {
+                ensure_size(bits_size);
+                return true;
+            }
+            else return can_write(bits_size);
+        }
+
+    public:
         [[nodiscard]] constexpr bit_type operator[](size_t index) const noexcept
             requires (traits_type::is_read)
         {
-            return (data()[index / traits_type::size_per_block] & (1 << (index % traits_type::size_per_block))) ? bit_type::one : bit_type::zero;
+            return (static_cast<size_t>(data()[index / traits_type::size_per_block]) & (1ull << (index % traits_type::size_per_block))) ? bit_type::one : bit_type::zero;
         }
 
         [[nodiscard]] constexpr auto read_iterator(size_t begin, size_t end) const noexcept
             requires (traits_type::is_read)
         {
-            return bitbuf_const_iterator_t<bitbuf_t>::impl(this, begin, end);
+            return typename bitbuf_const_iterator_t<bitbuf_t>::impl(this, begin, end);
         }
 
         [[nodiscard]] constexpr auto write_iterator(size_t begin, size_t end) const noexcept
             requires (traits_type::is_write)
         {
-            return bitbuf_const_iterator_t<bitbuf_t>::impl(this, begin, end);
+            return typename bitbuf_const_iterator_t<bitbuf_t>::impl(this, begin, end);
         }
 
     private:
@@ -486,6 +811,40 @@ namespace px
     //using bitbuf_pmr_iterator       = bitbuf_iterator_t<bitbuf>;
     using bitbuf_pmr_const_iterator = bitbuf_const_iterator_t<bitbuf>;
 
+    using ibitbuf_view   = bitbuf_t<bitbuf_default_view_traits<true, false>>;
+    using obitbuf_view   = bitbuf_t<bitbuf_default_view_traits<false, true>>;
+    using bitbuf_view    = bitbuf_t<bitbuf_default_view_traits<>>;
+
+    /// <summary>
+    /// Per-thread monotonic arena for bitbuf_pmr storage.
+    /// Allocations are a pointer bump and are never freed individually, call recycle() once per frame
+    /// after every buffer allocated from it has been destroyed.
+    /// </summary>
+    struct bitbuf_arena
+    {
+        static constexpr size_t initial_size = 64 * 1024;
+
+        [[nodiscard]] static std::pmr::monotonic_buffer_resource* resource() noexcept
+        {
+            thread_local std::pmr::monotonic_buffer_resource arena{ initial_size };
+            return &arena;
+        }
+
+        static void recycle() noexcept
+        {
+            resource()->release();
+        }
+
+        template<typename _BitBuf_Ty = bitbuf_pmr>
+        [[nodiscard]] static _BitBuf_Ty make(size_t reserve_bits = 0)
+        {
+            _BitBuf_Ty buf{ std::pmr::polymorphic_allocator<typename _BitBuf_Ty::traits_type::block_type>{ resource() } };
+            if (reserve_bits)
+                buf.reserve_bits(reserve_bits);
+            return buf;
+        }
+    };
+
     template<size_t _Size>  using static_ibitbuf = bitbuf_t<bitbuf_default_static_traits<_Size, true, false>>;
     template<size_t _Size>  using static_obitbuf = bitbuf_t<bitbuf_default_static_traits<_Size, false, true>>;
     template<size_t _Size>  using static_bitbuf  = bitbuf_t<bitbuf_default_static_traits<_Size>>;
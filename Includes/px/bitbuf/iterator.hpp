@@ -30,7 +30,7 @@ namespace px
 
         [[nodiscard]] constexpr bit_type operator*() const noexcept
         {
-            return (m_Parent->data()[index()] & (1 << bit_left())) ? bit_type::one : bit_type::zero;
+            return (static_cast<size_t>(m_Parent->data()[index()]) & (1ull << bit_left())) ? bit_type::one : bit_type::zero;
         }
 
         constexpr size_t index() const noexcept
@@ -156,7 +156,7 @@ namespace px
     {
     public:
         using parent_type = _BitBuffer_Ty;
-        using iterator_type = typename bitbuf_const_iterator_t<parent_type>;
+        using iterator_type = bitbuf_const_iterator_t<parent_type>;
 
         constexpr impl(const parent_type* parent, size_t begin, size_t end) noexcept :
             m_Begin(parent, begin),
@@ -1,10 +1,29 @@
 #pragma once
 
 #include <vector>
+#include <memory_resource>
 #include <array>
+#include <span>
+#include <cstddef>
 
 namespace px
 {
+    namespace detail
+    {
+        template<typename _Containter>
+        struct bitbuf_allocator_of
+        {
+            using type = std::allocator<typename _Containter::value_type>;
+        };
+
+        template<typename _Containter>
+            requires requires { typename _Containter::allocator_type; }
+        struct bitbuf_allocator_of<_Containter>
+        {
+            using type = typename _Containter::allocator_type;
+        };
+    }
+
     template<
         typename _Containter,
         size_t _Size,
@@ -13,9 +32,10 @@ namespace px
     >
     struct bitbuf_traits_t
     {
-        using container_type = typename _Containter;
+        using container_type = _Containter;
         using block_type     = typename container_type::value_type;
         using difference_type = typename container_type::difference_type;
+        using allocator_type = typename detail::bitbuf_allocator_of<container_type>::type;
 
         static constexpr difference_type npos = -1;
 
@@ -24,7 +44,12 @@ namespace px
         static constexpr size_t size_per_block = size_of_block * 8;
 
         static constexpr size_t block_count = _Size;
-        static constexpr bool is_dynamic_block = block_count == 0;
+
+        /// <summary>
+        /// Non-owning storage (eg: std::span), can't be resized and is bounded by the viewed memory
+        /// </summary>
+        static constexpr bool is_view = block_count == 0 && !requires(container_type& c) { c.resize(0); };
+        static constexpr bool is_dynamic_block = block_count == 0 && !is_view;
 
         static constexpr bool is_read   = _IsRead;
         static constexpr bool is_write  = _IsWrite;
@@ -39,6 +64,9 @@ namespace px
     template<size_t _Size, bool _IsRead = true, bool _IsWrite = true>
     using bitbuf_default_static_traits = bitbuf_traits_t<std::array<uint8_t, _Size>, _Size, _IsRead, _IsWrite>;
 
+    template<bool _IsRead = true, bool _IsWrite = true>
+    using bitbuf_default_view_traits = bitbuf_traits_t<std::span<std::conditional_t<_IsWrite, std::byte, const std::byte>>, 0, _IsRead, _IsWrite>;
+
     enum class bit_type : char { zero, one };
 
     namespace literals
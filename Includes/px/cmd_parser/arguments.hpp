@@ -86,7 +86,7 @@ namespace px
         [[nodiscard]] auto get(const string_t& name, const _Ty& default_type = { }) const
         {
             auto iter = find(name);
-            return iter == end() ? default_type : iter->second.get_as<_Ty>();
+            return iter == end() ? default_type : iter->second.template get_as<_Ty>();
         }
 
         template<typename _Ty>
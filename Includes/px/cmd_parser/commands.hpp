@@ -161,11 +161,11 @@ namespace px
         template<typename _OTy = value_type> constexpr auto& operator=(const con_var_t<_OTy, traits_type>& o) { m_Value = static_cast<const_reference>(o.m_Value); return *this; }
         template<typename _OTy = value_type> constexpr auto& operator=(const _OTy& o) { m_Value = static_cast<const_reference>(o); return *this; }
                                              
-        template<typename _OTy = value_type> constexpr [[nodiscard]] auto operator<=>(const _OTy& o) const noexcept { return m_Value <=> static_cast<const_reference>(o); }
-        template<typename _OTy = value_type> constexpr [[nodiscard]] bool operator!=(const _OTy& o) const noexcept { return m_Value != static_cast<const_reference>(o); }
+        template<typename _OTy = value_type> [[nodiscard]] constexpr auto operator<=>(const _OTy& o) const noexcept { return m_Value <=> static_cast<const_reference>(o); }
+        template<typename _OTy = value_type> [[nodiscard]] constexpr bool operator!=(const _OTy& o) const noexcept { return m_Value != static_cast<const_reference>(o); }
                                              
-        template<typename _OTy = value_type> constexpr [[nodiscard]] auto operator<=>(const con_var_t<_OTy, traits_type>& prop) const noexcept { return m_Value <=> static_cast<const_reference>(prop.m_Value); }
-        template<typename _OTy = value_type> constexpr [[nodiscard]] bool operator!=(const con_var_t<_OTy, traits_type>& prop) const noexcept { return m_Value != static_cast<const_reference>(prop.m_Value); }
+        template<typename _OTy = value_type> [[nodiscard]] constexpr auto operator<=>(const con_var_t<_OTy, traits_type>& prop) const noexcept { return m_Value <=> static_cast<const_reference>(prop.m_Value); }
+        template<typename _OTy = value_type> [[nodiscard]] constexpr bool operator!=(const con_var_t<_OTy, traits_type>& prop) const noexcept { return m_Value != static_cast<const_reference>(prop.m_Value); }
 
         constexpr auto& operator++() noexcept { ++m_Value; return *this; }
         constexpr auto& operator--() noexcept { --m_Value; return *this; }
@@ -177,23 +177,23 @@ namespace px
 
 
 #define PX_CONVAR_OPEARTOR(Operator)														\
-	    constexpr con_var_t& operator##Operator##=(const con_var_t& cvar) noexcept			\
+	    constexpr con_var_t& operator Operator##=(const con_var_t& cvar) noexcept			\
 	    {																					\
 		    m_Value Operator##= cvar.m_Value;												\
 		    return *this;																	\
 	    }																					\
 	    template<typename _OTy>																\
-	    constexpr con_var_t& operator##Operator##=(const _OTy& o)	noexcept				\
+	    constexpr con_var_t& operator Operator##=(const _OTy& o)	noexcept				\
 	    {																					\
 		    m_Value Operator##= static_cast<const_reference>(o);							\
 		    return *this;																	\
 	    }																					\
-	    [[nodiscard]] constexpr auto operator##Operator(const con_var_t& cvar) const noexcept\
+	    [[nodiscard]] constexpr auto operator Operator(const con_var_t& cvar) const noexcept\
 	    {																					\
 		    return m_Value Operator cvar.m_Value;											\
 	    }																					\
 	    template<typename _OTy>																\
-	    [[nodiscard]] constexpr auto operator##Operator(const _OTy& o) const noexcept		\
+	    [[nodiscard]] constexpr auto operator Operator(const _OTy& o) const noexcept		\
 	    {																					\
 		    return m_Value Operator static_cast<const_reference>(o);						\
 	    }
@@ -283,7 +283,7 @@ namespace px
             if (const auto min_iter = info.args.find("min"); min_iter != info.args.end())
             {
                 con_var_t& cvar = static_cast<con_var_t&>(*command);
-                if (auto val = min_iter->second.get_as<value_type>(); val > cvar)
+                if (auto val = min_iter->second.template get_as<value_type>(); val > cvar)
                     cvar = std::move(val);
             }
         }
@@ -293,7 +293,7 @@ namespace px
             if (const auto max_iter = info.args.find("max"); max_iter != info.args.end())
             {
                 con_var_t& cvar = static_cast<con_var_t&>(*command);
-                if (auto val = max_iter->second.get_as<value_type>(); val < cvar)
+                if (auto val = max_iter->second.template get_as<value_type>(); val < cvar)
                     cvar = std::move(val);
             }
         }
@@ -301,7 +301,7 @@ namespace px
         template<bool _Min = false, bool _Max = false>
         static void default_command_cvar_set(parent_type* command, const con_exec_info_t<traits_type>& info) noexcept
         {
-            static_cast<con_var_t*>(command)->m_Value = info.value.get_as<value_type>();
+            static_cast<con_var_t*>(command)->m_Value = info.value.template get_as<value_type>();
             if constexpr (_Min)
                 default_command_cvar_min(command, info);
             if constexpr (_Max)
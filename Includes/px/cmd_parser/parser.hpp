@@ -76,7 +76,7 @@ namespace px
                         else
                         {
                             res.emplace_back(
-                                cmd_arg_info<_Ty::value_type>::from_string(
+                                cmd_arg_info<typename _Ty::value_type>::from_string(
                                     tok,
                                     delimiters
                                 )
@@ -111,7 +111,7 @@ namespace px
                         }
                         else
                         {
-                            *iter++ = cmd_arg_info<_Ty::value_type>::from_string(
+                            *iter++ = cmd_arg_info<typename _Ty::value_type>::from_string(
                                 tok,
                                 delimiters
                             );
@@ -160,11 +160,11 @@ namespace px
                         {
                             if constexpr (is_std_string_view_v<_Ty::value_type> || is_std_string_v<_Ty::value_type>)
                                 res += *iter;
-                            else res += cmd_arg_info<_Ty::value_type>::to_string(*iter, delimiter);
+                            else res += cmd_arg_info<typename _Ty::value_type>::to_string(*iter, delimiter);
                             res += delimiter;
                         }
 
-                        res += cmd_arg_info<_Ty::value_type>::to_string(*iter);
+                        res += cmd_arg_info<typename _Ty::value_type>::to_string(*iter);
                     }
                    
                     return res;
@@ -205,7 +205,7 @@ namespace px
 template<>												            \
 struct px::cmd_arg_info<std::array<Type, Size>>::typeinfo	        \
 {																	\
-	static constexpr const char* name = Name##"["###Size##"]";      \
+	static constexpr const char* name = Name "[" #Size "]";      \
     static constexpr bool has_lexial_cast = false;                  \
 }
 
@@ -213,7 +213,7 @@ struct px::cmd_arg_info<std::array<Type, Size>>::typeinfo	        \
 template<>												    \
 struct px::cmd_arg_info<std::vector<Type>>::typeinfo        \
 {															\
-	static constexpr const char* name = Name##"[]";         \
+	static constexpr const char* name = Name "[]";         \
     static constexpr bool has_lexial_cast = false;          \
 }
 
@@ -18,7 +18,7 @@ namespace px
         static constexpr string_view_t default_split_str = DefaultSplit; \
     };                                                                   \
     template<>                                                           \
-    static constexpr bool is_cmd_parser_traits_v<Name> = true
+    constexpr bool is_cmd_parser_traits_v<Name> = true
 
     PX_CMD_PARSER_DEFINE_TRAITS(cmd_parser_default_traits,      char,    ";-;");
     PX_CMD_PARSER_DEFINE_TRAITS(cmd_parser_default_u8traits,    char8_t, u8";-;");
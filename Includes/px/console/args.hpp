@@ -34,7 +34,7 @@ public:
             res.reserve(std::distance(tokens.begin(), tokens.end()));
 
             for (auto& tok : tokens)
-                res.emplace_back(CommandParser<_Ty::value_type>::from_string(tok));
+                res.emplace_back(CommandParser<typename _Ty::value_type>::from_string(tok));
 
             return res;
         }
@@ -47,7 +47,7 @@ public:
 
             for (auto& tok : tokenizer{ value, boost::char_separator<char>{delimiters} })
             {
-                *iter = CommandParser<_Ty::value_type>::from_string(tok);
+                *iter = CommandParser<typename _Ty::value_type>::from_string(tok);
                 ++iter;
             }
             return res;
@@ -71,9 +71,9 @@ public:
             auto iter = value.begin();
             auto end = value.end() - 1;
             for (; iter != end; iter++)
-                res += CommandParser<_Ty::value_type>::to_string(*iter) + delimiters[1];
+                res += CommandParser<typename _Ty::value_type>::to_string(*iter) + delimiters[1];
 
-            res += CommandParser<_Ty::value_type>::to_string(*iter) + delimiters[2];
+            res += CommandParser<typename _Ty::value_type>::to_string(*iter) + delimiters[2];
             return res;
         }
         else
@@ -174,7 +174,7 @@ PX_NAMESPACE_END();
 template<>												                                    \
 struct px::CommandParser<std::array<Type, Size>>::typeinfo			                        \
 {																	                        \
-	static constexpr const char* type_name = Name##"["###Size##"]";                         \
+	static constexpr const char* type_name = Name "[" #Size "]";                         \
     static constexpr bool has_lexial_cast = false;                                          \
 }
 
@@ -152,23 +152,23 @@ public:
 public:
 
 #define PX_CONFIG_OPEARTOR(SYMBOL)																\
-	constexpr ConVar& operator##SYMBOL##=(const ConVar& prop) noexcept							\
+	constexpr ConVar& operator SYMBOL##=(const ConVar& prop) noexcept							\
 	{																							\
 		m_Value SYMBOL##= prop.m_Value;															\
 		return *this;																			\
 	}																							\
 	template<typename _OTy>																		\
-	constexpr ConVar& operator##SYMBOL##=(const _OTy& o)	noexcept							\
+	constexpr ConVar& operator SYMBOL##=(const _OTy& o)	noexcept							\
 	{																							\
 		m_Value SYMBOL##= static_cast<const_reference>(o);										\
 		return *this;																			\
 	}																							\
-	[[nodiscard]] constexpr auto operator##SYMBOL(const ConVar& prop) const noexcept			\
+	[[nodiscard]] constexpr auto operator SYMBOL(const ConVar& prop) const noexcept			\
 	{																							\
 		return m_Value SYMBOL prop.m_Value;														\
 	}																							\
 	template<typename _OTy>																		\
-	[[nodiscard]] constexpr auto operator##SYMBOL(const _OTy& o) const noexcept					\
+	[[nodiscard]] constexpr auto operator SYMBOL(const _OTy& o) const noexcept					\
 	{																							\
 		return m_Value SYMBOL static_cast<const_reference>(o);									\
 	}
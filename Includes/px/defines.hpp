@@ -3,6 +3,12 @@
 #include <string>
 #include <array>
 
+#if !defined(_MSC_VER)
+// MSVC keywords used by the interfaces, for the tools built with gcc or clang
+#define abstract = 0
+#define _NODISCARD [[nodiscard]]
+#endif
+
 #define PX_NAMESPACE_BEGIN(...)	namespace px##__VA_ARGS__ {
 #define PX_NAMESPACE_END()    	}
 
@@ -3,10 +3,49 @@
 #include <stdint.h>
 #include <cassert>
 
+#include <px/defines.hpp>
 #include <px/version.hpp>
 
+#if !defined(_MSC_VER)
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// Secure CRT calls used by the SDK, for the offline tools built with gcc or clang
+#define _MAX_PATH 260
+
+template<size_t _Size, typename... _Args>
+inline int sprintf_s(char (&buffer)[_Size], const char* format, _Args... args)
+{
+	return std::snprintf(buffer, _Size, format, args...);
+}
+
+inline int strncpy_s(char* dest, size_t size, const char* src, size_t count)
+{
+	if (!size)
+		return -1;
+
+	const size_t length = std::min({ std::strlen(src), count, size - 1 });
+	std::memcpy(dest, src, length);
+	dest[length] = '\0';
+	return 0;
+}
+
+template<size_t _Size>
+inline int strncpy_s(char (&dest)[_Size], const char* src, size_t count)
+{
+	return strncpy_s(dest, _Size, src, count);
+}
+
+template<size_t _Size>
+inline int strcpy_s(char (&dest)[_Size], const char* src)
+{
+	return strncpy_s(dest, _Size, src, _Size);
+}
+#endif
+
 #define TF2_NAMESPACE_BEGIN(...)			\
-namespace px::tf2##__VA_ARGS__	{
+namespace px::tf2 __VA_ARGS__	{
 
 #define TF2_NAMESPACE_END() }
 
@@ -56,7 +95,7 @@ public:
 		m_GameData = new_gamedata;
 	}
 
-	static [[nodiscard]] px::IGameData* Get()
+	[[nodiscard]] static px::IGameData* Get()
 	{
 		return Manager->m_GameData;
 	}
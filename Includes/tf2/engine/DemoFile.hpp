@@ -0,0 +1,211 @@
+#pragma once
+
+#include <chrono>
+#include <tf2/engine/NetMessageRegistry.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	static constexpr char DemoFile_Stamp[8] = "HL2DEMO";
+	static constexpr int DemoFile_Protocol = 3;
+	static constexpr size_t DemoFile_MaxOSPath = 260;
+
+	enum class DemoCommand : uint8_t
+	{
+		// it's a startup message, process as fast as possible
+		SignOn = 1,
+		// it's a normal network packet that we stored off
+		Packet,
+		// sync client clock to demo tick
+		SyncTick,
+		// console command
+		ConsoleCmd,
+		// user input command
+		UserCmd,
+		// network data tables
+		DataTables,
+		// end of time
+		Stop,
+		// string tables snapshot
+		StringTables,
+
+		LastCmd = StringTables
+	};
+}
+
+
+struct DemoHeader
+{
+	char	FileStamp[8];								// Should be HL2DEMO
+	int		DemoProtocol;								// Should be Const::DemoFile_Protocol
+	int		NetworkProtocol;							// Should be PROTOCOL_VERSION
+	char	ServerName[Const::DemoFile_MaxOSPath];		// Name of server
+	char	ClientName[Const::DemoFile_MaxOSPath];		// Name of client who recorded the game
+	char	MapName[Const::DemoFile_MaxOSPath];			// Name of map
+	char	GameDirectory[Const::DemoFile_MaxOSPath];	// Name of game directory (com_gamedir)
+	float	PlaybackTime;								// Time of track
+	int		PlaybackTicks;								// # of ticks in track
+	int		PlaybackFrames;								// # of frames in track
+	int		SignonLength;								// length of sigondata in bytes
+};
+static_assert(sizeof(DemoHeader) == 1072);
+
+
+struct DemoCmdInfo
+{
+	int			Flags;
+
+	// original origin/viewangles
+	Vector3D_F	ViewOrigin;
+	Angle_F		ViewAngles;
+	Angle_F		LocalViewAngles;
+
+	// Resampled origin/viewangles
+	Vector3D_F	ViewOrigin2;
+	Angle_F		ViewAngles2;
+	Angle_F		LocalViewAngles2;
+};
+static_assert(sizeof(DemoCmdInfo) == 76);
+
+
+struct DemoFrame
+{
+	Const::DemoCommand	Command;
+	int					Tick;
+
+	// SignOn and Packet frames only
+	DemoCmdInfo			CmdInfo;
+	int					SequenceIn;
+	int					SequenceOut;
+
+	// UserCmd frames only
+	int					OutgoingSequence;
+
+	// Payload of the frame, points inside the demo file and stays valid until it's closed
+	const uint8_t*		Data;
+	int					Size;
+
+	[[nodiscard]] bool has_packet() const noexcept
+	{
+		return Command == Const::DemoCommand::SignOn || Command == Const::DemoCommand::Packet;
+	}
+
+	/// <summary>
+	/// Bit reader over the frame's payload, no copy is made
+	/// </summary>
+	[[nodiscard]] utils::bf_read payload() const noexcept
+	{
+		return utils::bf_read(Data, Size);
+	}
+};
+
+
+struct DemoReadStats
+{
+	size_t	Frames{ };
+	size_t	Packets{ };
+	size_t	Messages{ };
+	// Packets that stopped on an unknown or malformed message
+	size_t	BadPackets{ };
+	double	Seconds{ };
+
+	[[nodiscard]] double frames_per_second() const noexcept
+	{
+		return Seconds > 0. ? static_cast<double>(Frames) / Seconds : 0.;
+	}
+};
+
+
+/// <summary>
+/// Streams the frames of a recorded demo, the file is memory mapped and frames point straight into the mapping.
+/// Doesn't need the game to be running
+/// </summary>
+class DemoFile
+{
+public:
+	DemoFile() = default;
+	explicit DemoFile(const char* path) { open(path); }
+	~DemoFile() { close(); }
+
+	DemoFile(const DemoFile&) = delete;
+	DemoFile& operator=(const DemoFile&) = delete;
+
+	/// <summary>
+	/// Maps 'path' and validates its header, the reader is positioned on the first frame
+	/// </summary>
+	PX_SDK_TF2 bool open(const char* path);
+
+	/// <summary>
+	/// Reads a demo already in memory, 'data' must outlive the reader
+	/// </summary>
+	PX_SDK_TF2 bool open(const void* data, size_t size);
+
+	PX_SDK_TF2 void close() noexcept;
+
+	[[nodiscard]] bool is_open() const noexcept { return View != nullptr; }
+	[[nodiscard]] const DemoHeader& header() const noexcept { return Header; }
+	[[nodiscard]] size_t size() const noexcept { return ViewSize; }
+	[[nodiscard]] size_t tell() const noexcept { return Offset; }
+
+	// Last read_frame() stopped on a frame that runs past the end of the file or an unknown command
+	[[nodiscard]] bool is_truncated() const noexcept { return IsTruncated; }
+
+	void rewind() noexcept
+	{
+		Offset = sizeof(DemoHeader);
+		IsTruncated = false;
+	}
+
+	/// <summary>
+	/// Reads the next frame, returns false once dem_stop or the end of the file is reached
+	/// </summary>
+	PX_SDK_TF2 bool read_frame(DemoFrame& frame);
+
+	/// <summary>
+	/// Walks the remaining frames and decodes every packet through 'decoder'.
+	/// 'callback(const DemoFrame&, NetMessageHandle&)' is invoked for each message, it may move the handle out to keep it
+	/// </summary>
+	template<typename _FnTy>
+	DemoReadStats read_messages(NetMessageDecoder& decoder, _FnTy&& callback)
+	{
+		DemoReadStats stats;
+		const auto start = std::chrono::steady_clock::now();
+
+		DemoFrame frame;
+		while (read_frame(frame))
+		{
+			stats.Frames++;
+			if (!frame.has_packet())
+				continue;
+
+			stats.Packets++;
+			utils::bf_read buffer = frame.payload();
+			const auto status = decoder.decode_all(
+				buffer,
+				[&](NetMessageHandle& message)
+				{
+					stats.Messages++;
+					callback(std::as_const(frame), message);
+				}
+			);
+
+			if (status != Const::NetMsgDecodeStatus::EndOfStream)
+				stats.BadPackets++;
+		}
+
+		stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return stats;
+	}
+
+private:
+	const uint8_t*	View{ };
+	size_t			ViewSize{ };
+	size_t			Offset{ };
+	bool			IsMapped{ };
+	bool			IsTruncated{ };
+
+	DemoHeader		Header{ };
+};
+
+TF2_NAMESPACE_END();
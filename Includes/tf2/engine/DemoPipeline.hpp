@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <tf2/engine/DemoFile.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+/// <summary>
+/// Per worker string interning, views stay valid until the pool is cleared
+/// </summary>
+class DemoStringPool
+{
+public:
+	[[nodiscard]] std::string_view intern(std::string_view str)
+	{
+		auto iter = Strings.find(str);
+		if (iter == Strings.end())
+			iter = Strings.emplace(str).first;
+		return *iter;
+	}
+
+	void clear() noexcept { Strings.clear(); }
+	[[nodiscard]] size_t size() const noexcept { return Strings.size(); }
+
+private:
+	struct hash_type
+	{
+		using is_transparent = void;
+		size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+	};
+
+	std::unordered_set<std::string, hash_type, std::equal_to<>> Strings;
+};
+
+
+/// <summary>
+/// State handed to the pipeline's callbacks, it describes the demo and the frame being decoded
+/// </summary>
+template<typename _ResultTy>
+struct DemoJob
+{
+	// Index of the demo in the list passed to DemoPipeline::run
+	size_t				FileIndex;
+	unsigned			Worker;
+	const DemoHeader*	Header;
+	const DemoFrame*	Frame;
+	// Result of the demo, only this job writes to it
+	_ResultTy*			Result;
+	DemoStringPool*		Strings;
+
+	[[nodiscard]] std::string_view intern(std::string_view str) { return Strings->intern(str); }
+};
+
+
+struct DemoPipelineStats
+{
+	size_t			Files{ };
+	// Demos that couldn't be mapped or had a bad header
+	size_t			FailedFiles{ };
+	DemoReadStats	Totals;
+	// Wall clock time of the whole run, Totals.Seconds sums the time spent by every worker
+	double			Seconds{ };
+
+	[[nodiscard]] double frames_per_second() const noexcept
+	{
+		return Seconds > 0. ? static_cast<double>(Totals.Frames) / Seconds : 0.;
+	}
+};
+
+
+class DemoPipelineBase
+{
+protected:
+	/// <summary>
+	/// Runs job(worker, index) for every entry of 'weights' over 'num_workers' threads, the calling thread included.
+	/// Jobs are dealt heaviest first to per worker queues, idle workers steal from the back of the others.
+	/// The first exception thrown by a job cancels the jobs not started yet and requests a stop on the token of the running ones,
+	/// it's rethrown once every worker is done
+	/// </summary>
+	PX_SDK_TF2 static void run_jobs(
+		std::span<const uint64_t> weights,
+		unsigned num_workers,
+		const std::function<void(unsigned, size_t, std::stop_token)>& job
+	);
+
+	/// <summary>
+	/// Sizes of 'files' on disk, 0 for the ones that can't be queried
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 static std::vector<uint64_t> get_file_sizes(std::span<const std::string> files);
+};
+
+
+/// <summary>
+/// Decodes many demos in parallel, demos are sharded across workers with work stealing.
+/// Inside a demo the frames are split first then decoded in a second stage, every worker owns its decoder pools and string pool.
+/// Callbacks are invoked concurrently from different workers but never concurrently for the same demo,
+/// results come back ordered by file index whatever the scheduling was
+/// </summary>
+template<typename _ResultTy>
+class DemoPipeline : public DemoPipelineBase
+{
+public:
+	using job_type = DemoJob<_ResultTy>;
+	using message_callback = std::function<void(job_type&, INetMessage&)>;
+	using user_message_callback = std::function<void(job_type&, const SVC_UserMessage&, utils::bf_read&)>;
+
+	/// <summary>
+	/// Registers 'callback(job_type&, _MsgTy&)' for every decoded _MsgTy, only net_ and svc_ messages are recorded in demos
+	/// </summary>
+	template<typename _MsgTy, typename _FnTy>
+	void on_message(_FnTy&& callback)
+	{
+		// Handlers are indexed by id and clc_ ids alias svc_ ones, a clc_ callback would fire for an unrelated svc_ message
+		static_assert(
+			!std::is_same_v<decltype(_MsgTy::MsgHandler), IClientMessageHandler*>,
+			"DemoPipeline only decodes server to client messages"
+		);
+
+		const auto type = static_cast<size_t>(_MsgTy{}.GetType());
+		Handlers[type].emplace_back(
+			[callback = std::forward<_FnTy>(callback)](job_type& job, INetMessage& message) mutable
+			{
+				callback(job, static_cast<_MsgTy&>(message));
+			}
+		);
+	}
+
+	/// <summary>
+	/// Registers 'callback(job_type&, const SVC_UserMessage&, bf_read& payload)' for user messages of 'type',
+	/// 'payload' is limited to the message's data
+	/// </summary>
+	template<typename _FnTy>
+	void on_user_message(Const::UserMsg type, _FnTy&& callback)
+	{
+		UserHandlers[static_cast<uint8_t>(type)].emplace_back(std::forward<_FnTy>(callback));
+		HasUserHandlers = true;
+	}
+
+	/// <summary>
+	/// Decodes every demo of 'files', 'num_workers' of 0 uses every core.
+	/// Strings interned by the callbacks stay valid until the next run or until the pipeline is destroyed.
+	/// If a callback throws, the other workers stop at their next frame and the exception is rethrown
+	/// </summary>
+	std::vector<_ResultTy> run(std::span<const std::string> files, unsigned num_workers = 0)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		if (!num_workers)
+			num_workers = std::max(std::thread::hardware_concurrency(), 1u);
+		num_workers = static_cast<unsigned>(std::clamp<size_t>(files.size(), 1, num_workers));
+
+		Workers.clear();
+		for (unsigned i = 0; i < num_workers; i++)
+			Workers.emplace_back(std::make_unique<worker_type>());
+
+		std::vector<_ResultTy> results(files.size());
+		std::vector<DemoReadStats> file_stats(files.size());
+		std::vector<uint8_t> failed(files.size());
+
+		const auto sizes = get_file_sizes(files);
+		run_jobs(
+			sizes,
+			num_workers,
+			[&](unsigned worker, size_t index, std::stop_token stop)
+			{
+				failed[index] = !process_file(*Workers[worker], worker, index, files[index], results[index], file_stats[index], stop);
+			}
+		);
+
+		// Merge in file order so the totals don't depend on the scheduling
+		Stats = { };
+		Stats.Files = files.size();
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			Stats.FailedFiles += failed[i];
+			Stats.Totals.Frames += file_stats[i].Frames;
+			Stats.Totals.Packets += file_stats[i].Packets;
+			Stats.Totals.Messages += file_stats[i].Messages;
+			Stats.Totals.BadPackets += file_stats[i].BadPackets;
+			Stats.Totals.Seconds += file_stats[i].Seconds;
+		}
+		Stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		return results;
+	}
+
+	[[nodiscard]] const DemoPipelineStats& stats() const noexcept { return Stats; }
+
+private:
+	struct worker_type
+	{
+		NetMessageDecoder		Decoder{ Const::NetMsgDirection::ServerToClient };
+		DemoStringPool			Strings;
+		std::vector<DemoFrame>	Frames;
+	};
+
+	bool process_file(
+		worker_type& worker,
+		unsigned worker_index,
+		size_t file_index,
+		const std::string& path,
+		_ResultTy& result,
+		DemoReadStats& stats,
+		const std::stop_token& stop
+	)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		DemoFile demo;
+		if (!demo.open(path.c_str()))
+			return false;
+
+		// Producer: split the mapped file into frames, payloads still point inside the mapping
+		worker.Frames.clear();
+		for (DemoFrame frame; demo.read_frame(frame);)
+		{
+			if (frame.has_packet())
+				worker.Frames.push_back(frame);
+			stats.Frames++;
+		}
+
+		// Consumer: decode the packets and dispatch the callbacks
+		job_type job{ file_index, worker_index, &demo.header(), nullptr, &result, &worker.Strings };
+		for (const DemoFrame& frame : worker.Frames)
+		{
+			// Another worker's callback threw, the run is abandoned
+			if (stop.stop_requested())
+				return false;
+
+			job.Frame = &frame;
+			stats.Packets++;
+
+			utils::bf_read buffer = frame.payload();
+			const auto status = worker.Decoder.decode_all(
+				buffer,
+				[&](NetMessageHandle& message)
+				{
+					stats.Messages++;
+					dispatch(job, *message.get());
+				}
+			);
+
+			if (status != Const::NetMsgDecodeStatus::EndOfStream)
+				stats.BadPackets++;
+		}
+
+		stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return true;
+	}
+
+	void dispatch(job_type& job, INetMessage& message)
+	{
+		const auto type = message.GetType();
+		for (auto& callback : Handlers[static_cast<size_t>(type)])
+			callback(job, message);
+
+		if (HasUserHandlers && type == Const::NetMsgType::svc_UserMessage)
+		{
+			const auto& user_message = static_cast<const SVC_UserMessage&>(message);
+			const int start_bit = user_message.DataIn.bits_written();
+			for (auto& callback : UserHandlers[static_cast<uint8_t>(user_message.MsgType)])
+			{
+				utils::bf_read payload(user_message.DataIn.data(), user_message.DataIn.remaining_bytes(), start_bit + user_message.Length);
+				payload.seek(start_bit);
+				callback(job, user_message, payload);
+			}
+		}
+	}
+
+	std::array<std::vector<message_callback>, Const::NetMsgType_Max>	Handlers;
+	std::array<std::vector<user_message_callback>, 256>				UserHandlers;
+	bool																HasUserHandlers{ };
+
+	std::vector<std::unique_ptr<worker_type>>	Workers;
+	DemoPipelineStats							Stats;
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <tf2/engine/NetMessages.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	static constexpr int GameEvent_MaxEvents = 1 << NetMsg_GameEventsBits;
+	static constexpr int GameEvent_KeyTypeBits = 3;
+	static constexpr int GameEvent_MaxStringLength = 1024;
+
+	enum class GameEventKeyType : uint8_t
+	{
+		// never networked, ends the keys of a descriptor
+		Local,
+		String,
+		Float,
+		Long,
+		Short,
+		Byte,
+		Bool,
+		UInt64
+	};
+}
+
+
+struct GameEventField
+{
+	std::string					Key;
+	Const::GameEventKeyType		Type{ };
+};
+
+/// <summary>
+/// Event description of a SVC_GameEventList, the fields are in the order they're networked
+/// </summary>
+struct GameEventDescriptor
+{
+	int							EventID{ -1 };
+	std::string					Name;
+	std::vector<GameEventField>	Fields;
+};
+
+
+/// <summary>
+/// Key of an event resolved once by GameEventDecoder::find_key, reading a record through it is an array access
+/// </summary>
+struct GameEventKey
+{
+	int16_t		EventID{ -1 };
+	uint16_t	Field{ };
+
+	[[nodiscard]] bool is_valid() const noexcept { return EventID != -1; }
+};
+
+
+union GameEventValue
+{
+	// Long, Short, Byte and Bool keys
+	int32_t		Int;
+	float		Float;
+	uint64_t	UInt64;
+	struct
+	{
+		// Null terminated
+		const char*	Data;
+		uint32_t	Length;
+	} String;
+};
+
+/// <summary>
+/// Decoded SVC_GameEvent, its values and strings live in the memory resource given to the decoder
+/// </summary>
+struct GameEventRecord
+{
+	const GameEventDescriptor*	Descriptor{ };
+	const GameEventValue*		Values{ };
+
+	[[nodiscard]] int event_id() const noexcept { return Descriptor ? Descriptor->EventID : -1; }
+	[[nodiscard]] std::string_view name() const noexcept { return Descriptor ? std::string_view{ Descriptor->Name } : std::string_view{ }; }
+
+	[[nodiscard]] bool has_key(GameEventKey key) const noexcept
+	{
+		return Descriptor && key.EventID == Descriptor->EventID;
+	}
+
+	[[nodiscard]] int get_int(GameEventKey key, int default_value = 0) const noexcept
+	{
+		if (!has_key(key))
+			return default_value;
+
+		switch (const auto& value = Values[key.Field]; Descriptor->Fields[key.Field].Type)
+		{
+		case Const::GameEventKeyType::Float:
+			return static_cast<int>(value.Float);
+		case Const::GameEventKeyType::UInt64:
+			return static_cast<int>(value.UInt64);
+		case Const::GameEventKeyType::String:
+			return default_value;
+		default:
+			return value.Int;
+		}
+	}
+
+	[[nodiscard]] bool get_bool(GameEventKey key, bool default_value = false) const noexcept
+	{
+		return get_int(key, default_value) != 0;
+	}
+
+	[[nodiscard]] float get_float(GameEventKey key, float default_value = 0.f) const noexcept
+	{
+		if (!has_key(key))
+			return default_value;
+
+		switch (const auto& value = Values[key.Field]; Descriptor->Fields[key.Field].Type)
+		{
+		case Const::GameEventKeyType::Float:
+			return value.Float;
+		case Const::GameEventKeyType::UInt64:
+			return static_cast<float>(value.UInt64);
+		case Const::GameEventKeyType::String:
+			return default_value;
+		default:
+			return static_cast<float>(value.Int);
+		}
+	}
+
+	[[nodiscard]] uint64_t get_uint64(GameEventKey key, uint64_t default_value = 0) const noexcept
+	{
+		if (!has_key(key))
+			return default_value;
+
+		switch (const auto& value = Values[key.Field]; Descriptor->Fields[key.Field].Type)
+		{
+		case Const::GameEventKeyType::UInt64:
+			return value.UInt64;
+		case Const::GameEventKeyType::Float:
+			return static_cast<uint64_t>(value.Float);
+		case Const::GameEventKeyType::String:
+			return default_value;
+		default:
+			return static_cast<uint64_t>(static_cast<uint32_t>(value.Int));
+		}
+	}
+
+	[[nodiscard]] std::string_view get_string(GameEventKey key, std::string_view default_value = { }) const noexcept
+	{
+		if (!has_key(key) || Descriptor->Fields[key.Field].Type != Const::GameEventKeyType::String)
+			return default_value;
+		return { Values[key.Field].String.Data, Values[key.Field].String.Length };
+	}
+};
+
+
+/// <summary>
+/// Decodes SVC_GameEvent messages with the descriptors of a SVC_GameEventList.
+/// Each descriptor is compiled once into a flat list of typed fields, an event is then decoded field by field
+/// into a record allocated from a memory resource, eg: a std::pmr::monotonic_buffer_resource per batch
+/// </summary>
+class GameEventDecoder
+{
+public:
+	/// <summary>
+	/// Replaces the descriptors with the ones of the list
+	/// </summary>
+	PX_SDK_TF2 bool read_descriptors(const SVC_GameEventList& message);
+	PX_SDK_TF2 bool read_descriptors(utils::bf_read& buffer, int num_events);
+
+	[[nodiscard]] const GameEventDescriptor* descriptor(int event_id) const noexcept
+	{
+		if (event_id < 0 || static_cast<size_t>(event_id) >= Descriptors.size() || Descriptors[event_id].EventID == -1)
+			return nullptr;
+		return &Descriptors[event_id];
+	}
+
+	[[nodiscard]] PX_SDK_TF2 const GameEventDescriptor* find_descriptor(std::string_view name) const noexcept;
+
+	/// <summary>
+	/// Resolves 'key' of 'event', the handle is invalid if either doesn't exist
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 GameEventKey find_key(std::string_view event, std::string_view key) const noexcept;
+
+	/// <summary>
+	/// Decodes a SVC_GameEvent, returns false if the event id is unknown or if the payload is too short
+	/// </summary>
+	PX_SDK_TF2 bool decode(const SVC_GameEvent& message, GameEventRecord& record, std::pmr::memory_resource* resource) const;
+	PX_SDK_TF2 bool decode(utils::bf_read& buffer, GameEventRecord& record, std::pmr::memory_resource* resource) const;
+
+	/// <summary>
+	/// Decodes every payload into 'records', the ones that fail to decode are skipped.
+	/// Returns the number of records appended
+	/// </summary>
+	PX_SDK_TF2 size_t decode_batch(
+		std::span<const SVC_GameEvent* const> messages,
+		std::vector<GameEventRecord>& records,
+		std::pmr::memory_resource* resource
+	) const;
+
+	/// <summary>
+	/// Adds the number of events of each id to 'counts', indexed by event id and at least Const::GameEvent_MaxEvents long.
+	/// Only the event ids are read
+	/// </summary>
+	PX_SDK_TF2 void count_events(std::span<const SVC_GameEvent* const> messages, std::span<uint32_t> counts) const noexcept;
+
+	[[nodiscard]] size_t size() const noexcept { return Index.size(); }
+
+	void clear() noexcept
+	{
+		Descriptors.clear();
+		Index.clear();
+	}
+
+private:
+	// Indexed by event id
+	std::vector<GameEventDescriptor>						Descriptors;
+	std::unordered_map<std::string_view, int>				Index;
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+#include <tf2/engine/NetMessages.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Names of a bucket of the perfect hash, on average
+	static constexpr size_t NetClass_BucketSize = 4;
+	// Seeds tried per bucket before giving up on the perfect hash
+	static constexpr uint32_t NetClass_MaxSeeds = 1 << 16;
+}
+
+
+/// <summary>
+/// Server class sent by SVC_ClassInfo, the names point into the NetClassTable's arena
+/// </summary>
+struct NetClassDescriptor
+{
+	std::string_view	Name;
+	std::string_view	TableName;
+	int					ClassID{ -1 };
+
+	[[nodiscard]] bool is_valid() const noexcept { return ClassID != -1; }
+};
+
+
+/// <summary>
+/// Compact index of the server classes: the names are interned in a single arena, class ids resolve through an array
+/// and names through a perfect hash, a lookup hashes the name once and compares it once
+/// </summary>
+class NetClassTable
+{
+public:
+	/// <summary>
+	/// Sizes the table from the server's class count, the width of the class ids in entity updates depends on it
+	/// </summary>
+	PX_SDK_TF2 void read(const SVC_ServerInfo& message);
+
+	/// <summary>
+	/// Replaces the classes with the message's ones.
+	/// Returns false if the client builds its own classes (SVC_ClassInfo::CreateOnClient) or the names can't be hashed
+	/// </summary>
+	PX_SDK_TF2 bool read(const SVC_ClassInfo& message);
+
+	/// <summary>
+	/// Same as read(const SVC_ClassInfo&) straight from the message body, past its type, without the 512 bytes per class of SVC_ClassInfo
+	/// </summary>
+	PX_SDK_TF2 bool read(utils::bf_read& buffer);
+
+	[[nodiscard]] const NetClassDescriptor* find(int class_id) const noexcept
+	{
+		if (class_id < 0 || static_cast<size_t>(class_id) >= Classes.size() || !Classes[class_id].is_valid())
+			return nullptr;
+		return &Classes[class_id];
+	}
+
+	[[nodiscard]] const NetClassDescriptor* find(std::string_view name) const noexcept
+	{
+		return find(find_id(name));
+	}
+
+	/// <summary>
+	/// Class id of the network name, eg: "CTFPlayer", -1 if the server didn't send it
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 int find_id(std::string_view name) const noexcept;
+
+	/// <summary>
+	/// Indexed by class id, the ids the server skipped are invalid descriptors
+	/// </summary>
+	[[nodiscard]] std::span<const NetClassDescriptor> classes() const noexcept { return Classes; }
+
+	[[nodiscard]] size_t size() const noexcept { return NumClasses; }
+
+	/// <summary>
+	/// Width of a class id in svc_PacketEntities and svc_TempEntities
+	/// </summary>
+	[[nodiscard]] int class_bits() const noexcept { return ClassBits; }
+
+	PX_SDK_TF2 void clear() noexcept;
+
+private:
+	struct pending_class
+	{
+		int			ClassID;
+		uint32_t	Name;
+		uint32_t	TableName;
+	};
+
+	void begin(int max_classes);
+	void add(int class_id, std::string_view name, std::string_view table_name);
+	bool finish();
+	bool build_hash();
+
+	[[nodiscard]] size_t slot_of(uint64_t hash, uint32_t seed) const noexcept;
+
+private:
+	// Every name, null terminated
+	std::vector<char>				Names;
+	std::vector<pending_class>		Pending;
+
+	// Indexed by class id
+	std::vector<NetClassDescriptor>	Classes;
+
+	// Seed of each bucket, the slot of a name is picked by its bucket's seed
+	std::vector<uint32_t>			Seeds;
+	// Class id of each slot, -1 for the empty ones
+	std::vector<int16_t>			Slots;
+
+	size_t							NumClasses{ };
+	int								ClassBits{ 1 };
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <tf2/utils/bitbuf.hpp>
+#include "NetChannel.hpp"
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Reliable payloads are split in fragments of 256 bytes, a subchannel block carries up to 7 of them
+	static constexpr int NetFrag_FragmentBits = 8;
+	static constexpr int NetFrag_FragmentSize = 1 << NetFrag_FragmentBits;
+	static constexpr int NetFrag_MaxFileSizeBits = 26;
+	static constexpr int NetFrag_StartFragmentBits = NetFrag_MaxFileSizeBits - NetFrag_FragmentBits;
+	static constexpr int NetFrag_NumFragmentsBits = 3;
+	// Size of a payload sent in a single block, up to NetFrag_Protocol_VarIntSize
+	static constexpr int NetFrag_PayloadBits = 17;
+	// Single block sizes are a varint past this protocol
+	static constexpr int NetFrag_Protocol_VarIntSize = 23;
+	// Protocol of the current game
+	static constexpr int NetFrag_Protocol = 24;
+	static constexpr int NetFrag_MaxPathLength = 260;
+
+	enum class NetFragStream
+	{
+		Normal,
+		File,
+
+		Count
+	};
+
+	enum class NetFragStatus : uint8_t
+	{
+		// the block didn't complete the transfer
+		Pending,
+		Complete,
+		// a fragment arrived before the first one, the engine drops the packet and waits for a retry
+		MissingHeader,
+		// fragment past the end of the transfer
+		BadFragment,
+		// the packet is shorter than its fragments
+		Overflow,
+		// the transfer is compressed and doesn't decompress to its announced size
+		BadCompression
+	};
+}
+
+
+/// <summary>
+/// Transfer of a subchannel stream being reassembled.
+/// Fragments are read straight into a single buffer sized by the transfer's header, a bitmap tracks the received ones
+/// so retransmitted fragments aren't counted twice. Buffers are kept between transfers, a fragment never allocates
+/// </summary>
+class NetFragmentStream
+{
+public:
+	/// <summary>
+	/// Reads a subchannel block of this stream, see CNetChan::ReadSubChannelData.
+	/// Returns Complete for the block that brings the last missing fragment, the payload is decompressed at that point.
+	/// 'protocol' is the network protocol of the channel, it sets how the size of a single block is written
+	/// </summary>
+	PX_SDK_TF2 Const::NetFragStatus read(utils::bf_read& buffer, int protocol = Const::NetFrag_Protocol);
+
+	/// <summary>
+	/// Drops the current transfer, the buffers are kept for the next one
+	/// </summary>
+	PX_SDK_TF2 void reset() noexcept;
+
+	[[nodiscard]] bool is_active() const noexcept { return IsActive; }
+	[[nodiscard]] bool is_complete() const noexcept { return IsActive && ReceivedFragments == NumFragments; }
+
+	/// <summary>
+	/// Payload of a complete transfer, decompressed if it was compressed
+	/// </summary>
+	[[nodiscard]] std::span<const uint8_t> data() const noexcept
+	{
+		if (IsCompressed)
+			return { Decompressed.data(), UncompressedSize };
+		return { Buffer.data(), Bytes };
+	}
+
+	[[nodiscard]] bool is_file() const noexcept { return !FileName.empty(); }
+	[[nodiscard]] const std::string& file_name() const noexcept { return FileName; }
+	[[nodiscard]] uint32_t transfer_id() const noexcept { return TransferID; }
+	[[nodiscard]] bool is_compressed() const noexcept { return IsCompressed; }
+
+	// Size of the transfer on the wire
+	[[nodiscard]] uint32_t wire_size() const noexcept { return Bytes; }
+	[[nodiscard]] uint32_t num_fragments() const noexcept { return NumFragments; }
+	[[nodiscard]] uint32_t received_fragments() const noexcept { return ReceivedFragments; }
+
+private:
+	bool read_header(utils::bf_read& buffer, bool single_block, int protocol);
+	Const::NetFragStatus finish();
+
+	/// <summary>
+	/// Marks [start, start + count) as received, returns the number of fragments that weren't
+	/// </summary>
+	uint32_t mark_received(uint32_t start, uint32_t count) noexcept;
+
+private:
+	std::vector<uint8_t>	Buffer;
+	std::vector<uint8_t>	Decompressed;
+	std::vector<uint64_t>	Received;
+
+	std::string				FileName;
+	uint32_t				TransferID{ };
+	uint32_t				Bytes{ };
+	uint32_t				UncompressedSize{ };
+	uint32_t				NumFragments{ };
+	uint32_t				ReceivedFragments{ };
+	bool					IsCompressed{ };
+	bool					IsActive{ };
+};
+
+
+/// <summary>
+/// Reassembles the reliable subchannel streams of a net channel from its packets, live or captured
+/// </summary>
+class NetFragmentAssembler
+{
+public:
+	explicit NetFragmentAssembler(int protocol = Const::NetFrag_Protocol) noexcept : Protocol(protocol) { }
+
+	/// <summary>
+	/// Reads the subchannel data of a packet flagged as reliable: a bit per stream followed by its block.
+	/// Returns false if a block was rejected, the rest of the packet shouldn't be processed then
+	/// </summary>
+	PX_SDK_TF2 bool read_subchannels(utils::bf_read& buffer);
+
+	[[nodiscard]] NetFragmentStream& stream(Const::NetFragStream stream) noexcept
+	{
+		return Streams[static_cast<size_t>(stream)];
+	}
+
+	[[nodiscard]] const NetFragmentStream& stream(Const::NetFragStream stream) const noexcept
+	{
+		return Streams[static_cast<size_t>(stream)];
+	}
+
+	// Status of the last block read for each stream
+	[[nodiscard]] Const::NetFragStatus last_status(Const::NetFragStream stream) const noexcept
+	{
+		return LastStatus[static_cast<size_t>(stream)];
+	}
+
+	void reset() noexcept
+	{
+		for (auto& stream : Streams)
+			stream.reset();
+	}
+
+	// Network protocol of the channel, eg: DemoHeader::NetworkProtocol of a demo
+	[[nodiscard]] int protocol() const noexcept { return Protocol; }
+	void set_protocol(int protocol) noexcept { Protocol = protocol; }
+
+private:
+	NetFragmentStream		Streams[static_cast<size_t>(Const::NetFragStream::Count)];
+	Const::NetFragStatus	LastStatus[static_cast<size_t>(Const::NetFragStream::Count)]{ };
+	int						Protocol;
+};
+
+TF2_NAMESPACE_END();
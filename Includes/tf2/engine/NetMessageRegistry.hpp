@@ -0,0 +1,196 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <tf2/engine/NetMessages.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Every message id NetMsgType_Bits can encode
+	static constexpr uint32_t NetMsgType_Max = 1 << NetMsgType_Bits;
+
+	// svc_ and clc_ ids overlap, a decoder only ever sees one side of the connection
+	enum class NetMsgDirection
+	{
+		// net_ and svc_ messages
+		ServerToClient,
+		// net_ and clc_ messages
+		ClientToServer
+	};
+
+	enum class NetMsgDecodeStatus
+	{
+		Ok,
+		// no message header left in the buffer
+		EndOfStream,
+		// no decoder is registered for the message id
+		UnknownType,
+		// ReadFromBuffer failed
+		ReadFailed
+	};
+}
+
+class NetMessageDecoder;
+class NetMessageTrace;
+class NetMessageStats;
+
+/// <summary>
+/// Owns a decoded message, the message goes back to its decoder's pool once the handle is reset or destroyed.
+/// A handle must not outlive the decoder that produced it
+/// </summary>
+class NetMessageHandle
+{
+	friend class NetMessageDecoder;
+
+public:
+	NetMessageHandle() = default;
+	~NetMessageHandle() { reset(); }
+
+	NetMessageHandle(const NetMessageHandle&) = delete;
+	NetMessageHandle& operator=(const NetMessageHandle&) = delete;
+
+	NetMessageHandle(NetMessageHandle&& other) noexcept :
+		Owner(std::exchange(other.Owner, nullptr)), Message(std::exchange(other.Message, nullptr))
+	{ }
+
+	NetMessageHandle& operator=(NetMessageHandle&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			Owner = std::exchange(other.Owner, nullptr);
+			Message = std::exchange(other.Message, nullptr);
+		}
+		return *this;
+	}
+
+	PX_SDK_TF2 void reset() noexcept;
+
+	[[nodiscard]] INetMessage* get() const noexcept { return Message; }
+	[[nodiscard]] INetMessage* operator->() const noexcept { return Message; }
+	[[nodiscard]] explicit operator bool() const noexcept { return Message != nullptr; }
+
+	/// <summary>
+	/// Access the concrete message, check GetType() first
+	/// </summary>
+	template<typename _MsgTy>
+	[[nodiscard]] _MsgTy* as() const noexcept { return static_cast<_MsgTy*>(Message); }
+
+private:
+	NetMessageHandle(NetMessageDecoder* owner, INetMessage* message) noexcept :
+		Owner(owner), Message(message)
+	{ }
+
+	NetMessageDecoder*	Owner{ };
+	INetMessage*		Message{ };
+};
+
+
+/// <summary>
+/// Decodes a stream of net messages through a flat table indexed by message id.
+/// Messages are recycled through per-type pools, once the pools are warm decoding a packet doesn't allocate
+/// </summary>
+class NetMessageDecoder
+{
+	friend class NetMessageHandle;
+
+public:
+	using factory_type = INetMessage* (*)();
+
+	/// <summary>
+	/// Registers every message the SDK can decode for 'direction'
+	/// </summary>
+	PX_SDK_TF2 explicit NetMessageDecoder(Const::NetMsgDirection direction);
+
+	NetMessageDecoder(const NetMessageDecoder&) = delete;
+	NetMessageDecoder& operator=(const NetMessageDecoder&) = delete;
+
+	/// <summary>
+	/// Registers or replaces the decoder of _MsgTy's id, the first pooled instance is created right away
+	/// </summary>
+	template<typename _MsgTy>
+	void register_message()
+	{
+		std::unique_ptr<INetMessage> message = std::make_unique<_MsgTy>();
+		const auto type = message->GetType();
+
+		register_factory(type, []() -> INetMessage* { return new _MsgTy; });
+		Entries[static_cast<size_t>(type)].Free.push_back(std::move(message));
+	}
+
+	/// <summary>
+	/// Registers or replaces the decoder of 'type', nullptr unregisters it.
+	/// Must not be called while decoded messages of 'type' are still held
+	/// </summary>
+	PX_SDK_TF2 void register_factory(Const::NetMsgType type, factory_type factory);
+
+	/// <summary>
+	/// Makes sure at least 'count' messages of 'type' are pooled
+	/// </summary>
+	PX_SDK_TF2 void reserve(Const::NetMsgType type, size_t count);
+
+	/// <summary>
+	/// Reads the next message header and body, net_Nop messages are skipped.
+	/// 'message' is reset first and only holds a message when Ok is returned
+	/// </summary>
+	PX_SDK_TF2 Const::NetMsgDecodeStatus decode(utils::bf_read& buffer, NetMessageHandle& message);
+
+	/// <summary>
+	/// Decodes every message of 'buffer' and hands them to 'callback(NetMessageHandle&)', stops at the first failure.
+	/// The callback may move the handle out to keep the message
+	/// </summary>
+	template<typename _FnTy>
+	Const::NetMsgDecodeStatus decode_all(utils::bf_read& buffer, _FnTy&& callback)
+	{
+		NetMessageHandle message;
+		Const::NetMsgDecodeStatus status;
+		while ((status = decode(buffer, message)) == Const::NetMsgDecodeStatus::Ok)
+			callback(message);
+		return status;
+	}
+
+	[[nodiscard]] bool is_registered(Const::NetMsgType type) const noexcept
+	{
+		return Entries[static_cast<size_t>(type)].Factory != nullptr;
+	}
+
+	[[nodiscard]] Const::NetMsgDirection direction() const noexcept { return Direction; }
+
+	/// <summary>
+	/// Records every decoded message into 'trace', nullptr stops recording.
+	/// The trace must outlive the decoder or be detached first
+	/// </summary>
+	void set_trace(NetMessageTrace* trace) noexcept { Trace = trace; }
+	[[nodiscard]] NetMessageTrace* trace() const noexcept { return Trace; }
+
+	/// <summary>
+	/// Times every decoded message into 'stats', nullptr stops collecting.
+	/// The stats must outlive the decoder or be detached first
+	/// </summary>
+	void set_stats(NetMessageStats* stats) noexcept { Stats = stats; }
+	[[nodiscard]] NetMessageStats* stats() const noexcept { return Stats; }
+
+	// Tick of the last net_Tick decoded, -1 until then
+	[[nodiscard]] int tick() const noexcept { return Tick; }
+
+private:
+	PX_SDK_TF2 void release(INetMessage* message) noexcept;
+
+	struct entry_type
+	{
+		factory_type								Factory{ };
+		std::vector<std::unique_ptr<INetMessage>>	Free;
+	};
+
+	std::array<entry_type, Const::NetMsgType_Max>	Entries;
+	Const::NetMsgDirection							Direction;
+	NetMessageTrace*								Trace{ };
+	NetMessageStats*								Stats{ };
+	int												Tick{ -1 };
+};
+
+TF2_NAMESPACE_END();
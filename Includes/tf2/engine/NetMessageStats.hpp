@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <string>
+#include <tf2/engine/NetMessageRegistry.hpp>
+
+PX_NAMESPACE_BEGIN();
+class IConsoleManager;
+PX_NAMESPACE_END();
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Decode times are bucketed by powers of two: [0, 32ns), [32ns, 64ns), ..., [2^19ns, inf)
+	static constexpr size_t NetStats_HistogramBuckets = 16;
+	static constexpr int NetStats_HistogramShift = 5;
+	// Live threads with a slot of their own, the ones past this count share a slot updated with locked adds
+	static constexpr size_t NetStats_MaxThreads = 64;
+	static constexpr size_t NetStats_NumGroups = static_cast<size_t>(NetMsgGroup::Count);
+}
+
+
+struct NetMessageCounters
+{
+	uint64_t	Count{ };
+	uint64_t	Bits{ };
+	uint64_t	MaxBits{ };
+	uint64_t	Nanoseconds{ };
+	uint64_t	Histogram[Const::NetStats_HistogramBuckets]{ };
+
+	void merge(const NetMessageCounters& other) noexcept
+	{
+		Count += other.Count;
+		Bits += other.Bits;
+		MaxBits = std::max(MaxBits, other.MaxBits);
+		Nanoseconds += other.Nanoseconds;
+		for (size_t i = 0; i < std::size(Histogram); i++)
+			Histogram[i] += other.Histogram[i];
+	}
+
+	/// <summary>
+	/// Upper bound of the decode time under which 'fraction' of the messages were decoded, eg: 0.99 for the 99th percentile
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 uint64_t percentile_nanoseconds(double fraction) const noexcept;
+
+	[[nodiscard]] static constexpr uint64_t bucket_upper_bound(size_t bucket) noexcept
+	{
+		return bucket + 1 < Const::NetStats_HistogramBuckets ? uint64_t{ 1 } << (bucket + Const::NetStats_HistogramShift) : UINT64_MAX;
+	}
+};
+
+
+/// <summary>
+/// Merged view of NetMessageStats, indexed by Const::NetMsgType and Const::NetMsgGroup
+/// </summary>
+struct NetMessageStatsSnapshot
+{
+	std::array<NetMessageCounters, Const::NetMsgType_Max>		Types;
+	std::array<NetMessageCounters, Const::NetStats_NumGroups>	Groups;
+	Const::NetMsgDirection										Direction{ };
+
+	/// <summary>
+	/// Formats the types and groups as a table sorted by decode time
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 std::string to_string() const;
+	[[nodiscard]] PX_SDK_TF2 std::string to_json() const;
+
+	/// <summary>
+	/// Prints to_string() to the console, meant to be bound to a plugin command
+	/// </summary>
+	PX_SDK_TF2 void print(IConsoleManager& console) const;
+};
+
+
+/// <summary>
+/// Per message type counters: count, bits, largest message and a decode time histogram.
+/// Each thread writes to its own cache line aligned slot with plain relaxed stores, the slots are only merged by snapshot().
+/// A slot is given back when its thread exits and reused by the next thread
+/// </summary>
+class NetMessageStats
+{
+public:
+	PX_SDK_TF2 explicit NetMessageStats(Const::NetMsgDirection direction);
+	PX_SDK_TF2 ~NetMessageStats();
+
+	NetMessageStats(const NetMessageStats&) = delete;
+	NetMessageStats& operator=(const NetMessageStats&) = delete;
+
+	void record(Const::NetMsgType type, Const::NetMsgGroup group, uint32_t bits, uint64_t nanoseconds) noexcept
+	{
+		const auto& thread = thread_index();
+		auto& slot = local_slot(thread.Index);
+		auto& counters = slot.Types[static_cast<size_t>(type) & (Const::NetMsgType_Max - 1)];
+
+		// Only the owner writes to its slot, the shared one needs a locked add
+		const bool is_shared = thread.IsShared;
+		auto add = [is_shared](std::atomic<uint64_t>& counter, uint64_t value)
+		{
+			if (is_shared)
+				counter.fetch_add(value, std::memory_order_relaxed);
+			else
+				counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		};
+
+		add(counters.Count, 1);
+		add(counters.Bits, bits);
+		add(counters.Nanoseconds, nanoseconds);
+		add(counters.Histogram[histogram_bucket(nanoseconds)], 1);
+
+		uint64_t max_bits = counters.MaxBits.load(std::memory_order_relaxed);
+		while (bits > max_bits && !counters.MaxBits.compare_exchange_weak(max_bits, bits, std::memory_order_relaxed))
+		{ }
+		counters.Group.store(static_cast<uint8_t>(group), std::memory_order_relaxed);
+	}
+
+	void record(const INetMessage& message, uint32_t bits, uint64_t nanoseconds) noexcept
+	{
+		record(message.GetType(), message.GetGroup(), bits, nanoseconds);
+	}
+
+	/// <summary>
+	/// Merges every thread's counters, safe to call while other threads record
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 NetMessageStatsSnapshot snapshot() const;
+
+	/// <summary>
+	/// Zeroes the counters, messages recorded concurrently may be partially kept
+	/// </summary>
+	PX_SDK_TF2 void reset() noexcept;
+
+	[[nodiscard]] Const::NetMsgDirection direction() const noexcept { return Direction; }
+
+	[[nodiscard]] static size_t histogram_bucket(uint64_t nanoseconds) noexcept
+	{
+		const size_t bucket = std::bit_width(nanoseconds >> Const::NetStats_HistogramShift);
+		return std::min(bucket, Const::NetStats_HistogramBuckets - 1);
+	}
+
+private:
+	struct counters_type
+	{
+		std::atomic<uint64_t>	Count{ };
+		std::atomic<uint64_t>	Bits{ };
+		std::atomic<uint64_t>	MaxBits{ };
+		std::atomic<uint64_t>	Nanoseconds{ };
+		std::atomic<uint64_t>	Histogram[Const::NetStats_HistogramBuckets]{ };
+		std::atomic<uint8_t>	Group{ };
+	};
+
+	struct alignas(64) slot_type
+	{
+		counters_type	Types[Const::NetMsgType_Max];
+	};
+
+	/// <summary>
+	/// Slot index of a thread, shared by every instance.
+	/// Taken from the free indices when the thread first records and given back when it exits,
+	/// threads past Const::NetStats_MaxThreads live ones get the shared slot
+	/// </summary>
+	struct thread_index_type
+	{
+		PX_SDK_TF2 thread_index_type() noexcept;
+		PX_SDK_TF2 ~thread_index_type();
+
+		thread_index_type(const thread_index_type&) = delete;
+		thread_index_type& operator=(const thread_index_type&) = delete;
+
+		size_t	Index;
+		bool	IsShared;
+	};
+
+	[[nodiscard]] static const thread_index_type& thread_index() noexcept
+	{
+		thread_local const thread_index_type index;
+		return index;
+	}
+
+	slot_type& local_slot(size_t index) noexcept
+	{
+		auto slot = Slots[index].load(std::memory_order_acquire);
+		return slot ? *slot : create_slot(index);
+	}
+
+	PX_SDK_TF2 slot_type& create_slot(size_t index);
+
+	// The last one is the shared slot
+	std::array<std::atomic<slot_type*>, Const::NetStats_MaxThreads + 1>	Slots{ };
+	Const::NetMsgDirection												Direction;
+
+	// Bit 'i' is set if no live thread owns the index 'i'
+	static inline std::atomic<uint64_t>									FreeThreadIndices{ ~uint64_t{ } };
+	static_assert(Const::NetStats_MaxThreads <= 64, "FreeThreadIndices has a bit per thread index");
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include <tf2/engine/NetMessageRegistry.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	static constexpr size_t NetTrace_DefaultCapacity = 1 << 14;
+
+	// NetTraceEvent::Flags
+	static constexpr uint8_t NetTrace_Reliable = 1 << 0;
+	static constexpr uint8_t NetTrace_ClientToServer = 1 << 1;
+}
+
+
+/// <summary>
+/// Compact record of a net message, formatted on demand with NetMessageTrace::format
+/// </summary>
+struct NetTraceEvent
+{
+	int32_t		Tick{ };
+	// Size of the message in bits, header included
+	uint32_t	Bits{ };
+	uint8_t		Type{ };
+	uint8_t		Group{ };
+	uint8_t		Flags{ };
+
+	[[nodiscard]] Const::NetMsgType type() const noexcept { return static_cast<Const::NetMsgType>(Type); }
+	[[nodiscard]] Const::NetMsgGroup group() const noexcept { return static_cast<Const::NetMsgGroup>(Group); }
+	[[nodiscard]] bool is_reliable() const noexcept { return Flags & Const::NetTrace_Reliable; }
+	[[nodiscard]] bool is_client_to_server() const noexcept { return Flags & Const::NetTrace_ClientToServer; }
+};
+
+
+/// <summary>
+/// Fixed size ring of the last net messages, recording is lock free and never allocates so it can stay on.
+/// Writers claim a slot with a single atomic increment, each slot is guarded by its sequence number:
+/// a reader skips the slots that were overwritten or are being written while it copies them
+/// </summary>
+class NetMessageTrace
+{
+public:
+	/// <summary>
+	/// 'capacity' is rounded up to a power of two
+	/// </summary>
+	PX_SDK_TF2 explicit NetMessageTrace(size_t capacity = Const::NetTrace_DefaultCapacity);
+
+	NetMessageTrace(const NetMessageTrace&) = delete;
+	NetMessageTrace& operator=(const NetMessageTrace&) = delete;
+
+	void record(const NetTraceEvent& event) noexcept
+	{
+		const uint64_t index = Head.fetch_add(1, std::memory_order_relaxed);
+		auto& slot = Slots[index & Mask];
+
+		// Odd while the slot is written
+		slot.Sequence.store(index * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.Words[0].store(static_cast<uint32_t>(event.Tick) | (static_cast<uint64_t>(event.Bits) << 32), std::memory_order_relaxed);
+		slot.Words[1].store(event.Type | (event.Group << 8) | (event.Flags << 16), std::memory_order_relaxed);
+
+		slot.Sequence.store(index * 2 + 2, std::memory_order_release);
+	}
+
+	void record(const INetMessage& message, int tick, uint32_t bits, bool client_to_server = false) noexcept
+	{
+		record(
+			NetTraceEvent{
+				.Tick = tick,
+				.Bits = bits,
+				.Type = static_cast<uint8_t>(message.GetType()),
+				.Group = static_cast<uint8_t>(message.GetGroup()),
+				.Flags = static_cast<uint8_t>(
+					(message.IsReliable() ? Const::NetTrace_Reliable : 0) |
+					(client_to_server ? Const::NetTrace_ClientToServer : 0)
+				)
+			}
+		);
+	}
+
+	/// <summary>
+	/// Copies the events still in the ring, oldest first, into 'events'. Returns the number of events copied.
+	/// Safe to call while other threads record
+	/// </summary>
+	PX_SDK_TF2 size_t snapshot(std::vector<NetTraceEvent>& events) const;
+
+	// Number of events recorded since the trace was created, including the overwritten ones
+	[[nodiscard]] uint64_t total() const noexcept { return Head.load(std::memory_order_relaxed); }
+	[[nodiscard]] size_t capacity() const noexcept { return Mask + 1; }
+
+	/// <summary>
+	/// Writes a line such as "tick 1520 svc_PacketEntities (Entities) 1336 bits reliable" into 'buffer'.
+	/// Returns the length of the line
+	/// </summary>
+	PX_SDK_TF2 static size_t format(const NetTraceEvent& event, char* buffer, size_t size) noexcept;
+	PX_SDK_TF2 static std::string format(std::span<const NetTraceEvent> events);
+
+	/// <summary>
+	/// Name of the message type, eg "svc_PacketEntities", "" if the id isn't used
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 static const char* type_name(Const::NetMsgType type, bool client_to_server) noexcept;
+	[[nodiscard]] PX_SDK_TF2 static const char* group_name(Const::NetMsgGroup group) noexcept;
+
+	/// <summary>
+	/// Decodes every message of 'buffer' and appends their ToString() to 'output', a line per message.
+	/// Returns the number of messages decoded
+	/// </summary>
+	PX_SDK_TF2 static size_t dump(NetMessageDecoder& decoder, utils::bf_read& buffer, std::string& output);
+
+private:
+	struct slot_type
+	{
+		std::atomic<uint64_t>	Sequence{ };
+		std::atomic<uint64_t>	Words[2]{ };
+	};
+
+	std::unique_ptr<slot_type[]>	Slots;
+	size_t							Mask;
+	std::atomic<uint64_t>			Head{ };
+};
+
+TF2_NAMESPACE_END();
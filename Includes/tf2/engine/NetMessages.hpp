@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Netchannel.hpp"
+#include "NetChannel.hpp"
 #include <tf2/utils/UtlVector.hpp>
 #include <tf2/utils/bitbuf.hpp>
 #include <tf2/utils/Checksum.hpp>
@@ -19,6 +19,21 @@ namespace Const
 	static constexpr uint32_t NetMsg_BackupCommandBits = 4;
 	static constexpr uint32_t NetMsg_BackupCommand = (1 << NetMsg_NewCommandBits) - 1;
 
+	// Length in bits of user messages, entity messages and game events
+	static constexpr uint32_t NetMsg_LengthBits = 11;
+	// Length in bits of entity deltas, string table updates and game event lists
+	static constexpr uint32_t NetMsg_DeltaSizeBits = 20;
+	static constexpr uint32_t NetMsg_MaxTablesBits = 5;
+	static constexpr uint32_t NetMsg_UserDataBits = 12;
+	static constexpr uint32_t NetMsg_UserDataSizeBits = 4;
+	static constexpr uint32_t NetMsg_DecalIndexBits = 9;
+	static constexpr uint32_t NetMsg_ModelIndexBits = 12;
+	static constexpr uint32_t NetMsg_SoundIndexBits = 14;
+	static constexpr uint32_t NetMsg_TempEntitiesBits = 8;
+	static constexpr uint32_t NetMsg_GameEventsBits = 9;
+	// svc_ServerInfo carries the map's MD5 instead of its CRC past this protocol
+	static constexpr int NetMsg_Protocol_MapCRC = 17;
+
 	enum class UserMsg
 	{
 		Geiger,
@@ -178,8 +193,8 @@ namespace Const
 		svc_VoiceInit,
 		// Voicestream data from the 
 		svc_VoiceData,
-		// starts playing 
-		svc_Sounds,
+		// starts playing, 16 was svc_HLTV
+		svc_Sounds = 17,
 		// sets entity as point of view
 		svc_SetView,
 		// sets/corrects players viewangle
@@ -190,8 +205,8 @@ namespace Const
 		svc_BSPDecal,
 
 		//, from server side to client side entity
-		// a game specific message 
-		svc_UserMessage,	
+		// a game specific message, 22 was svc_TerrainMod
+		svc_UserMessage = 23,	
 		// a message for an entity
 		svc_EntityMessage,	
 		// global game event 
@@ -257,9 +272,9 @@ using QueryCVarCookie = int;
 		bool				IsReliable()				const final { return Reliable; }							\
 		PX_SDK_TF2 bool		ReadFromBuffer(utils::bf_read& buffer)	final;											\
 		PX_SDK_TF2 bool		WriteToBuffer(utils::bf_write& buffer)	final;											\
-		const char*			ToString()					const final { return ""; }									\
+		PX_SDK_TF2 const char*	ToString()					const final;													\
 		Const::NetMsgType	GetType()					const final { return Const::NetMsgType::NAME##_##TYPE; }	\
-		const char*			GetName()					const final { return #NAME## "_" #TYPE; }					\
+		const char*			GetName()					const final { return #NAME "_" #TYPE; }					\
 		Const::NetMsgGroup	GetGroup()					const final { return Const::NetMsgGroup::GROUP; }			\
 		bool				Process()						  final { return MsgHandler->Process##TYPE(this); }
 
@@ -367,6 +382,7 @@ class NET_SignonState : public INetMessage
 {
 	DECLARE_NET_MESSAGE(SignonState, Signon, net, INetMessageHandler);
 
+	NET_SignonState() = default;
 	NET_SignonState(Const::SignonStateType state, int spawncount) noexcept : SignonState(state), SpawnCount(spawncount) { };
 
 public:
@@ -446,6 +462,7 @@ class CLC_BaselineAck : public INetMessage
 {
 	DECLARE_NET_MESSAGE(BaselineAck, Entities, clc, IClientMessageHandler);
 
+	CLC_BaselineAck() = default;
 	CLC_BaselineAck(int tick, int baseline) noexcept : BaselineTick(tick), BaselineNr(baseline) { };
 
 public:
@@ -600,6 +617,22 @@ public:
 	bool		Paused;
 };
 
+class SVC_GetCvarValue : public INetMessage
+{
+	DECLARE_NET_MESSAGE(GetCvarValue, Generic, svc, IServerMessageHandler);
+
+	SVC_GetCvarValue() = default;
+	SVC_GetCvarValue(QueryCVarCookie cookie, const char* name) noexcept : Cookie(cookie), CvarName(name) { }
+
+public:
+	QueryCVarCookie Cookie{ };
+	const char*		CvarName{ };	// The sender sets this, and it automatically
+									// points it at CvarNameBuffer when receiving.
+
+private:
+	char CvarNameBuffer[256];
+};
+
 class SVC_SetPauseTimed : public INetMessage
 {
 	DECLARE_NET_MESSAGE(SetPauseTimed, Generic, svc, IServerMessageHandler);
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <memory_resource>
+#include <span>
+#include <tf2/engine/NetMessageRegistry.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Default of net_maxroutable, the largest payload the engine sends in one datagram
+	static constexpr int NetPacket_DefaultMTU = 1260;
+	// Room reserved for a message whose size can't be computed upfront, the buffer grows and the message is written again past it
+	static constexpr int NetPacket_WriteSlackBits = 4096 * 8;
+	// NET_MAX_PAYLOAD, the buffer doesn't grow past it for a single message
+	static constexpr int NetPacket_MaxMessageBits = 288000 * 8;
+}
+
+
+/// <summary>
+/// Range of NetPacketBuilder's buffer holding whole messages, starts on a 32 bits boundary
+/// </summary>
+struct NetPacketRange
+{
+	int			StartBit{ };
+	int			Bits{ };
+	uint32_t	FirstMessage{ };
+	uint32_t	NumMessages{ };
+
+	[[nodiscard]] int bytes() const noexcept { return (Bits + 7) / 8; }
+};
+
+
+/// <summary>
+/// Serializes a batch of net messages into one growable bit buffer allocated from a memory resource,
+/// eg: a std::pmr::monotonic_buffer_resource per batch.
+/// The batch is split in packets of at most 'mtu' bytes as messages are added, a message is never split nor encoded twice
+/// unless the buffer had to grow while writing it
+/// </summary>
+class NetPacketBuilder
+{
+public:
+	PX_SDK_TF2 explicit NetPacketBuilder(
+		Const::NetMsgDirection direction,
+		int mtu = Const::NetPacket_DefaultMTU,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+	);
+
+	NetPacketBuilder(const NetPacketBuilder&) = delete;
+	NetPacketBuilder& operator=(const NetPacketBuilder&) = delete;
+
+	/// <summary>
+	/// Appends 'message' to the current packet or starts a new one if the message would cross the MTU.
+	/// A message larger than the MTU gets a packet of its own, the channel would send it through a subchannel.
+	/// Returns false and leaves the batch untouched if the message can't be written, eg: svc_Menu,
+	/// or if it doesn't fit in Const::NetPacket_MaxMessageBits
+	/// </summary>
+	PX_SDK_TF2 bool add(INetMessage& message);
+
+	/// <summary>
+	/// Appends every message of 'messages', stops at the first failure. Returns the number of messages added
+	/// </summary>
+	template<typename _RangeTy>
+	size_t add_range(_RangeTy&& messages)
+	{
+		size_t count = 0;
+		for (auto&& message : messages)
+		{
+			if (!add(*message))
+				break;
+			count++;
+		}
+		return count;
+	}
+
+	/// <summary>
+	/// Drops every message but keeps the buffer
+	/// </summary>
+	PX_SDK_TF2 void clear() noexcept;
+
+	/// <summary>
+	/// Makes sure 'bits' can be written without growing the buffer
+	/// </summary>
+	PX_SDK_TF2 void reserve(int bits);
+
+	[[nodiscard]] std::span<const NetPacketRange> packets() const noexcept { return { Packets.data(), Packets.size() }; }
+
+	/// <summary>
+	/// Bytes of the packet at 'index', valid until the next add(), reserve() or clear()
+	/// </summary>
+	[[nodiscard]] std::span<const uint8_t> packet_data(size_t index) const noexcept
+	{
+		const auto& packet = Packets[index];
+		return { reinterpret_cast<const uint8_t*>(Words.data() + packet.StartBit / 32), static_cast<size_t>(packet.bytes()) };
+	}
+
+	/// <summary>
+	/// Reader bounded to the packet at 'index'
+	/// </summary>
+	[[nodiscard]] utils::bf_read read_packet(size_t index) const noexcept
+	{
+		const auto data = packet_data(index);
+		return utils::bf_read(data.data(), static_cast<int>(data.size()), Packets[index].Bits);
+	}
+
+	[[nodiscard]] size_t message_count() const noexcept { return MessageCount; }
+	[[nodiscard]] int bits_written() const noexcept { return Writer.bits_written(); }
+	[[nodiscard]] int mtu() const noexcept { return MTU; }
+	[[nodiscard]] Const::NetMsgDirection direction() const noexcept { return Direction; }
+
+	/// <summary>
+	/// Exact size in bits of 'message' once written, header included.
+	/// -1 for the messages whose size isn't cheap to know without writing them
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 static int message_bits(const INetMessage& message, Const::NetMsgDirection direction) noexcept;
+
+private:
+	void grow(int bits);
+	void move_bits(int from, int to, int bits) noexcept;
+
+	std::pmr::vector<uint32_t>			Words;
+	std::pmr::vector<NetPacketRange>	Packets;
+	utils::bf_write						Writer;
+	size_t								MessageCount{ };
+	int									MTU;
+	Const::NetMsgDirection				Direction;
+};
+
+TF2_NAMESPACE_END();
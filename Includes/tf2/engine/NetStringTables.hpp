@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tf2/engine/NetMessages.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Entries remembered for the substring reuse of an update
+	static constexpr size_t StringTable_HistorySize = 32;
+	// Width of the history index and of the reused prefix length
+	static constexpr int StringTable_SubstringBits = 5;
+	static constexpr int StringTable_MaxEntryLength = 1024;
+	static constexpr int StringTable_MaxUserDataBits = 14;
+	static constexpr int StringTable_MaxUserDataSize = 1 << StringTable_MaxUserDataBits;
+
+	enum class StringTableStatus : uint8_t
+	{
+		Ok,
+		// entry index past the table's capacity or past its end
+		BadIndex,
+		// substring reference to a history entry that doesn't exist
+		BadHistory,
+		// the payload is shorter than its entries
+		Overflow,
+		// update of a table that wasn't created
+		UnknownTable,
+		// compressed payload with bad sizes or a corrupted LZSS stream
+		BadCompression
+	};
+}
+
+
+/// <summary>
+/// Last entries of an update, an entry can start with a prefix of one of them.
+/// Only the first 31 characters of an entry can be reused, that's all the history keeps
+/// </summary>
+class NetStringTableHistory
+{
+public:
+	void push(std::string_view str) noexcept
+	{
+		auto& entry = Entries[(Start + Count) % Const::StringTable_HistorySize];
+		entry.Length = static_cast<uint8_t>(std::min(str.size(), sizeof(entry.String)));
+		std::copy_n(str.data(), entry.Length, entry.String);
+
+		if (Count < Const::StringTable_HistorySize)
+			Count++;
+		else
+			Start = (Start + 1) % Const::StringTable_HistorySize;
+	}
+
+	// 'index' 0 is the oldest entry
+	[[nodiscard]] std::string_view get(size_t index) const noexcept
+	{
+		auto& entry = Entries[(Start + index) % Const::StringTable_HistorySize];
+		return { entry.String, entry.Length };
+	}
+
+	[[nodiscard]] size_t size() const noexcept { return Count; }
+	void clear() noexcept { Start = Count = 0; }
+
+private:
+	struct entry_type
+	{
+		char	String[(1 << Const::StringTable_SubstringBits) - 1];
+		uint8_t	Length;
+	};
+
+	entry_type	Entries[Const::StringTable_HistorySize];
+	size_t		Start{ };
+	size_t		Count{ };
+};
+
+
+/// <summary>
+/// Client copy of a networked string table.
+/// Strings and user data live in a single arena, entries are reached by index in O(1) or by string through a hash table.
+/// Views and pointers returned by the table stay valid until the next apply(), set_user_data() or add()
+/// </summary>
+class NetStringTable
+{
+public:
+	PX_SDK_TF2 NetStringTable(
+		std::string_view name,
+		int max_entries,
+		bool user_data_fixed_size = false,
+		int user_data_size = 0,
+		int user_data_size_bits = 0
+	);
+
+	/// <summary>
+	/// Decodes 'num_entries' entries of a SVC_CreateStringTable or SVC_UpdateStringTable payload and applies them
+	/// </summary>
+	PX_SDK_TF2 Const::StringTableStatus apply(utils::bf_read& buffer, int num_entries);
+
+	/// <summary>
+	/// Adds 'str' or replaces its user data if it's already in the table, returns its index
+	/// </summary>
+	PX_SDK_TF2 int add(std::string_view str, std::span<const uint8_t> user_data = { });
+
+	PX_SDK_TF2 void set_user_data(int index, std::span<const uint8_t> user_data);
+
+	/// <summary>
+	/// Index of 'str', -1 if it's not in the table
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 int find(std::string_view str) const noexcept;
+
+	[[nodiscard]] std::string_view string(int index) const noexcept
+	{
+		auto& entry = Entries[index];
+		return { Arena.data() + entry.StringOffset, entry.StringLength };
+	}
+
+	// Null terminated
+	[[nodiscard]] const char* c_str(int index) const noexcept { return Arena.data() + Entries[index].StringOffset; }
+
+	[[nodiscard]] std::span<const uint8_t> user_data(int index) const noexcept
+	{
+		auto& entry = Entries[index];
+		return { reinterpret_cast<const uint8_t*>(Arena.data()) + entry.DataOffset, entry.DataLength };
+	}
+
+	[[nodiscard]] const std::string& name() const noexcept { return Name; }
+	[[nodiscard]] int size() const noexcept { return static_cast<int>(Entries.size()); }
+	[[nodiscard]] int max_entries() const noexcept { return MaxEntries; }
+	[[nodiscard]] int entry_bits() const noexcept { return EntryBits; }
+	[[nodiscard]] bool is_user_data_fixed_size() const noexcept { return UserDataFixedSize; }
+	[[nodiscard]] size_t arena_size() const noexcept { return Arena.size(); }
+
+	PX_SDK_TF2 void clear() noexcept;
+
+private:
+	struct entry_type
+	{
+		uint32_t	StringOffset;
+		uint32_t	StringLength;
+		uint32_t	DataOffset;
+		uint32_t	DataLength;
+		uint32_t	Hash;
+	};
+
+	[[nodiscard]] static uint32_t hash_string(std::string_view str) noexcept;
+
+	uint32_t append(const void* data, size_t size);
+	void insert_hash(int index);
+	void rehash(size_t num_buckets);
+	void compact();
+
+private:
+	std::string				Name;
+	int						MaxEntries;
+	int						EntryBits;
+	bool					UserDataFixedSize;
+	int						UserDataSize;
+	int						UserDataSizeBits;
+
+	std::vector<entry_type>	Entries;
+	// Open addressing with linear probing, entry index or -1, the size is a power of two at least twice the entries
+	std::vector<int32_t>	Buckets;
+	std::vector<char>		Arena;
+	// Bytes of the arena left behind by user data that was replaced with a larger one
+	size_t					Garbage{ };
+
+	std::vector<uint8_t>	Scratch;
+};
+
+
+/// <summary>
+/// String tables of a game in creation order, the order SVC_UpdateStringTable::TableID refers to
+/// </summary>
+class NetStringTableSet
+{
+public:
+	/// <summary>
+	/// Creates the table and applies its initial entries
+	/// </summary>
+	PX_SDK_TF2 Const::StringTableStatus create(const SVC_CreateStringTable& message);
+
+	PX_SDK_TF2 Const::StringTableStatus update(const SVC_UpdateStringTable& message);
+
+	PX_SDK_TF2 NetStringTable* create(
+		std::string_view name,
+		int max_entries,
+		bool user_data_fixed_size = false,
+		int user_data_size = 0,
+		int user_data_size_bits = 0
+	);
+
+	[[nodiscard]] NetStringTable* table(int id) noexcept
+	{
+		return id >= 0 && static_cast<size_t>(id) < Tables.size() ? Tables[id].get() : nullptr;
+	}
+
+	[[nodiscard]] const NetStringTable* table(int id) const noexcept
+	{
+		return id >= 0 && static_cast<size_t>(id) < Tables.size() ? Tables[id].get() : nullptr;
+	}
+
+	[[nodiscard]] PX_SDK_TF2 NetStringTable* find_table(std::string_view name) noexcept;
+
+	[[nodiscard]] size_t size() const noexcept { return Tables.size(); }
+	void clear() noexcept { Tables.clear(); }
+
+private:
+	std::vector<std::unique_ptr<NetStringTable>>	Tables;
+	// Compressed payload and its decompressed data
+	std::vector<uint8_t>							Scratch;
+	std::vector<uint8_t>							Decompressed;
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <tf2/engine/NetMessages.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	static constexpr size_t UserMsg_Max = 256;
+	// SayText2 and TextMsg always carry 4 parameters, empty when unused
+	static constexpr size_t UserMsg_NumParams = 4;
+	static constexpr int UserMsg_MaxStringLength = 2048;
+	// TFSTAT_MAX - TFSTAT_FIRST, a stat is sent if its bit is set
+	static constexpr size_t UserMsg_MaxPlayerStats = 32;
+}
+
+
+/// <summary>
+/// Decoded payload of a SVC_UserMessage, see UserMessageRegistry
+/// </summary>
+class IUserMessage
+{
+public:
+	virtual ~IUserMessage() = default;
+
+	virtual Const::UserMsg GetType() const abstract;
+	virtual bool ReadFromBuffer(utils::bf_read& buffer) abstract;
+};
+
+#define DECLARE_USER_MESSAGE(name)																\
+	static constexpr Const::UserMsg Type = Const::UserMsg::name;								\
+	Const::UserMsg GetType() const override { return Type; }									\
+	PX_SDK_TF2 bool ReadFromBuffer(utils::bf_read& buffer) override
+
+
+class UserMsg_SayText : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(SayText);
+
+	int			Client{ };
+	std::string	Text;
+	bool		WantsToChat{ };
+};
+
+class UserMsg_SayText2 : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(SayText2);
+
+	int			Client{ };
+	bool		WantsToChat{ };
+	// Localization token, eg: "#TF_Chat_All"
+	std::string	Message;
+	std::string	Params[Const::UserMsg_NumParams];
+};
+
+class UserMsg_TextMsg : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(TextMsg);
+
+	// HUD_PRINTNOTIFY, HUD_PRINTCONSOLE, HUD_PRINTTALK or HUD_PRINTCENTER
+	int			Destination{ };
+	std::string	Message;
+	std::string	Params[Const::UserMsg_NumParams];
+};
+
+class UserMsg_HudText : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(HudText);
+
+	std::string	Text;
+};
+
+class UserMsg_HintText : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(HintText);
+
+	std::string	Text;
+};
+
+class UserMsg_HudMsg : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(HudMsg);
+
+	int			Channel{ };
+	float		X{ }, Y{ };
+	uint8_t		Color1[4]{ };
+	uint8_t		Color2[4]{ };
+	int			Effect{ };
+	float		FadeIn{ }, FadeOut{ }, HoldTime{ }, FxTime{ };
+	std::string	Text;
+};
+
+class UserMsg_Shake : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(Shake);
+
+	// ShakeCommand_t
+	int			Command{ };
+	float		Amplitude{ };
+	float		Frequency{ };
+	float		Duration{ };
+};
+
+class UserMsg_Fade : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(Fade);
+
+	// Fixed point, 1 << SCREENFADE_FRACBITS (9) units per second
+	uint16_t	Duration{ };
+	uint16_t	HoldTime{ };
+	// FFADE_* flags
+	uint16_t	Flags{ };
+	uint8_t		Color[4]{ };
+};
+
+class UserMsg_VoteStart : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(VoteStart);
+
+	// -1 if every team votes
+	int			Team{ };
+	int			VoteIndex{ };
+	int			Caller{ };
+	std::string	Issue;
+	std::string	Details;
+	bool		IsYesNo{ };
+	int			Target{ };
+};
+
+class UserMsg_VotePass : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(VotePass);
+
+	int			Team{ };
+	int			VoteIndex{ };
+	std::string	Issue;
+	std::string	Details;
+};
+
+class UserMsg_VoteFailed : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(VoteFailed);
+
+	int			Team{ };
+	int			VoteIndex{ };
+	// vote_create_failed_t
+	int			Reason{ };
+};
+
+class UserMsg_CallVoteFailed : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(CallVoteFailed);
+
+	int			Reason{ };
+	// Seconds before the caller can vote again
+	int			Time{ };
+};
+
+class UserMsg_PlayerStatsUpdate : public IUserMessage
+{
+public:
+	DECLARE_USER_MESSAGE(PlayerStatsUpdate);
+
+	[[nodiscard]] bool has_stat(size_t stat) const noexcept { return stat >= 1 && stat <= Const::UserMsg_MaxPlayerStats && (SentStats >> (stat - 1)) & 1; }
+	// 'stat' is a TFStatType_t, 0 if it wasn't sent
+	[[nodiscard]] int stat(size_t stat) const noexcept { return has_stat(stat) ? Stats[stat - 1] : 0; }
+
+	int			Class{ };
+	// STATMSG_*, eg: STATMSG_UPDATE or STATMSG_PLAYERDEATH
+	int			MsgType{ };
+	// Bit 'i' is set if Stats[i] was sent
+	uint32_t	SentStats{ };
+	int32_t		Stats[Const::UserMsg_MaxPlayerStats]{ };
+};
+
+#undef DECLARE_USER_MESSAGE
+
+
+/// <summary>
+/// Typed decoders of the user messages, a single instance of each type is kept and reused by every decode.
+/// Each decode bumps the generation of its type, views use it to tell whether the instance still holds their message.
+/// Types without a decoder are still readable as raw bits through UserMessageView::payload()
+/// </summary>
+class UserMessageRegistry
+{
+public:
+	/// <summary>
+	/// Registers every user message the SDK can decode
+	/// </summary>
+	PX_SDK_TF2 UserMessageRegistry();
+
+	UserMessageRegistry(const UserMessageRegistry&) = delete;
+	UserMessageRegistry& operator=(const UserMessageRegistry&) = delete;
+
+	/// <summary>
+	/// Registers or replaces the decoder of _MsgTy::Type
+	/// </summary>
+	template<typename _MsgTy>
+	void register_message()
+	{
+		Messages[static_cast<size_t>(_MsgTy::Type)] = std::make_unique<_MsgTy>();
+	}
+
+	[[nodiscard]] bool is_registered(Const::UserMsg type) const noexcept
+	{
+		return static_cast<size_t>(type) < Messages.size() && Messages[static_cast<size_t>(type)] != nullptr;
+	}
+
+	/// <summary>
+	/// Decodes 'payload' with the decoder of 'type', returns nullptr if there's none or if the payload is too short.
+	/// The message is overwritten by the next decode of the same type
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 IUserMessage* decode(Const::UserMsg type, utils::bf_read& payload);
+
+	// Number of decodes of 'type', 'type' must be registered
+	[[nodiscard]] uint32_t generation(Const::UserMsg type) const noexcept
+	{
+		return Generations[static_cast<size_t>(type)];
+	}
+
+private:
+	std::array<std::unique_ptr<IUserMessage>, Const::UserMsg_Max>	Messages;
+	std::array<uint32_t, Const::UserMsg_Max>						Generations{ };
+};
+
+
+/// <summary>
+/// Lazily decoded SVC_UserMessage: the type and length are read from the message itself,
+/// the payload is only decoded on the first call to get() or as().
+/// The view must not outlive the message nor the registry
+/// </summary>
+class UserMessageView
+{
+public:
+	UserMessageView(UserMessageRegistry& registry, const SVC_UserMessage& message) noexcept :
+		Registry(&registry), Message(&message)
+	{ }
+
+	[[nodiscard]] Const::UserMsg type() const noexcept { return static_cast<Const::UserMsg>(Message->MsgType); }
+	// Size of the payload in bits
+	[[nodiscard]] int length() const noexcept { return Message->Length; }
+	[[nodiscard]] bool is_known() const noexcept { return Registry->is_registered(type()); }
+
+	/// <summary>
+	/// Raw payload, limited to the message's data
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 utils::bf_read payload() const;
+
+	/// <summary>
+	/// Decodes the payload on the first call, returns nullptr if the type has no decoder or if decoding failed.
+	/// The decoded message is shared with every other view of the same type, see UserMessageRegistry::decode:
+	/// the payload is decoded again if another view decoded the same type since, a pointer returned earlier
+	/// then holds the other view's message
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 IUserMessage* get();
+
+	/// <summary>
+	/// Decoded message if it's a _MsgTy, nullptr otherwise
+	/// </summary>
+	template<typename _MsgTy>
+	[[nodiscard]] _MsgTy* as()
+	{
+		if (type() != _MsgTy::Type)
+			return nullptr;
+		return static_cast<_MsgTy*>(get());
+	}
+
+private:
+	UserMessageRegistry*	Registry;
+	const SVC_UserMessage*	Message;
+	IUserMessage*			Decoded{ };
+	// Registry generation of the type when Decoded was read
+	uint32_t				Generation{ };
+	bool					IsDecoded{ };
+};
+
+TF2_NAMESPACE_END();
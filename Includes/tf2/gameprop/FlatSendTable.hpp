@@ -0,0 +1,237 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <tf2/utils/bitbuf.hpp>
+#include "SendProp.hpp"
+
+TF2_NAMESPACE_BEGIN();
+
+namespace Const
+{
+	// Widths of the SendTable descriptions sent by the server
+	static constexpr int SendTable_NumPropsBits = 10;
+	static constexpr int SendTable_PropTypeBits = 5;
+	static constexpr int SendTable_PropFlagsBits = 16;
+	static constexpr int SendTable_NumElementsBits = 10;
+	static constexpr int SendTable_NumBitsBits = 7;
+	static constexpr int SendTable_MaxProps = 1 << 12;
+
+	// Length prefix of a string prop's value
+	static constexpr int SendTable_StringBits = 9;
+
+	enum class FlatPropKind : uint8_t
+	{
+		UInt,
+		SInt,
+		UVarInt,
+		SVarInt,
+		Float,
+		Vector,
+		// x and y are floats, z is rebuilt from a sign bit
+		VectorNormal,
+		VectorXY,
+		String,
+		Array
+	};
+
+	enum class FlatFloatKind : uint8_t
+	{
+		// Bits wide integer mapped to [LowValue, HighValue]
+		Scaled,
+		Coord,
+		CoordMP,
+		CoordMP_LP,
+		CoordMP_INT,
+		NoScale,
+		Normal
+	};
+}
+
+
+/// <summary>
+/// Networked description of a SendProp, read from a demo's data tables or copied from the server's SendProps
+/// </summary>
+struct SendPropInfo
+{
+	std::string		Name;
+	// Child table of a PropType::DataTable, table of the excluded prop for PropFlags::Exclude
+	std::string		DataTableName;
+	Const::PropType	Type{ };
+	uint32_t		Flags{ };
+	int				Bits{ };
+	int				NumElements{ };
+	float			LowValue{ };
+	float			HighValue{ };
+	// Index of a PropType::Array's element in the same table, -1 otherwise
+	int				ArrayElement{ -1 };
+};
+
+struct SendTableInfo
+{
+	std::string					Name;
+	bool						NeedsDecoder{ };
+	std::vector<SendPropInfo>	Props;
+};
+
+struct ServerClassInfo
+{
+	int			ClassID{ -1 };
+	std::string	Name;
+	std::string	TableName;
+};
+
+
+/// <summary>
+/// How a single value is read, every flag test is resolved when the table is flattened
+/// </summary>
+struct FlatPropCodec
+{
+	Const::FlatPropKind		Kind{ };
+	Const::FlatFloatKind	FloatKind{ };
+	uint8_t					Bits{ };
+	float					LowValue{ };
+	float					HighValue{ };
+	// (1 << Bits) - 1, divisor of Const::FlatFloatKind::Scaled
+	float					Range{ };
+};
+
+struct FlatSendProp
+{
+	FlatPropCodec			Codec;
+
+	// Const::FlatPropKind::Array only, the element count is read on CountBits bits
+	FlatPropCodec			Element;
+	uint8_t					CountBits{ };
+	uint16_t				MaxElements{ };
+
+	// Index in FlatEntityState::Strings or FlatEntityState::Arrays, unused for the other kinds
+	uint32_t				Slot{ };
+
+	const SendPropInfo*		Prop{ };
+	// Table that declared the prop
+	const SendTableInfo*	Table{ };
+};
+
+
+union FlatPropValue
+{
+	int		Int;
+	float	Float;
+	float	Vector[3];
+};
+
+/// <summary>
+/// Decoded props of an entity, Values is indexed by the flat prop index.
+/// Copy it to start from a baseline
+/// </summary>
+struct FlatEntityState
+{
+	std::vector<FlatPropValue>				Values;
+	std::vector<std::string>				Strings;
+	// String elements of an array are skipped, their value reads as zero
+	std::vector<std::vector<FlatPropValue>>	Arrays;
+};
+
+
+/// <summary>
+/// Server class with its SendTables flattened into a linear list of prop decoders.
+/// Excludes, collapsible data tables and arrays are resolved once and the props that change often come first,
+/// a delta is then a loop over field index deltas
+/// </summary>
+class FlatSendTable
+{
+	friend class FlatSendTableSet;
+
+public:
+	[[nodiscard]] bool is_valid() const noexcept { return Class.ClassID != -1; }
+	[[nodiscard]] const ServerClassInfo& server_class() const noexcept { return Class; }
+	[[nodiscard]] std::span<const FlatSendProp> props() const noexcept { return Props; }
+
+	/// <summary>
+	/// Index of the first flat prop named 'name', optionally declared by 'table', -1 if there is none
+	/// </summary>
+	[[nodiscard]] PX_SDK_TF2 int find_prop(std::string_view name, std::string_view table = { }) const noexcept;
+
+	/// <summary>
+	/// Sizes 'state' for this class, every value is zeroed
+	/// </summary>
+	PX_SDK_TF2 void init_state(FlatEntityState& state) const;
+
+	/// <summary>
+	/// Reads the props of a delta into 'state', the indices of the props read are appended to 'changed' if it's not null.
+	/// Returns false on a bad prop index or if the buffer overflows
+	/// </summary>
+	PX_SDK_TF2 bool read_delta(utils::bf_read& buffer, FlatEntityState& state, std::vector<uint16_t>* changed = nullptr) const;
+	PX_SDK_TF2 bool read_delta(utils::bf_read_buffered& buffer, FlatEntityState& state, std::vector<uint16_t>* changed = nullptr) const;
+
+private:
+	ServerClassInfo				Class;
+	std::vector<FlatSendProp>	Props;
+	uint32_t					NumStrings{ };
+	uint32_t					NumArrays{ };
+};
+
+
+/// <summary>
+/// SendTables and server classes of a game, either read from the network or copied from the server's ServerClass list.
+/// flatten() must be called again once tables or classes are added
+/// </summary>
+class FlatSendTableSet
+{
+public:
+	/// <summary>
+	/// Reads the payload of a dem_datatables frame, the SendTables followed by the server classes
+	/// </summary>
+	PX_SDK_TF2 bool read_datatables(utils::bf_read& buffer);
+
+	/// <summary>
+	/// Reads a single SendTable, the format of SVC_SendTable::DataIn
+	/// </summary>
+	PX_SDK_TF2 bool read_send_table(utils::bf_read& buffer, bool needs_decoder);
+
+	/// <summary>
+	/// Copies the SendTables of every class of the list, see IServerGameDLL::GetAllServerClasses
+	/// </summary>
+	PX_SDK_TF2 void add_server_classes(const ServerClass* classes);
+
+	PX_SDK_TF2 void add_class(int class_id, std::string_view name, std::string_view table_name);
+
+	/// <summary>
+	/// Flattens every class, returns false if a class or a data table references a table that doesn't exist
+	/// </summary>
+	PX_SDK_TF2 bool flatten();
+
+	PX_SDK_TF2 void clear() noexcept;
+
+	[[nodiscard]] PX_SDK_TF2 const SendTableInfo* find_table(std::string_view name) const noexcept;
+
+	[[nodiscard]] const FlatSendTable* find_class(int class_id) const noexcept
+	{
+		if (class_id < 0 || static_cast<size_t>(class_id) >= Flat.size() || !Flat[class_id].is_valid())
+			return nullptr;
+		return &Flat[class_id];
+	}
+
+	[[nodiscard]] std::span<const ServerClassInfo> classes() const noexcept { return Classes; }
+	[[nodiscard]] size_t num_tables() const noexcept { return Tables.size(); }
+
+private:
+	SendTableInfo* add_table(std::string_view name);
+	const SendTableInfo* copy_send_table(const SendTable* table);
+
+	bool flatten_class(const ServerClassInfo& server_class, FlatSendTable& flat) const;
+
+private:
+	std::vector<std::unique_ptr<SendTableInfo>>					Tables;
+	std::unordered_map<std::string_view, const SendTableInfo*>	TableIndex;
+	std::vector<ServerClassInfo>								Classes;
+	// Indexed by class id
+	std::vector<FlatSendTable>									Flat;
+};
+
+TF2_NAMESPACE_END();
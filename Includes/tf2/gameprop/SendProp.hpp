@@ -156,7 +156,7 @@ private:
 struct ServerClass
 {
 	const char* const NetworkName;
-	SendTable* SendTable;
+	tf2::SendTable* SendTable;
 
 	ServerClass* const NextClass;
 	const Const::EntClassID ClassID;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <bit>
 #include <array>
 #include <cmath>
 
@@ -303,7 +304,7 @@ public:
 
 public:
 #define VECTORXD_IMPL_MATH_OP(SYMBOL)														\
-	constexpr VectorXD& operator##SYMBOL##=(const VectorXD& other) noexcept					\
+	constexpr VectorXD& operator SYMBOL##=(const VectorXD& other) noexcept					\
 	{																						\
 		auto meit = begin();																\
 		for (auto oit = other.begin(); meit != end(); meit++, oit++)						\
@@ -313,7 +314,7 @@ public:
 		return *this;																		\
 	}																						\
 	template<typename _VTy>																	\
-	constexpr VectorXD& operator##SYMBOL##=(_VTy other) noexcept							\
+	constexpr VectorXD& operator SYMBOL##=(_VTy other) noexcept							\
 	{																						\
 		for (reference v : m_Data)															\
 		{																					\
@@ -321,7 +322,7 @@ public:
 		}																					\
 		return *this;																		\
 	}																						\
-	[[nodiscard]] constexpr VectorXD operator##SYMBOL(const VectorXD& other) const noexcept	\
+	[[nodiscard]] constexpr VectorXD operator SYMBOL(const VectorXD& other) const noexcept	\
 	{																						\
 		VectorXD res{ };																	\
 		auto rit = res.begin();																\
@@ -336,7 +337,7 @@ public:
 		return res;																			\
 	}																						\
 	template<typename _VTy>																	\
-	[[nodiscard]] constexpr VectorXD operator##SYMBOL(_VTy other) const noexcept			\
+	[[nodiscard]] constexpr VectorXD operator SYMBOL(_VTy other) const noexcept			\
 	{																						\
 		VectorXD res{ };																	\
 		auto rit = res.begin();																\
@@ -412,7 +413,8 @@ private:
 };
 
 template<typename _Ty, typename... _Rest>
-VectorXD(_Ty, _Rest...) -> VectorXD<typename std::_Enforce_same<_Ty, _Rest...>::type, 1 + sizeof ...(_Rest)>;
+	requires (std::is_same_v<_Ty, _Rest> && ...)
+VectorXD(_Ty, _Rest...) -> VectorXD<_Ty, 1 + sizeof ...(_Rest)>;
 
 using Vector2D_I = VectorXD<int, 2>;
 using Vector3D_I = VectorXD<int, 3>;
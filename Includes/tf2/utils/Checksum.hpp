@@ -10,6 +10,11 @@ using CRC32_t = uint32_t;
 PX_SDK_TF2 void CRC32_Init(CRC32_t*);
 PX_SDK_TF2 void CRC32_ProcessBuffer(CRC32_t*, const void* p, int len);
 PX_SDK_TF2 void CRC32_Final(CRC32_t*);
+PX_SDK_TF2 CRC32_t CRC32_GetTableEntry(size_t slot);
+
+// CRC of two buffers put back to back from their final CRCs, 'len2' is the size of the second buffer.
+// Lets parts of a buffer be hashed in parallel
+PX_SDK_TF2 CRC32_t CRC32_Combine(CRC32_t crc1, CRC32_t crc2, uint64_t len2);
 
 inline CRC32_t CRC32_ProcessSingleBuffer(const void* p, int len)
 {
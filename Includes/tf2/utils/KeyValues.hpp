@@ -244,4 +244,30 @@ inline bool  KeyValues::IsEmpty(int keySymbol) const noexcept
 	return dat ? dat->IsEmpty() : true;
 }
 
+
+// Inline so the offline tools can destroy net messages holding KeyValues without the game's symbol table
+inline KeyValues::~KeyValues()
+{
+	KeyValues* dat;
+	KeyValues* datNext = NULL;
+	for (dat = SubKV; dat; dat = datNext)
+	{
+		datNext = dat->PeerKV;
+		dat->PeerKV = nullptr;
+		delete dat;
+	}
+
+	for (dat = PeerKV; dat && dat != this; dat = datNext)
+	{
+		datNext = dat->PeerKV;
+		dat->PeerKV = nullptr;
+		delete dat;
+	}
+
+	delete[] StringValue;
+	StringValue = NULL;
+	delete[] WStringValue;
+	WStringValue = NULL;
+}
+
 TF2_NAMESPACE_END();
\ No newline at end of file
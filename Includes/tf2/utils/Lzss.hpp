@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory_resource>
+#include <span>
+#include <vector>
+#include <tf2/config.hpp>
+
+TF2_NAMESPACE_BEGIN(::utils);
+
+namespace Const
+{
+	// "LZSS" followed by the little endian size of the uncompressed data
+	static constexpr uint32_t LZSS_Id = 'L' | ('Z' << 8) | ('S' << 16) | ('S' << 24);
+	static constexpr size_t LZSS_HeaderSize = 8;
+
+	// A back-reference is a 12 bits distance and a 4 bits length
+	static constexpr int LZSS_LookShift = 4;
+	static constexpr size_t LZSS_WindowSize = 1 << 12;
+	static constexpr size_t LZSS_MaxMatch = 1 << LZSS_LookShift;
+	static constexpr size_t LZSS_MinMatch = 3;
+}
+
+/// <summary>
+/// Size of the uncompressed data of an LZSS buffer, 0 if 'data' doesn't start with an LZSS header
+/// </summary>
+[[nodiscard]] PX_SDK_TF2 uint32_t LZSS_GetActualSize(const void* data, size_t size) noexcept;
+
+[[nodiscard]] inline bool LZSS_IsCompressed(const void* data, size_t size) noexcept
+{
+	return LZSS_GetActualSize(data, size) != 0;
+}
+
+/// <summary>
+/// Decompresses an LZSS buffer, header included, into 'output'.
+/// Returns the size of the uncompressed data, 0 if the header is invalid, if 'output' is too small
+/// or if the stream is truncated, references data before its start or doesn't match the header's size
+/// </summary>
+[[nodiscard]] PX_SDK_TF2 size_t LZSS_Decompress(const void* input, size_t input_size, void* output, size_t output_size) noexcept;
+
+/// <summary>
+/// Same as LZSS_Decompress, the output is allocated from 'resource', eg: a monotonic arena.
+/// Returns an empty span on failure
+/// </summary>
+[[nodiscard]] PX_SDK_TF2 std::span<uint8_t> LZSS_Decompress(const void* input, size_t input_size, std::pmr::memory_resource* resource);
+
+[[nodiscard]] inline bool LZSS_Decompress(std::span<const uint8_t> input, std::vector<uint8_t>& output)
+{
+	output.resize(LZSS_GetActualSize(input.data(), input.size()));
+	return !output.empty() && LZSS_Decompress(input.data(), input.size(), output.data(), output.size()) == output.size();
+}
+
+/// <summary>
+/// Largest output of LZSS_Compress for 'size' bytes of input: a command byte per 8 literals, the header and the end marker
+/// </summary>
+[[nodiscard]] constexpr size_t LZSS_CompressBound(size_t size) noexcept
+{
+	return Const::LZSS_HeaderSize + size + (size + 1 + 7) / 8 + 2;
+}
+
+/// <summary>
+/// Compresses 'input' with the engine's LZSS format, header included.
+/// Returns the size of the compressed data, 0 if 'output' is too small, LZSS_CompressBound(input_size) always fits.
+/// Unlike the engine, data that doesn't shrink is still compressed, the caller decides to keep it or not
+/// </summary>
+[[nodiscard]] PX_SDK_TF2 size_t LZSS_Compress(const void* input, size_t input_size, void* output, size_t output_size) noexcept;
+
+[[nodiscard]] inline bool LZSS_Compress(std::span<const uint8_t> input, std::vector<uint8_t>& output)
+{
+	output.resize(LZSS_CompressBound(input.size()));
+	output.resize(LZSS_Compress(input.data(), input.size(), output.data(), output.size()));
+	return !output.empty();
+}
+
+TF2_NAMESPACE_END();
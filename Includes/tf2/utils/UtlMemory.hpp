@@ -40,7 +40,7 @@ public:
 	class iterator_t
 	{
 	public:
-		iterator_t(_IterTy _IterTy) : index(_IterTy) { }
+		iterator_t(_IterTy i) : index(i) { }
 		_IterTy index;
 
 		bool operator==(const iterator_t it) const { return index == it.index; }
@@ -49,18 +49,18 @@ public:
 	[[nodiscard]] iterator_t first() const { return iterator_t(is_valid_index(0) ? 0 : invalid_index()); }
 	[[nodiscard]] iterator_t next(const iterator_t& it) const { return iterator_t(is_valid_index(it.index + 1) ? it.index + 1 : invalid_index()); }
 	[[nodiscard]] _IterTy get_index(const iterator_t& it) const { return it.index; }
-	[[nodiscard]] bool is_index_after(_IterTy _IterTy, const iterator_t& it) const { return _IterTy > it.index; }
+	[[nodiscard]] bool is_index_after(_IterTy i, const iterator_t& it) const { return i > it.index; }
 	[[nodiscard]] bool is_valid_iterator(const iterator_t& it) const { return is_valid_index(it.index); }
 	[[nodiscard]] iterator_t invalid_iterator() const { return iterator_t(invalid_index()); }
 
 	// element access
-	[[nodiscard]] reference operator[](_IterTy _IterTy);
-	[[nodiscard]] const_reference operator[](_IterTy _IterTy) const;
-	[[nodiscard]] reference at(_IterTy _IterTy);
-	[[nodiscard]] const_reference at(_IterTy _IterTy) const;
+	[[nodiscard]] reference operator[](_IterTy i);
+	[[nodiscard]] const_reference operator[](_IterTy i) const;
+	[[nodiscard]] reference at(_IterTy i);
+	[[nodiscard]] const_reference at(_IterTy i) const;
 
 	// Can we use this index?
-	[[nodiscard]] bool is_valid_index(_IterTy _IterTy) const;
+	[[nodiscard]] bool is_valid_index(_IterTy i) const;
 
 	// Specify the invalid ('null') index that we'll only return on failure
 	[[nodiscard]] static _IterTy invalid_index() { return static_cast<_IterTy>(-1); }
@@ -378,27 +378,27 @@ void UtlMemory<_Ty, _IterTy>::take_ownership(pointer pMemory, uint32_t numElemen
 // element access
 //-----------------------------------------------------------------------------
 template<class _Ty, class _IterTy>
-inline UtlMemory<_Ty, _IterTy>::reference UtlMemory<_Ty, _IterTy>::operator[](_IterTy _IterTy)
+inline UtlMemory<_Ty, _IterTy>::reference UtlMemory<_Ty, _IterTy>::operator[](_IterTy i)
 {
-	return m_Memory[_IterTy];
+	return m_Memory[i];
 }
 
 template<class _Ty, class _IterTy>
-inline UtlMemory<_Ty, _IterTy>::const_reference UtlMemory<_Ty, _IterTy>::operator[](_IterTy _IterTy) const
+inline UtlMemory<_Ty, _IterTy>::const_reference UtlMemory<_Ty, _IterTy>::operator[](_IterTy i) const
 {
-	return m_Memory[_IterTy];
+	return m_Memory[i];
 }
 
 template<class _Ty, class _IterTy>
-inline UtlMemory<_Ty, _IterTy>::reference UtlMemory<_Ty, _IterTy>::at(_IterTy _IterTy)
+inline UtlMemory<_Ty, _IterTy>::reference UtlMemory<_Ty, _IterTy>::at(_IterTy i)
 {
-	return m_Memory[_IterTy];
+	return m_Memory[i];
 }
 
 template<class _Ty, class _IterTy>
-inline UtlMemory<_Ty, _IterTy>::const_reference UtlMemory<_Ty, _IterTy>::at(_IterTy _IterTy) const
+inline UtlMemory<_Ty, _IterTy>::const_reference UtlMemory<_Ty, _IterTy>::at(_IterTy i) const
 {
-	return m_Memory[_IterTy];
+	return m_Memory[i];
 }
 
 
@@ -459,12 +459,12 @@ inline uint32_t UtlMemory<_Ty, _IterTy>::capacity() const
 // Is element index valid?
 //-----------------------------------------------------------------------------
 template<class _Ty, class _IterTy>
-inline bool UtlMemory<_Ty, _IterTy>::is_valid_index(_IterTy _IterTy) const
+inline bool UtlMemory<_Ty, _IterTy>::is_valid_index(_IterTy i) const
 {
-	// If we always cast '_IterTy' and 'm_AllocationCount' to unsigned then we can
+	// If we always cast 'i' and 'm_AllocationCount' to unsigned then we can
 	// do our range checking with a single comparison instead of two. This gives
 	// a modest speedup in debug builds.
-	return static_cast<uint32_t>(_IterTy) < m_AllocationCount;
+	return static_cast<uint32_t>(i) < m_AllocationCount;
 }
 
 template<class _Ty, class _IterTy>
@@ -683,7 +683,7 @@ template<typename _Ty, class _AllocTy>
 void UtlVector<_Ty, _AllocTy>::erase_multiple(uint32_t elem, uint32_t num)
 {
 	// Global scope to resolve conflict with Scaleform 4.0
-	for (uint32_t i = elem + num; --i >= elem; )
+	for (uint32_t i = elem + num; i-- > elem; )
 		VAlloc::Destruct(&at(i));
 
 	shift_to_left(elem, num);
@@ -694,7 +694,7 @@ template<typename _Ty, class _AllocTy>
 void UtlVector<_Ty, _AllocTy>::erase_from_head_multiple(uint32_t num)
 {
 	// Global scope to resolve conflict with Scaleform 4.0
-	for (uint32_t i = num; --i >= 0; )
+	for (uint32_t i = num; i-- > 0; )
 		VAlloc::Destruct(&at(i));
 
 	shift_to_left(0, num);
@@ -714,7 +714,7 @@ void UtlVector<_Ty, _AllocTy>::erase_from_tail_multiple(uint32_t num)
 template<typename _Ty, class _AllocTy>
 void UtlVector<_Ty, _AllocTy>::clear()
 {
-	for (uint32_t i = m_Size; --i >= 0; )
+	for (uint32_t i = m_Size; i-- > 0; )
 	{
 		// Global scope to resolve conflict with Scaleform 4.0
 		VAlloc::Destruct(&at(i));
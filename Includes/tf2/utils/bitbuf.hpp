@@ -1,6 +1,8 @@
 #pragma once
 
 #include <tf2/config.hpp>
+#include <cstring>
+#include <px/bitbuf.hpp>
 
 TF2_NAMESPACE_BEGIN(::utils);
 
@@ -63,9 +65,26 @@ public:
 		write_angle(float fAngle, int numbits);
 	PX_SDK_TF2 void
 		write_coord(const float f);
+	// Multiplayer coord, see PropFlags::CoordMP
+	PX_SDK_TF2 void
+		write_coord_mp(const float f, bool integral, bool low_precision);
+	// Component of a unit vector, sign and 11 bits fraction
+	PX_SDK_TF2 void
+		write_normal(const float f);
+	// 4, 8, 12 or 32 bits integer prefixed by its 2 bits width
+	PX_SDK_TF2 void
+		write_ubit_var(uint32_t data);
 	PX_SDK_TF2 void
 		write_vec3(const float fa[3]);
 
+	// Writes 'count' consecutive values, the whole run is checked for overflow once
+	PX_SDK_TF2 void
+		write_ubit_array(const uint32_t* in, int count, int numbits);
+	PX_SDK_TF2 void
+		write_coord_array(const float* in, int count);
+	PX_SDK_TF2 void
+		write_vec3_array(const float (*in)[3], int count);
+
 	// Byte functions.
 public:
 
@@ -116,7 +135,7 @@ public:
 	void mark_as_overflowed() noexcept { IsOverflow = true; }
 
 private:
-	unsigned long*	Data{ };
+	uint32_t*		Data{ };
 	int				DataBytes{ };
 	int				DataBits{ -1 };
 
@@ -132,12 +151,15 @@ private:
 class bf_read
 {
 public:
+	// Largest lookahead of peek_bits, served by a single 8 bytes load
+	static constexpr int max_peek_bits = 57;
+
 	bf_read() = default;
 
 	// nMaxBits can be used as the number of bits in the buffer. 
 	// It must be <= nBytes*8. If you leave it at -1, then it's set to nBytes * 8.
-	bf_read(const void* pData, int nBytes, int nBits = -1) noexcept { start_reading(pData, nBytes, nBits); }
-	bf_read(const char* pDebugName, const void* pData, int nBytes, int nBits = -1) noexcept : DebugName(pDebugName) { start_reading(pData, nBytes, nBits); }
+	bf_read(const void* pData, int nBytes, int nBits = -1) noexcept { start_reading(pData, nBytes, 0, nBits); }
+	bf_read(const char* pDebugName, const void* pData, int nBytes, int nBits = -1) noexcept : DebugName(pDebugName) { start_reading(pData, nBytes, 0, nBits); }
 
 	// Start reading from the specified buffer.
 	// pData's start address must be dword-aligned.
@@ -154,7 +176,7 @@ public:
 
 	bool seek(int bitPos) 
 	{ 
-		if (bitPos < 0 || bitPos >= DataBits)
+		if (bitPos < 0 || bitPos > DataBits)
 			return false;
 		CurBit = bitPos;
 		return true;
@@ -175,8 +197,10 @@ public:
 	[[nodiscard]] PX_SDK_TF2 float
 		read_angle(int numbits);
 
-	[[nodiscard]] PX_SDK_TF2 uint32_t
-		peek_ubit(int numbits);
+	// Returns the next numbits (<= max_peek_bits) bits without consuming them, bits past the end read as zeros
+	[[nodiscard]] PX_SDK_TF2 uint64_t
+		peek_bits(int numbits) const;
+	[[nodiscard]] uint32_t peek_ubit(int numbits) const { return static_cast<uint32_t>(peek_bits(numbits)); }
 	[[nodiscard]] PX_SDK_TF2 uint32_t
 		read_ubit(int numbits);
 	[[nodiscard]] PX_SDK_TF2 int
@@ -194,14 +218,31 @@ public:
 
 	[[nodiscard]] PX_SDK_TF2 float
 		read_coord();
+	// Multiplayer coord, see PropFlags::CoordMP
+	[[nodiscard]] PX_SDK_TF2 float
+		read_coord_mp(bool integral, bool low_precision);
+	// Component of a unit vector, sign and 11 bits fraction
+	[[nodiscard]] PX_SDK_TF2 float
+		read_normal();
+	// 4, 8, 12 or 32 bits integer prefixed by its 2 bits width
+	[[nodiscard]] PX_SDK_TF2 uint32_t
+		read_ubit_var();
 	[[nodiscard]] PX_SDK_TF2 void
 		read_vec3(float fa[3]);
 
+	// Reads 'count' consecutive values, fields of up to 32 bits for read_ubit_array
+	PX_SDK_TF2 void
+		read_ubit_array(uint32_t* out, int count, int numbits);
+	PX_SDK_TF2 void
+		read_coord_array(float* out, int count);
+	PX_SDK_TF2 void
+		read_vec3_array(float (*out)[3], int count);
+
 	// Byte functions (these still read data in bit-by-bit).
 public:
 
 	inline int8_t	read_char() { return static_cast<int8_t>(read_ubit(8)); }
-	inline uint8_t	read_byte() { return static_cast<uint8_t>(read_ubit(16)); }
+	inline uint8_t	read_byte() { return static_cast<uint8_t>(read_ubit(8)); }
 	inline int16_t	read_short() { return static_cast<int16_t>(read_ubit(16)); }
 	inline uint16_t read_word() { return static_cast<uint16_t>(read_ubit(16)); }
 	inline int32_t	read_long() { return static_cast<int32_t>(read_ubit(32)); }
@@ -255,14 +296,450 @@ public:
 	void mark_as_overflowed() noexcept { IsOverflow = true; }
 
 private:
-	const uint8_t*	Data;
-	int				DataBytes;
-	int				DataBits;
-
-	int				CurBit;
-	bool			IsOverflow;
-	bool			AssertOnOverflow;
-	const char*		DebugName;
+	const uint8_t*	Data{ };
+	int				DataBytes{ };
+	int				DataBits{ };
+
+	int				CurBit{ };
+	bool			IsOverflow{ };
+	bool			AssertOnOverflow{ };
+	const char*		DebugName{ };
 };
 
+
+//-----------------------------------------------------------------------------
+// Same interface as bf_read, but keeps up to 64 bits of the stream in a register.
+// The accumulator is refilled with a single unaligned 8 bytes load, so the hot path of read_ubit
+// is a mask and a shift with no per-call word addressing. Prefer it for long sequential decodes
+// (entities, string tables, demos), bf_read remains cheaper for a handful of reads.
+//-----------------------------------------------------------------------------
+class bf_read_buffered
+{
+public:
+	// Largest read that is guaranteed to be served by a single refill
+	static constexpr int max_read_bits = 56;
+
+	bf_read_buffered() = default;
+
+	bf_read_buffered(const void* pData, int nBytes, int nBits = -1) noexcept { start_reading(pData, nBytes, 0, nBits); }
+	bf_read_buffered(const char* pDebugName, const void* pData, int nBytes, int nBits = -1) noexcept : DebugName(pDebugName) { start_reading(pData, nBytes, 0, nBits); }
+
+	// Start reading from the specified buffer, pData has no alignment requirement.
+	// nMaxBits can be used as the number of bits in the buffer. 
+	// It must be <= nBytes*8. If you leave it at -1, then it's set to nBytes * 8.
+	PX_SDK_TF2 void start_reading(const void* pData, int nBytes, int iStartBit = 0, int nBits = -1);
+
+	void reset() noexcept { IsOverflow = false; seek(0); }
+
+	void set_assert(bool bassert) noexcept { AssertOnOverflow = bassert; }
+
+	[[nodiscard]] const char* get_name() const noexcept { return DebugName; }
+	void set_name(const char* dbgname) noexcept { DebugName = dbgname; }
+
+	// Repositions the stream, drops the accumulator
+	PX_SDK_TF2 bool seek(int bitPos);
+	bool seek_relative(int bitPos) { return seek(CurBit + bitPos); }
+
+	[[nodiscard]] int read_bit() { return static_cast<int>(read_ubits(1)); }
+
+	// Read up to 64 bits, anything wider than max_read_bits takes two refills
+	[[nodiscard]] uint64_t read_ubits(int numbits)
+	{
+		if (bits_left() < numbits)
+		{
+			CurBit = DataBits;
+			mark_as_overflowed();
+			return 0;
+		}
+
+		if (numbits > max_read_bits)
+		{
+			const uint64_t lo = read_ubits(32);
+			return lo | (read_ubits(numbits - 32) << 32);
+		}
+
+		if (AccumBits < numbits)
+			refill();
+
+		const uint64_t value = Accum & ((uint64_t(1) << numbits) - 1);
+		Accum >>= numbits;
+		AccumBits -= numbits;
+		CurBit += numbits;
+		return value;
+	}
+
+	// Read up to max_read_bits bits without checking for overflow, reading past the end yields zeros
+	[[nodiscard]] uint64_t read_ubits_nocheck(int numbits) noexcept
+	{
+		if (AccumBits < numbits)
+			refill();
+
+		const uint64_t value = Accum & ((uint64_t(1) << numbits) - 1);
+		Accum >>= numbits;
+		AccumBits -= numbits;
+		CurBit += numbits;
+		return value;
+	}
+
+	// Peek up to max_read_bits bits from the accumulator, bits past the end read as zeros
+	[[nodiscard]] uint64_t peek_ubits(int numbits)
+	{
+		numbits = std::min(numbits, std::max(bits_left(), 0));
+
+		if (AccumBits < numbits)
+			refill();
+		return Accum & ((uint64_t(1) << numbits) - 1);
+	}
+
+	// See bf_read::peek_bits, doesn't touch the accumulator
+	[[nodiscard]] PX_SDK_TF2 uint64_t
+		peek_bits(int numbits) const;
+
+public:
+	// Read a list of bits in.
+	PX_SDK_TF2 void
+		read_bits(void* pOut, int nBits);
+
+	[[nodiscard]] PX_SDK_TF2 float
+		read_angle(int numbits);
+
+	[[nodiscard]] uint32_t peek_ubit(int numbits) { return static_cast<uint32_t>(peek_ubits(numbits)); }
+	[[nodiscard]] uint32_t read_ubit(int numbits) { return static_cast<uint32_t>(read_ubits(numbits)); }
+	[[nodiscard]] PX_SDK_TF2 int
+		read_sbit(int numbits);
+
+	// reads a varint encoded integer
+	[[nodiscard]] PX_SDK_TF2 uint32_t
+		read_uint32();
+	[[nodiscard]] PX_SDK_TF2 uint64_t
+		read_uint64();
+	[[nodiscard]] PX_SDK_TF2 int32_t
+		read_int32();
+	[[nodiscard]] PX_SDK_TF2 int64_t
+		read_int64();
+
+	[[nodiscard]] PX_SDK_TF2 float
+		read_coord();
+	// Multiplayer coord, see PropFlags::CoordMP
+	[[nodiscard]] PX_SDK_TF2 float
+		read_coord_mp(bool integral, bool low_precision);
+	// Component of a unit vector, sign and 11 bits fraction
+	[[nodiscard]] PX_SDK_TF2 float
+		read_normal();
+	// 4, 8, 12 or 32 bits integer prefixed by its 2 bits width
+	[[nodiscard]] PX_SDK_TF2 uint32_t
+		read_ubit_var();
+	PX_SDK_TF2 void
+		read_vec3(float fa[3]);
+
+public:
+	inline int8_t	read_char() { return static_cast<int8_t>(read_ubit(8)); }
+	inline uint8_t	read_byte() { return static_cast<uint8_t>(read_ubit(8)); }
+	inline int16_t	read_short() { return static_cast<int16_t>(read_ubit(16)); }
+	inline uint16_t read_word() { return static_cast<uint16_t>(read_ubit(16)); }
+	inline int32_t	read_long() { return static_cast<int32_t>(read_ubit(32)); }
+	PX_SDK_TF2 int64_t read_longlong();
+	float			read_float()
+	{
+		return std::bit_cast<float>(read_ubit(32));
+	}
+	bool			read_bytes(void* pOut, int nBytes)
+	{
+		read_bits(pOut, nBytes << 3);
+		return !has_overflown();
+	}
+
+	// See bf_read::read_string
+	PX_SDK_TF2 bool read_string(char* pStr, int bufLen, bool bLine = false, int* pOutNumChars = NULL);
+
+	// Status.
+public:
+	[[nodiscard]] int	bits_written()	const noexcept { return CurBit; }
+	[[nodiscard]] int	bytes_written() const noexcept { return (bits_written() + 7) >> 3; }
+	[[nodiscard]] int	max_bits()		const noexcept { return DataBits; }
+	[[nodiscard]] int	bits_left()		const noexcept { return max_bits() - bits_written(); }
+	[[nodiscard]] int	bytes_left()	const noexcept { return bits_left() >> 3; }
+	[[nodiscard]] const uint8_t* data() const noexcept { return Data; }
+	[[nodiscard]] int	remaining_bytes()const noexcept { return DataBytes; }
+
+	[[nodiscard]] bool check_for_overflow(int nBits)
+	{
+		if (CurBit + nBits > DataBits)
+			mark_as_overflowed();
+		return IsOverflow;
+	}
+
+	[[nodiscard]] bool has_overflown() const noexcept { return IsOverflow; }
+	void mark_as_overflowed() noexcept { IsOverflow = true; }
+
+private:
+	// Tops the accumulator up to at least 56 bits
+	void refill() noexcept
+	{
+		if (Next + sizeof(uint64_t) <= Data + DataBytes)
+		{
+			uint64_t word;
+			std::memcpy(&word, Next, sizeof(word));
+			Accum |= word << AccumBits;
+			Next += (63 - AccumBits) >> 3;
+			AccumBits |= 56;
+		}
+		else
+			refill_tail();
+	}
+
+	PX_SDK_TF2 void refill_tail() noexcept;
+
+private:
+	const uint8_t*	Data{ };
+	const uint8_t*	Next{ };
+	int				DataBytes{ };
+	int				DataBits{ };
+
+	uint64_t		Accum{ };
+	int				AccumBits{ };
+
+	int				CurBit{ };
+	bool			IsOverflow{ };
+	bool			AssertOnOverflow{ };
+	const char*		DebugName{ };
+};
+
+
+//-----------------------------------------------------------------------------
+// Reservation scopes, the budget is checked once against the parent buffer when the scope is created
+// and the reads/writes made through the scope skip the per-call overflow check.
+// Memory accesses never leave the bytes the reservation spans: exceeding the budget writes nothing or reads zeros past them,
+// and marks the parent as overflown once the scope is committed.
+// If the reservation itself fails, the parent is marked as overflown and the scope evaluates to false.
+//
+//	if (bf_write_reservation scope{ buffer, 6 + 32 + 1 })
+//	{
+//		scope.write_ubit(type, 6);
+//		scope.write_long(tick);
+//		scope.write_bit(flag);
+//	}
+//-----------------------------------------------------------------------------
+class bf_write_reservation
+{
+public:
+	PX_SDK_TF2 bf_write_reservation(bf_write& writer, int nBits);
+	~bf_write_reservation() { commit(); }
+
+	bf_write_reservation(const bf_write_reservation&) = delete;
+	bf_write_reservation& operator=(const bf_write_reservation&) = delete;
+
+	[[nodiscard]] explicit operator bool() const noexcept { return Parent != nullptr; }
+
+	// Flushes the pending bits and moves the parent's cursor past them, the scope is invalid afterward
+	PX_SDK_TF2 void commit();
+
+	void write_bit(int bit) { write_ubit(bit ? 1 : 0, 1); }
+
+	// numbits is at most 32, the mask is built in 64 bits so 0 and 32 bits both shift in range
+	void write_ubit(uint32_t data, int numbits)
+	{
+		Accum |= (data & ((uint64_t(1) << numbits) - 1)) << AccumBits;
+		AccumBits += numbits;
+		CurBit += numbits;
+
+		if (AccumBits >= 32)
+			flush_word();
+	}
+
+	PX_SDK_TF2 void
+		write_sbit(int data, int numbits);
+
+	PX_SDK_TF2 void
+		write_bits(const void* in_data, int numbits);
+
+	// writes a varint encoded integer
+	PX_SDK_TF2 void
+		write_uint32(uint32_t data);
+	PX_SDK_TF2 void
+		write_uint64(uint64_t data);
+	PX_SDK_TF2 void
+		write_sint32(int32_t data);
+	PX_SDK_TF2 void
+		write_sint64(int64_t data);
+
+	PX_SDK_TF2 void
+		write_angle(float fAngle, int numbits);
+	PX_SDK_TF2 void
+		write_coord(const float f);
+	// Multiplayer coord, see PropFlags::CoordMP
+	PX_SDK_TF2 void
+		write_coord_mp(const float f, bool integral, bool low_precision);
+	// Component of a unit vector, sign and 11 bits fraction
+	PX_SDK_TF2 void
+		write_normal(const float f);
+	// 4, 8, 12 or 32 bits integer prefixed by its 2 bits width
+	PX_SDK_TF2 void
+		write_ubit_var(uint32_t data);
+	PX_SDK_TF2 void
+		write_vec3(const float fa[3]);
+
+public:
+	void write_char(int8_t val)		{ write_ubit(static_cast<uint8_t>(val), 8); }
+	void write_byte(uint8_t val)	{ write_ubit(val, 8); }
+	void write_short(int16_t val)	{ write_ubit(static_cast<uint16_t>(val), 16); }
+	void write_word(uint16_t val)	{ write_ubit(val, 16); }
+	void write_long(int32_t val)	{ write_ubit(static_cast<uint32_t>(val), 32); }
+	PX_SDK_TF2 void
+		write_longlong(int64_t val);
+	void write_float(float val)		{ write_ubit(std::bit_cast<uint32_t>(val), 32); }
+	void write_bytes(const void* pBuf, int nBytes) { write_bits(pBuf, nBytes << 3); }
+
+	PX_SDK_TF2 void
+		write_string(const char* str);
+
+public:
+	[[nodiscard]] int	bits_written()	const noexcept { return CurBit; }
+	[[nodiscard]] int	bits_left()		const noexcept { return EndBit - CurBit; }
+	[[nodiscard]] bool	has_overflown()	const noexcept { return CurBit > EndBit; }
+
+private:
+	PX_SDK_TF2 void flush_word() noexcept;
+
+private:
+	bf_write*	Parent{ };
+	uint8_t*	Data{ };
+	int			NextByte{ };
+	int			EndByte{ };
+
+	uint64_t	Accum{ };
+	int			AccumBits{ };
+
+	int			CurBit{ };
+	int			EndBit{ };
+};
+
+
+class bf_read_reservation
+{
+public:
+	PX_SDK_TF2 bf_read_reservation(bf_read& reader, int nBits);
+	~bf_read_reservation() { commit(); }
+
+	bf_read_reservation(const bf_read_reservation&) = delete;
+	bf_read_reservation& operator=(const bf_read_reservation&) = delete;
+
+	[[nodiscard]] explicit operator bool() const noexcept { return Parent != nullptr; }
+
+	// Moves the parent's cursor past the consumed bits, the scope is invalid afterward
+	PX_SDK_TF2 void commit();
+
+	[[nodiscard]] int read_bit() { return static_cast<int>(Stream.read_ubits_nocheck(1)); }
+	[[nodiscard]] uint32_t read_ubit(int numbits) { return static_cast<uint32_t>(Stream.read_ubits_nocheck(numbits)); }
+
+	PX_SDK_TF2 void
+		read_bits(void* pOut, int nBits);
+
+	[[nodiscard]] PX_SDK_TF2 float
+		read_angle(int numbits);
+	[[nodiscard]] PX_SDK_TF2 int
+		read_sbit(int numbits);
+
+	// reads a varint encoded integer
+	[[nodiscard]] PX_SDK_TF2 uint32_t
+		read_uint32();
+	[[nodiscard]] PX_SDK_TF2 uint64_t
+		read_uint64();
+	[[nodiscard]] PX_SDK_TF2 int32_t
+		read_int32();
+	[[nodiscard]] PX_SDK_TF2 int64_t
+		read_int64();
+
+	[[nodiscard]] PX_SDK_TF2 float
+		read_coord();
+	// Multiplayer coord, see PropFlags::CoordMP
+	[[nodiscard]] PX_SDK_TF2 float
+		read_coord_mp(bool integral, bool low_precision);
+	// Component of a unit vector, sign and 11 bits fraction
+	[[nodiscard]] PX_SDK_TF2 float
+		read_normal();
+	// 4, 8, 12 or 32 bits integer prefixed by its 2 bits width
+	[[nodiscard]] PX_SDK_TF2 uint32_t
+		read_ubit_var();
+	PX_SDK_TF2 void
+		read_vec3(float fa[3]);
+
+public:
+	inline int8_t	read_char() { return static_cast<int8_t>(read_ubit(8)); }
+	inline uint8_t	read_byte() { return static_cast<uint8_t>(read_ubit(8)); }
+	inline int16_t	read_short() { return static_cast<int16_t>(read_ubit(16)); }
+	inline uint16_t read_word() { return static_cast<uint16_t>(read_ubit(16)); }
+	inline int32_t	read_long() { return static_cast<int32_t>(read_ubit(32)); }
+	PX_SDK_TF2 int64_t read_longlong();
+	float			read_float() { return std::bit_cast<float>(read_ubit(32)); }
+	bool			read_bytes(void* pOut, int nBytes)
+	{
+		read_bits(pOut, nBytes << 3);
+		return !has_overflown();
+	}
+
+	// See bf_read::read_string, the string can't extend past the reservation
+	PX_SDK_TF2 bool read_string(char* pStr, int bufLen, bool bLine = false, int* pOutNumChars = NULL);
+
+public:
+	[[nodiscard]] int	bits_read()		const noexcept { return Stream.bits_written(); }
+	[[nodiscard]] int	bits_left()		const noexcept { return Stream.bits_left(); }
+	[[nodiscard]] bool	has_overflown()	const noexcept { return Stream.bits_left() < 0; }
+
+private:
+	bf_read*			Parent{ };
+	bf_read_buffered	Stream;
+};
+
+
+// Bridges between px::bitbuf_t and bf_read/bf_write, both sides share the same memory and bit order.
+// Only the cursor is carried over, no data is copied.
+
+/// <summary>
+/// Start reading 'buf' from its current read position
+/// </summary>
+template<typename _Traits>
+	requires (_Traits::is_read && _Traits::size_of_block == 1)
+[[nodiscard]] inline bf_read make_bf_read(const px::bitbuf_t<_Traits>& buf, const char* debug_name = nullptr)
+{
+	bf_read reader;
+	reader.set_name(debug_name);
+	reader.start_reading(buf.data(), static_cast<int>(buf.size()), static_cast<int>(buf.read_get()));
+	return reader;
+}
+
+/// <summary>
+/// Start writing to 'buf' from its current write position.
+/// bf_write works on whole dwords, trailing bytes of a buffer that isn't a multiple of 4 bytes are not writable
+/// </summary>
+template<typename _Traits>
+	requires (_Traits::is_write && _Traits::size_of_block == 1)
+[[nodiscard]] inline bf_write make_bf_write(px::bitbuf_t<_Traits>& buf, const char* debug_name = nullptr)
+{
+	bf_write writer;
+	writer.set_name(debug_name);
+	writer.start_writing(buf.data(), static_cast<int>(buf.size()), static_cast<int>(buf.write_get()));
+	return writer;
+}
+
+/// <summary>
+/// View the remaining bits of a reader, the view's read cursor is the reader's current bit
+/// </summary>
+[[nodiscard]] inline px::ibitbuf_view make_bitbuf_view(const bf_read& reader)
+{
+	px::ibitbuf_view view{ std::span{ reinterpret_cast<const std::byte*>(reader.data()), static_cast<size_t>((reader.max_bits() + 7) >> 3) } };
+	view.read_set(reader.bits_written());
+	return view;
+}
+
+/// <summary>
+/// View the memory of a writer, the view's write cursor is the writer's current bit
+/// </summary>
+[[nodiscard]] inline px::obitbuf_view make_bitbuf_view(bf_write& writer)
+{
+	px::obitbuf_view view{ std::span{ reinterpret_cast<std::byte*>(writer.data()), static_cast<size_t>(writer.max_bits() >> 3) } };
+	view.write_set(writer.bits_written());
+	return view;
+}
+
 TF2_NAMESPACE_END();
\ No newline at end of file
@@ -0,0 +1,600 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <tf2/utils/bitbuf.hpp>
+
+TF2_NAMESPACE_BEGIN(::utils);
+
+struct bit_buffer_constants
+{
+	static constexpr int maxbytes_var_int32 = 5;
+	static constexpr int max_var = 10;
+
+	static constexpr int coord_int = 14;
+	static constexpr int coord_fraction = 5;
+	static constexpr int coord_denominator = 1 << coord_fraction;
+	static constexpr float coord_resolution = 1.f / (1 << 5);
+	// flags, sign, integer and fraction
+	static constexpr int coord_max_bits = 3 + coord_int + coord_fraction;
+	static constexpr int vec3_max_bits = 3 + 3 * coord_max_bits;
+
+	// CoordMP, integers in bounds only take 11 bits, low precision fractions 3 bits
+	static constexpr int coord_int_mp = 11;
+	static constexpr int coord_fraction_lp = 3;
+	static constexpr int coord_denominator_lp = 1 << coord_fraction_lp;
+	static constexpr float coord_resolution_lp = 1.f / (1 << coord_fraction_lp);
+
+	static constexpr int normal_fraction = 11;
+	static constexpr int normal_denominator = (1 << normal_fraction) - 1;
+	static constexpr float normal_resolution = 1.f / normal_denominator;
+
+	// Widths selected by the 2 bits prefix of a ubit_var
+	static constexpr int ubit_var_bits[4]{ 4, 8, 12, 32 };
+
+	static constexpr uint32_t enconde_zigzag(int32_t v) { return (v << 1) ^ (v >> 31); }
+	static constexpr uint64_t enconde_zigzag(int64_t v) { return (v << 1) ^ (v >> 63); }
+
+	static constexpr uint32_t deconde_zigzag(uint32_t v) { return (v >> 1) ^ -static_cast<int32_t>(v & 1); }
+	static constexpr uint64_t deconde_zigzag(uint64_t v) { return (v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+	static constexpr uint32_t bit_for_bitnum(int bit)
+	{
+		constexpr uint32_t bitsForBitnum[]
+		{
+			(1u << 0),
+			(1u << 1),
+			(1u << 2),
+			(1u << 3),
+			(1u << 4),
+			(1u << 5),
+			(1u << 6),
+			(1u << 7),
+			(1u << 8),
+			(1u << 9),
+			(1u << 10),
+			(1u << 11),
+			(1u << 12),
+			(1u << 13),
+			(1u << 14),
+			(1u << 15),
+			(1u << 16),
+			(1u << 17),
+			(1u << 18),
+			(1u << 19),
+			(1u << 20),
+			(1u << 21),
+			(1u << 22),
+			(1u << 23),
+			(1u << 24),
+			(1u << 25),
+			(1u << 26),
+			(1u << 27),
+			(1u << 28),
+			(1u << 29),
+			(1u << 30),
+			(1u << 31),
+		};
+		static_assert(std::extent_v<decltype(bitsForBitnum)> == 32);
+		return bitsForBitnum[bit & 31];
+	}
+
+	uint32_t bit_write_bitmask[32][33]{ };
+	uint32_t bit_write_littlemask[32]{ };
+
+	constexpr bit_buffer_constants()
+	{
+		for (int i = 0; i < 32; i++)
+		{
+			for (int j = 0; j < 33; j++)
+			{
+				unsigned int k = i + j;
+
+				bit_write_bitmask[i][j] = bit_for_bitnum(i) - 1;
+				if (k < 32)
+					bit_write_bitmask[i][j] |= ~(bit_for_bitnum(k) - 1);
+			}
+		}
+
+		for (size_t i = 0; i < 32; i++)
+			bit_write_littlemask[i] = 1u << i;
+	}
+};
+
+
+//-----------------------------------------------------------------------------
+// Encoders shared by bf_write, bf_write_reservation and schema::px_writer
+//-----------------------------------------------------------------------------
+struct bit_writer_impl
+{
+	template<typename _WriterTy>
+	static void write_sbit(_WriterTy& writer, int data, int numbits)
+	{
+		// Force the sign-extension bit to be correct even in the case of overflow.
+		int nValue = data;
+		int nPreserveBits = (0x7FFFFFFF >> (32 - numbits));
+		int nSignExtension = (nValue >> 31) & ~nPreserveBits;
+		nValue &= nPreserveBits;
+		nValue |= nSignExtension;
+
+		writer.write_ubit(nValue, numbits);
+	}
+
+	template<typename _WriterTy, typename _Ty>
+	static void write_varint(_WriterTy& writer, _Ty data)
+	{
+		while (data > 0x7F)
+		{
+			writer.write_ubit(static_cast<uint32_t>((data & 0x7F) | 0x80), 8);
+			data >>= 7;
+		}
+		writer.write_ubit(static_cast<uint32_t>(data & 0x7F), 8);
+	}
+
+	template<typename _WriterTy>
+	static void write_angle(_WriterTy& writer, float fAngle, int numbits)
+	{
+		uint32_t shift = bit_buffer_constants::bit_for_bitnum(numbits);
+		uint32_t mask = shift - 1;
+
+		uint32_t d = static_cast<uint32_t>((fAngle / 360.0) * shift) & mask;
+
+		writer.write_ubit(d, numbits);
+	}
+
+	template<typename _WriterTy>
+	static void write_coord(_WriterTy& writer, const float f)
+	{
+		int	signbit = (f <= -bit_buffer_constants::coord_resolution);
+		int	intval = static_cast<int>(std::abs(f));
+		// The fraction of a negative value is masked once positive, masking first would send its two's complement
+		int	fractval = std::abs(static_cast<int>(f * bit_buffer_constants::coord_denominator)) & (bit_buffer_constants::coord_denominator - 1);
+
+		// Send the bit flags that indicate whether we have an integer part and/or a fraction part.
+		writer.write_bit(intval);
+		writer.write_bit(fractval);
+
+		if (intval || fractval)
+		{
+			// Send the sign bit
+			writer.write_bit(signbit);
+
+			// Send the integer if we have one.
+			if (intval)
+			{
+				// Adjust the integers from [1..MAX_COORD_VALUE] to [0..MAX_COORD_VALUE-1]
+				intval--;
+				writer.write_ubit(static_cast<uint32_t>(intval), bit_buffer_constants::coord_int);
+			}
+
+			// Send the fraction if we have one
+			if (fractval)
+			{
+				writer.write_ubit(static_cast<uint32_t>(fractval), bit_buffer_constants::coord_fraction);
+			}
+		}
+	}
+
+	template<typename _WriterTy>
+	static void write_coord_mp(_WriterTy& writer, const float f, bool integral, bool low_precision)
+	{
+		int signbit = (f <= -(low_precision ? bit_buffer_constants::coord_resolution_lp : bit_buffer_constants::coord_resolution));
+		int intval = static_cast<int>(std::abs(f));
+		int fractval = low_precision ?
+			(std::abs(static_cast<int>(f * bit_buffer_constants::coord_denominator_lp)) & (bit_buffer_constants::coord_denominator_lp - 1)) :
+			(std::abs(static_cast<int>(f * bit_buffer_constants::coord_denominator)) & (bit_buffer_constants::coord_denominator - 1));
+
+		bool inbounds = intval < (1 << bit_buffer_constants::coord_int_mp);
+		writer.write_bit(inbounds);
+
+		// Integral coords only send the sign when there's an integer
+		if (integral)
+		{
+			writer.write_bit(intval);
+			if (intval)
+			{
+				writer.write_bit(signbit);
+				// Adjust the integers from [1..MAX_COORD_VALUE] to [0..MAX_COORD_VALUE-1]
+				writer.write_ubit(static_cast<uint32_t>(intval - 1), inbounds ? bit_buffer_constants::coord_int_mp : bit_buffer_constants::coord_int);
+			}
+		}
+		else
+		{
+			writer.write_bit(intval);
+			writer.write_bit(signbit);
+			if (intval)
+				writer.write_ubit(static_cast<uint32_t>(intval - 1), inbounds ? bit_buffer_constants::coord_int_mp : bit_buffer_constants::coord_int);
+
+			writer.write_ubit(static_cast<uint32_t>(fractval), low_precision ? bit_buffer_constants::coord_fraction_lp : bit_buffer_constants::coord_fraction);
+		}
+	}
+
+	template<typename _WriterTy>
+	static void write_normal(_WriterTy& writer, const float f)
+	{
+		int signbit = (f <= -bit_buffer_constants::normal_resolution);
+
+		// +/-1 are valid values for a normal, they are encoded as all ones
+		uint32_t fractval = std::min<uint32_t>(std::abs(static_cast<int>(f * bit_buffer_constants::normal_denominator)), bit_buffer_constants::normal_denominator);
+
+		writer.write_bit(signbit);
+		writer.write_ubit(fractval, bit_buffer_constants::normal_fraction);
+	}
+
+	template<typename _WriterTy>
+	static void write_ubit_var(_WriterTy& writer, uint32_t data)
+	{
+		const uint32_t encoding = (data >= 0x10u) + (data >= 0x100u) + (data >= 0x1000u);
+		writer.write_ubit(encoding, 2);
+		writer.write_ubit(data, bit_buffer_constants::ubit_var_bits[encoding]);
+	}
+
+	template<typename _WriterTy>
+	static void write_vec3(_WriterTy& writer, const float fa[3])
+	{
+		int xflag = (fa[0] >= bit_buffer_constants::coord_resolution) || (fa[0] <= -bit_buffer_constants::coord_resolution);
+		int yflag = (fa[1] >= bit_buffer_constants::coord_resolution) || (fa[1] <= -bit_buffer_constants::coord_resolution);
+		int zflag = (fa[2] >= bit_buffer_constants::coord_resolution) || (fa[2] <= -bit_buffer_constants::coord_resolution);
+
+		writer.write_bit(xflag);
+		writer.write_bit(yflag);
+		writer.write_bit(zflag);
+
+		if (xflag)	writer.write_coord(fa[0]);
+		if (yflag)	writer.write_coord(fa[1]);
+		if (zflag)	writer.write_coord(fa[2]);
+	}
+
+	template<typename _WriterTy>
+	static void write_longlong(_WriterTy& writer, int64_t val)
+	{
+		uint32_t* longs = reinterpret_cast<uint32_t*>(&val);
+
+		// Insert the two DWORDS according to network endian
+		const short endianIndex = 0x0100;
+		const int8_t* idx = reinterpret_cast<const int8_t*>(&endianIndex);
+		writer.write_ubit(longs[*idx++], sizeof(int32_t) << 3);
+		writer.write_ubit(longs[*idx], sizeof(int32_t) << 3);
+	}
+
+	template<typename _WriterTy>
+	static void write_string(_WriterTy& writer, const char* str)
+	{
+		if (str)
+		{
+			do
+			{
+				writer.write_char(*str);
+				++str;
+			} while (*(str - 1) != 0);
+		}
+		else
+			writer.write_char(0);
+	}
+};
+
+
+//-----------------------------------------------------------------------------
+// Decoders shared by bf_read, bf_read_buffered and schema::px_reader, they only differ in how raw bits are fetched
+//-----------------------------------------------------------------------------
+struct bit_reader_impl
+{
+	// Byte-aligned decoders, they work straight on the buffer and return the number of bytes consumed
+
+	static uint64_t load_u64(const uint8_t* p) noexcept
+	{
+		uint64_t word;
+		std::memcpy(&word, p, sizeof(word));
+		return word;
+	}
+
+	// Extracts up to 32 bits at 'iBit', never loads past 'nBytes'
+	static uint32_t load_bits(const uint8_t* data, int nBytes, int iBit, int numbits) noexcept
+	{
+		// at most 32 bits at an unaligned offset spans 5 bytes
+		const int iByteOffset = iBit >> 3;
+
+		uint64_t dw = 0;
+		if (iByteOffset + static_cast<int>(sizeof(dw)) <= nBytes)
+			dw = load_u64(data + iByteOffset);
+		else
+			std::memcpy(&dw, data + iByteOffset, std::min(nBytes - iByteOffset, 5));
+
+		const uint64_t bitmask = (uint64_t(1) << numbits) - 1;
+		return static_cast<uint32_t>((dw >> (iBit & 7)) & bitmask);
+	}
+
+	// Up to 57 bits at 'iBit' plus its offset in the first byte fit a single 8 bytes load
+	static uint64_t peek_bits(const uint8_t* data, int nBytes, int iBit, int nBitsLeft, int numbits) noexcept
+	{
+		assert(numbits >= 0 && numbits <= bf_read::max_peek_bits);
+
+		numbits = std::min(numbits, nBitsLeft);
+		if (numbits <= 0)
+			return 0;
+
+		const int iByteOffset = iBit >> 3;
+
+		uint64_t dw = 0;
+		if (iByteOffset + static_cast<int>(sizeof(dw)) <= nBytes)
+			dw = load_u64(data + iByteOffset);
+		else
+			std::memcpy(&dw, data + iByteOffset, nBytes - iByteOffset);
+
+		return (dw >> (iBit & 7)) & ((uint64_t(1) << numbits) - 1);
+	}
+
+	// Packs the 7 bits payload of up to 8 varint bytes into 56 contiguous bits
+	static uint64_t compact_varint(uint64_t x) noexcept
+	{
+		x &= 0x7F7F7F7F7F7F7F7Full;
+		x = ((x & 0x7F007F007F007F00ull) >> 1) | (x & 0x007F007F007F007Full);
+		x = ((x & 0x3FFF00003FFF0000ull) >> 2) | (x & 0x00003FFF00003FFFull);
+		x = ((x & 0x0FFFFFFF00000000ull) >> 4) | (x & 0x000000000FFFFFFFull);
+		return x;
+	}
+
+	// Requires 8 readable bytes at 'p'
+	static int decode_uint32(const uint8_t* p, uint32_t& out) noexcept
+	{
+		const uint64_t word = load_u64(p);
+		// the fifth byte always terminates, its continuation bit is ignored
+		const uint64_t stop = (~word & 0x8080808080808080ull) | (0x80ull << 32);
+		const int len = (std::countr_zero(stop) >> 3) + 1;
+
+		out = static_cast<uint32_t>(compact_varint(word & ((uint64_t(1) << (len << 3)) - 1)));
+		return len;
+	}
+
+	// Requires 10 readable bytes at 'p'
+	static int decode_uint64(const uint8_t* p, uint64_t& out) noexcept
+	{
+		const uint64_t word = load_u64(p);
+		const uint64_t stop = ~word & 0x8080808080808080ull;
+		if (stop)
+		{
+			const int len = (std::countr_zero(stop) >> 3) + 1;
+			out = compact_varint(len == 8 ? word : word & ((uint64_t(1) << (len << 3)) - 1));
+			return len;
+		}
+
+		out = compact_varint(word) | (static_cast<uint64_t>(p[8] & 0x7F) << 56);
+		if (!(p[8] & 0x80))
+			return 9;
+
+		// the tenth byte always terminates
+		out |= static_cast<uint64_t>(p[9] & 0x7F) << 63;
+		return 10;
+	}
+
+	// Scans 'p' up to 'avail' bytes for the terminator, copies the string and returns the number of bytes consumed,
+	// or -1 if no terminator was found, in which case every available byte is consumed
+	static int scan_string(const uint8_t* p, int avail, char* str, int maxLen, bool bLine, bool& bTooSmall, int* pOutNumChars) noexcept
+	{
+		const void* nul = std::memchr(p, 0, avail);
+		int len = nul ? static_cast<int>(static_cast<const uint8_t*>(nul) - p) : avail;
+		if (bLine)
+		{
+			if (const void* nl = std::memchr(p, '\n', len))
+				len = static_cast<int>(static_cast<const uint8_t*>(nl) - p);
+		}
+
+		const int copy = std::max(std::min(len, maxLen - 1), 0);
+		std::memcpy(str, p, copy);
+		str[copy] = 0;
+
+		bTooSmall = len > copy;
+		if (pOutNumChars)
+			*pOutNumChars = copy;
+
+		return len < avail ? len + 1 : -1;
+	}
+
+	template<typename _ReaderTy>
+	static float read_angle(_ReaderTy& reader, int numbits)
+	{
+		float shift = static_cast<float>((bit_buffer_constants::bit_for_bitnum(numbits)));
+		return static_cast<float>(reader.read_ubit(numbits)) * (360.0f / shift);
+	}
+
+	template<typename _ReaderTy>
+	static int32_t read_sbit(_ReaderTy& reader, int numbits)
+	{
+		uint32_t r = reader.read_ubit(numbits);
+		uint32_t s = 1 << (numbits - 1);
+		if (r >= s)
+		{
+			// sign-extend by removing sign bit and then subtracting sign bit again
+			r = r - s - s;
+		}
+		return r;
+	}
+
+	template<typename _ReaderTy>
+	static uint32_t read_uint32(_ReaderTy& reader)
+	{
+		uint32_t result = 0;
+		int count = 0;
+		uint32_t b;
+
+		do
+		{
+			if (count == bit_buffer_constants::maxbytes_var_int32)
+				return result;
+
+			b = reader.read_ubit(8);
+			result |= (b & 0x7F) << (7 * count);
+			++count;
+		} while (b & 0x80);
+
+		return result;
+	}
+
+	template<typename _ReaderTy>
+	static uint64_t read_uint64(_ReaderTy& reader)
+	{
+		uint64_t result = 0;
+		int count = 0;
+		uint64_t b;
+
+		do
+		{
+			if (count == bit_buffer_constants::max_var)
+				return result;
+
+			b = reader.read_ubit(8);
+			result |= static_cast<uint64_t>(b & 0x7F) << (7 * count);
+			++count;
+		} while (b & 0x80);
+
+		return result;
+	}
+
+	// Basic Coordinate Routines (these contain bit-field size AND fixed point scaling constants)
+	template<typename _ReaderTy>
+	static float read_coord(_ReaderTy& reader)
+	{
+		float value = 0.0;
+
+		// Read the required integer and fraction flags
+		int intval = reader.read_bit();
+		int fractval = reader.read_bit();
+
+		// If we got either parse them, otherwise it's a zero.
+		if (intval || fractval)
+		{
+			// Read the sign bit
+			int signbit = reader.read_bit();
+
+			// If there's an integer, read it in
+			// Adjust the integers from [0..MAX_COORD_VALUE-1] to [1..MAX_COORD_VALUE]
+			if (intval)
+				intval = reader.read_ubit(bit_buffer_constants::coord_int) + 1;
+
+			// If there's a fraction, read it in
+			if (fractval)
+				fractval = reader.read_ubit(bit_buffer_constants::coord_fraction);
+
+			// Calculate the correct floating point value
+			value = intval + ((float)fractval * bit_buffer_constants::coord_resolution);
+
+			// Fixup the sign if negative.
+			if (signbit)
+				value = -value;
+		}
+
+		return value;
+	}
+
+	template<typename _ReaderTy>
+	static float read_coord_mp(_ReaderTy& reader, bool integral, bool low_precision)
+	{
+		const int inbounds = reader.read_bit();
+		const int intbits = inbounds ? bit_buffer_constants::coord_int_mp : bit_buffer_constants::coord_int;
+
+		float value;
+		int signbit;
+		if (integral)
+		{
+			if (!reader.read_bit())
+				return 0.f;
+
+			signbit = reader.read_bit();
+			value = static_cast<float>(reader.read_ubit(intbits) + 1);
+		}
+		else
+		{
+			const int intflag = reader.read_bit();
+			signbit = reader.read_bit();
+
+			// Adjust the integers from [0..MAX_COORD_VALUE-1] to [1..MAX_COORD_VALUE]
+			const int intval = intflag ? static_cast<int>(reader.read_ubit(intbits)) + 1 : 0;
+			if (low_precision)
+				value = intval + static_cast<float>(reader.read_ubit(bit_buffer_constants::coord_fraction_lp)) * bit_buffer_constants::coord_resolution_lp;
+			else
+				value = intval + static_cast<float>(reader.read_ubit(bit_buffer_constants::coord_fraction)) * bit_buffer_constants::coord_resolution;
+		}
+
+		return signbit ? -value : value;
+	}
+
+	template<typename _ReaderTy>
+	static float read_normal(_ReaderTy& reader)
+	{
+		const int signbit = reader.read_bit();
+		const float value = static_cast<float>(reader.read_ubit(bit_buffer_constants::normal_fraction)) * bit_buffer_constants::normal_resolution;
+		return signbit ? -value : value;
+	}
+
+	template<typename _ReaderTy>
+	static uint32_t read_ubit_var(_ReaderTy& reader)
+	{
+		const uint32_t encoding = reader.read_ubit(2);
+		return reader.read_ubit(bit_buffer_constants::ubit_var_bits[encoding]);
+	}
+
+	template<typename _ReaderTy>
+	static void read_vec3(_ReaderTy& reader, float fa[3])
+	{
+		int xflag = reader.read_bit();
+		int yflag = reader.read_bit();
+		int zflag = reader.read_bit();
+
+		fa[0] = xflag ? reader.read_coord() : 0.f;
+		fa[1] = yflag ? reader.read_coord() : 0.f;
+		fa[2] = zflag ? reader.read_coord() : 0.f;
+	}
+
+	template<typename _ReaderTy>
+	static int64_t read_longlong(_ReaderTy& reader)
+	{
+		int64_t ret;
+		uint32_t* longs = (uint32_t*)&ret;
+
+		// Read the two DWORDs according to network endian
+		const short endianIndex = 0x0100;
+		const int8_t* idx = reinterpret_cast<const int8_t*>(&endianIndex);
+		longs[*idx++] = reader.read_ubit(sizeof(int32_t) << 3);
+		longs[*idx] = reader.read_ubit(sizeof(int32_t) << 3);
+
+		return ret;
+	}
+
+	template<typename _ReaderTy>
+	static bool read_string(_ReaderTy& reader, char* str, int maxLen, bool bLine, int* pOutNumChars)
+	{
+		bool bTooSmall = false;
+		int i = 0;
+
+		while (1)
+		{
+			char val = reader.read_char();
+			if (val == 0)
+				break;
+			else if (bLine && val == '\n')
+				break;
+
+			if (i < (maxLen - 1))
+			{
+				str[i] = val;
+				++i;
+			}
+			else
+			{
+				bTooSmall = true;
+			}
+		}
+
+		str[i] = 0;
+
+		if (pOutNumChars)
+			*pOutNumChars = i;
+
+		return !reader.has_overflown() && !bTooSmall;
+	}
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,555 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <tf2/utils/bitbuf_impl.hpp>
+
+TF2_NAMESPACE_BEGIN(::utils);
+
+//-----------------------------------------------------------------------------
+// Declarative bit layouts:
+//
+//	using ClientInfo_Schema = bit_schema<
+//		schema::sbit<&CLC_ClientInfo::ServerCount, 32>,
+//		schema::flag<&CLC_ClientInfo::IsHLTV>,
+//		schema::string<&CLC_ClientInfo::FriendsName>,
+//		schema::optional<schema::ubit<&CLC_ClientInfo::FriendsID, 32>>
+//	>;
+//
+//	ClientInfo_Schema::write(msg, bf_write_or_px_bitbuf);
+//	ClientInfo_Schema::read(msg, bf_read_or_px_bitbuf);
+//
+// Both directions are generated from the same list, adjacent fixed-width fields
+// are folded into a single write_ubit/read_ubit of up to 32 bits.
+//-----------------------------------------------------------------------------
+namespace schema
+{
+	template<typename>
+	struct member_pointer_traits;
+
+	template<typename _ClassTy, typename _Ty>
+	struct member_pointer_traits<_Ty _ClassTy::*>
+	{
+		using class_type = _ClassTy;
+		using value_type = _Ty;
+	};
+
+	template<auto _Member>
+	struct field_base
+	{
+		using class_type = typename member_pointer_traits<decltype(_Member)>::class_type;
+		using value_type = typename member_pointer_traits<decltype(_Member)>::value_type;
+
+		[[nodiscard]] static constexpr const value_type& get(const class_type& obj) noexcept { return obj.*_Member; }
+		[[nodiscard]] static constexpr value_type& get(class_type& obj) noexcept { return obj.*_Member; }
+	};
+
+
+	/// <summary>
+	/// Unsigned fixed-width field (integers, enums)
+	/// </summary>
+	template<auto _Member, int _Bits>
+	struct ubit : field_base<_Member>
+	{
+		static_assert(_Bits > 0 && _Bits <= 32, "fixed-width fields are limited to 32 bits");
+
+		using typename field_base<_Member>::value_type;
+
+		static constexpr bool is_fixed = true;
+		static constexpr int bits = _Bits;
+		static constexpr int max_bits = _Bits;
+
+		[[nodiscard]] static constexpr uint32_t encode(const value_type& val) noexcept
+		{
+			constexpr uint32_t mask = static_cast<uint32_t>((1ull << _Bits) - 1);
+			return static_cast<uint32_t>(val) & mask;
+		}
+
+		[[nodiscard]] static constexpr value_type decode(uint32_t val) noexcept
+		{
+			return static_cast<value_type>(val);
+		}
+	};
+
+	/// <summary>
+	/// Signed fixed-width field, sign-extended on read
+	/// </summary>
+	template<auto _Member, int _Bits>
+	struct sbit : ubit<_Member, _Bits>
+	{
+		using typename field_base<_Member>::value_type;
+
+		[[nodiscard]] static constexpr value_type decode(uint32_t val) noexcept
+		{
+			if constexpr (_Bits < 32)
+			{
+				constexpr uint32_t sign = 1u << (_Bits - 1);
+				val = (val ^ sign) - sign;
+			}
+			return static_cast<value_type>(static_cast<int32_t>(val));
+		}
+	};
+
+	/// <summary>
+	/// Single bit boolean field
+	/// </summary>
+	template<auto _Member>
+	struct flag : ubit<_Member, 1>
+	{
+		using typename field_base<_Member>::value_type;
+
+		[[nodiscard]] static constexpr uint32_t encode(const value_type& val) noexcept
+		{
+			return val ? 1 : 0;
+		}
+
+		[[nodiscard]] static constexpr value_type decode(uint32_t val) noexcept
+		{
+			return static_cast<value_type>(val != 0);
+		}
+	};
+
+	/// <summary>
+	/// Unsigned varint (uint32_t or uint64_t depending on the member)
+	/// </summary>
+	template<auto _Member>
+	struct varint : field_base<_Member>
+	{
+		using typename field_base<_Member>::value_type;
+
+		static constexpr bool is_wide = sizeof(value_type) > sizeof(uint32_t);
+		static constexpr bool is_fixed = false;
+		static constexpr int max_bits = is_wide ? 10 * 8 : 5 * 8;
+
+		template<typename _WriterTy>
+		static void write(const typename field_base<_Member>::class_type& obj, _WriterTy& writer)
+		{
+			if constexpr (is_wide)
+				writer.write_uint64(static_cast<uint64_t>(field_base<_Member>::get(obj)));
+			else
+				writer.write_uint32(static_cast<uint32_t>(field_base<_Member>::get(obj)));
+		}
+
+		template<typename _ReaderTy>
+		static void read(typename field_base<_Member>::class_type& obj, _ReaderTy& reader)
+		{
+			if constexpr (is_wide)
+				field_base<_Member>::get(obj) = static_cast<value_type>(reader.read_uint64());
+			else
+				field_base<_Member>::get(obj) = static_cast<value_type>(reader.read_uint32());
+		}
+	};
+
+	/// <summary>
+	/// Zigzag encoded signed varint (int32_t or int64_t depending on the member)
+	/// </summary>
+	template<auto _Member>
+	struct zigzag : field_base<_Member>
+	{
+		using typename field_base<_Member>::value_type;
+
+		static constexpr bool is_wide = sizeof(value_type) > sizeof(int32_t);
+		static constexpr bool is_fixed = false;
+		static constexpr int max_bits = is_wide ? 10 * 8 : 5 * 8;
+
+		template<typename _WriterTy>
+		static void write(const typename field_base<_Member>::class_type& obj, _WriterTy& writer)
+		{
+			if constexpr (is_wide)
+				writer.write_sint64(static_cast<int64_t>(field_base<_Member>::get(obj)));
+			else
+				writer.write_sint32(static_cast<int32_t>(field_base<_Member>::get(obj)));
+		}
+
+		template<typename _ReaderTy>
+		static void read(typename field_base<_Member>::class_type& obj, _ReaderTy& reader)
+		{
+			if constexpr (is_wide)
+				field_base<_Member>::get(obj) = static_cast<value_type>(reader.read_int64());
+			else
+				field_base<_Member>::get(obj) = static_cast<value_type>(reader.read_int32());
+		}
+	};
+
+	/// <summary>
+	/// Engine bit-coord (integer/fraction flags, sign, integer and fraction bits)
+	/// </summary>
+	template<auto _Member>
+	struct coord : field_base<_Member>
+	{
+		static constexpr bool is_fixed = false;
+		static constexpr int max_bits = bit_buffer_constants::coord_max_bits;
+
+		template<typename _WriterTy>
+		static void write(const typename field_base<_Member>::class_type& obj, _WriterTy& writer)
+		{
+			writer.write_coord(static_cast<float>(field_base<_Member>::get(obj)));
+		}
+
+		template<typename _ReaderTy>
+		static void read(typename field_base<_Member>::class_type& obj, _ReaderTy& reader)
+		{
+			field_base<_Member>::get(obj) = reader.read_coord();
+		}
+	};
+
+	/// <summary>
+	/// Null terminated string stored in a char array member
+	/// </summary>
+	template<auto _Member>
+	struct string : field_base<_Member>
+	{
+		using typename field_base<_Member>::value_type;
+		static_assert(std::is_array_v<value_type>, "string fields must be char arrays");
+
+		static constexpr bool is_fixed = false;
+		static constexpr int max_bits = static_cast<int>(sizeof(value_type)) * 8;
+
+		template<typename _WriterTy>
+		static void write(const typename field_base<_Member>::class_type& obj, _WriterTy& writer)
+		{
+			writer.write_string(field_base<_Member>::get(obj));
+		}
+
+		template<typename _ReaderTy>
+		static void read(typename field_base<_Member>::class_type& obj, _ReaderTy& reader)
+		{
+			reader.read_string(field_base<_Member>::get(obj), static_cast<int>(std::size(field_base<_Member>::get(obj))));
+		}
+	};
+
+	/// <summary>
+	/// Presence bit followed by the field, the field is skipped (and reset on read) when it's value-initialized,
+	/// or when it's an empty string
+	/// </summary>
+	template<typename _FieldTy>
+	struct optional
+	{
+		using class_type = typename _FieldTy::class_type;
+		using value_type = typename _FieldTy::value_type;
+
+		static constexpr bool is_fixed = false;
+		static constexpr int max_bits = 1 + _FieldTy::max_bits;
+
+		[[nodiscard]] static constexpr bool is_present(const class_type& obj) noexcept
+		{
+			if constexpr (std::is_array_v<value_type>)
+				return _FieldTy::get(obj)[0] != 0;
+			else return !(_FieldTy::get(obj) == value_type{ });
+		}
+
+		static constexpr void reset(class_type& obj) noexcept
+		{
+			if constexpr (std::is_array_v<value_type>)
+				std::fill(std::begin(_FieldTy::get(obj)), std::end(_FieldTy::get(obj)), 0);
+			else _FieldTy::get(obj) = value_type{ };
+		}
+
+		template<typename _WriterTy>
+		static void write(const class_type& obj, _WriterTy& writer)
+		{
+			const bool present = is_present(obj);
+			writer.write_bit(present ? 1 : 0);
+			if (present)
+			{
+				if constexpr (_FieldTy::is_fixed)
+					writer.write_ubit(_FieldTy::encode(_FieldTy::get(obj)), _FieldTy::bits);
+				else
+					_FieldTy::write(obj, writer);
+			}
+		}
+
+		template<typename _ReaderTy>
+		static void read(class_type& obj, _ReaderTy& reader)
+		{
+			if (reader.read_bit())
+			{
+				if constexpr (_FieldTy::is_fixed)
+					_FieldTy::get(obj) = _FieldTy::decode(reader.read_ubit(_FieldTy::bits));
+				else
+					_FieldTy::read(obj, reader);
+			}
+			else
+				reset(obj);
+		}
+	};
+
+
+	/// <summary>
+	/// bf_write compatible front-end for px::bitbuf_t
+	/// </summary>
+	template<typename _Traits>
+	class px_writer
+	{
+	public:
+		using buffer_type = px::bitbuf_t<_Traits>;
+
+		px_writer(buffer_type& buf) noexcept : m_Buffer(buf) { }
+
+		void write_bit(int bit)
+		{
+			write_ubit(bit ? 1 : 0, 1);
+		}
+
+		void write_ubit(uint32_t data, int numbits)
+		{
+			// Grows a dynamic buffer, a fixed-size or view buffer overflows once full
+			if (!m_Overflow && !m_Buffer.write_ubits(data, static_cast<size_t>(numbits)))
+				m_Overflow = true;
+		}
+
+		void write_char(int data)
+		{
+			write_ubit(static_cast<uint32_t>(data), 8);
+		}
+
+		void write_uint32(uint32_t data)
+		{
+			bit_writer_impl::write_varint(*this, data);
+		}
+
+		void write_uint64(uint64_t data)
+		{
+			bit_writer_impl::write_varint(*this, data);
+		}
+
+		void write_sint32(int32_t data)
+		{
+			write_uint32(bit_buffer_constants::enconde_zigzag(data));
+		}
+
+		void write_sint64(int64_t data)
+		{
+			write_uint64(bit_buffer_constants::enconde_zigzag(data));
+		}
+
+		void write_coord(const float f)
+		{
+			bit_writer_impl::write_coord(*this, f);
+		}
+
+		bool write_string(const char* str)
+		{
+			bit_writer_impl::write_string(*this, str);
+			return !has_overflown();
+		}
+
+		[[nodiscard]] bool has_overflown() const noexcept { return m_Overflow; }
+
+	private:
+		buffer_type&	m_Buffer;
+		bool			m_Overflow{ };
+	};
+
+	/// <summary>
+	/// bf_read compatible front-end for px::bitbuf_t
+	/// </summary>
+	template<typename _Traits>
+	class px_reader
+	{
+	public:
+		using buffer_type = px::bitbuf_t<_Traits>;
+
+		px_reader(const buffer_type& buf) noexcept : m_Buffer(buf) { }
+
+		[[nodiscard]] int read_bit()
+		{
+			return static_cast<int>(read_ubit(1));
+		}
+
+		[[nodiscard]] uint32_t read_ubit(int numbits)
+		{
+			// Bounded by the buffer's size, a truncated dynamic buffer overflows too
+			uint64_t value{ };
+			if (!m_Overflow && !m_Buffer.read_ubits(value, static_cast<size_t>(numbits)))
+				m_Overflow = true;
+			return static_cast<uint32_t>(value);
+		}
+
+		[[nodiscard]] char read_char()
+		{
+			return static_cast<char>(read_ubit(8));
+		}
+
+		[[nodiscard]] uint32_t read_uint32()
+		{
+			return bit_reader_impl::read_uint32(*this);
+		}
+
+		[[nodiscard]] uint64_t read_uint64()
+		{
+			return bit_reader_impl::read_uint64(*this);
+		}
+
+		[[nodiscard]] int32_t read_int32()
+		{
+			return static_cast<int32_t>(bit_buffer_constants::deconde_zigzag(read_uint32()));
+		}
+
+		[[nodiscard]] int64_t read_int64()
+		{
+			return static_cast<int64_t>(bit_buffer_constants::deconde_zigzag(read_uint64()));
+		}
+
+		[[nodiscard]] float read_coord()
+		{
+			return bit_reader_impl::read_coord(*this);
+		}
+
+		bool read_string(char* str, int maxLen)
+		{
+			return bit_reader_impl::read_string(*this, str, maxLen, false, nullptr);
+		}
+
+		[[nodiscard]] bool has_overflown() const noexcept { return m_Overflow; }
+
+	private:
+		const buffer_type&	m_Buffer;
+		bool				m_Overflow{ };
+	};
+}
+
+
+template<typename... _FieldsTy>
+class bit_schema
+{
+	static_assert(sizeof...(_FieldsTy) > 0);
+
+public:
+	using class_type = typename std::tuple_element_t<0, std::tuple<_FieldsTy...>>::class_type;
+
+	static constexpr size_t field_count = sizeof...(_FieldsTy);
+
+	/// <summary>
+	/// Largest run of fixed-width fields merged into a single read/write
+	/// </summary>
+	static constexpr int fold_bits = 32;
+
+	/// <summary>
+	/// Upper bound of the encoded size, in bits
+	/// </summary>
+	static constexpr int max_bits = (_FieldsTy::max_bits + ...);
+
+	template<typename _WriterTy>
+		requires requires(const _WriterTy& writer) { writer.has_overflown(); }
+	static bool write(const class_type& obj, _WriterTy& writer)
+	{
+		write_from<0>(obj, writer);
+		return !writer.has_overflown();
+	}
+
+	template<typename _Traits>
+	static bool write(const class_type& obj, px::bitbuf_t<_Traits>& buf)
+	{
+		schema::px_writer<_Traits> writer(buf);
+		return write(obj, writer);
+	}
+
+	template<typename _ReaderTy>
+		requires requires(const _ReaderTy& reader) { reader.has_overflown(); }
+	static bool read(class_type& obj, _ReaderTy& reader)
+	{
+		read_from<0>(obj, reader);
+		return !reader.has_overflown();
+	}
+
+	template<typename _Traits>
+	static bool read(class_type& obj, const px::bitbuf_t<_Traits>& buf)
+	{
+		schema::px_reader<_Traits> reader(buf);
+		return read(obj, reader);
+	}
+
+private:
+	template<size_t _Idx>
+	using field_at = std::tuple_element_t<_Idx, std::tuple<_FieldsTy...>>;
+
+	template<typename _FieldTy>
+	static constexpr int fixed_bits() noexcept
+	{
+		if constexpr (_FieldTy::is_fixed)
+			return _FieldTy::bits;
+		else return 0;
+	}
+
+	static constexpr std::array<bool, field_count> is_fixed{ _FieldsTy::is_fixed... };
+	static constexpr std::array<int, field_count> bits{ fixed_bits<_FieldsTy>()... };
+
+	/// <summary>
+	/// One past the last field of the fixed-width run starting at 'first'
+	/// </summary>
+	static constexpr size_t run_end(size_t first) noexcept
+	{
+		int total = 0;
+		size_t i = first;
+		while (i < field_count && is_fixed[i] && total + bits[i] <= fold_bits)
+			total += bits[i++];
+		return i;
+	}
+
+	static constexpr int run_bits(size_t first, size_t last) noexcept
+	{
+		int total = 0;
+		for (size_t i = first; i < last; i++)
+			total += bits[i];
+		return total;
+	}
+
+	template<size_t _First, size_t... _Idx>
+	static uint32_t pack(const class_type& obj, std::index_sequence<_Idx...>) noexcept
+	{
+		return (0u | ... | (field_at<_First + _Idx>::encode(field_at<_First + _Idx>::get(obj)) << run_bits(_First, _First + _Idx)));
+	}
+
+	template<size_t _First, size_t... _Idx>
+	static void unpack(class_type& obj, uint32_t data, std::index_sequence<_Idx...>) noexcept
+	{
+		((field_at<_First + _Idx>::get(obj) = field_at<_First + _Idx>::decode(
+			(data >> run_bits(_First, _First + _Idx)) & static_cast<uint32_t>((1ull << field_at<_First + _Idx>::bits) - 1)
+		)), ...);
+	}
+
+	template<size_t _First, typename _WriterTy>
+	static void write_from(const class_type& obj, _WriterTy& writer)
+	{
+		if constexpr (_First < field_count)
+		{
+			constexpr size_t last = run_end(_First);
+			if constexpr (last == _First)
+			{
+				field_at<_First>::write(obj, writer);
+				write_from<_First + 1>(obj, writer);
+			}
+			else
+			{
+				writer.write_ubit(pack<_First>(obj, std::make_index_sequence<last - _First>{}), run_bits(_First, last));
+				write_from<last>(obj, writer);
+			}
+		}
+	}
+
+	template<size_t _First, typename _ReaderTy>
+	static void read_from(class_type& obj, _ReaderTy& reader)
+	{
+		if constexpr (_First < field_count)
+		{
+			constexpr size_t last = run_end(_First);
+			if constexpr (last == _First)
+			{
+				field_at<_First>::read(obj, reader);
+				read_from<_First + 1>(obj, reader);
+			}
+			else
+			{
+				unpack<_First>(obj, reader.read_ubit(run_bits(_First, last)), std::make_index_sequence<last - _First>{});
+				read_from<last>(obj, reader);
+			}
+		}
+	}
+};
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,46 @@
+// Scaling of DemoPipeline with its worker count, over copies of Data/synth.dem.
+// Run from the Tests directory, frames/s is the throughput of the whole run
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <tf2/engine/DemoPipeline.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	struct DemoSummary
+	{
+		int Ticks{ };
+		int Entities{ };
+	};
+
+	// range(0): workers
+	void BM_DemoPipeline(benchmark::State& state)
+	{
+		const std::vector<std::string> files(64, "Data/synth.dem");
+		const auto num_workers = static_cast<unsigned>(state.range(0));
+
+		DemoPipeline<DemoSummary> pipeline;
+		pipeline.on_message<NET_Tick>([](auto& job, NET_Tick&) { job.Result->Ticks++; });
+		pipeline.on_message<SVC_PacketEntities>([](auto& job, SVC_PacketEntities& message) { job.Result->Entities += message.UpdatedEntries; });
+
+		size_t frames = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(pipeline.run(files, num_workers));
+			frames += pipeline.stats().Totals.Frames;
+		}
+
+		if (pipeline.stats().FailedFiles)
+			state.SkipWithError("Data/synth.dem not found, run from the Tests directory");
+
+		state.counters["frames/s"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+		state.counters["hw_threads"] = std::thread::hardware_concurrency();
+	}
+}
+
+BENCHMARK(BM_DemoPipeline)->ArgName("workers")->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
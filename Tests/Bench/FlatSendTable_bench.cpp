@@ -0,0 +1,100 @@
+// Replays the deltas of each server class of the fixture from a bf_read and from a bf_read_buffered.
+// time/op is the cost of one prop read
+#include <benchmark/benchmark.h>
+#include "../GameProp/FlatSendTableFixture.hpp"
+
+using namespace tf2_tests;
+
+namespace
+{
+	// Ticks replayed per iteration
+	constexpr int Bench_Ticks = 2048;
+
+	struct BenchTables
+	{
+		BenchTables()
+		{
+			Classes = fixture_classes();
+
+			std::vector<uint32_t> words(1 << 14);
+			utils::bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+			write_datatables(writer, Classes);
+
+			utils::bf_read reader(words.data(), writer.bytes_written());
+			Valid = Tables.read_datatables(reader) && Tables.flatten();
+		}
+
+		std::vector<FixtureClass>	Classes;
+		FlatSendTableSet			Tables;
+		bool						Valid{ };
+	};
+
+	const BenchTables& bench_tables()
+	{
+		static const BenchTables tables;
+		return tables;
+	}
+
+
+	// range(0): class id of the fixture
+	template<typename _ReaderTy>
+	void replay_class(benchmark::State& state)
+	{
+		const BenchTables& tables = bench_tables();
+		const FixtureClass& fixture = tables.Classes[state.range(0)];
+		const FlatSendTable* flat = tables.Valid ? tables.Tables.find_class(fixture.ClassID) : nullptr;
+		if (!flat)
+		{
+			state.SkipWithError("fixture tables don't flatten");
+			return;
+		}
+
+		const DeltaReplay replay(*flat, fixture, Bench_Ticks);
+		state.SetLabel(fixture.Name);
+
+		FlatEntityState entity;
+		flat->init_state(entity);
+		for (auto _ : state)
+		{
+			_ReaderTy reader(replay.data(), replay.bytes(), replay.bits());
+			bool res = true;
+			for (size_t i = 0; i < replay.num_ticks(); i++)
+				res &= flat->read_delta(reader, entity);
+
+			if (!res)
+			{
+				state.SkipWithError("bad delta");
+				break;
+			}
+			benchmark::DoNotOptimize(entity.Values.data());
+		}
+
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * replay.bytes());
+		state.counters["time/op"] = benchmark::Counter(
+			static_cast<double>(replay.num_props()),
+			benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+		);
+	}
+
+
+	void BM_replay(benchmark::State& state)
+	{
+		replay_class<utils::bf_read>(state);
+	}
+
+	void BM_replay_buffered(benchmark::State& state)
+	{
+		replay_class<utils::bf_read_buffered>(state);
+	}
+
+
+	void classes(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgName("class")->DenseRange(0, 2);
+	}
+}
+
+BENCHMARK(BM_replay)->Apply(classes);
+BENCHMARK(BM_replay_buffered)->Apply(classes);
+
+BENCHMARK_MAIN();
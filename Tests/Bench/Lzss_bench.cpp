@@ -0,0 +1,96 @@
+// Decompresses each kind of input with LZSS_Decompress and with the port of the engine's decoder, and compresses it.
+// Bytes are counted uncompressed, time/op is the cost of one byte
+#include <benchmark/benchmark.h>
+#include "../Utils/LzssReference.hpp"
+
+using namespace tf2_tests;
+
+namespace
+{
+	// Uncompressed size of the inputs, about a string table update
+	constexpr size_t Bench_Size = 1 << 16;
+
+	const char* input_name(LzssInput kind)
+	{
+		switch (kind)
+		{
+		case LzssInput::Random:	return "random";
+		case LzssInput::Text:	return "text";
+		case LzssInput::Mixed:	return "mixed";
+		default:				return "run";
+		}
+	}
+
+	void set_counters(benchmark::State& state, size_t compressed_size)
+	{
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * Bench_Size);
+		state.counters["ratio"] = static_cast<double>(compressed_size) / Bench_Size;
+		state.counters["time/op"] = benchmark::Counter(
+			static_cast<double>(Bench_Size),
+			benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+		);
+	}
+
+
+	// range(0): LzssInput
+	void BM_decompress(benchmark::State& state, bool engine)
+	{
+		const auto kind = static_cast<LzssInput>(state.range(0));
+		const std::vector<uint8_t> input = make_lzss_input(kind, Bench_Size, 1);
+		std::vector<uint8_t> compressed;
+		if (!LZSS_Compress(input, compressed))
+		{
+			state.SkipWithError("compression failed");
+			return;
+		}
+		state.SetLabel(input_name(kind));
+
+		// The engine's decoder may write up to a match past the end
+		std::vector<uint8_t> output(Bench_Size + Const::LZSS_MaxMatch);
+		for (auto _ : state)
+		{
+			const size_t size = engine ?
+				engine_lzss_uncompress(compressed.data(), output.data()) :
+				LZSS_Decompress(compressed.data(), compressed.size(), output.data(), Bench_Size);
+
+			if (size != Bench_Size)
+			{
+				state.SkipWithError("bad stream");
+				break;
+			}
+			benchmark::DoNotOptimize(output.data());
+		}
+
+		set_counters(state, compressed.size());
+	}
+
+	// range(0): LzssInput
+	void BM_compress(benchmark::State& state)
+	{
+		const auto kind = static_cast<LzssInput>(state.range(0));
+		const std::vector<uint8_t> input = make_lzss_input(kind, Bench_Size, 1);
+		state.SetLabel(input_name(kind));
+
+		std::vector<uint8_t> output(LZSS_CompressBound(Bench_Size));
+		size_t size = 0;
+		for (auto _ : state)
+		{
+			size = LZSS_Compress(input.data(), input.size(), output.data(), output.size());
+			benchmark::DoNotOptimize(output.data());
+		}
+
+		set_counters(state, size);
+	}
+
+
+	void inputs(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgName("input")->DenseRange(static_cast<int>(LzssInput::Random), static_cast<int>(LzssInput::Run));
+	}
+}
+
+BENCHMARK_CAPTURE(BM_decompress, sdk, false)->Apply(inputs);
+BENCHMARK_CAPTURE(BM_decompress, engine, true)->Apply(inputs);
+BENCHMARK(BM_compress)->Apply(inputs);
+
+BENCHMARK_MAIN();
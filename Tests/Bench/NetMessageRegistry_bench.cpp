@@ -0,0 +1,85 @@
+// Replays a stream of net messages through the pooled NetMessageDecoder and through a decoder that allocates every message,
+// as the SDK did before the pools. time/op is the cost of one message
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <tf2/engine/NetMessageRegistry.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	struct ReplayStream
+	{
+		explicit ReplayStream(int ticks)
+		{
+			utils::bf_write writer(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+			for (int i = 0; i < ticks; i++)
+			{
+				NET_Tick(i, 0.015f, 0.001f).WriteToBuffer(writer);
+				if (i % 4 == 0)
+					NET_StringCmd("status").WriteToBuffer(writer);
+				if (i % 16 == 0)
+					NET_SetConVar("cl_interp", "0.0152").WriteToBuffer(writer);
+				NET_SignonState(Const::SignonStateType::Full, i).WriteToBuffer(writer);
+				Messages += 2 + (i % 4 == 0) + (i % 16 == 0);
+			}
+			Bytes = writer.bytes_written();
+		}
+
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1 << 16);
+		int						Bytes{ };
+		int						Messages{ };
+	};
+
+	std::unique_ptr<INetMessage> make_message(uint32_t type)
+	{
+		switch (static_cast<Const::NetMsgType>(type))
+		{
+		case Const::NetMsgType::net_Tick:			return std::make_unique<NET_Tick>();
+		case Const::NetMsgType::net_StringCmd:		return std::make_unique<NET_StringCmd>();
+		case Const::NetMsgType::net_SetConVar:		return std::make_unique<NET_SetConVar>();
+		case Const::NetMsgType::net_SignonState:	return std::make_unique<NET_SignonState>();
+		default:									return nullptr;
+		}
+	}
+
+
+	// range(0): ticks in the stream
+	void BM_decode_allocating(benchmark::State& state)
+	{
+		const ReplayStream stream(static_cast<int>(state.range(0)));
+		for (auto _ : state)
+		{
+			utils::bf_read reader(stream.Words.data(), stream.Bytes);
+			while (reader.bits_left() >= static_cast<int>(Const::NetMsgType_Bits))
+			{
+				auto message = make_message(reader.read_ubit(Const::NetMsgType_Bits));
+				if (!message || !message->ReadFromBuffer(reader))
+					break;
+				benchmark::DoNotOptimize(message.get());
+			}
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * stream.Bytes);
+		state.counters["time/op"] = benchmark::Counter(stream.Messages, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+	}
+
+	void BM_decode_pooled(benchmark::State& state)
+	{
+		const ReplayStream stream(static_cast<int>(state.range(0)));
+		NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+		for (auto _ : state)
+		{
+			utils::bf_read reader(stream.Words.data(), stream.Bytes);
+			benchmark::DoNotOptimize(decoder.decode_all(reader, [](NetMessageHandle& message) { benchmark::DoNotOptimize(message.get()); }));
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * stream.Bytes);
+		state.counters["time/op"] = benchmark::Counter(stream.Messages, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+	}
+}
+
+BENCHMARK(BM_decode_allocating)->Arg(66)->Arg(1024);
+BENCHMARK(BM_decode_pooled)->Arg(66)->Arg(1024);
+
+BENCHMARK_MAIN();
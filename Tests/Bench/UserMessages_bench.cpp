@@ -0,0 +1,139 @@
+// Replays a stream of SVC_UserMessage through UserMessageView, decoding every payload as a client would eagerly,
+// or only the chat messages a chat logger looks at. time/op is the cost of one message
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <tf2/engine/UserMessages.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	struct ReplayStream
+	{
+		explicit ReplayStream(int messages) : Messages(messages)
+		{
+			utils::bf_write writer(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+			std::vector<uint32_t> payload(256);
+			for (int i = 0; i < messages; i++)
+			{
+				SVC_UserMessage message;
+				message.DataOut = utils::bf_write(payload.data(), static_cast<int>(payload.size() * sizeof(uint32_t)));
+				write_payload(message, i);
+				message.WriteToBuffer(writer);
+			}
+			Bytes = writer.bytes_written();
+		}
+
+		// The user messages of a match, stats updates and HUD text outnumber the chat
+		static void write_payload(SVC_UserMessage& message, int i)
+		{
+			auto& data = message.DataOut;
+			switch (i % 8)
+			{
+			case 0:
+				message.MsgType = static_cast<int>(Const::UserMsg::SayText2);
+				data.write_byte(i % 33);
+				data.write_byte(1);
+				data.write_string("#TF_Chat_All");
+				data.write_string("player");
+				data.write_string(("gg " + std::to_string(i)).c_str());
+				data.write_string("");
+				data.write_string("");
+				break;
+
+			case 1:
+			case 2:
+			case 3:
+				message.MsgType = static_cast<int>(Const::UserMsg::PlayerStatsUpdate);
+				data.write_byte(i % 10);
+				// STATMSG_UPDATE
+				data.write_byte(1);
+				data.write_long(0b1000101);
+				data.write_long(10);
+				data.write_long(i);
+				data.write_long(99);
+				break;
+
+			case 4:
+			case 5:
+				message.MsgType = static_cast<int>(Const::UserMsg::HudMsg);
+				data.write_byte(1);
+				data.write_float(0.5f);
+				data.write_float(-1.f);
+				for (int c = 0; c < 8; c++)
+					data.write_byte(c * 31);
+				data.write_byte(2);
+				for (int c = 0; c < 4; c++)
+					data.write_float(static_cast<float>(c));
+				data.write_string("Capture the point!");
+				break;
+
+			case 6:
+				message.MsgType = static_cast<int>(Const::UserMsg::TextMsg);
+				data.write_byte(3);
+				data.write_string("#game_player_joined_team");
+				data.write_string("player");
+				data.write_string("#TF_RedTeam_Name");
+				data.write_string("");
+				data.write_string("");
+				break;
+
+			default:
+				message.MsgType = static_cast<int>(Const::UserMsg::Geiger);
+				data.write_byte(5);
+				break;
+			}
+		}
+
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1 << 18);
+		int						Bytes{ };
+		int						Messages{ };
+	};
+
+
+	// range(0): messages in the stream
+	void BM_user_messages(benchmark::State& state, bool eager)
+	{
+		const ReplayStream stream(static_cast<int>(state.range(0)));
+		UserMessageRegistry registry;
+		SVC_UserMessage message;
+
+		for (auto _ : state)
+		{
+			utils::bf_read reader(stream.Words.data(), stream.Bytes);
+			int decoded = 0;
+			while (reader.bits_left() >= static_cast<int>(Const::NetMsgType_Bits))
+			{
+				if (reader.read_ubit(Const::NetMsgType_Bits) != static_cast<uint32_t>(Const::NetMsgType::svc_UserMessage) ||
+					!message.ReadFromBuffer(reader))
+					break;
+
+				UserMessageView view(registry, message);
+				if (eager)
+					decoded += view.get() != nullptr;
+				else if (auto chat = view.as<UserMsg_SayText2>())
+				{
+					benchmark::DoNotOptimize(chat->Params[1].data());
+					decoded++;
+				}
+			}
+
+			if (!decoded)
+			{
+				state.SkipWithError("bad stream");
+				break;
+			}
+			benchmark::DoNotOptimize(decoded);
+		}
+
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * stream.Bytes);
+		state.counters["time/op"] = benchmark::Counter(stream.Messages, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+	}
+}
+
+BENCHMARK_CAPTURE(BM_user_messages, eager, true)->Arg(64)->Arg(4096);
+BENCHMARK_CAPTURE(BM_user_messages, lazy, false)->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,165 @@
+// The array codecs of bf_write and bf_read against their scalar loops, for ubit fields of several widths, coords and vec3s.
+// bytes_per_second is the size of the encoded stream, time/op the cost of one element
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <tf2/utils/bitbuf.hpp>
+
+using namespace tf2::utils;
+
+namespace
+{
+	// Elements per iteration, a vec3 is one element
+	constexpr int Bench_Count = 4096;
+
+	enum class Codec
+	{
+		UBit,
+		Coord,
+		Vec3
+	};
+
+	struct BenchData
+	{
+		std::vector<uint32_t>	Ints;
+		std::vector<float>		Floats;
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(Bench_Count * 3 * 24 / 32 + 64);
+	};
+
+	BenchData make_data(int bits)
+	{
+		std::mt19937 rng(bits);
+		BenchData data;
+		for (int i = 0; i < Bench_Count; i++)
+			data.Ints.push_back(static_cast<uint32_t>(rng()) & (~0u >> (32 - bits)));
+		for (int i = 0; i < Bench_Count * 3; i++)
+			data.Floats.push_back(static_cast<float>(static_cast<int>(rng() % (1 << 20)) - (1 << 19)) / 32.f);
+		return data;
+	}
+
+	void write(bf_write& writer, Codec codec, bool array, int bits, const BenchData& data)
+	{
+		const auto* vectors = reinterpret_cast<const float(*)[3]>(data.Floats.data());
+		switch (codec)
+		{
+		case Codec::UBit:
+			if (array)
+				writer.write_ubit_array(data.Ints.data(), Bench_Count, bits);
+			else for (int i = 0; i < Bench_Count; i++)
+				writer.write_ubit(data.Ints[i], bits);
+			break;
+
+		case Codec::Coord:
+			if (array)
+				writer.write_coord_array(data.Floats.data(), Bench_Count);
+			else for (int i = 0; i < Bench_Count; i++)
+				writer.write_coord(data.Floats[i]);
+			break;
+
+		case Codec::Vec3:
+			if (array)
+				writer.write_vec3_array(vectors, Bench_Count);
+			else for (int i = 0; i < Bench_Count; i++)
+				writer.write_vec3(vectors[i]);
+			break;
+		}
+	}
+
+	void read(bf_read& reader, Codec codec, bool array, int bits, BenchData& out)
+	{
+		auto* vectors = reinterpret_cast<float(*)[3]>(out.Floats.data());
+		switch (codec)
+		{
+		case Codec::UBit:
+			if (array)
+				reader.read_ubit_array(out.Ints.data(), Bench_Count, bits);
+			else for (int i = 0; i < Bench_Count; i++)
+				out.Ints[i] = reader.read_ubit(bits);
+			break;
+
+		case Codec::Coord:
+			if (array)
+				reader.read_coord_array(out.Floats.data(), Bench_Count);
+			else for (int i = 0; i < Bench_Count; i++)
+				out.Floats[i] = reader.read_coord();
+			break;
+
+		case Codec::Vec3:
+			if (array)
+				reader.read_vec3_array(vectors, Bench_Count);
+			else for (int i = 0; i < Bench_Count; i++)
+				reader.read_vec3(vectors[i]);
+			break;
+		}
+	}
+
+	void set_counters(benchmark::State& state, int stream_bits)
+	{
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * (stream_bits / 8));
+		state.counters["time/op"] = benchmark::Counter(
+			Bench_Count,
+			benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+		);
+	}
+
+
+	// range(0): 1 for the array codec, 0 for the scalar loop, range(1): field width for UBit
+	void BM_array_write(benchmark::State& state, Codec codec)
+	{
+		const bool array = state.range(0);
+		const int bits = static_cast<int>(state.range(1));
+		BenchData data = make_data(bits);
+
+		bf_write writer(data.Words.data(), static_cast<int>(data.Words.size() * sizeof(uint32_t)));
+		for (auto _ : state)
+		{
+			// One bit in, the arrays rarely start on a word
+			writer.seek(1);
+			write(writer, codec, array, bits, data);
+			benchmark::DoNotOptimize(data.Words.data());
+		}
+		set_counters(state, writer.bits_written() - 1);
+	}
+
+	void BM_array_read(benchmark::State& state, Codec codec)
+	{
+		const bool array = state.range(0);
+		const int bits = static_cast<int>(state.range(1));
+		BenchData data = make_data(bits);
+
+		bf_write writer(data.Words.data(), static_cast<int>(data.Words.size() * sizeof(uint32_t)));
+		writer.seek(1);
+		write(writer, codec, array, bits, data);
+
+		bf_read reader(data.Words.data(), writer.bytes_written(), writer.bits_written());
+		for (auto _ : state)
+		{
+			reader.seek(1);
+			read(reader, codec, array, bits, data);
+			benchmark::DoNotOptimize(data.Ints.data());
+			benchmark::DoNotOptimize(data.Floats.data());
+		}
+		set_counters(state, writer.bits_written() - 1);
+	}
+
+
+	void widths(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgNames({ "array", "bits" })->ArgsProduct({ { 0, 1 }, { 1, 7, 11, 17, 32 } });
+	}
+
+	void floats(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgNames({ "array", "bits" })->ArgsProduct({ { 0, 1 }, { 0 } });
+	}
+}
+
+BENCHMARK_CAPTURE(BM_array_write, ubit, Codec::UBit)->Apply(widths);
+BENCHMARK_CAPTURE(BM_array_write, coord, Codec::Coord)->Apply(floats);
+BENCHMARK_CAPTURE(BM_array_write, vec3, Codec::Vec3)->Apply(floats);
+BENCHMARK_CAPTURE(BM_array_read, ubit, Codec::UBit)->Apply(widths);
+BENCHMARK_CAPTURE(BM_array_read, coord, Codec::Coord)->Apply(floats);
+BENCHMARK_CAPTURE(BM_array_read, vec3, Codec::Vec3)->Apply(floats);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,356 @@
+// Throughput of every encoding of bf_write/bf_read, bf_read_buffered and px::bitbuf_t, from aligned and unaligned cursors.
+// bytes_per_second is the size of the encoded stream, time/op the cost of one value
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <tf2/utils/bitbuf_schema.hpp>
+
+using namespace tf2::utils;
+
+namespace
+{
+	enum class Encoding
+	{
+		UBit,
+		SBit,
+		UInt32,
+		UInt64,
+		SInt32,
+		SInt64,
+		Coord,
+		Vec3,
+		Angle,
+		String,
+		Bits
+	};
+
+	// Values per iteration
+	constexpr size_t Bench_Count = 4096;
+	// Bulk bits per value
+	constexpr int Bench_BulkBits = 1024;
+
+	struct BenchValues
+	{
+		std::vector<uint64_t>		Ints;
+		std::vector<float>			Floats;
+		std::vector<std::string>	Strings;
+		std::vector<uint8_t>		Raw;
+	};
+
+	BenchValues make_values(Encoding encoding, int bits)
+	{
+		std::mt19937_64 rng(static_cast<uint64_t>(encoding) * 131 + bits);
+		BenchValues values;
+
+		for (size_t i = 0; i < Bench_Count; i++)
+		{
+			switch (encoding)
+			{
+			case Encoding::UBit:
+			case Encoding::SBit:
+				values.Ints.push_back(rng() & (~0ull >> (64 - bits)));
+				break;
+
+			// Varints of every length
+			case Encoding::UInt32:
+			case Encoding::SInt32:
+				values.Ints.push_back(static_cast<uint32_t>(rng()) >> (rng() % 32));
+				break;
+
+			case Encoding::UInt64:
+			case Encoding::SInt64:
+				values.Ints.push_back(rng() >> (rng() % 64));
+				break;
+
+			case Encoding::Coord:
+			case Encoding::Vec3:
+				for (int j = 0; j < (encoding == Encoding::Vec3 ? 3 : 1); j++)
+					values.Floats.push_back(static_cast<float>(static_cast<int>(rng() % (1 << 20)) - (1 << 19)) / 32.f);
+				break;
+
+			case Encoding::Angle:
+				values.Floats.push_back(static_cast<float>(rng() % 36000) / 100.f);
+				break;
+
+			case Encoding::String:
+				values.Strings.emplace_back(4 + rng() % 28, static_cast<char>('a' + rng() % 26));
+				break;
+
+			case Encoding::Bits:
+				for (int j = 0; j < Bench_BulkBits / 8; j++)
+					values.Raw.push_back(static_cast<uint8_t>(rng()));
+				break;
+			}
+		}
+		return values;
+	}
+
+	template<typename _WriterTy>
+	void write_values(_WriterTy& writer, Encoding encoding, int bits, const BenchValues& values)
+	{
+		switch (encoding)
+		{
+		case Encoding::UBit:	for (uint64_t v : values.Ints) writer.write_ubit(static_cast<uint32_t>(v), bits); break;
+		case Encoding::SBit:	for (uint64_t v : values.Ints) writer.write_sbit(static_cast<int>(v), bits); break;
+		case Encoding::UInt32:	for (uint64_t v : values.Ints) writer.write_uint32(static_cast<uint32_t>(v)); break;
+		case Encoding::UInt64:	for (uint64_t v : values.Ints) writer.write_uint64(v); break;
+		case Encoding::SInt32:	for (uint64_t v : values.Ints) writer.write_sint32(static_cast<int32_t>(v)); break;
+		case Encoding::SInt64:	for (uint64_t v : values.Ints) writer.write_sint64(static_cast<int64_t>(v)); break;
+		case Encoding::Coord:	for (float v : values.Floats) writer.write_coord(v); break;
+		case Encoding::Vec3:	for (size_t i = 0; i < values.Floats.size(); i += 3) writer.write_vec3(&values.Floats[i]); break;
+		case Encoding::Angle:	for (float v : values.Floats) writer.write_angle(v, bits); break;
+		case Encoding::String:	for (const auto& v : values.Strings) writer.write_string(v.c_str()); break;
+		case Encoding::Bits:
+			for (size_t i = 0; i < values.Raw.size(); i += Bench_BulkBits / 8)
+				writer.write_bits(&values.Raw[i], Bench_BulkBits);
+			break;
+		}
+	}
+
+	template<typename _ReaderTy>
+	uint64_t read_values(_ReaderTy& reader, Encoding encoding, int bits)
+	{
+		uint64_t sink = 0;
+		float fsink = 0.f;
+		switch (encoding)
+		{
+		case Encoding::UBit:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_ubit(bits); break;
+		case Encoding::SBit:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_sbit(bits); break;
+		case Encoding::UInt32:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_uint32(); break;
+		case Encoding::UInt64:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_uint64(); break;
+		case Encoding::SInt32:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_int32(); break;
+		case Encoding::SInt64:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_int64(); break;
+		case Encoding::Coord:	for (size_t i = 0; i < Bench_Count; i++) fsink += reader.read_coord(); break;
+		case Encoding::Vec3:
+			for (size_t i = 0; i < Bench_Count; i++)
+			{
+				float v[3];
+				reader.read_vec3(v);
+				fsink += v[0] + v[1] + v[2];
+			}
+			break;
+		case Encoding::Angle:	for (size_t i = 0; i < Bench_Count; i++) fsink += reader.read_angle(bits); break;
+		case Encoding::String:
+			for (size_t i = 0; i < Bench_Count; i++)
+			{
+				char text[64];
+				reader.read_string(text, sizeof(text));
+				sink += static_cast<uint8_t>(text[0]);
+			}
+			break;
+		case Encoding::Bits:
+			for (size_t i = 0; i < Bench_Count; i++)
+			{
+				uint8_t raw[Bench_BulkBits / 8];
+				reader.read_bits(raw, Bench_BulkBits);
+				sink += raw[0];
+			}
+			break;
+		}
+		return sink + static_cast<uint64_t>(fsink);
+	}
+
+	std::vector<uint32_t> make_buffer()
+	{
+		// Large enough for Bench_Count values of the widest encoding
+		return std::vector<uint32_t>(Bench_Count * Bench_BulkBits / 32 + 64);
+	}
+
+	void set_counters(benchmark::State& state, int stream_bits)
+	{
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * (stream_bits / 8));
+		// Seconds per value, printed with its SI prefix (eg: 8.5ns)
+		state.counters["time/op"] = benchmark::Counter(
+			Bench_Count,
+			benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+		);
+	}
+
+
+	// range(0): bit offset of the cursor, range(1): field width for UBit, SBit and Angle
+	void BM_bf_write(benchmark::State& state, Encoding encoding)
+	{
+		const int offset = static_cast<int>(state.range(0));
+		const int bits = static_cast<int>(state.range(1));
+		const BenchValues values = make_values(encoding, bits);
+		auto buffer = make_buffer();
+
+		bf_write writer(buffer.data(), static_cast<int>(buffer.size() * sizeof(uint32_t)));
+		for (auto _ : state)
+		{
+			writer.seek(offset);
+			write_values(writer, encoding, bits, values);
+			benchmark::DoNotOptimize(buffer.data());
+		}
+		set_counters(state, writer.bits_written() - offset);
+	}
+
+	void BM_bf_read(benchmark::State& state, Encoding encoding)
+	{
+		const int offset = static_cast<int>(state.range(0));
+		const int bits = static_cast<int>(state.range(1));
+		const BenchValues values = make_values(encoding, bits);
+		auto buffer = make_buffer();
+
+		bf_write writer(buffer.data(), static_cast<int>(buffer.size() * sizeof(uint32_t)));
+		writer.seek(offset);
+		write_values(writer, encoding, bits, values);
+
+		bf_read reader(buffer.data(), writer.bytes_written(), writer.bits_written());
+		for (auto _ : state)
+		{
+			reader.seek(offset);
+			benchmark::DoNotOptimize(read_values(reader, encoding, bits));
+		}
+		set_counters(state, writer.bits_written() - offset);
+	}
+
+	void BM_bf_read_buffered(benchmark::State& state, Encoding encoding)
+	{
+		const int offset = static_cast<int>(state.range(0));
+		const int bits = static_cast<int>(state.range(1));
+		const BenchValues values = make_values(encoding, bits);
+		auto buffer = make_buffer();
+
+		bf_write writer(buffer.data(), static_cast<int>(buffer.size() * sizeof(uint32_t)));
+		writer.seek(offset);
+		write_values(writer, encoding, bits, values);
+
+		bf_read_buffered reader;
+		for (auto _ : state)
+		{
+			reader.start_reading(buffer.data(), writer.bytes_written(), offset, writer.bits_written());
+			benchmark::DoNotOptimize(read_values(reader, encoding, bits));
+		}
+		set_counters(state, writer.bits_written() - offset);
+	}
+
+
+	// px::bitbuf_t through the schema front-ends, for the encodings they share with bf_write
+	template<typename _Ty>
+	void write_px_values(_Ty& writer, Encoding encoding, int bits, const BenchValues& values)
+	{
+		switch (encoding)
+		{
+		case Encoding::UBit:	for (uint64_t v : values.Ints) writer.write_ubit(static_cast<uint32_t>(v), bits); break;
+		case Encoding::UInt32:	for (uint64_t v : values.Ints) writer.write_uint32(static_cast<uint32_t>(v)); break;
+		case Encoding::UInt64:	for (uint64_t v : values.Ints) writer.write_uint64(v); break;
+		case Encoding::SInt32:	for (uint64_t v : values.Ints) writer.write_sint32(static_cast<int32_t>(v)); break;
+		case Encoding::SInt64:	for (uint64_t v : values.Ints) writer.write_sint64(static_cast<int64_t>(v)); break;
+		case Encoding::Coord:	for (float v : values.Floats) writer.write_coord(v); break;
+		case Encoding::String:	for (const auto& v : values.Strings) writer.write_string(v.c_str()); break;
+		default: break;
+		}
+	}
+
+	template<typename _Ty>
+	uint64_t read_px_values(_Ty& reader, Encoding encoding, int bits)
+	{
+		uint64_t sink = 0;
+		float fsink = 0.f;
+		switch (encoding)
+		{
+		case Encoding::UBit:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_ubit(bits); break;
+		case Encoding::UInt32:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_uint32(); break;
+		case Encoding::UInt64:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_uint64(); break;
+		case Encoding::SInt32:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_int32(); break;
+		case Encoding::SInt64:	for (size_t i = 0; i < Bench_Count; i++) sink += reader.read_int64(); break;
+		case Encoding::Coord:	for (size_t i = 0; i < Bench_Count; i++) fsink += reader.read_coord(); break;
+		case Encoding::String:
+			for (size_t i = 0; i < Bench_Count; i++)
+			{
+				char text[64];
+				reader.read_string(text, sizeof(text));
+				sink += static_cast<uint8_t>(text[0]);
+			}
+			break;
+		default: break;
+		}
+		return sink + static_cast<uint64_t>(fsink);
+	}
+
+	void BM_px_write(benchmark::State& state, Encoding encoding)
+	{
+		const int offset = static_cast<int>(state.range(0));
+		const int bits = static_cast<int>(state.range(1));
+		const BenchValues values = make_values(encoding, bits);
+
+		px::bitbuf buffer;
+		for (auto _ : state)
+		{
+			buffer.write_set(0);
+			schema::px_writer writer(buffer);
+			if (offset)
+				writer.write_ubit(0, offset);
+			write_px_values(writer, encoding, bits, values);
+			benchmark::DoNotOptimize(buffer.data());
+		}
+		set_counters(state, static_cast<int>(buffer.write_get()) - offset);
+	}
+
+	void BM_px_read(benchmark::State& state, Encoding encoding)
+	{
+		const int offset = static_cast<int>(state.range(0));
+		const int bits = static_cast<int>(state.range(1));
+		const BenchValues values = make_values(encoding, bits);
+
+		px::bitbuf buffer;
+		schema::px_writer writer(buffer);
+		if (offset)
+			writer.write_ubit(0, offset);
+		write_px_values(writer, encoding, bits, values);
+
+		for (auto _ : state)
+		{
+			buffer.read_set(offset);
+			schema::px_reader reader(buffer);
+			benchmark::DoNotOptimize(read_px_values(reader, encoding, bits));
+		}
+		set_counters(state, static_cast<int>(buffer.write_get()) - offset);
+	}
+
+
+	// 0 and 8 are byte-aligned, where bf_read takes its aligned paths for varints, strings and bulk bits
+	const std::vector<int64_t> Bench_Offsets{ 0, 1, 3, 7, 8 };
+
+	void widths(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgNames({ "offset", "bits" })->ArgsProduct({ Bench_Offsets, { 1, 5, 8, 13, 17, 32 } });
+	}
+
+	void angle_widths(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgNames({ "offset", "bits" })->ArgsProduct({ Bench_Offsets, { 8, 16 } });
+	}
+
+	void offsets(benchmark::internal::Benchmark* bench)
+	{
+		bench->ArgNames({ "offset", "bits" })->ArgsProduct({ Bench_Offsets, { 0 } });
+	}
+}
+
+#define BITBUF_BENCH(IMPL)																	\
+	BENCHMARK_CAPTURE(IMPL, ubit, Encoding::UBit)->Apply(widths);							\
+	BENCHMARK_CAPTURE(IMPL, uint32, Encoding::UInt32)->Apply(offsets);						\
+	BENCHMARK_CAPTURE(IMPL, uint64, Encoding::UInt64)->Apply(offsets);						\
+	BENCHMARK_CAPTURE(IMPL, sint32, Encoding::SInt32)->Apply(offsets);						\
+	BENCHMARK_CAPTURE(IMPL, sint64, Encoding::SInt64)->Apply(offsets);						\
+	BENCHMARK_CAPTURE(IMPL, coord, Encoding::Coord)->Apply(offsets);						\
+	BENCHMARK_CAPTURE(IMPL, string, Encoding::String)->Apply(offsets)
+
+#define BF_BENCH(IMPL)																		\
+	BITBUF_BENCH(IMPL);																		\
+	BENCHMARK_CAPTURE(IMPL, sbit, Encoding::SBit)->Apply(widths);							\
+	BENCHMARK_CAPTURE(IMPL, vec3, Encoding::Vec3)->Apply(offsets);							\
+	BENCHMARK_CAPTURE(IMPL, angle, Encoding::Angle)->Apply(angle_widths);					\
+	BENCHMARK_CAPTURE(IMPL, bits, Encoding::Bits)->Apply(offsets)
+
+BF_BENCH(BM_bf_write);
+BF_BENCH(BM_bf_read);
+BF_BENCH(BM_bf_read_buffered);
+BITBUF_BENCH(BM_px_write);
+BITBUF_BENCH(BM_px_read);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+// Cost of growing a px::bitbuf_t from empty: geometric growth alone, with reserve_bits up front, and from the per-thread arena.
+// allocs/iter counts the calls reaching the memory resource for one filled buffer
+#include <memory_resource>
+
+#include <benchmark/benchmark.h>
+#include <px/bitbuf.hpp>
+
+namespace
+{
+	struct CountingResource : std::pmr::memory_resource
+	{
+		explicit CountingResource(std::pmr::memory_resource* upstream) noexcept :
+			Upstream(upstream)
+		{ }
+
+		std::pmr::memory_resource*	Upstream;
+		size_t						Allocations = 0;
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			Allocations++;
+			return Upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			Upstream->deallocate(ptr, bytes, alignment);
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+	enum class Growth
+	{
+		Geometric,
+		Reserved,
+		Arena
+	};
+
+	// range(0): 32-bit values appended, each followed by a single bit to keep the cursor unaligned
+	void BM_px_bitbuf_fill(benchmark::State& state, Growth growth)
+	{
+		const int count = static_cast<int>(state.range(0));
+		const size_t bits = static_cast<size_t>(count) * 33;
+
+		CountingResource counter(growth == Growth::Arena ? px::bitbuf_arena::resource() : std::pmr::new_delete_resource());
+		for (auto _ : state)
+		{
+			{
+				px::bitbuf_pmr buffer{ &counter };
+				if (growth != Growth::Geometric)
+					buffer.reserve_bits(bits);
+
+				for (int i = 0; i < count; i++)
+					buffer << i << px::bit_type::one;
+				benchmark::DoNotOptimize(buffer.data());
+			}
+			if (growth == Growth::Arena)
+				px::bitbuf_arena::recycle();
+		}
+
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bits / 8));
+		state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(counter.Allocations), benchmark::Counter::kAvgIterations);
+	}
+}
+
+BENCHMARK_CAPTURE(BM_px_bitbuf_fill, geometric, Growth::Geometric)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_CAPTURE(BM_px_bitbuf_fill, reserved, Growth::Reserved)->RangeMultiplier(16)->Range(64, 16384);
+BENCHMARK_CAPTURE(BM_px_bitbuf_fill, arena, Growth::Arena)->RangeMultiplier(16)->Range(64, 16384);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,268 @@
+// Writes the synthetic demo used by the demo tests: a SignOn packet, then one Packet and one UserCmd frame per tick
+// from SynthDemo_FirstTick to SynthDemo_LastTick, each packet carrying every svc_ message the SDK can write.
+// Usage: make_synth_demo <output.dem>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <tf2/engine/DemoFile.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	constexpr int SynthDemo_FirstTick = 10;
+	constexpr int SynthDemo_LastTick = 210;
+
+	class DemoWriter
+	{
+	public:
+		void put(const void* data, size_t size)
+		{
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			Bytes.insert(Bytes.end(), bytes, bytes + size);
+		}
+
+		void put_int(int value)
+		{
+			put(&value, sizeof(value));
+		}
+
+		void frame(Const::DemoCommand command, int tick)
+		{
+			const auto cmd = static_cast<uint8_t>(command);
+			put(&cmd, sizeof(cmd));
+			put_int(tick);
+		}
+
+		void packet(Const::DemoCommand command, int tick, const utils::bf_write& buffer)
+		{
+			frame(command, tick);
+
+			DemoCmdInfo info{ };
+			info.Flags = 7;
+			put(&info, sizeof(info));
+			put_int(1);
+			put_int(2);
+			put_int(buffer.bytes_written());
+			put(buffer.data(), buffer.bytes_written());
+		}
+
+		std::vector<uint8_t> Bytes;
+	};
+
+	bool write(INetMessage& message, utils::bf_write& buffer)
+	{
+		if (message.WriteToBuffer(buffer))
+			return true;
+
+		std::fprintf(stderr, "failed to write %s\n", message.GetName());
+		return false;
+	}
+
+	template<typename _MsgTy>
+	utils::bf_write& payload(_MsgTy& message, std::vector<uint32_t>& words)
+	{
+		std::fill(words.begin(), words.end(), 0);
+		message.DataOut = utils::bf_write(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+		return message.DataOut;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		std::fprintf(stderr, "usage: %s <output.dem>\n", argv[0]);
+		return 1;
+	}
+
+	DemoWriter demo;
+	bool ok = true;
+
+	DemoHeader header{ };
+	std::memcpy(header.FileStamp, "HL2DEMO", 8);
+	header.DemoProtocol = 3;
+	header.NetworkProtocol = 24;
+	std::strcpy(header.MapName, "cp_test");
+	demo.put(&header, sizeof(header));
+
+	std::vector<uint32_t> words(8192), sub_words(1024);
+	{
+		utils::bf_write buffer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+
+		SVC_ServerInfo server_info;
+		server_info.Protocol = 24;
+		server_info.ServerCount = 3;
+		server_info.IsHLTV = true;
+		server_info.IsDedicated = true;
+		server_info.MaxClasses = 350;
+		std::memset(server_info.MapMD5.bits, 0xAB, sizeof(server_info.MapMD5.bits));
+		server_info.PlayerSlot = 5;
+		server_info.MaxClients = 24;
+		server_info.fTickInterval = 0.015f;
+		server_info.GameDir = "tf";
+		server_info.MapName = "cp_test";
+		server_info.SkyName = "sky";
+		server_info.HostName = "host";
+		server_info.IsReplay = false;
+		*reinterpret_cast<char*>(&server_info.OS) = 'L';
+		ok &= write(server_info, buffer);
+
+		SVC_ClassInfo class_info(false, 3);
+		for (int i = 0; i < 3; i++)
+		{
+			SVC_ClassInfo::class_t server_class{ };
+			server_class.classID = i;
+			std::snprintf(server_class.classname, sizeof(server_class.classname), "CClass%d", i);
+			std::snprintf(server_class.datatablename, sizeof(server_class.datatablename), "DT_%d", i);
+			class_info.Classes.push_to_tail(server_class);
+		}
+		ok &= write(class_info, buffer);
+
+		SVC_CreateStringTable create_table;
+		payload(create_table, sub_words).write_ubit(0x1234, 13);
+		create_table.TableName = "downloadables";
+		create_table.IsFilenames = true;
+		create_table.MaxEntries = 4096;
+		create_table.NumEntries = 17;
+		create_table.UserDataFixedSize = true;
+		create_table.UserDataSize = 2;
+		create_table.UserDataSizeBits = 9;
+		create_table.DataCompressed = false;
+		ok &= write(create_table, buffer);
+
+		SVC_VoiceInit voice_init("vaudio_celt", 12, 22050);
+		ok &= write(voice_init, buffer);
+
+		NET_SignonState signon(Const::SignonStateType::New, 3);
+		ok &= write(signon, buffer);
+
+		demo.packet(Const::DemoCommand::SignOn, 0, buffer);
+	}
+
+	demo.frame(Const::DemoCommand::SyncTick, 0);
+
+	demo.frame(Const::DemoCommand::ConsoleCmd, 1);
+	demo.put_int(8);
+	demo.put("echo hi", 8);
+
+	demo.frame(Const::DemoCommand::DataTables, 1);
+	demo.put_int(3);
+	demo.put("abc", 3);
+
+	for (int tick = SynthDemo_FirstTick; tick < SynthDemo_LastTick; tick++)
+	{
+		std::fill(words.begin(), words.end(), 0);
+		utils::bf_write buffer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+
+		NET_Tick net_tick(tick, 0.015f, 0.f);
+		ok &= write(net_tick, buffer);
+
+		SVC_PacketEntities entities;
+		auto& entity_data = payload(entities, sub_words);
+		for (int i = 0; i < tick; i++)
+			entity_data.write_ubit(i, 7);
+		entities.MaxEntries = 2048;
+		entities.IsDelta = tick & 1;
+		entities.DeltaFrom = tick - 1;
+		entities.Baseline = 1;
+		entities.UpdatedEntries = tick % 50;
+		entities.UpdateBaseline = false;
+		ok &= write(entities, buffer);
+
+		SVC_UserMessage user_message;
+		payload(user_message, sub_words).write_string("hello");
+		user_message.MsgType = 4;
+		ok &= write(user_message, buffer);
+
+		SVC_GameEvent game_event;
+		payload(game_event, sub_words).write_ubit(tick, 9);
+		ok &= write(game_event, buffer);
+
+		SVC_TempEntities temp_entities;
+		payload(temp_entities, sub_words).write_ubit(1, 3);
+		temp_entities.NumEntries = 2;
+		ok &= write(temp_entities, buffer);
+
+		SVC_Sounds sounds;
+		payload(sounds, sub_words).write_ubit(5, 20);
+		sounds.ReliableSound = tick % 3 == 0;
+		sounds.NumSounds = 1;
+		ok &= write(sounds, buffer);
+
+		SVC_FixAngle fix_angle(true, Angle_F{ 10.f, 20.f, 30.f });
+		ok &= write(fix_angle, buffer);
+
+		SVC_CrosshairAngle crosshair(Angle_F{ 1.f, 2.f, 3.f });
+		ok &= write(crosshair, buffer);
+
+		SVC_BSPDecal decal;
+		decal.Pos = { 1.5f, -2.f, 300.25f };
+		decal.DecalTextureIndex = 33;
+		decal.EntityIndex = tick % 2 ? 5 : 0;
+		decal.ModelIndex = 77;
+		decal.LowPriority = true;
+		ok &= write(decal, buffer);
+
+		SVC_SetPauseTimed pause_timed(true, 2.5f);
+		ok &= write(pause_timed, buffer);
+
+		SVC_GetCvarValue get_cvar(99, "sv_cheats");
+		ok &= write(get_cvar, buffer);
+
+		SVC_Print print("print me");
+		ok &= write(print, buffer);
+
+		SVC_UpdateStringTable update_table;
+		payload(update_table, sub_words).write_ubit(3, 5);
+		update_table.TableID = 7;
+		update_table.ChangedEntries = tick % 2 ? 1 : 12;
+		ok &= write(update_table, buffer);
+
+		SVC_Prefetch prefetch;
+		prefetch.SoundIndex = 1000;
+		ok &= write(prefetch, buffer);
+
+		SVC_SetView set_view(3);
+		ok &= write(set_view, buffer);
+
+		SVC_EntityMessage entity_message;
+		payload(entity_message, sub_words).write_ubit(3, 5);
+		entity_message.EntityIndex = 9;
+		entity_message.ClassID = 100;
+		ok &= write(entity_message, buffer);
+
+		SVC_GameEventList event_list;
+		payload(event_list, sub_words).write_ubit(3, 5);
+		event_list.NumEvents = 200;
+		ok &= write(event_list, buffer);
+
+		SVC_SetPause pause(false);
+		ok &= write(pause, buffer);
+
+		demo.packet(Const::DemoCommand::Packet, tick, buffer);
+
+		demo.frame(Const::DemoCommand::UserCmd, tick);
+		demo.put_int(tick);
+		demo.put_int(2);
+		demo.put("uc", 2);
+	}
+
+	demo.frame(Const::DemoCommand::Stop, SynthDemo_LastTick);
+
+	if (!ok)
+		return 1;
+
+	FILE* file = std::fopen(argv[1], "wb");
+	if (!file)
+	{
+		std::fprintf(stderr, "can't open %s\n", argv[1]);
+		return 1;
+	}
+
+	const bool written = std::fwrite(demo.Bytes.data(), 1, demo.Bytes.size(), file) == demo.Bytes.size();
+	std::fclose(file);
+	return written ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+// Parses Data/synth.dem, written by Data/make_synth_demo.cpp
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/DemoFile.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	constexpr const char* SynthDemo_Path = "Data/synth.dem";
+	constexpr int SynthDemo_FirstTick = 10;
+	constexpr int SynthDemo_LastTick = 210;
+	constexpr int SynthDemo_Ticks = SynthDemo_LastTick - SynthDemo_FirstTick;
+
+	// Every tick's packet
+	constexpr int SynthDemo_MessagesPerPacket = 18;
+	// svc_ServerInfo, svc_ClassInfo, svc_CreateStringTable, svc_VoiceInit, net_SignonState
+	constexpr int SynthDemo_SignOnMessages = 5;
+
+	std::vector<uint8_t> load_fixture()
+	{
+		std::ifstream file(SynthDemo_Path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	}
+}
+
+
+TEST(DemoFile, ReadsHeaderAndFrames)
+{
+	DemoFile demo(SynthDemo_Path);
+	ASSERT_TRUE(demo.is_open());
+	EXPECT_STREQ(demo.header().MapName, "cp_test");
+	EXPECT_EQ(demo.header().NetworkProtocol, 24);
+
+	std::array<int, 16> commands{ };
+	DemoFrame frame;
+	while (demo.read_frame(frame))
+	{
+		commands[static_cast<size_t>(frame.Command)]++;
+		if (frame.Command == Const::DemoCommand::ConsoleCmd)
+			EXPECT_STREQ(reinterpret_cast<const char*>(frame.Data), "echo hi");
+		else if (frame.Command == Const::DemoCommand::UserCmd)
+		{
+			EXPECT_EQ(frame.OutgoingSequence, frame.Tick);
+			EXPECT_EQ(frame.Size, 2);
+		}
+	}
+
+	EXPECT_FALSE(demo.is_truncated());
+	EXPECT_EQ(demo.tell(), demo.size());
+	EXPECT_EQ(commands[static_cast<size_t>(Const::DemoCommand::SignOn)], 1);
+	EXPECT_EQ(commands[static_cast<size_t>(Const::DemoCommand::Packet)], SynthDemo_Ticks);
+	EXPECT_EQ(commands[static_cast<size_t>(Const::DemoCommand::UserCmd)], SynthDemo_Ticks);
+	EXPECT_EQ(commands[static_cast<size_t>(Const::DemoCommand::SyncTick)], 1);
+	EXPECT_EQ(commands[static_cast<size_t>(Const::DemoCommand::DataTables)], 1);
+}
+
+TEST(DemoFile, DecodesEveryMessage)
+{
+	DemoFile demo(SynthDemo_Path);
+	ASSERT_TRUE(demo.is_open());
+
+	NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+	std::array<int, Const::NetMsgType_Max> counts{ };
+	int mismatches = 0;
+
+	const DemoReadStats stats = demo.read_messages(decoder, [&](const DemoFrame& frame, NetMessageHandle& message)
+		{
+			counts[static_cast<size_t>(message->GetType())]++;
+			switch (message->GetType())
+			{
+			case Const::NetMsgType::net_Tick:
+			{
+				mismatches += message.as<NET_Tick>()->Tick != frame.Tick;
+				break;
+			}
+			case Const::NetMsgType::svc_ServerInfo:
+			{
+				const auto* info = message.as<SVC_ServerInfo>();
+				EXPECT_EQ(info->MaxClasses, 350);
+				EXPECT_EQ(info->PlayerSlot, 5);
+				EXPECT_STREQ(info->MapName, "cp_test");
+				EXPECT_STREQ(info->HostName, "host");
+				break;
+			}
+			case Const::NetMsgType::svc_ClassInfo:
+			{
+				const auto* info = message.as<SVC_ClassInfo>();
+				ASSERT_EQ(info->NumServerClasses, 3);
+				EXPECT_STREQ(info->Classes[2].datatablename, "DT_2");
+				break;
+			}
+			case Const::NetMsgType::svc_CreateStringTable:
+			{
+				const auto* table = message.as<SVC_CreateStringTable>();
+				EXPECT_STREQ(table->TableName, "downloadables");
+				EXPECT_EQ(table->NumEntries, 17);
+				utils::bf_read data = table->DataIn;
+				EXPECT_EQ(data.read_ubit(13), 0x1234u);
+				break;
+			}
+			case Const::NetMsgType::svc_PacketEntities:
+			{
+				const auto* entities = message.as<SVC_PacketEntities>();
+				mismatches += entities->Length != frame.Tick * 7 || entities->UpdatedEntries != frame.Tick % 50;
+
+				utils::bf_read data = entities->DataIn;
+				for (int i = 0; i < frame.Tick; i++)
+					mismatches += data.read_ubit(7) != static_cast<uint32_t>(i & 127);
+				break;
+			}
+			case Const::NetMsgType::svc_UserMessage:
+			{
+				const auto* user_message = message.as<SVC_UserMessage>();
+				char text[16];
+				utils::bf_read data = user_message->DataIn;
+				mismatches += !data.read_string(text, sizeof(text)) || std::strcmp(text, "hello") || user_message->MsgType != 4;
+				break;
+			}
+			case Const::NetMsgType::svc_GameEvent:
+			{
+				utils::bf_read data = message.as<SVC_GameEvent>()->DataIn;
+				mismatches += data.read_ubit(9) != static_cast<uint32_t>(frame.Tick);
+				break;
+			}
+			case Const::NetMsgType::svc_BSPDecal:
+			{
+				const auto* decal = message.as<SVC_BSPDecal>();
+				mismatches += decal->DecalTextureIndex != 33 || std::abs(decal->Pos[2] - 300.25f) > 0.1f || decal->EntityIndex != (frame.Tick % 2 ? 5 : 0);
+				break;
+			}
+			case Const::NetMsgType::svc_GetCvarValue:
+			{
+				const auto* get_cvar = message.as<SVC_GetCvarValue>();
+				mismatches += get_cvar->Cookie != 99 || std::strcmp(get_cvar->CvarName, "sv_cheats");
+				break;
+			}
+			case Const::NetMsgType::svc_Print:
+			{
+				mismatches += std::strcmp(message.as<SVC_Print>()->Text, "print me") != 0;
+				break;
+			}
+			default:
+				break;
+			}
+		});
+
+	EXPECT_EQ(mismatches, 0);
+	EXPECT_EQ(stats.BadPackets, 0u);
+	EXPECT_EQ(stats.Packets, static_cast<size_t>(SynthDemo_Ticks + 1));
+	EXPECT_EQ(stats.Messages, static_cast<size_t>(SynthDemo_Ticks * SynthDemo_MessagesPerPacket + SynthDemo_SignOnMessages));
+	EXPECT_GT(stats.frames_per_second(), 0.);
+
+	EXPECT_EQ(counts[static_cast<size_t>(Const::NetMsgType::net_Tick)], SynthDemo_Ticks);
+	EXPECT_EQ(counts[static_cast<size_t>(Const::NetMsgType::svc_PacketEntities)], SynthDemo_Ticks);
+	EXPECT_EQ(counts[static_cast<size_t>(Const::NetMsgType::svc_ServerInfo)], 1);
+	EXPECT_EQ(decoder.tick(), SynthDemo_LastTick - 1);
+}
+
+TEST(DemoFile, TruncatedDemo)
+{
+	const std::vector<uint8_t> bytes = load_fixture();
+	ASSERT_FALSE(bytes.empty());
+
+	DemoFile demo;
+	ASSERT_TRUE(demo.open(bytes.data(), bytes.size() - 10));
+
+	DemoFrame frame;
+	int frames = 0;
+	while (demo.read_frame(frame))
+		frames++;
+
+	EXPECT_TRUE(demo.is_truncated());
+	EXPECT_GT(frames, 0);
+}
+
+TEST(DemoFile, RejectsBadStamp)
+{
+	std::vector<uint8_t> bytes = load_fixture();
+	ASSERT_FALSE(bytes.empty());
+	bytes[0] = 'X';
+
+	DemoFile demo;
+	EXPECT_FALSE(demo.open(bytes.data(), bytes.size()));
+	EXPECT_FALSE(demo.is_open());
+	EXPECT_FALSE(DemoFile("Data/missing.dem").is_open());
+}
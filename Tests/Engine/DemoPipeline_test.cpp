@@ -0,0 +1,112 @@
+// Runs the pipeline over copies of Data/synth.dem, written by Data/make_synth_demo.cpp
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/DemoPipeline.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	constexpr const char* SynthDemo_Path = "Data/synth.dem";
+	constexpr int SynthDemo_Ticks = 200;
+
+	struct DemoSummary
+	{
+		size_t				FileIndex{ };
+		int					Ticks{ };
+		int					Entities{ };
+		std::string_view	SayText;
+	};
+}
+
+
+TEST(DemoPipeline, ResultsInFileOrder)
+{
+	std::vector<std::string> files(12, SynthDemo_Path);
+	files[5] = "Data/missing.dem";
+
+	DemoPipeline<DemoSummary> pipeline;
+	pipeline.on_message<NET_Tick>([](auto& job, NET_Tick&) { job.Result->FileIndex = job.FileIndex; job.Result->Ticks++; });
+	pipeline.on_message<SVC_PacketEntities>([](auto& job, SVC_PacketEntities&) { job.Result->Entities++; });
+	pipeline.on_user_message(
+		Const::UserMsg::SayText2,
+		[](auto& job, const SVC_UserMessage&, utils::bf_read& payload)
+		{
+			char text[16];
+			if (payload.read_string(text, sizeof(text)))
+				job.Result->SayText = job.intern(text);
+		}
+	);
+
+	const auto results = pipeline.run(files, 4);
+	ASSERT_EQ(results.size(), files.size());
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (i == 5)
+		{
+			EXPECT_EQ(results[i].Ticks, 0);
+			continue;
+		}
+
+		EXPECT_EQ(results[i].FileIndex, i);
+		EXPECT_EQ(results[i].Ticks, SynthDemo_Ticks);
+		EXPECT_EQ(results[i].Entities, SynthDemo_Ticks);
+		EXPECT_EQ(results[i].SayText, "hello");
+	}
+
+	const auto& stats = pipeline.stats();
+	EXPECT_EQ(stats.Files, files.size());
+	EXPECT_EQ(stats.FailedFiles, 1u);
+	EXPECT_EQ(stats.Totals.BadPackets, 0u);
+	EXPECT_EQ(stats.Totals.Packets, (files.size() - 1) * (SynthDemo_Ticks + 1));
+}
+
+TEST(DemoPipeline, SameTotalsWhateverTheWorkers)
+{
+	const std::vector<std::string> files(8, SynthDemo_Path);
+
+	DemoPipeline<DemoSummary> pipeline;
+	pipeline.on_message<NET_Tick>([](auto& job, NET_Tick&) { job.Result->Ticks++; });
+
+	(void)pipeline.run(files, 1);
+	const DemoPipelineStats single = pipeline.stats();
+
+	(void)pipeline.run(files, 4);
+	const DemoPipelineStats parallel = pipeline.stats();
+
+	EXPECT_EQ(single.Totals.Frames, parallel.Totals.Frames);
+	EXPECT_EQ(single.Totals.Packets, parallel.Totals.Packets);
+	EXPECT_EQ(single.Totals.Messages, parallel.Totals.Messages);
+}
+
+TEST(DemoPipeline, CallbackExceptionCancelsRun)
+{
+	constexpr unsigned num_workers = 4;
+	const std::vector<std::string> files(32, SynthDemo_Path);
+
+	std::atomic<bool> thrown{ };
+	std::atomic<int> ticks_after_throw{ };
+
+	DemoPipeline<DemoSummary> pipeline;
+	pipeline.on_message<NET_Tick>(
+		[&](auto& job, NET_Tick&)
+		{
+			if (thrown)
+				ticks_after_throw++;
+			else if (job.FileIndex == 0)
+			{
+				thrown = true;
+				throw std::runtime_error("callback failed");
+			}
+		}
+	);
+
+	EXPECT_THROW((void)pipeline.run(files, num_workers), std::runtime_error);
+	// The other workers stop at their next frame once the exception is caught, the thrower can be preempted
+	// before that so the bound is loose, but far from the remaining demos
+	EXPECT_LT(ticks_after_throw, SynthDemo_Ticks * static_cast<int>(files.size()) / 4);
+}
@@ -0,0 +1,227 @@
+// GameEventDecoder on a SVC_GameEventList and the SVC_GameEvent messages written with its descriptors
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/GameEventDecoder.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	constexpr int PlayerDeath_ID = 23;
+	constexpr int RoundStart_ID = 200;
+	constexpr int Unknown_ID = 7;
+
+	struct Payload
+	{
+		Payload()
+		{
+			Writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+		}
+
+		// DataIn and Length as SVC_GameEvent::ReadFromBuffer leaves them
+		template<typename _Ty>
+		void attach(_Ty& message) const
+		{
+			message.DataIn = utils::bf_read(Words.data(), Writer.bytes_written(), Writer.bits_written());
+			message.Length = Writer.bits_written();
+		}
+
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1024);
+		utils::bf_write			Writer;
+	};
+
+	void write_key(utils::bf_write& writer, Const::GameEventKeyType type, const char* name)
+	{
+		writer.write_ubit(static_cast<uint32_t>(type), Const::GameEvent_KeyTypeBits);
+		writer.write_string(name);
+	}
+
+	void write_descriptors(utils::bf_write& writer)
+	{
+		using Type = Const::GameEventKeyType;
+
+		writer.write_ubit(PlayerDeath_ID, Const::NetMsg_GameEventsBits);
+		writer.write_string("player_death");
+		write_key(writer, Type::Short, "userid");
+		write_key(writer, Type::Short, "attacker");
+		write_key(writer, Type::String, "weapon");
+		write_key(writer, Type::Long, "damagebits");
+		write_key(writer, Type::Float, "distance");
+		write_key(writer, Type::Byte, "crit_type");
+		write_key(writer, Type::Bool, "silent_kill");
+		write_key(writer, Type::UInt64, "steamid");
+		writer.write_ubit(static_cast<uint32_t>(Type::Local), Const::GameEvent_KeyTypeBits);
+
+		// Out of id order, without keys
+		writer.write_ubit(RoundStart_ID, Const::NetMsg_GameEventsBits);
+		writer.write_string("teamplay_round_start");
+		writer.write_ubit(static_cast<uint32_t>(Type::Local), Const::GameEvent_KeyTypeBits);
+	}
+
+	void write_player_death(utils::bf_write& writer, short attacker, const char* weapon)
+	{
+		writer.write_ubit(PlayerDeath_ID, Const::NetMsg_GameEventsBits);
+		writer.write_short(12);
+		writer.write_short(attacker);
+		writer.write_string(weapon);
+		writer.write_long(-65536);
+		writer.write_float(812.5f);
+		writer.write_byte(2);
+		writer.write_bit(1);
+		writer.write_longlong(static_cast<int64_t>(76561197960287930ull));
+	}
+
+	GameEventDecoder make_decoder()
+	{
+		Payload payload;
+		write_descriptors(payload.Writer);
+
+		SVC_GameEventList list;
+		list.NumEvents = 2;
+		payload.attach(list);
+
+		GameEventDecoder decoder;
+		EXPECT_TRUE(decoder.read_descriptors(list));
+		return decoder;
+	}
+}
+
+
+TEST(GameEventDecoder, Descriptors)
+{
+	const GameEventDecoder decoder = make_decoder();
+	ASSERT_EQ(decoder.size(), 2u);
+
+	auto death = decoder.descriptor(PlayerDeath_ID);
+	ASSERT_NE(death, nullptr);
+	EXPECT_EQ(death->EventID, PlayerDeath_ID);
+	EXPECT_EQ(death->Name, "player_death");
+	ASSERT_EQ(death->Fields.size(), 8u);
+	EXPECT_EQ(death->Fields[2].Key, "weapon");
+	EXPECT_EQ(death->Fields[2].Type, Const::GameEventKeyType::String);
+	EXPECT_EQ(death->Fields[7].Type, Const::GameEventKeyType::UInt64);
+
+	auto round_start = decoder.find_descriptor("teamplay_round_start");
+	ASSERT_NE(round_start, nullptr);
+	EXPECT_EQ(round_start->EventID, RoundStart_ID);
+	EXPECT_TRUE(round_start->Fields.empty());
+
+	EXPECT_EQ(decoder.descriptor(Unknown_ID), nullptr);
+	EXPECT_EQ(decoder.descriptor(-1), nullptr);
+	EXPECT_EQ(decoder.descriptor(Const::GameEvent_MaxEvents), nullptr);
+	EXPECT_EQ(decoder.find_descriptor("player_hurt"), nullptr);
+
+	// A list cut in the middle of a key leaves no descriptor behind
+	Payload payload;
+	write_descriptors(payload.Writer);
+	SVC_GameEventList list;
+	list.NumEvents = 2;
+	payload.attach(list);
+	list.Length -= 40;
+
+	GameEventDecoder truncated = make_decoder();
+	EXPECT_FALSE(truncated.read_descriptors(list));
+	EXPECT_EQ(truncated.size(), 0u);
+	EXPECT_EQ(truncated.descriptor(PlayerDeath_ID), nullptr);
+}
+
+TEST(GameEventDecoder, TypedDecode)
+{
+	const GameEventDecoder decoder = make_decoder();
+	Payload payload;
+	write_player_death(payload.Writer, -3, "tf_projectile_rocket");
+	SVC_GameEvent message;
+	payload.attach(message);
+
+	std::pmr::monotonic_buffer_resource arena;
+	GameEventRecord record;
+	ASSERT_TRUE(decoder.decode(message, record, &arena));
+	EXPECT_EQ(record.event_id(), PlayerDeath_ID);
+	EXPECT_EQ(record.name(), "player_death");
+
+	const auto key = [&](const char* name) { return decoder.find_key("player_death", name); };
+	EXPECT_EQ(record.get_int(key("userid")), 12);
+	EXPECT_EQ(record.get_int(key("attacker")), -3);
+	EXPECT_EQ(record.get_string(key("weapon")), "tf_projectile_rocket");
+	EXPECT_STREQ(record.Values[key("weapon").Field].String.Data, "tf_projectile_rocket");
+	EXPECT_EQ(record.get_int(key("damagebits")), -65536);
+	EXPECT_EQ(record.get_float(key("distance")), 812.5f);
+	EXPECT_EQ(record.get_int(key("crit_type")), 2);
+	EXPECT_TRUE(record.get_bool(key("silent_kill")));
+	EXPECT_EQ(record.get_uint64(key("steamid")), 76561197960287930ull);
+
+	// Conversions between numeric types, strings don't convert
+	EXPECT_EQ(record.get_int(key("distance")), 812);
+	EXPECT_EQ(record.get_float(key("attacker")), -3.f);
+	EXPECT_EQ(record.get_uint64(key("damagebits")), 0xFFFF0000ull);
+	EXPECT_EQ(record.get_int(key("weapon"), 99), 99);
+	EXPECT_EQ(record.get_string(key("userid"), "none"), "none");
+
+	// The payload ends in the middle of the last key
+	message.Length -= 32;
+	EXPECT_FALSE(decoder.decode(message, record, &arena));
+
+	Payload unknown;
+	unknown.Writer.write_ubit(Unknown_ID, Const::NetMsg_GameEventsBits);
+	SVC_GameEvent unknown_message;
+	unknown.attach(unknown_message);
+	EXPECT_FALSE(decoder.decode(unknown_message, record, &arena));
+}
+
+TEST(GameEventDecoder, FindKeyAndCount)
+{
+	const GameEventDecoder decoder = make_decoder();
+
+	const GameEventKey weapon = decoder.find_key("player_death", "weapon");
+	ASSERT_TRUE(weapon.is_valid());
+	EXPECT_EQ(weapon.EventID, PlayerDeath_ID);
+	EXPECT_EQ(weapon.Field, 2);
+	EXPECT_FALSE(decoder.find_key("player_death", "assister").is_valid());
+	EXPECT_FALSE(decoder.find_key("player_hurt", "userid").is_valid());
+	EXPECT_FALSE(decoder.find_key("teamplay_round_start", "").is_valid());
+
+	// A key of another event reads as the default value
+	Payload round_payload;
+	round_payload.Writer.write_ubit(RoundStart_ID, Const::NetMsg_GameEventsBits);
+	SVC_GameEvent round_start;
+	round_payload.attach(round_start);
+
+	std::pmr::monotonic_buffer_resource arena;
+	GameEventRecord record;
+	ASSERT_TRUE(decoder.decode(round_start, record, &arena));
+	EXPECT_FALSE(record.has_key(weapon));
+	EXPECT_EQ(record.get_string(weapon, "none"), "none");
+
+	Payload death_payload;
+	write_player_death(death_payload.Writer, 5, "scattergun");
+	SVC_GameEvent death;
+	death_payload.attach(death);
+
+	Payload unknown_payload;
+	unknown_payload.Writer.write_ubit(Unknown_ID, Const::NetMsg_GameEventsBits);
+	SVC_GameEvent unknown;
+	unknown_payload.attach(unknown);
+
+	// Too short for an event id, or with a negative length
+	SVC_GameEvent short_event, negative;
+	death_payload.attach(short_event);
+	short_event.Length = Const::NetMsg_GameEventsBits - 1;
+	death_payload.attach(negative);
+	negative.Length = -1;
+
+	const SVC_GameEvent* messages[]{ &death, &round_start, &death, &unknown, &short_event, &negative, &death };
+	std::vector<uint32_t> counts(Const::GameEvent_MaxEvents);
+	decoder.count_events(messages, counts);
+	EXPECT_EQ(counts[PlayerDeath_ID], 3u);
+	EXPECT_EQ(counts[RoundStart_ID], 1u);
+	EXPECT_EQ(counts[Unknown_ID], 0u);
+
+	std::vector<GameEventRecord> records;
+	EXPECT_EQ(decoder.decode_batch(messages, records, &arena), 4u);
+	ASSERT_EQ(records.size(), 4u);
+	EXPECT_EQ(records[0].get_string(weapon), "scattergun");
+	EXPECT_EQ(records[1].event_id(), RoundStart_ID);
+}
@@ -0,0 +1,215 @@
+// NetClassTable: names through the perfect hash, ids through the array, from a SVC_ClassInfo or straight from its body
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetClassTable.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	struct ClassEntry
+	{
+		int			ClassID;
+		std::string	Name;
+		std::string	TableName;
+	};
+
+	void fill_class_info(SVC_ClassInfo& message, int num_classes, const std::vector<ClassEntry>& classes)
+	{
+		message.CreateOnClient = false;
+		message.NumServerClasses = num_classes;
+		message.Classes.clear();
+		for (const auto& entry : classes)
+		{
+			auto svclass = message.Classes.push_to_tail_ptr();
+			svclass->classID = entry.ClassID;
+			std::snprintf(svclass->classname, sizeof(svclass->classname), "%s", entry.Name.c_str());
+			std::snprintf(svclass->datatablename, sizeof(svclass->datatablename), "%s", entry.TableName.c_str());
+		}
+	}
+
+	// A server's worth of classes, dense ids, names sharing long prefixes
+	std::vector<ClassEntry> make_classes(int count)
+	{
+		std::vector<ClassEntry> classes;
+		const char* fixed[]{ "CTFPlayer", "CTFRocketLauncher", "CObjectSentrygun", "CTFGameRulesProxy", "CWorld" };
+		for (int i = 0; i < count; i++)
+		{
+			std::string name = i < static_cast<int>(std::size(fixed)) ? fixed[i] : "CTFWeaponBase_" + std::to_string(i);
+			classes.push_back({ i, name, "DT_" + name.substr(1) });
+		}
+		return classes;
+	}
+
+	void expect_resolves(const NetClassTable& table, const std::vector<ClassEntry>& classes)
+	{
+		for (const auto& entry : classes)
+		{
+			SCOPED_TRACE(entry.Name);
+			ASSERT_EQ(table.find_id(entry.Name), entry.ClassID);
+
+			auto descriptor = table.find(entry.ClassID);
+			ASSERT_NE(descriptor, nullptr);
+			EXPECT_EQ(descriptor->Name, entry.Name);
+			EXPECT_EQ(descriptor->TableName, entry.TableName);
+			EXPECT_EQ(table.find(entry.Name), descriptor);
+		}
+	}
+}
+
+
+TEST(NetClassTable, EveryNameResolves)
+{
+	for (int count : { 1, 2, 5, 63, 64, 65, 400, 2000 })
+	{
+		SCOPED_TRACE(testing::Message() << count << " classes");
+		const auto classes = make_classes(count);
+		SVC_ClassInfo message;
+		fill_class_info(message, count, classes);
+
+		NetClassTable table;
+		ASSERT_TRUE(table.read(message));
+		EXPECT_EQ(table.size(), static_cast<size_t>(count));
+		EXPECT_EQ(table.classes().size(), static_cast<size_t>(count));
+		EXPECT_EQ(table.class_bits(), std::max<int>(std::bit_width(static_cast<uint32_t>(count)), 1));
+		expect_resolves(table, classes);
+	}
+}
+
+TEST(NetClassTable, UnknownNames)
+{
+	NetClassTable empty;
+	EXPECT_EQ(empty.find_id("CTFPlayer"), -1);
+	EXPECT_EQ(empty.find(0), nullptr);
+
+	const auto classes = make_classes(400);
+	SVC_ClassInfo message;
+	fill_class_info(message, 400, classes);
+
+	NetClassTable table;
+	ASSERT_TRUE(table.read(message));
+	for (const char* name : { "", "CTFPlaye", "CTFPlayerX", "ctfplayer", "DT_TFPlayer", "CTFWeaponBase_400", "CTFWeaponBase_" })
+		EXPECT_EQ(table.find_id(name), -1) << name;
+
+	// A name with the same bytes past an embedded null
+	EXPECT_EQ(table.find_id(std::string_view("CTFPlayer\0", 10)), -1);
+	EXPECT_EQ(table.find(-1), nullptr);
+	EXPECT_EQ(table.find(400), nullptr);
+
+	table.clear();
+	EXPECT_EQ(table.find_id("CTFPlayer"), -1);
+	EXPECT_EQ(table.size(), 0u);
+}
+
+TEST(NetClassTable, DuplicateNames)
+{
+	const std::vector<ClassEntry> classes{
+		{ 0, "CWorld", "DT_World" },
+		{ 3, "CDuplicate", "DT_First" },
+		{ 5, "CTFPlayer", "DT_TFPlayer" },
+		{ 7, "CDuplicate", "DT_Second" },
+	};
+	SVC_ClassInfo message;
+	fill_class_info(message, 8, classes);
+
+	NetClassTable table;
+	ASSERT_TRUE(table.read(message));
+	EXPECT_EQ(table.size(), 4u);
+
+	// The name resolves to the lowest id, both ids keep their descriptor
+	EXPECT_EQ(table.find_id("CDuplicate"), 3);
+	ASSERT_NE(table.find(7), nullptr);
+	EXPECT_EQ(table.find(7)->Name, "CDuplicate");
+	EXPECT_EQ(table.find(7)->TableName, "DT_Second");
+	EXPECT_EQ(table.find_id("CTFPlayer"), 5);
+
+	// The same id sent twice keeps the last one and counts once
+	const std::vector<ClassEntry> repeated{
+		{ 1, "CFirst", "DT_First" },
+		{ 1, "CSecond", "DT_Second" },
+	};
+	fill_class_info(message, 2, repeated);
+	ASSERT_TRUE(table.read(message));
+	EXPECT_EQ(table.size(), 1u);
+	EXPECT_EQ(table.find(1)->Name, "CSecond");
+	EXPECT_EQ(table.find_id("CSecond"), 1);
+	EXPECT_EQ(table.find_id("CFirst"), -1);
+}
+
+TEST(NetClassTable, SparseClassIds)
+{
+	const std::vector<ClassEntry> classes{
+		{ 1000, "CLast", "DT_Last" },
+		{ 0, "CWorld", "DT_World" },
+		{ 5, "CTFPlayer", "DT_TFPlayer" },
+		{ 300, "CTFMinigun", "DT_WeaponMinigun" },
+	};
+	SVC_ClassInfo message;
+	fill_class_info(message, 1024, classes);
+
+	NetClassTable table;
+	ASSERT_TRUE(table.read(message));
+	EXPECT_EQ(table.size(), 4u);
+	ASSERT_EQ(table.classes().size(), 1001u);
+	EXPECT_EQ(table.class_bits(), 11);
+	expect_resolves(table, classes);
+
+	for (int id : { 1, 4, 6, 299, 999 })
+	{
+		EXPECT_EQ(table.find(id), nullptr) << id;
+		EXPECT_FALSE(table.classes()[id].is_valid()) << id;
+	}
+}
+
+TEST(NetClassTable, ReadsMessageBody)
+{
+	auto classes = make_classes(300);
+	// Ids in any order and with holes, as long as they fit the width of the class count
+	std::swap(classes[10], classes[200]);
+	classes.erase(classes.begin() + 50, classes.begin() + 60);
+
+	// The body holds as many classes as it announces
+	SVC_ClassInfo message;
+	fill_class_info(message, static_cast<int>(classes.size()), classes);
+
+	std::vector<uint32_t> words(1 << 14);
+	utils::bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+	ASSERT_TRUE(message.WriteToBuffer(writer));
+
+	utils::bf_read reader(words.data(), writer.bytes_written(), writer.bits_written());
+	ASSERT_EQ(reader.read_ubit(Const::NetMsgType_Bits), static_cast<uint32_t>(Const::NetMsgType::svc_ClassInfo));
+	NetClassTable from_body;
+	ASSERT_TRUE(from_body.read(reader));
+	EXPECT_EQ(reader.bits_left(), 0);
+
+	NetClassTable from_message;
+	ASSERT_TRUE(from_message.read(message));
+
+	EXPECT_EQ(from_body.size(), classes.size());
+	EXPECT_EQ(from_body.class_bits(), from_message.class_bits());
+	ASSERT_EQ(from_body.classes().size(), from_message.classes().size());
+	expect_resolves(from_body, classes);
+	EXPECT_EQ(from_body.find(55), nullptr);
+
+	// Cut in the middle of the last class
+	utils::bf_read truncated(words.data(), writer.bytes_written(), writer.bits_written() - 20);
+	(void)truncated.read_ubit(Const::NetMsgType_Bits);
+	NetClassTable table;
+	EXPECT_FALSE(table.read(truncated));
+
+	// The client builds its own classes from the send tables
+	SVC_ClassInfo on_client(true, 300);
+	writer.reset();
+	ASSERT_TRUE(on_client.WriteToBuffer(writer));
+	utils::bf_read on_client_reader(words.data(), writer.bytes_written(), writer.bits_written());
+	(void)on_client_reader.read_ubit(Const::NetMsgType_Bits);
+	EXPECT_FALSE(table.read(on_client_reader));
+	EXPECT_EQ(table.class_bits(), from_message.class_bits());
+	EXPECT_FALSE(table.read(on_client));
+}
@@ -0,0 +1,255 @@
+// NetFragmentStream and NetFragmentAssembler on subchannel blocks written as CNetChan::SendSubChannelData does
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetFragments.hpp>
+#include <tf2/utils/Lzss.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	std::vector<uint8_t> make_payload(size_t size, uint32_t seed)
+	{
+		std::vector<uint8_t> payload(size);
+		for (size_t i = 0; i < size; i++)
+			payload[i] = static_cast<uint8_t>((i * 31 + seed) ^ (i >> 8));
+		return payload;
+	}
+
+	/// <summary>
+	/// Writes the blocks of a transfer, the header goes with the block of the first fragment
+	/// </summary>
+	struct TransferWriter
+	{
+		std::vector<uint8_t>	Wire;
+		uint32_t				UncompressedSize{ };
+		bool					IsCompressed{ };
+		std::string				FileName;
+		uint32_t				TransferID{ };
+
+		void write_header(utils::bf_write& writer, bool single_block, int protocol) const
+		{
+			if (!single_block)
+			{
+				writer.write_bit(FileName.empty() ? 0 : 1);
+				if (!FileName.empty())
+				{
+					writer.write_ubit(TransferID, 32);
+					writer.write_string(FileName.c_str());
+				}
+			}
+
+			writer.write_bit(IsCompressed ? 1 : 0);
+			if (IsCompressed)
+				writer.write_ubit(UncompressedSize, Const::NetFrag_MaxFileSizeBits);
+
+			const uint32_t bytes = static_cast<uint32_t>(Wire.size());
+			if (!single_block)
+				writer.write_ubit(bytes, Const::NetFrag_MaxFileSizeBits);
+			else if (protocol > Const::NetFrag_Protocol_VarIntSize)
+				writer.write_uint32(bytes);
+			else
+				writer.write_ubit(bytes, Const::NetFrag_PayloadBits);
+		}
+
+		void write_single(utils::bf_write& writer, int protocol = Const::NetFrag_Protocol) const
+		{
+			writer.write_bit(0);
+			write_header(writer, true, protocol);
+			writer.write_bytes(Wire.data(), static_cast<int>(Wire.size()));
+		}
+
+		void write_block(utils::bf_write& writer, uint32_t start, uint32_t count) const
+		{
+			writer.write_bit(1);
+			writer.write_ubit(start, Const::NetFrag_StartFragmentBits);
+			writer.write_ubit(count, Const::NetFrag_NumFragmentsBits);
+			if (!start)
+				write_header(writer, false, Const::NetFrag_Protocol);
+
+			const size_t offset = static_cast<size_t>(start) * Const::NetFrag_FragmentSize;
+			const size_t length = std::min<size_t>(static_cast<size_t>(count) * Const::NetFrag_FragmentSize, Wire.size() - offset);
+			writer.write_bytes(Wire.data() + offset, static_cast<int>(length));
+		}
+
+		[[nodiscard]] uint32_t num_fragments() const noexcept
+		{
+			return static_cast<uint32_t>((Wire.size() + Const::NetFrag_FragmentSize - 1) / Const::NetFrag_FragmentSize);
+		}
+	};
+
+	struct Packet
+	{
+		Packet()
+		{
+			Writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+		}
+
+		[[nodiscard]] utils::bf_read reader() const
+		{
+			return utils::bf_read(Words.data(), Writer.bytes_written(), Writer.bits_written());
+		}
+
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1 << 16);
+		utils::bf_write			Writer;
+	};
+
+	Const::NetFragStatus send_block(NetFragmentStream& stream, const TransferWriter& transfer, uint32_t start, uint32_t count)
+	{
+		Packet packet;
+		transfer.write_block(packet.Writer, start, count);
+		utils::bf_read reader = packet.reader();
+		const auto status = stream.read(reader);
+		EXPECT_FALSE(reader.has_overflown());
+		return status;
+	}
+
+	bool same_data(const NetFragmentStream& stream, const std::vector<uint8_t>& expected)
+	{
+		const auto data = stream.data();
+		return std::equal(data.begin(), data.end(), expected.begin(), expected.end());
+	}
+}
+
+
+TEST(NetFragments, SingleBlock)
+{
+	// The size is a varint past protocol 23, 17 bits before
+	for (int protocol : { Const::NetFrag_Protocol_VarIntSize, Const::NetFrag_Protocol })
+	{
+		SCOPED_TRACE(testing::Message() << "protocol " << protocol);
+		TransferWriter transfer;
+		transfer.Wire = make_payload(700, protocol);
+
+		Packet packet;
+		transfer.write_single(packet.Writer, protocol);
+		packet.Writer.write_ubit(0x5A, 8);
+
+		NetFragmentStream stream;
+		utils::bf_read reader = packet.reader();
+		ASSERT_EQ(stream.read(reader, protocol), Const::NetFragStatus::Complete);
+		EXPECT_EQ(stream.num_fragments(), 3u);
+		EXPECT_EQ(stream.received_fragments(), 3u);
+		EXPECT_FALSE(stream.is_file());
+		EXPECT_TRUE(same_data(stream, transfer.Wire));
+		// The block ends where the next one starts
+		EXPECT_EQ(reader.read_ubit(8), 0x5Au);
+	}
+}
+
+TEST(NetFragments, MultipleBlocks)
+{
+	TransferWriter transfer;
+	transfer.Wire = make_payload(9 * Const::NetFrag_FragmentSize + 40, 1);
+	transfer.FileName = "downloads/maps/cp_test.bsp";
+	transfer.TransferID = 77;
+	ASSERT_EQ(transfer.num_fragments(), 10u);
+
+	NetFragmentStream stream;
+	EXPECT_EQ(send_block(stream, transfer, 0, 7), Const::NetFragStatus::Pending);
+	EXPECT_TRUE(stream.is_file());
+	EXPECT_EQ(stream.file_name(), transfer.FileName);
+	EXPECT_EQ(stream.transfer_id(), 77u);
+	EXPECT_EQ(stream.received_fragments(), 7u);
+
+	// The last block carries the short fragment
+	EXPECT_EQ(send_block(stream, transfer, 7, 3), Const::NetFragStatus::Complete);
+	EXPECT_TRUE(stream.is_complete());
+	EXPECT_EQ(stream.wire_size(), transfer.Wire.size());
+	EXPECT_TRUE(same_data(stream, transfer.Wire));
+}
+
+TEST(NetFragments, OutOfOrderAndRetransmitted)
+{
+	TransferWriter transfer;
+	transfer.Wire = make_payload(20 * Const::NetFrag_FragmentSize - 1, 2);
+	ASSERT_EQ(transfer.num_fragments(), 20u);
+
+	NetFragmentStream stream;
+	EXPECT_EQ(send_block(stream, transfer, 0, 3), Const::NetFragStatus::Pending);
+	EXPECT_EQ(send_block(stream, transfer, 13, 7), Const::NetFragStatus::Pending);
+	EXPECT_EQ(stream.received_fragments(), 10u);
+
+	// Retransmitted, fully and partly overlapping blocks don't count twice
+	EXPECT_EQ(send_block(stream, transfer, 13, 7), Const::NetFragStatus::Pending);
+	EXPECT_EQ(send_block(stream, transfer, 1, 4), Const::NetFragStatus::Pending);
+	EXPECT_EQ(stream.received_fragments(), 12u);
+
+	// Crosses the first bitmap word
+	EXPECT_EQ(send_block(stream, transfer, 5, 7), Const::NetFragStatus::Pending);
+	EXPECT_EQ(stream.received_fragments(), 19u);
+	EXPECT_FALSE(stream.is_complete());
+
+	EXPECT_EQ(send_block(stream, transfer, 10, 4), Const::NetFragStatus::Complete);
+	EXPECT_EQ(stream.received_fragments(), 20u);
+	EXPECT_TRUE(same_data(stream, transfer.Wire));
+
+	// A retransmission past completion doesn't complete it again
+	EXPECT_EQ(send_block(stream, transfer, 10, 4), Const::NetFragStatus::Pending);
+	EXPECT_EQ(stream.received_fragments(), 20u);
+
+	// Past the end of the transfer
+	EXPECT_EQ(send_block(stream, transfer, 18, 3), Const::NetFragStatus::BadFragment);
+}
+
+TEST(NetFragments, MissingHeader)
+{
+	TransferWriter transfer;
+	transfer.Wire = make_payload(5 * Const::NetFrag_FragmentSize, 3);
+
+	NetFragmentStream stream;
+	EXPECT_EQ(send_block(stream, transfer, 3, 2), Const::NetFragStatus::MissingHeader);
+	EXPECT_FALSE(stream.is_active());
+
+	// The retry with the header starts the transfer
+	EXPECT_EQ(send_block(stream, transfer, 0, 3), Const::NetFragStatus::Pending);
+	EXPECT_EQ(send_block(stream, transfer, 3, 2), Const::NetFragStatus::Complete);
+	EXPECT_TRUE(same_data(stream, transfer.Wire));
+}
+
+TEST(NetFragments, CompressedTransfer)
+{
+	std::vector<uint8_t> payload;
+	for (int i = 0; i < 400; i++)
+	{
+		const std::string line = "entity " + std::to_string(i % 50) + " origin 0 0 0\n";
+		payload.insert(payload.end(), line.begin(), line.end());
+	}
+
+	TransferWriter transfer;
+	ASSERT_TRUE(utils::LZSS_Compress(payload, transfer.Wire));
+	transfer.IsCompressed = true;
+	transfer.UncompressedSize = static_cast<uint32_t>(payload.size());
+	ASSERT_GT(transfer.num_fragments(), 1u);
+
+	NetFragmentAssembler assembler;
+	auto& stream = assembler.stream(Const::NetFragStream::Normal);
+	for (uint32_t start = 0; start < transfer.num_fragments(); start += 7)
+	{
+		// The bit of the file stream is clear
+		Packet packet;
+		packet.Writer.write_bit(1);
+		transfer.write_block(packet.Writer, start, std::min(7u, transfer.num_fragments() - start));
+		packet.Writer.write_bit(0);
+
+		utils::bf_read reader = packet.reader();
+		ASSERT_TRUE(assembler.read_subchannels(reader));
+		EXPECT_EQ(reader.bits_left(), 0);
+	}
+
+	ASSERT_EQ(assembler.last_status(Const::NetFragStream::Normal), Const::NetFragStatus::Complete);
+	EXPECT_TRUE(stream.is_compressed());
+	EXPECT_EQ(stream.wire_size(), transfer.Wire.size());
+	EXPECT_TRUE(same_data(stream, payload));
+
+	// A stream that doesn't decompress to the announced size
+	transfer.UncompressedSize++;
+	NetFragmentStream bad;
+	Packet packet;
+	transfer.write_single(packet.Writer);
+	utils::bf_read reader = packet.reader();
+	EXPECT_EQ(bad.read(reader), Const::NetFragStatus::BadCompression);
+}
@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetMessageRegistry.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	std::atomic<size_t> Allocations{ 0 };
+
+	/// <summary>
+	/// A stream of net_Tick, net_StringCmd and net_SignonState messages with net_Nop padding
+	/// </summary>
+	struct MessageStream
+	{
+		static constexpr int Ticks = 300;
+
+		MessageStream()
+		{
+			utils::bf_write writer(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+			for (int i = 0; i < Ticks; i++)
+			{
+				NET_Tick(i, 0.015f, 0.001f).WriteToBuffer(writer);
+				if (i % 3 == 0)
+					NET_StringCmd("say hi").WriteToBuffer(writer);
+				if (i % 7 == 0)
+					writer.write_ubit(static_cast<uint32_t>(Const::NetMsgType::net_Nop), Const::NetMsgType_Bits);
+				NET_SignonState(Const::SignonStateType::Full, i).WriteToBuffer(writer);
+			}
+			Bytes = writer.bytes_written();
+		}
+
+		[[nodiscard]] utils::bf_read reader() const
+		{
+			return utils::bf_read(Words.data(), Bytes);
+		}
+
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(8192);
+		int						Bytes;
+	};
+}
+
+void* operator new(size_t size)
+{
+	Allocations++;
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+
+TEST(NetMessageDecoder, DecodesStream)
+{
+	const MessageStream stream;
+	NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+
+	utils::bf_read reader = stream.reader();
+	int messages = 0, ticks = 0, tick_sum = 0;
+	const auto status = decoder.decode_all(reader, [&](NetMessageHandle& message)
+		{
+			messages++;
+			if (message->GetType() == Const::NetMsgType::net_Tick)
+			{
+				ticks++;
+				tick_sum += message.as<NET_Tick>()->Tick;
+			}
+		});
+
+	EXPECT_EQ(status, Const::NetMsgDecodeStatus::EndOfStream);
+	EXPECT_EQ(ticks, MessageStream::Ticks);
+	EXPECT_EQ(messages, MessageStream::Ticks * 2 + (MessageStream::Ticks + 2) / 3);
+	EXPECT_EQ(tick_sum, MessageStream::Ticks * (MessageStream::Ticks - 1) / 2);
+	EXPECT_EQ(decoder.tick(), MessageStream::Ticks - 1);
+}
+
+TEST(NetMessageDecoder, WarmPoolsDontAllocate)
+{
+	const MessageStream stream;
+	NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+
+	for (int pass = 0; pass < 3; pass++)
+	{
+		utils::bf_read reader = stream.reader();
+		const size_t before = Allocations;
+		const auto status = decoder.decode_all(reader, [](NetMessageHandle&) { });
+
+		EXPECT_EQ(status, Const::NetMsgDecodeStatus::EndOfStream);
+		EXPECT_EQ(Allocations - before, 0u) << "pass " << pass;
+	}
+}
+
+TEST(NetMessageDecoder, HeldMessagesGrowPoolsOnce)
+{
+	const MessageStream stream;
+	NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+
+	std::vector<NetMessageHandle> held;
+	held.reserve(MessageStream::Ticks * 3);
+
+	size_t first_pass = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		held.clear();
+		utils::bf_read reader = stream.reader();
+		const size_t before = Allocations;
+		(void)decoder.decode_all(reader, [&](NetMessageHandle& message) { held.push_back(std::move(message)); });
+
+		if (!pass)
+			first_pass = Allocations - before;
+		// The pools only grow the first time, the free lists' storage included
+		else EXPECT_EQ(Allocations - before, 0u);
+	}
+	EXPECT_GT(first_pass, 0u);
+	EXPECT_EQ(held.size(), MessageStream::Ticks * 2 + (MessageStream::Ticks + 2) / 3);
+}
+
+TEST(NetMessageDecoder, RegistersOneDirection)
+{
+	NetMessageDecoder server(Const::NetMsgDirection::ServerToClient);
+	NetMessageDecoder client(Const::NetMsgDirection::ClientToServer);
+
+	EXPECT_TRUE(server.is_registered(Const::NetMsgType::net_Tick));
+	EXPECT_TRUE(client.is_registered(Const::NetMsgType::net_Tick));
+
+	// Both are id 8
+	EXPECT_TRUE(server.is_registered(Const::NetMsgType::svc_ServerInfo));
+	EXPECT_EQ(server.direction(), Const::NetMsgDirection::ServerToClient);
+	EXPECT_TRUE(client.is_registered(Const::NetMsgType::clc_ClientInfo));
+	EXPECT_EQ(client.direction(), Const::NetMsgDirection::ClientToServer);
+}
+
+TEST(NetMessageDecoder, UnknownTypeAndEndOfStream)
+{
+	NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+	NetMessageHandle message;
+
+	const uint8_t unknown[4]{ Const::NetMsgType_Max - 1, 0, 0, 0 };
+	utils::bf_read reader(unknown, sizeof(unknown));
+	EXPECT_EQ(decoder.decode(reader, message), Const::NetMsgDecodeStatus::UnknownType);
+	EXPECT_FALSE(message);
+
+	// Five bits of padding is less than a header
+	const uint8_t padding[1]{ 0 };
+	utils::bf_read end(padding, sizeof(padding), 5);
+	EXPECT_EQ(decoder.decode(end, message), Const::NetMsgDecodeStatus::EndOfStream);
+}
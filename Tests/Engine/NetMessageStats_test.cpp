@@ -0,0 +1,101 @@
+// NetMessageStats recorded from many threads at once, more than it has slots, and from threads that come and go
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetMessageStats.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	constexpr int Records_PerThread = 5000;
+
+	// Every thread records the same messages, the largest one is a bit larger for each thread
+	void record_messages(NetMessageStats& stats, int thread)
+	{
+		for (int i = 0; i < Records_PerThread; i++)
+		{
+			stats.record(Const::NetMsgType::net_Tick, Const::NetMsgGroup::Generic, 10, 20);
+			stats.record(Const::NetMsgType::svc_PacketEntities, Const::NetMsgGroup::Entities, i == 0 ? 1000 + thread : 100, 5000);
+		}
+	}
+
+	void expect_totals(const NetMessageStats& stats, int num_threads)
+	{
+		const auto snapshot = stats.snapshot();
+		const uint64_t records = static_cast<uint64_t>(num_threads) * Records_PerThread;
+
+		const auto& tick = snapshot.Types[static_cast<size_t>(Const::NetMsgType::net_Tick)];
+		EXPECT_EQ(tick.Count, records);
+		EXPECT_EQ(tick.Bits, records * 10);
+		EXPECT_EQ(tick.MaxBits, 10u);
+		EXPECT_EQ(tick.Nanoseconds, records * 20);
+		EXPECT_EQ(tick.Histogram[NetMessageStats::histogram_bucket(20)], records);
+
+		const auto& entities = snapshot.Types[static_cast<size_t>(Const::NetMsgType::svc_PacketEntities)];
+		EXPECT_EQ(entities.Count, records);
+		// The first message of each thread is 900 + thread bits larger
+		const uint64_t threads = static_cast<uint64_t>(num_threads);
+		EXPECT_EQ(entities.Bits, records * 100 + threads * 900 + threads * (threads - 1) / 2);
+		EXPECT_EQ(entities.MaxBits, 1000u + num_threads - 1);
+		EXPECT_EQ(entities.Histogram[NetMessageStats::histogram_bucket(5000)], records);
+
+		EXPECT_EQ(snapshot.Groups[static_cast<size_t>(Const::NetMsgGroup::Generic)].Count, records);
+		EXPECT_EQ(snapshot.Groups[static_cast<size_t>(Const::NetMsgGroup::Entities)].Count, records);
+	}
+
+	// Every thread is alive until all of them recorded
+	void record_concurrently(NetMessageStats& stats, int num_threads)
+	{
+		std::latch done(num_threads);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < num_threads; i++)
+		{
+			threads.emplace_back([&, i]
+			{
+				record_messages(stats, i);
+				done.arrive_and_wait();
+			});
+		}
+		for (auto& thread : threads)
+			thread.join();
+	}
+}
+
+
+TEST(NetMessageStats, ConcurrentThreads)
+{
+	NetMessageStats stats(Const::NetMsgDirection::ServerToClient);
+	record_concurrently(stats, 8);
+	expect_totals(stats, 8);
+}
+
+TEST(NetMessageStats, MoreThreadsThanSlots)
+{
+	// The threads past the slots share one, and still count exactly
+	constexpr int num_threads = static_cast<int>(Const::NetStats_MaxThreads) + 16;
+	NetMessageStats stats(Const::NetMsgDirection::ServerToClient);
+	record_concurrently(stats, num_threads);
+	expect_totals(stats, num_threads);
+}
+
+TEST(NetMessageStats, ThreadsComeAndGo)
+{
+	// Far more threads than slots over time, each reuses the slot of one that exited
+	constexpr int num_threads = static_cast<int>(Const::NetStats_MaxThreads) * 4;
+	NetMessageStats stats(Const::NetMsgDirection::ServerToClient);
+	for (int i = 0; i < num_threads; i += 4)
+	{
+		std::vector<std::thread> threads;
+		for (int j = i; j < i + 4; j++)
+			threads.emplace_back([&, j] { record_messages(stats, j); });
+		for (auto& thread : threads)
+			thread.join();
+	}
+	expect_totals(stats, num_threads);
+
+	stats.reset();
+	EXPECT_EQ(stats.snapshot().Types[static_cast<size_t>(Const::NetMsgType::net_Tick)].Count, 0u);
+}
@@ -0,0 +1,69 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetMessageRegistry.hpp>
+#include <tf2/engine/NetMessageTrace.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	// ToString() starts with the name the trace uses for the same type, eg "net_Tick: "
+	void expect_prefix(const INetMessage& message, bool client_to_server)
+	{
+		const std::string prefix = std::string(NetMessageTrace::type_name(message.GetType(), client_to_server)) + ": ";
+		ASSERT_NE(prefix, ": ");
+		EXPECT_EQ(message.GetName() + std::string(": "), prefix);
+		EXPECT_EQ(std::string_view(message.ToString()).substr(0, prefix.size()), prefix);
+	}
+}
+
+
+TEST(NetMessageToString, Text)
+{
+	EXPECT_STREQ(NET_Tick(1520, 0.015f, 0.001f).ToString(), "net_Tick: tick 1520");
+	EXPECT_STREQ(NET_StringCmd("status").ToString(), "net_StringCmd: \"status\"");
+	EXPECT_STREQ(NET_SetConVar("cl_interp", "0").ToString(), "net_SetConVar: 1 cvars, \"cl_interp\"=\"0\"");
+	EXPECT_STREQ(NET_SignonState(Const::SignonStateType::Full, 3).ToString(), "net_SignonState: state 6, count 3");
+	EXPECT_STREQ(CLC_BaselineAck(100, 1).ToString(), "clc_BaselineAck: tick 100, baseline 1");
+	EXPECT_STREQ(SVC_Print("hello").ToString(), "svc_Print: \"hello\"");
+	EXPECT_STREQ(SVC_SetPause(true).ToString(), "svc_SetPause: paused");
+	EXPECT_STREQ(SVC_SetView(7).ToString(), "svc_SetView: view entity 7");
+}
+
+TEST(NetMessageToString, NameMatchesTrace)
+{
+	expect_prefix(NET_Tick(1, 0.015f, 0.f), false);
+	expect_prefix(NET_StringCmd("status"), true);
+	expect_prefix(NET_SetConVar("name", "value"), true);
+	expect_prefix(NET_SignonState(Const::SignonStateType::Connected, 1), false);
+	expect_prefix(CLC_BaselineAck(1, 0), true);
+	expect_prefix(CLC_CmdKeyValues(), true);
+	expect_prefix(SVC_CmdKeyValues(), false);
+	expect_prefix(SVC_Print("text"), false);
+	expect_prefix(SVC_SetPause(false), false);
+	expect_prefix(SVC_GetCvarValue(1, "sv_cheats"), false);
+	expect_prefix(SVC_SetView(1), false);
+
+	SVC_UserMessage user_message;
+	user_message.MsgType = 4;
+	user_message.Length = 16;
+	expect_prefix(user_message, false);
+	EXPECT_STREQ(user_message.ToString(), "svc_UserMessage: type 4, bytes 2");
+}
+
+TEST(NetMessageToString, Dump)
+{
+	std::vector<uint32_t> words(256);
+	utils::bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+	NET_Tick(42, 0.015f, 0.001f).WriteToBuffer(writer);
+	NET_StringCmd("status").WriteToBuffer(writer);
+
+	NetMessageDecoder decoder(Const::NetMsgDirection::ServerToClient);
+	utils::bf_read reader(words.data(), writer.bytes_written());
+	std::string output;
+	EXPECT_EQ(NetMessageTrace::dump(decoder, reader, output), 2u);
+	EXPECT_EQ(output, "net_Tick: tick 42\nnet_StringCmd: \"status\"\n");
+}
@@ -0,0 +1,283 @@
+// NetPacketBuilder: the sizes it predicts, how it splits a batch at the MTU and the messages it moves to a new packet
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetPacketBuilder.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	/// <summary>
+	/// Payload of a message with a DataOut, every bit is a function of its index
+	/// </summary>
+	struct Payload
+	{
+		explicit Payload(int bits) : Bits(bits)
+		{
+			utils::bf_write writer(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+			for (int i = 0; i < bits; i++)
+				writer.write_bit(bit(i));
+			Writer = writer;
+		}
+
+		[[nodiscard]] static int bit(int index) noexcept
+		{
+			return ((index * 7) ^ (index >> 3)) & 1;
+		}
+
+		int						Bits;
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1 << 17);
+		utils::bf_write			Writer;
+	};
+
+	void expect_exact_size(INetMessage& message, Const::NetMsgDirection direction)
+	{
+		SCOPED_TRACE(message.GetName());
+		const int expected = NetPacketBuilder::message_bits(message, direction);
+		ASSERT_GE(expected, 0);
+
+		// From an odd offset, nothing depends on the alignment
+		std::vector<uint32_t> words(1 << 12);
+		utils::bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+		writer.write_ubit(0b101, 3);
+		ASSERT_TRUE(message.WriteToBuffer(writer));
+		ASSERT_FALSE(writer.has_overflown());
+		EXPECT_EQ(writer.bits_written() - 3, expected);
+	}
+}
+
+
+TEST(NetPacketBuilder, ExactSizes)
+{
+	Payload payload(333);
+
+	{
+		constexpr auto direction = Const::NetMsgDirection::ClientToServer;
+		NET_Tick tick(1520, 0.015f, 0.001f);
+		NET_StringCmd command("say hello");
+		NET_StringCmd null_command;
+		NET_SignonState signon(Const::SignonStateType::Full, 3);
+		CLC_BaselineAck ack(100, 1);
+
+		CLC_Move move;
+		move.NewCommands = 2;
+		move.BackupCommands = 1;
+		move.DataOut = payload.Writer;
+
+		CLC_VoiceData voice;
+		voice.DataOut = payload.Writer;
+
+		for (INetMessage* message : std::initializer_list<INetMessage*>{ &tick, &command, &null_command, &signon, &ack, &move, &voice })
+			expect_exact_size(*message, direction);
+	}
+
+	{
+		constexpr auto direction = Const::NetMsgDirection::ServerToClient;
+		SVC_Print print("server message");
+		SVC_Print null_print;
+		null_print.Text = nullptr;
+		SVC_SetPause pause(true);
+		SVC_SetPauseTimed pause_timed(true, 12.5f);
+		SVC_SetView view(7);
+		SVC_FixAngle fix_angle(true, Angle_F{ 10.f, 20.f, 0.f });
+		SVC_CrosshairAngle crosshair(Angle_F{ 1.f, 2.f, 3.f });
+
+		SVC_Prefetch prefetch;
+		prefetch.fType = 0;
+		prefetch.SoundIndex = 1234;
+
+		SVC_VoiceData voice;
+		voice.FromClient = 3;
+		voice.Proximity = true;
+		voice.Length = payload.Bits;
+		voice.DataOut = payload.Words.data();
+
+		SVC_GameEvent game_event;
+		game_event.DataOut = payload.Writer;
+
+		SVC_UserMessage user_message;
+		user_message.MsgType = 4;
+		user_message.DataOut = payload.Writer;
+
+		SVC_EntityMessage entity_message;
+		entity_message.EntityIndex = 12;
+		entity_message.ClassID = 40;
+		entity_message.DataOut = payload.Writer;
+
+		SVC_PacketEntities entities, delta_entities;
+		for (auto message : { &entities, &delta_entities })
+		{
+			message->MaxEntries = 2048;
+			message->UpdatedEntries = 17;
+			message->IsDelta = message == &delta_entities;
+			message->UpdateBaseline = true;
+			message->Baseline = 1;
+			message->DeltaFrom = 5000;
+			message->DataOut = payload.Writer;
+		}
+
+		SVC_GameEventList event_list;
+		event_list.NumEvents = 12;
+		event_list.DataOut = payload.Writer;
+
+		for (INetMessage* message : std::initializer_list<INetMessage*>{
+				&print, &null_print, &pause, &pause_timed, &view, &fix_angle, &crosshair, &prefetch, &voice,
+				&game_event, &user_message, &entity_message, &entities, &delta_entities, &event_list })
+			expect_exact_size(*message, direction);
+
+		// Types whose size is only known once written
+		SVC_Sounds sounds;
+		EXPECT_EQ(NetPacketBuilder::message_bits(sounds, direction), -1);
+		SVC_UpdateStringTable update;
+		EXPECT_EQ(NetPacketBuilder::message_bits(update, direction), -1);
+	}
+}
+
+TEST(NetPacketBuilder, SplitsAtTheMTU)
+{
+	constexpr int mtu = 100;
+	constexpr int num_ticks = 100;
+	NetPacketBuilder builder(Const::NetMsgDirection::ServerToClient, mtu);
+
+	for (int i = 0; i < num_ticks; i++)
+	{
+		NET_Tick tick(i, 0.015f, 0.f);
+		ASSERT_TRUE(builder.add(tick));
+	}
+	// Larger than the MTU, gets a packet of its own
+	const std::string long_command(2 * mtu, 'x');
+	NET_StringCmd command(long_command.c_str());
+	ASSERT_TRUE(builder.add(command));
+	NET_Tick last(num_ticks, 0.015f, 0.f);
+	ASSERT_TRUE(builder.add(last));
+
+	const auto packets = builder.packets();
+	constexpr int ticks_per_packet = mtu * 8 / (6 + 64);
+	ASSERT_EQ(packets.size(), static_cast<size_t>((num_ticks + ticks_per_packet - 1) / ticks_per_packet + 2));
+	EXPECT_EQ(builder.message_count(), static_cast<size_t>(num_ticks + 2));
+
+	int next_tick = 0;
+	uint32_t next_message = 0;
+	for (size_t i = 0; i < packets.size(); i++)
+	{
+		SCOPED_TRACE(testing::Message() << "packet " << i);
+		const auto& packet = packets[i];
+		EXPECT_EQ(packet.StartBit % 32, 0);
+		EXPECT_EQ(packet.FirstMessage, next_message);
+		next_message += packet.NumMessages;
+
+		const bool is_command = i + 2 == packets.size();
+		if (!is_command)
+			EXPECT_LE(packet.bytes(), mtu);
+
+		utils::bf_read reader = builder.read_packet(i);
+		for (uint32_t m = 0; m < packet.NumMessages; m++)
+		{
+			const auto type = static_cast<Const::NetMsgType>(reader.read_ubit(Const::NetMsgType_Bits));
+			if (is_command)
+			{
+				ASSERT_EQ(type, Const::NetMsgType::net_StringCmd);
+				NET_StringCmd received;
+				ASSERT_TRUE(received.ReadFromBuffer(reader));
+				EXPECT_EQ(received.Command, long_command);
+				continue;
+			}
+
+			ASSERT_EQ(type, Const::NetMsgType::net_Tick);
+			NET_Tick received;
+			ASSERT_TRUE(received.ReadFromBuffer(reader));
+			EXPECT_EQ(received.Tick, next_tick++);
+		}
+		EXPECT_EQ(reader.bits_left(), 0);
+	}
+	EXPECT_EQ(next_tick, num_ticks + 1);
+}
+
+TEST(NetPacketBuilder, MovesUnsizedMessageToNewPacket)
+{
+	constexpr int mtu = 64;
+	NetPacketBuilder builder(Const::NetMsgDirection::ServerToClient, mtu);
+
+	// 5 * 70 + 5 * 7 bits, the next message starts a bit past a word boundary and is moved by 31 bits
+	for (int i = 0; i < 5; i++)
+	{
+		NET_Tick tick(i, 0.015f, 0.f);
+		ASSERT_TRUE(builder.add(tick));
+	}
+	for (int i = 0; i < 5; i++)
+	{
+		SVC_SetPause pause(i % 2 != 0);
+		ASSERT_TRUE(builder.add(pause));
+	}
+	ASSERT_EQ(builder.bits_written() % 32, 1);
+
+	Payload payload(300);
+	SVC_UpdateStringTable update;
+	update.TableID = 3;
+	update.ChangedEntries = 9;
+	update.DataOut = payload.Writer;
+	ASSERT_EQ(NetPacketBuilder::message_bits(update, builder.direction()), -1);
+	ASSERT_TRUE(builder.add(update));
+
+	const auto packets = builder.packets();
+	ASSERT_EQ(packets.size(), 2u);
+	EXPECT_EQ(packets[0].NumMessages, 10u);
+	EXPECT_EQ(packets[0].Bits, 5 * 70 + 5 * 7);
+	EXPECT_EQ(packets[1].NumMessages, 1u);
+	EXPECT_EQ(packets[1].StartBit % 32, 0);
+
+	utils::bf_read reader = builder.read_packet(1);
+	ASSERT_EQ(reader.read_ubit(Const::NetMsgType_Bits), static_cast<uint32_t>(Const::NetMsgType::svc_UpdateStringTable));
+	SVC_UpdateStringTable received;
+	ASSERT_TRUE(received.ReadFromBuffer(reader));
+	EXPECT_EQ(received.TableID, 3);
+	EXPECT_EQ(received.ChangedEntries, 9);
+	ASSERT_EQ(received.Length, payload.Bits);
+	for (int i = 0; i < payload.Bits; i++)
+		ASSERT_EQ(received.DataIn.read_bit(), Payload::bit(i)) << "bit " << i;
+	EXPECT_EQ(reader.bits_left(), 0);
+
+	// The first packet is untouched by the move
+	utils::bf_read first = builder.read_packet(0);
+	for (int i = 0; i < 5; i++)
+	{
+		ASSERT_EQ(first.read_ubit(Const::NetMsgType_Bits), static_cast<uint32_t>(Const::NetMsgType::net_Tick));
+		NET_Tick tick;
+		ASSERT_TRUE(tick.ReadFromBuffer(first));
+		EXPECT_EQ(tick.Tick, i);
+	}
+}
+
+TEST(NetPacketBuilder, RejectsOversizedMessage)
+{
+	NetPacketBuilder builder(Const::NetMsgDirection::ServerToClient);
+	NET_Tick tick(1, 0.015f, 0.f);
+	ASSERT_TRUE(builder.add(tick));
+	const int bits = builder.bits_written();
+
+	// Larger than NET_MAX_PAYLOAD, the builder gives up instead of growing forever
+	std::vector<uint32_t> data(Const::NetPacket_MaxMessageBits / 32 + 1024);
+	SVC_CreateStringTable table;
+	table.TableName = "downloadables";
+	table.MaxEntries = 4096;
+	table.NumEntries = 1;
+	table.UserDataFixedSize = false;
+	table.IsFilenames = false;
+	table.DataCompressed = false;
+	table.DataOut = utils::bf_write(data.data(), static_cast<int>(data.size() * sizeof(uint32_t)));
+	table.DataOut.seek(Const::NetPacket_MaxMessageBits + 8);
+
+	EXPECT_FALSE(builder.add(table));
+	EXPECT_EQ(builder.bits_written(), bits);
+	EXPECT_EQ(builder.message_count(), 1u);
+
+	// The batch is still usable
+	NET_Tick next(2, 0.015f, 0.f);
+	ASSERT_TRUE(builder.add(next));
+	EXPECT_EQ(builder.message_count(), 2u);
+	EXPECT_EQ(builder.packets().size(), 1u);
+	EXPECT_EQ(builder.packets()[0].Bits, 2 * (6 + 64));
+}
@@ -0,0 +1,301 @@
+// NetStringTable::apply against payloads written in the engine's format, and NetStringTableSet on the messages that carry them
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/NetStringTables.hpp>
+#include <tf2/utils/Lzss.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	/// <summary>
+	/// Writes the entries of a SVC_CreateStringTable or SVC_UpdateStringTable payload as CNetworkStringTable::WriteUpdate does
+	/// </summary>
+	class EntryWriter
+	{
+	public:
+		explicit EntryWriter(int entry_bits) : EntryBits(entry_bits)
+		{
+			Writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+		}
+
+		EntryWriter& index(int entry_index)
+		{
+			if (entry_index == LastEntry + 1)
+				Writer.write_bit(1);
+			else
+			{
+				Writer.write_bit(0);
+				Writer.write_ubit(entry_index, EntryBits);
+			}
+			LastEntry = entry_index;
+			return *this;
+		}
+
+		EntryWriter& no_string()
+		{
+			Writer.write_bit(0);
+			return *this;
+		}
+
+		EntryWriter& string(const char* str)
+		{
+			Writer.write_bit(1);
+			Writer.write_bit(0);
+			Writer.write_string(str);
+			return *this;
+		}
+
+		// 'history_index' 0 is the oldest of the last entries
+		EntryWriter& substring(int history_index, int bytes_to_copy, const char* rest)
+		{
+			Writer.write_bit(1);
+			Writer.write_bit(1);
+			Writer.write_ubit(history_index, Const::StringTable_SubstringBits);
+			Writer.write_ubit(bytes_to_copy, Const::StringTable_SubstringBits);
+			Writer.write_string(rest);
+			return *this;
+		}
+
+		EntryWriter& no_data()
+		{
+			Writer.write_bit(0);
+			return *this;
+		}
+
+		EntryWriter& fixed_data(uint32_t value, int num_bits)
+		{
+			Writer.write_bit(1);
+			Writer.write_ubit(value, num_bits);
+			return *this;
+		}
+
+		EntryWriter& data(std::string_view bytes)
+		{
+			Writer.write_bit(1);
+			Writer.write_ubit(static_cast<uint32_t>(bytes.size()), Const::StringTable_MaxUserDataBits);
+			Writer.write_bytes(bytes.data(), static_cast<int>(bytes.size()));
+			return *this;
+		}
+
+		[[nodiscard]] utils::bf_read reader() const
+		{
+			return utils::bf_read(Words.data(), Writer.bytes_written(), Writer.bits_written());
+		}
+
+		[[nodiscard]] std::vector<uint8_t> bytes() const
+		{
+			const auto data = reinterpret_cast<const uint8_t*>(Words.data());
+			return { data, data + Writer.bytes_written() };
+		}
+
+		utils::bf_write			Writer;
+
+	private:
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1 << 14);
+		int						EntryBits;
+		int						LastEntry = -1;
+	};
+
+	std::string_view as_string(std::span<const uint8_t> data)
+	{
+		return { reinterpret_cast<const char*>(data.data()), data.size() };
+	}
+
+	/// <summary>
+	/// Writes 'message' with its type and reads it back, DataIn then points into 'words'
+	/// </summary>
+	template<typename _Ty>
+	void round_trip(_Ty& message, _Ty& received, std::vector<uint32_t>& words)
+	{
+		utils::bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+		ASSERT_TRUE(message.WriteToBuffer(writer));
+		ASSERT_FALSE(writer.has_overflown());
+
+		utils::bf_read reader(words.data(), writer.bytes_written(), writer.bits_written());
+		ASSERT_EQ(reader.read_ubit(Const::NetMsgType_Bits), static_cast<uint32_t>(message.GetType()));
+		ASSERT_TRUE(received.ReadFromBuffer(reader));
+	}
+}
+
+
+TEST(NetStringTables, HistorySubstring)
+{
+	NetStringTable table("modelprecache", 1024);
+	EntryWriter writer(table.entry_bits());
+	writer.index(0).string("models/player/scout.mdl").no_data();
+	writer.index(1).substring(0, 14, "soldier.mdl").no_data();
+	// The prefix is reused from the second entry, not the first
+	writer.index(2).substring(1, 21, "_animations.mdl").no_data();
+	// The history keeps the first 31 characters of an entry
+	writer.index(3).string("materials/effects/a_rather_long_path/texture.vmt").no_data();
+	writer.index(4).substring(3, 31, "x.vmt").no_data();
+
+	utils::bf_read reader = writer.reader();
+	ASSERT_EQ(table.apply(reader, 5), Const::StringTableStatus::Ok);
+	ASSERT_EQ(table.size(), 5);
+	EXPECT_EQ(table.string(0), "models/player/scout.mdl");
+	EXPECT_EQ(table.string(1), "models/player/soldier.mdl");
+	EXPECT_EQ(table.string(2), "models/player/soldier_animations.mdl");
+	EXPECT_EQ(table.string(4), "materials/effects/a_rather_longx.vmt");
+	EXPECT_STREQ(table.c_str(2), "models/player/soldier_animations.mdl");
+	EXPECT_EQ(table.find("models/player/soldier.mdl"), 1);
+
+	// A reference past the entries of the update
+	NetStringTable other("modelprecache", 1024);
+	EntryWriter bad(other.entry_bits());
+	bad.index(0).string("models/player/scout.mdl").no_data();
+	bad.index(1).substring(1, 14, "soldier.mdl").no_data();
+
+	utils::bf_read bad_reader = bad.reader();
+	EXPECT_EQ(other.apply(bad_reader, 2), Const::StringTableStatus::BadHistory);
+}
+
+TEST(NetStringTables, FixedUserData)
+{
+	// 2 bits stored in a byte
+	NetStringTable table("flags", 64, true, 1, 2);
+	EntryWriter writer(table.entry_bits());
+	writer.index(0).string("first").fixed_data(0b10, 2);
+	writer.index(1).string("second").no_data();
+	writer.index(2).string("third").fixed_data(0b01, 2);
+
+	utils::bf_read reader = writer.reader();
+	ASSERT_EQ(table.apply(reader, 3), Const::StringTableStatus::Ok);
+	ASSERT_EQ(table.size(), 3);
+	ASSERT_EQ(table.user_data(0).size(), 1u);
+	EXPECT_EQ(table.user_data(0)[0], 0b10);
+	EXPECT_TRUE(table.user_data(1).empty());
+	ASSERT_EQ(table.user_data(2).size(), 1u);
+	EXPECT_EQ(table.user_data(2)[0], 0b01);
+	EXPECT_EQ(reader.bits_left(), 0);
+}
+
+TEST(NetStringTables, VariableUserData)
+{
+	NetStringTable table("instancebaseline", 1024);
+	const std::string large(3000, 'x');
+	EntryWriter writer(table.entry_bits());
+	writer.index(0).string("12").data("baseline of class 12");
+	writer.index(1).string("40").data(large);
+	writer.index(2).string("7").no_data();
+
+	utils::bf_read reader = writer.reader();
+	ASSERT_EQ(table.apply(reader, 3), Const::StringTableStatus::Ok);
+	ASSERT_EQ(table.size(), 3);
+	EXPECT_EQ(as_string(table.user_data(0)), "baseline of class 12");
+	EXPECT_EQ(as_string(table.user_data(1)), large);
+	EXPECT_TRUE(table.user_data(2).empty());
+
+	// The payload ends before the user data does
+	NetStringTable truncated("instancebaseline", 1024);
+	EntryWriter cut(truncated.entry_bits());
+	cut.index(0).string("12");
+	cut.Writer.write_bit(1);
+	cut.Writer.write_ubit(100, Const::StringTable_MaxUserDataBits);
+	cut.Writer.write_bytes("abc", 3);
+
+	utils::bf_read cut_reader = cut.reader();
+	EXPECT_EQ(truncated.apply(cut_reader, 1), Const::StringTableStatus::Overflow);
+}
+
+TEST(NetStringTables, UpdateExistingEntries)
+{
+	NetStringTableSet tables;
+	NetStringTable* table = tables.create("userinfo", 64);
+	table->add("alpha");
+	table->add("beta", std::span{ reinterpret_cast<const uint8_t*>("bb"), 2 });
+
+	EntryWriter writer(table->entry_bits());
+	// In range: only the user data changes, longer than before
+	writer.index(1).no_string().data("new beta data");
+	// Past the end with a string already in the table: the existing entry is updated
+	writer.index(5).string("alpha").data("a");
+	// Follows the index written above, not the one "alpha" was found at
+	writer.index(6).string("gamma").data("g");
+
+	std::vector<uint32_t> payload(1024);
+	SVC_UpdateStringTable message;
+	message.TableID = 0;
+	message.ChangedEntries = 3;
+	message.DataOut = utils::bf_write(payload.data(), static_cast<int>(payload.size() * sizeof(uint32_t)));
+	const auto bytes = writer.bytes();
+	message.DataOut.write_bits(bytes.data(), writer.Writer.bits_written());
+
+	std::vector<uint32_t> words(1024);
+	SVC_UpdateStringTable received;
+	round_trip(message, received, words);
+	ASSERT_EQ(tables.update(received), Const::StringTableStatus::Ok);
+
+	ASSERT_EQ(table->size(), 3);
+	EXPECT_EQ(table->string(0), "alpha");
+	EXPECT_EQ(as_string(table->user_data(0)), "a");
+	EXPECT_EQ(table->string(1), "beta");
+	EXPECT_EQ(as_string(table->user_data(1)), "new beta data");
+	EXPECT_EQ(table->string(2), "gamma");
+	EXPECT_EQ(as_string(table->user_data(2)), "g");
+
+	received.TableID = 3;
+	EXPECT_EQ(tables.update(received), Const::StringTableStatus::UnknownTable);
+}
+
+TEST(NetStringTables, CompressedCreate)
+{
+	constexpr int num_entries = 200;
+	NetStringTable reference("modelprecache", 1024);
+	EntryWriter writer(reference.entry_bits());
+	for (int i = 0; i < num_entries; i++)
+	{
+		char name[64];
+		std::snprintf(name, sizeof(name), "models/props_gameplay/resupply_locker_%03d.mdl", i);
+		writer.index(i).string(name).data("static prop");
+	}
+
+	const std::vector<uint8_t> uncompressed = writer.bytes();
+	std::vector<uint8_t> compressed;
+	ASSERT_TRUE(utils::LZSS_Compress(uncompressed, compressed));
+	ASSERT_LT(compressed.size(), uncompressed.size());
+
+	std::vector<uint32_t> payload(uncompressed.size());
+	SVC_CreateStringTable message;
+	message.TableName = "modelprecache";
+	message.MaxEntries = 1024;
+	message.NumEntries = num_entries;
+	message.UserDataFixedSize = false;
+	message.UserDataSize = message.UserDataSizeBits = 0;
+	message.IsFilenames = false;
+	message.DataCompressed = true;
+	message.DataOut = utils::bf_write(payload.data(), static_cast<int>(payload.size() * sizeof(uint32_t)));
+	message.DataOut.write_long(static_cast<int>(uncompressed.size()));
+	message.DataOut.write_long(static_cast<int>(compressed.size()));
+	message.DataOut.write_bytes(compressed.data(), static_cast<int>(compressed.size()));
+
+	std::vector<uint32_t> words(payload.size() + 64);
+	SVC_CreateStringTable received;
+	round_trip(message, received, words);
+
+	NetStringTableSet tables;
+	ASSERT_EQ(tables.create(received), Const::StringTableStatus::Ok);
+	NetStringTable* table = tables.find_table("modelprecache");
+	ASSERT_NE(table, nullptr);
+	ASSERT_EQ(table->size(), num_entries);
+	EXPECT_EQ(table->string(0), "models/props_gameplay/resupply_locker_000.mdl");
+	EXPECT_EQ(table->string(num_entries - 1), "models/props_gameplay/resupply_locker_199.mdl");
+	EXPECT_EQ(as_string(table->user_data(57)), "static prop");
+	EXPECT_EQ(table->find("models/props_gameplay/resupply_locker_123.mdl"), 123);
+
+	// A stream whose header claims more than the uncompressed size
+	payload.assign(payload.size(), 0);
+	message.DataOut = utils::bf_write(payload.data(), static_cast<int>(payload.size() * sizeof(uint32_t)));
+	message.DataOut.write_long(static_cast<int>(uncompressed.size() / 2));
+	message.DataOut.write_long(static_cast<int>(compressed.size()));
+	message.DataOut.write_bytes(compressed.data(), static_cast<int>(compressed.size()));
+
+	round_trip(message, received, words);
+	EXPECT_EQ(tables.create(received), Const::StringTableStatus::BadCompression);
+}
@@ -0,0 +1,135 @@
+// UserMessageView and the typed user message decoders on payloads written as the game does
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/engine/UserMessages.hpp>
+
+using namespace tf2;
+
+namespace
+{
+	/// <summary>
+	/// SVC_UserMessage as ReadFromBuffer leaves it, DataIn points into the payload's own buffer
+	/// </summary>
+	struct Message
+	{
+		explicit Message(Const::UserMsg type)
+		{
+			Writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+			Received.MsgType = static_cast<int>(type);
+		}
+
+		const SVC_UserMessage& finish()
+		{
+			Received.DataIn = utils::bf_read(Words.data(), Writer.bytes_written(), Writer.bits_written());
+			Received.Length = Writer.bits_written();
+			return Received;
+		}
+
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(256);
+		utils::bf_write			Writer;
+		SVC_UserMessage			Received;
+	};
+
+	Message make_say_text2(int client, const char* text)
+	{
+		Message message(Const::UserMsg::SayText2);
+		message.Writer.write_byte(client);
+		message.Writer.write_byte(1);
+		message.Writer.write_string("#TF_Chat_All");
+		message.Writer.write_string("player");
+		message.Writer.write_string(text);
+		message.Writer.write_string("");
+		message.Writer.write_string("");
+		return message;
+	}
+}
+
+
+TEST(UserMessages, InterleavedViews)
+{
+	UserMessageRegistry registry;
+	Message first = make_say_text2(3, "first");
+	Message second = make_say_text2(9, "second");
+
+	UserMessageView first_view(registry, first.finish());
+	UserMessageView second_view(registry, second.finish());
+
+	auto chat = first_view.as<UserMsg_SayText2>();
+	ASSERT_NE(chat, nullptr);
+	EXPECT_EQ(chat->Client, 3);
+	EXPECT_EQ(chat->Params[1], "first");
+
+	chat = second_view.as<UserMsg_SayText2>();
+	ASSERT_NE(chat, nullptr);
+	EXPECT_EQ(chat->Client, 9);
+	EXPECT_EQ(chat->Params[1], "second");
+
+	// The first view decodes its payload again, the second one keeps the decoded message until then
+	chat = first_view.as<UserMsg_SayText2>();
+	ASSERT_NE(chat, nullptr);
+	EXPECT_EQ(chat->Client, 3);
+	EXPECT_EQ(chat->Params[1], "first");
+
+	const uint32_t generation = registry.generation(Const::UserMsg::SayText2);
+	EXPECT_EQ(first_view.as<UserMsg_SayText2>()->Params[1], "first");
+	EXPECT_EQ(registry.generation(Const::UserMsg::SayText2), generation);
+
+	EXPECT_EQ(second_view.as<UserMsg_SayText2>()->Params[1], "second");
+	EXPECT_EQ(first_view.as<UserMsg_TextMsg>(), nullptr);
+}
+
+TEST(UserMessages, PlayerStatsUpdate)
+{
+	Message message(Const::UserMsg::PlayerStatsUpdate);
+	message.Writer.write_byte(7);
+	// STATMSG_PLAYERDEATH
+	message.Writer.write_byte(4);
+	message.Writer.write_long(static_cast<int>(0x80000005u));
+	message.Writer.write_long(120);
+	message.Writer.write_long(-1);
+	message.Writer.write_long(31337);
+
+	UserMessageRegistry registry;
+	UserMessageView view(registry, message.finish());
+	auto stats = view.as<UserMsg_PlayerStatsUpdate>();
+	ASSERT_NE(stats, nullptr);
+	EXPECT_EQ(stats->Class, 7);
+	EXPECT_EQ(stats->MsgType, 4);
+	EXPECT_EQ(stats->SentStats, 0x80000005u);
+	EXPECT_TRUE(stats->has_stat(1));
+	EXPECT_FALSE(stats->has_stat(2));
+	EXPECT_EQ(stats->stat(1), 120);
+	EXPECT_EQ(stats->stat(2), 0);
+	EXPECT_EQ(stats->stat(3), -1);
+	EXPECT_EQ(stats->stat(32), 31337);
+	EXPECT_FALSE(stats->has_stat(0));
+	EXPECT_FALSE(stats->has_stat(33));
+
+	// A stat announced by the mask but missing from the payload
+	Message truncated(Const::UserMsg::PlayerStatsUpdate);
+	truncated.Writer.write_byte(7);
+	truncated.Writer.write_byte(1);
+	truncated.Writer.write_long(0b11);
+	truncated.Writer.write_long(5);
+
+	UserMessageView truncated_view(registry, truncated.finish());
+	EXPECT_EQ(truncated_view.get(), nullptr);
+}
+
+TEST(UserMessages, UnknownType)
+{
+	Message message(static_cast<Const::UserMsg>(200));
+	message.Writer.write_word(0xBEEF);
+
+	UserMessageRegistry registry;
+	UserMessageView view(registry, message.finish());
+	EXPECT_FALSE(view.is_known());
+	EXPECT_EQ(view.get(), nullptr);
+	EXPECT_EQ(view.length(), 16);
+
+	auto payload = view.payload();
+	EXPECT_EQ(payload.read_word(), 0xBEEF);
+	EXPECT_EQ(payload.bits_left(), 0);
+}
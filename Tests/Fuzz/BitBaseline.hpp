@@ -0,0 +1,113 @@
+#pragma once
+
+#include <tf2/utils/bitbuf_impl.hpp>
+
+namespace tf2_tests
+{
+	using namespace tf2::utils;
+
+	/// <summary>
+	/// Reference encoder: every codec goes through bit_writer_impl one write_ubit at a time,
+	/// without the aligned, bulk or array fast paths of bf_write
+	/// </summary>
+	class BaselineWriter
+	{
+	public:
+		explicit BaselineWriter(bf_write& writer) noexcept : Writer(writer) { }
+
+		void write_bit(int bit)							{ Writer.write_ubit(bit ? 1 : 0, 1); }
+		void write_ubit(uint32_t data, int numbits)		{ Writer.write_ubit(data, numbits); }
+		void write_char(int data)						{ Writer.write_ubit(static_cast<uint8_t>(data), 8); }
+		void write_sbit(int data, int numbits)			{ bit_writer_impl::write_sbit(*this, data, numbits); }
+		void write_uint32(uint32_t data)				{ bit_writer_impl::write_varint(*this, data); }
+		void write_uint64(uint64_t data)				{ bit_writer_impl::write_varint(*this, data); }
+		void write_sint32(int32_t data)					{ write_uint32(bit_buffer_constants::enconde_zigzag(data)); }
+		void write_sint64(int64_t data)					{ write_uint64(bit_buffer_constants::enconde_zigzag(data)); }
+		void write_coord(float f)						{ bit_writer_impl::write_coord(*this, f); }
+		void write_coord_mp(float f, bool integral, bool low_precision) { bit_writer_impl::write_coord_mp(*this, f, integral, low_precision); }
+		void write_normal(float f)						{ bit_writer_impl::write_normal(*this, f); }
+		void write_ubit_var(uint32_t data)				{ bit_writer_impl::write_ubit_var(*this, data); }
+		void write_vec3(const float fa[3])				{ bit_writer_impl::write_vec3(*this, fa); }
+		void write_angle(float angle, int numbits)		{ bit_writer_impl::write_angle(*this, angle, numbits); }
+		void write_string(const char* str)				{ bit_writer_impl::write_string(*this, str); }
+
+		void write_bits(const void* data, int numbits)
+		{
+			const auto bytes = static_cast<const uint8_t*>(data);
+			for (int i = 0; numbits > 0; i++, numbits -= 8)
+				write_ubit(bytes[i], std::min(numbits, 8));
+		}
+
+		void write_ubit_array(const uint32_t* in, int count, int numbits)
+		{
+			for (int i = 0; i < count; i++)
+				write_ubit(in[i], numbits);
+		}
+
+		void write_coord_array(const float* in, int count)
+		{
+			for (int i = 0; i < count; i++)
+				write_coord(in[i]);
+		}
+
+		[[nodiscard]] bool has_overflown() const noexcept { return Writer.has_overflown(); }
+
+	private:
+		bf_write& Writer;
+	};
+
+
+	/// <summary>
+	/// Reference decoder: every codec goes through bit_reader_impl one read_ubit at a time,
+	/// without the byte-aligned varint, string and memcpy fast paths of bf_read
+	/// </summary>
+	class BaselineReader
+	{
+	public:
+		explicit BaselineReader(bf_read& reader) noexcept : Reader(reader) { }
+
+		[[nodiscard]] int read_bit()					{ return static_cast<int>(Reader.read_ubit(1)); }
+		[[nodiscard]] uint32_t read_ubit(int numbits)	{ return Reader.read_ubit(numbits); }
+		[[nodiscard]] char read_char()					{ return static_cast<char>(Reader.read_ubit(8)); }
+		[[nodiscard]] int read_sbit(int numbits)		{ return bit_reader_impl::read_sbit(*this, numbits); }
+		[[nodiscard]] uint32_t read_uint32()			{ return bit_reader_impl::read_uint32(*this); }
+		[[nodiscard]] uint64_t read_uint64()			{ return bit_reader_impl::read_uint64(*this); }
+		[[nodiscard]] int32_t read_int32()				{ return static_cast<int32_t>(bit_buffer_constants::deconde_zigzag(read_uint32())); }
+		[[nodiscard]] int64_t read_int64()				{ return static_cast<int64_t>(bit_buffer_constants::deconde_zigzag(read_uint64())); }
+		[[nodiscard]] float read_coord()				{ return bit_reader_impl::read_coord(*this); }
+		[[nodiscard]] float read_coord_mp(bool integral, bool low_precision) { return bit_reader_impl::read_coord_mp(*this, integral, low_precision); }
+		[[nodiscard]] float read_normal()				{ return bit_reader_impl::read_normal(*this); }
+		[[nodiscard]] uint32_t read_ubit_var()			{ return bit_reader_impl::read_ubit_var(*this); }
+		void read_vec3(float fa[3])						{ bit_reader_impl::read_vec3(*this, fa); }
+		[[nodiscard]] float read_angle(int numbits)		{ return bit_reader_impl::read_angle(*this, numbits); }
+
+		bool read_string(char* str, int maxLen, bool bLine = false, int* pOutNumChars = nullptr)
+		{
+			return bit_reader_impl::read_string(*this, str, maxLen, bLine, pOutNumChars);
+		}
+
+		void read_bits(void* out, int numbits)
+		{
+			const auto bytes = static_cast<uint8_t*>(out);
+			for (int i = 0; numbits > 0; i++, numbits -= 8)
+				bytes[i] = static_cast<uint8_t>(read_ubit(std::min(numbits, 8)));
+		}
+
+		void read_ubit_array(uint32_t* out, int count, int numbits)
+		{
+			for (int i = 0; i < count; i++)
+				out[i] = read_ubit(numbits);
+		}
+
+		void read_coord_array(float* out, int count)
+		{
+			for (int i = 0; i < count; i++)
+				out[i] = read_coord();
+		}
+
+		[[nodiscard]] bool has_overflown() const noexcept { return Reader.has_overflown(); }
+
+	private:
+		bf_read& Reader;
+	};
+}
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+#include <tf2/utils/bitbuf_impl.hpp>
+
+// Aborts the fuzz target, libFuzzer keeps the input as a crash
+#define FUZZ_CHECK(COND)																\
+	do																					\
+	{																					\
+		if (!(COND))																	\
+		{																				\
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #COND);	\
+			std::abort();																\
+		}																				\
+	} while (false)
+
+namespace tf2_tests
+{
+	using namespace tf2::utils;
+
+	/// <summary>
+	/// Consumes a fuzzer's input, reads past the end yield zeros so every input decodes to a program
+	/// </summary>
+	class FuzzInput
+	{
+	public:
+		FuzzInput(const uint8_t* data, size_t size) noexcept : Data(data), Size(size) { }
+
+		[[nodiscard]] bool empty() const noexcept { return Offset >= Size; }
+
+		template<typename _Ty>
+		[[nodiscard]] _Ty take() noexcept
+		{
+			_Ty value{ };
+			const size_t count = std::min(sizeof(_Ty), Size - std::min(Offset, Size));
+			std::memcpy(&value, Data + Offset, count);
+			Offset += sizeof(_Ty);
+			return value;
+		}
+
+		/// <summary>
+		/// Value in [min, max]
+		/// </summary>
+		[[nodiscard]] uint32_t take_range(uint32_t min, uint32_t max) noexcept
+		{
+			return min + static_cast<uint32_t>(take<uint32_t>() % (static_cast<uint64_t>(max) - min + 1));
+		}
+
+	private:
+		const uint8_t*	Data;
+		size_t			Size;
+		size_t			Offset{ };
+	};
+
+
+	enum class BitOpType : uint8_t
+	{
+		Bit,
+		UBit,
+		SBit,
+		UInt32,
+		UInt64,
+		SInt32,
+		SInt64,
+		Coord,
+		CoordMP,
+		Normal,
+		UBitVar,
+		Vec3,
+		Angle,
+		String,
+		Bits,
+		UBitArray,
+		CoordArray,
+
+		Count
+	};
+
+	/// <summary>
+	/// One call of a writer, its value is chosen so the reader returns it unchanged, except for Normal and Angle
+	/// that lose up to one unit of their resolution
+	/// </summary>
+	struct BitOp
+	{
+		BitOpType				Type{ };
+		// Width of UBit, SBit, Angle and UBitArray fields, size of Bits.
+		// CoordMP: bit 0 integral, bit 1 low precision
+		int						Bits{ };
+		uint64_t				Value{ };
+		float					Floats[3]{ };
+		std::string				Text;
+		std::vector<uint8_t>	Raw;
+		std::vector<uint32_t>	Array;
+		std::vector<float>		FloatArray;
+	};
+
+	using BitProgram = std::vector<BitOp>;
+
+	// Every op but the Bits of up to 256 bits and the arrays of up to 64 fields fit in 256 bits
+	static constexpr size_t BitProgram_MaxOps = 256;
+	static constexpr size_t BitProgram_MaxBits = BitProgram_MaxOps * 64 * 32;
+
+	static constexpr BitOpType BitOps_All[]
+	{
+		BitOpType::Bit, BitOpType::UBit, BitOpType::SBit, BitOpType::UInt32, BitOpType::UInt64, BitOpType::SInt32, BitOpType::SInt64,
+		BitOpType::Coord, BitOpType::CoordMP, BitOpType::Normal, BitOpType::UBitVar, BitOpType::Vec3, BitOpType::Angle,
+		BitOpType::String, BitOpType::Bits, BitOpType::UBitArray, BitOpType::CoordArray
+	};
+
+	// The codecs of schema::px_writer and schema::px_reader
+	static constexpr BitOpType BitOps_Px[]
+	{
+		BitOpType::Bit, BitOpType::UBit, BitOpType::UInt32, BitOpType::UInt64, BitOpType::SInt32, BitOpType::SInt64,
+		BitOpType::Coord, BitOpType::String
+	};
+
+
+	/// <summary>
+	/// Coord with 'int_bits' integer bits and 'fraction_bits' fraction bits, exactly representable by the encoding
+	/// </summary>
+	inline float make_coord(FuzzInput& input, int int_bits, int fraction_bits) noexcept
+	{
+		const int integer = static_cast<int>(input.take_range(0, (1u << int_bits)));
+		const int fraction = static_cast<int>(input.take_range(0, (1u << fraction_bits) - 1));
+		const float value = static_cast<float>(integer) + static_cast<float>(fraction) / static_cast<float>(1 << fraction_bits);
+		return (input.take<uint8_t>() & 1) ? -value : value;
+	}
+
+	inline BitProgram make_program(FuzzInput& input, std::span<const BitOpType> types)
+	{
+		BitProgram program;
+		while (!input.empty() && program.size() < BitProgram_MaxOps)
+		{
+			BitOp op;
+			op.Type = types[input.take<uint8_t>() % types.size()];
+
+			switch (op.Type)
+			{
+			case BitOpType::Bit:
+				op.Value = input.take<uint8_t>() & 1;
+				break;
+
+			case BitOpType::UBit:
+				op.Bits = static_cast<int>(input.take_range(1, 32));
+				op.Value = input.take<uint32_t>() & (~0u >> (32 - op.Bits));
+				break;
+
+			case BitOpType::SBit:
+			{
+				op.Bits = static_cast<int>(input.take_range(1, 32));
+				// Sign extend from the field's width
+				const int shift = 32 - op.Bits;
+				op.Value = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(input.take<uint32_t>() << shift) >> shift));
+				break;
+			}
+
+			case BitOpType::UInt32:
+			case BitOpType::SInt32:
+				op.Value = input.take<uint32_t>() >> input.take_range(0, 31);
+				break;
+
+			case BitOpType::UInt64:
+			case BitOpType::SInt64:
+				op.Value = input.take<uint64_t>() >> input.take_range(0, 63);
+				break;
+
+			case BitOpType::Coord:
+				op.Floats[0] = make_coord(input, bit_buffer_constants::coord_int, bit_buffer_constants::coord_fraction);
+				break;
+
+			case BitOpType::CoordMP:
+			{
+				op.Bits = input.take<uint8_t>() & 3;
+				const bool integral = op.Bits & 1;
+				const bool low_precision = op.Bits & 2;
+				const int int_bits = input.take<uint8_t>() & 1 ? bit_buffer_constants::coord_int_mp : bit_buffer_constants::coord_int;
+				op.Floats[0] = make_coord(
+					input,
+					int_bits,
+					integral ? 0 : (low_precision ? bit_buffer_constants::coord_fraction_lp : bit_buffer_constants::coord_fraction)
+				);
+				// The sign is only sent with an integer part
+				if (integral && op.Floats[0] > -1.f && op.Floats[0] < 1.f)
+					op.Floats[0] = 0.f;
+				break;
+			}
+
+			case BitOpType::Normal:
+				op.Floats[0] = static_cast<float>(static_cast<int>(input.take_range(0, 2 * bit_buffer_constants::normal_denominator)) - bit_buffer_constants::normal_denominator) *
+					bit_buffer_constants::normal_resolution;
+				break;
+
+			case BitOpType::UBitVar:
+				op.Value = input.take<uint32_t>() >> input.take_range(0, 31);
+				break;
+
+			case BitOpType::Vec3:
+				for (float& value : op.Floats)
+					value = input.take<uint8_t>() & 1 ? make_coord(input, bit_buffer_constants::coord_int, bit_buffer_constants::coord_fraction) : 0.f;
+				break;
+
+			case BitOpType::Angle:
+				// A float can't resolve more than ~20 bits of an angle in [0, 360)
+				op.Bits = static_cast<int>(input.take_range(1, 20));
+				op.Floats[0] = static_cast<float>(input.take<uint32_t>() & (~0u >> (32 - op.Bits))) * (360.f / static_cast<float>(1u << op.Bits));
+				break;
+
+			case BitOpType::String:
+			{
+				const size_t length = input.take_range(0, 64);
+				for (size_t i = 0; i < length; i++)
+					op.Text.push_back(static_cast<char>(input.take_range(1, 255)));
+				break;
+			}
+
+			case BitOpType::Bits:
+				op.Bits = static_cast<int>(input.take_range(1, 256));
+				op.Raw.resize((op.Bits + 7) / 8);
+				for (auto& byte : op.Raw)
+					byte = input.take<uint8_t>();
+				if (op.Bits & 7)
+					op.Raw.back() &= (1u << (op.Bits & 7)) - 1;
+				break;
+
+			case BitOpType::UBitArray:
+				op.Bits = static_cast<int>(input.take_range(1, 32));
+				op.Array.resize(input.take_range(0, 64));
+				for (auto& value : op.Array)
+					value = input.take<uint32_t>() & (~0u >> (32 - op.Bits));
+				break;
+
+			case BitOpType::CoordArray:
+				op.FloatArray.resize(input.take_range(0, 64));
+				for (auto& value : op.FloatArray)
+					value = make_coord(input, bit_buffer_constants::coord_int, bit_buffer_constants::coord_fraction);
+				break;
+
+			default:
+				break;
+			}
+
+			program.push_back(std::move(op));
+		}
+		return program;
+	}
+
+
+	template<typename _WriterTy>
+	void write_program(_WriterTy& writer, const BitProgram& program)
+	{
+		for (const auto& op : program)
+		{
+			switch (op.Type)
+			{
+			case BitOpType::Bit:		writer.write_bit(static_cast<int>(op.Value)); break;
+			case BitOpType::UBit:		writer.write_ubit(static_cast<uint32_t>(op.Value), op.Bits); break;
+			case BitOpType::SBit:		writer.write_sbit(static_cast<int>(op.Value), op.Bits); break;
+			case BitOpType::UInt32:		writer.write_uint32(static_cast<uint32_t>(op.Value)); break;
+			case BitOpType::UInt64:		writer.write_uint64(op.Value); break;
+			case BitOpType::SInt32:		writer.write_sint32(static_cast<int32_t>(op.Value)); break;
+			case BitOpType::SInt64:		writer.write_sint64(static_cast<int64_t>(op.Value)); break;
+			case BitOpType::Coord:		writer.write_coord(op.Floats[0]); break;
+			case BitOpType::CoordMP:	writer.write_coord_mp(op.Floats[0], op.Bits & 1, op.Bits & 2); break;
+			case BitOpType::Normal:		writer.write_normal(op.Floats[0]); break;
+			case BitOpType::UBitVar:	writer.write_ubit_var(static_cast<uint32_t>(op.Value)); break;
+			case BitOpType::Vec3:		writer.write_vec3(op.Floats); break;
+			case BitOpType::Angle:		writer.write_angle(op.Floats[0], op.Bits); break;
+			case BitOpType::String:		writer.write_string(op.Text.c_str()); break;
+			case BitOpType::Bits:		writer.write_bits(op.Raw.data(), op.Bits); break;
+			case BitOpType::UBitArray:	writer.write_ubit_array(op.Array.data(), static_cast<int>(op.Array.size()), op.Bits); break;
+			case BitOpType::CoordArray:	writer.write_coord_array(op.FloatArray.data(), static_cast<int>(op.FloatArray.size())); break;
+			default: break;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Reads the program back into a copy of it, the values the writer was given are replaced by the decoded ones
+	/// </summary>
+	template<typename _ReaderTy>
+	BitProgram read_program(_ReaderTy& reader, const BitProgram& program)
+	{
+		BitProgram result;
+		result.reserve(program.size());
+
+		for (const auto& op : program)
+		{
+			BitOp& out = result.emplace_back();
+			out.Type = op.Type;
+			out.Bits = op.Bits;
+
+			switch (op.Type)
+			{
+			case BitOpType::Bit:		out.Value = static_cast<uint64_t>(reader.read_bit()); break;
+			case BitOpType::UBit:		out.Value = reader.read_ubit(op.Bits); break;
+			case BitOpType::SBit:		out.Value = static_cast<uint64_t>(static_cast<int64_t>(reader.read_sbit(op.Bits))); break;
+			case BitOpType::UInt32:		out.Value = reader.read_uint32(); break;
+			case BitOpType::UInt64:		out.Value = reader.read_uint64(); break;
+			case BitOpType::SInt32:		out.Value = static_cast<uint32_t>(reader.read_int32()); break;
+			case BitOpType::SInt64:		out.Value = static_cast<uint64_t>(reader.read_int64()); break;
+			case BitOpType::Coord:		out.Floats[0] = reader.read_coord(); break;
+			case BitOpType::CoordMP:	out.Floats[0] = reader.read_coord_mp(op.Bits & 1, op.Bits & 2); break;
+			case BitOpType::Normal:		out.Floats[0] = reader.read_normal(); break;
+			case BitOpType::UBitVar:	out.Value = reader.read_ubit_var(); break;
+			case BitOpType::Vec3:		reader.read_vec3(out.Floats); break;
+			case BitOpType::Angle:		out.Floats[0] = reader.read_angle(op.Bits); break;
+			case BitOpType::String:
+			{
+				char text[256];
+				reader.read_string(text, sizeof(text));
+				out.Text = text;
+				break;
+			}
+			case BitOpType::Bits:
+				out.Raw.resize(op.Raw.size());
+				reader.read_bits(out.Raw.data(), op.Bits);
+				if (op.Bits & 7)
+					out.Raw.back() &= (1u << (op.Bits & 7)) - 1;
+				break;
+
+			case BitOpType::UBitArray:
+				out.Array.resize(op.Array.size());
+				if constexpr (requires { reader.read_ubit_array(out.Array.data(), 0, 1); })
+					reader.read_ubit_array(out.Array.data(), static_cast<int>(out.Array.size()), op.Bits);
+				else
+				{
+					for (auto& value : out.Array)
+						value = reader.read_ubit(op.Bits);
+				}
+				break;
+
+			case BitOpType::CoordArray:
+				out.FloatArray.resize(op.FloatArray.size());
+				if constexpr (requires { reader.read_coord_array(out.FloatArray.data(), 0); })
+					reader.read_coord_array(out.FloatArray.data(), static_cast<int>(out.FloatArray.size()));
+				else
+				{
+					for (auto& value : out.FloatArray)
+						value = reader.read_coord();
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+		return result;
+	}
+
+
+	inline bool same_float(float a, float b) noexcept
+	{
+		// -0 and 0 are the same coord
+		return a == b || (std::isnan(a) && std::isnan(b));
+	}
+
+	/// <summary>
+	/// Decoded values of two readers of the same stream, both must agree bit for bit
+	/// </summary>
+	inline bool same_result(const BitOp& a, const BitOp& b) noexcept
+	{
+		return a.Type == b.Type && a.Value == b.Value && a.Text == b.Text && a.Raw == b.Raw && a.Array == b.Array &&
+			std::equal(a.Floats, a.Floats + 3, b.Floats, same_float) &&
+			std::equal(a.FloatArray.begin(), a.FloatArray.end(), b.FloatArray.begin(), b.FloatArray.end(), same_float);
+	}
+
+	/// <summary>
+	/// Decoded value against the value that was written
+	/// </summary>
+	inline bool round_trips(const BitOp& written, const BitOp& read) noexcept
+	{
+		switch (written.Type)
+		{
+		case BitOpType::UInt32:
+		case BitOpType::SInt32:
+			return static_cast<uint32_t>(written.Value) == static_cast<uint32_t>(read.Value);
+
+		case BitOpType::Normal:
+			return std::abs(written.Floats[0] - read.Floats[0]) <= bit_buffer_constants::normal_resolution * 1.01f;
+
+		case BitOpType::Angle:
+		{
+			// Truncated to the field's resolution, 360 wraps to 0
+			const float resolution = 360.f / static_cast<float>(1u << written.Bits);
+			const float delta = std::abs(written.Floats[0] - read.Floats[0]);
+			return delta <= resolution * 1.01f || std::abs(delta - 360.f) <= resolution * 1.01f;
+		}
+
+		default:
+			return same_result(written, read);
+		}
+	}
+}
@@ -0,0 +1,51 @@
+// Stand-in for libFuzzer's main when the compiler doesn't provide it (gcc, MSVC):
+// runs every file given on the command line, then -runs=N random inputs of up to -max_len=N bytes from -seed=N.
+// The fuzz targets abort on the first mismatch, ctest reports the failure
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char** argv)
+{
+	size_t runs = 1000;
+	size_t max_len = 4096;
+	uint64_t seed = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (!std::strncmp(argv[i], "-runs=", 6))
+			runs = std::strtoull(argv[i] + 6, nullptr, 10);
+		else if (!std::strncmp(argv[i], "-max_len=", 9))
+			max_len = std::strtoull(argv[i] + 9, nullptr, 10);
+		else if (!std::strncmp(argv[i], "-seed=", 6))
+			seed = std::strtoull(argv[i] + 6, nullptr, 10);
+		else if (argv[i][0] != '-')
+		{
+			std::ifstream file(argv[i], std::ios::binary);
+			const std::vector<uint8_t> input{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+			LLVMFuzzerTestOneInput(input.data(), input.size());
+		}
+	}
+
+	std::mt19937_64 rng(seed);
+	std::vector<uint8_t> input;
+	for (size_t run = 0; run < runs; run++)
+	{
+		// Mostly short inputs, the programs they decode to exercise every op
+		input.resize(rng() % (run & 7 ? std::min<size_t>(max_len, 256) + 1 : max_len + 1));
+		for (auto& byte : input)
+			byte = static_cast<uint8_t>(rng());
+
+		LLVMFuzzerTestOneInput(input.data(), input.size());
+	}
+
+	std::printf("Done %zu runs\n", runs);
+	return 0;
+}
@@ -0,0 +1,56 @@
+// Differential check of the fast paths of bf_write and bf_read (byte-aligned varints and strings, bulk bits, arrays)
+// against the same codecs issued one write_ubit/read_ubit at a time
+#include "BitBaseline.hpp"
+#include "BitOps.hpp"
+
+using namespace tf2_tests;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	FuzzInput input(data, size);
+	// Half of the streams start on a byte, where the aligned paths kick in
+	const uint8_t start = input.take<uint8_t>();
+	const int start_bit = start & 1 ? (start & 0x38) : (start >> 2);
+	const BitProgram program = make_program(input, BitOps_All);
+
+	const size_t num_words = BitProgram_MaxBits / 32 + 4;
+	const int num_bytes = static_cast<int>(num_words * sizeof(uint32_t));
+
+	std::vector<uint32_t> fast_words(num_words);
+	bf_write fast_writer;
+	fast_writer.start_writing(fast_words.data(), num_bytes, start_bit);
+	write_program(fast_writer, program);
+
+	std::vector<uint32_t> baseline_words(num_words);
+	bf_write baseline_buffer;
+	baseline_buffer.start_writing(baseline_words.data(), num_bytes, start_bit);
+	BaselineWriter baseline_writer(baseline_buffer);
+	write_program(baseline_writer, program);
+
+	const int end_bit = fast_writer.bits_written();
+	FUZZ_CHECK(!fast_writer.has_overflown() && !baseline_buffer.has_overflown());
+	FUZZ_CHECK(baseline_buffer.bits_written() == end_bit);
+	FUZZ_CHECK(std::equal(fast_words.begin(), fast_words.begin() + (end_bit + 31) / 32, baseline_words.begin()));
+
+	bf_read fast_reader;
+	fast_reader.start_reading(fast_words.data(), num_bytes, start_bit, end_bit);
+	const BitProgram fast = read_program(fast_reader, program);
+
+	bf_read baseline_buffer_reader;
+	baseline_buffer_reader.start_reading(fast_words.data(), num_bytes, start_bit, end_bit);
+	BaselineReader baseline_reader(baseline_buffer_reader);
+	const BitProgram baseline = read_program(baseline_reader, program);
+
+	bf_read_buffered buffered_reader;
+	buffered_reader.start_reading(fast_words.data(), num_bytes, start_bit, end_bit);
+	const BitProgram buffered = read_program(buffered_reader, program);
+
+	FUZZ_CHECK(fast_reader.bits_written() == end_bit && baseline_buffer_reader.bits_written() == end_bit);
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		FUZZ_CHECK(same_result(fast[i], baseline[i]));
+		FUZZ_CHECK(same_result(buffered[i], baseline[i]));
+	}
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+// Differential check of px::bitbuf_t, through schema::px_writer and schema::px_reader, against bf_write and bf_read:
+// both must produce the same bytes and each must read the other's stream
+#include <tf2/utils/bitbuf_schema.hpp>
+#include "BitOps.hpp"
+
+using namespace tf2_tests;
+
+namespace
+{
+	template<typename _Traits>
+	void write_px(schema::px_writer<_Traits>& writer, const BitProgram& program)
+	{
+		for (const auto& op : program)
+		{
+			switch (op.Type)
+			{
+			case BitOpType::Bit:		writer.write_bit(static_cast<int>(op.Value)); break;
+			case BitOpType::UBit:		writer.write_ubit(static_cast<uint32_t>(op.Value), op.Bits); break;
+			case BitOpType::UInt32:		writer.write_uint32(static_cast<uint32_t>(op.Value)); break;
+			case BitOpType::UInt64:		writer.write_uint64(op.Value); break;
+			case BitOpType::SInt32:		writer.write_sint32(static_cast<int32_t>(op.Value)); break;
+			case BitOpType::SInt64:		writer.write_sint64(static_cast<int64_t>(op.Value)); break;
+			case BitOpType::Coord:		writer.write_coord(op.Floats[0]); break;
+			case BitOpType::String:		writer.write_string(op.Text.c_str()); break;
+			default: break;
+			}
+		}
+	}
+
+	template<typename _Traits>
+	BitProgram read_px(schema::px_reader<_Traits>& reader, const BitProgram& program)
+	{
+		BitProgram result;
+		for (const auto& op : program)
+		{
+			BitOp& out = result.emplace_back();
+			out.Type = op.Type;
+			out.Bits = op.Bits;
+
+			switch (op.Type)
+			{
+			case BitOpType::Bit:		out.Value = static_cast<uint64_t>(reader.read_bit()); break;
+			case BitOpType::UBit:		out.Value = reader.read_ubit(op.Bits); break;
+			case BitOpType::UInt32:		out.Value = reader.read_uint32(); break;
+			case BitOpType::UInt64:		out.Value = reader.read_uint64(); break;
+			case BitOpType::SInt32:		out.Value = static_cast<uint32_t>(reader.read_int32()); break;
+			case BitOpType::SInt64:		out.Value = static_cast<uint64_t>(reader.read_int64()); break;
+			case BitOpType::Coord:		out.Floats[0] = reader.read_coord(); break;
+			case BitOpType::String:
+			{
+				char text[256];
+				reader.read_string(text, sizeof(text));
+				out.Text = text;
+				break;
+			}
+			default: break;
+			}
+		}
+		return result;
+	}
+}
+
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	FuzzInput input(data, size);
+	const int start_bit = input.take<uint8_t>() & 31;
+	const BitProgram program = make_program(input, BitOps_Px);
+
+	// px::bitbuf_t starts at bit 0, the offset is a run of zeros in both streams
+	px::bitbuf px_buffer;
+	schema::px_writer px_writer(px_buffer);
+	if (start_bit)
+		px_writer.write_ubit(0, start_bit);
+	write_px(px_writer, program);
+
+	std::vector<uint32_t> words(BitProgram_MaxBits / 32 + 4);
+	bf_write bf_writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+	if (start_bit)
+		bf_writer.write_ubit(0, start_bit);
+	write_program(bf_writer, program);
+
+	const int end_bit = bf_writer.bits_written();
+	FUZZ_CHECK(!px_writer.has_overflown() && !bf_writer.has_overflown());
+	FUZZ_CHECK(px_buffer.write_get() == static_cast<size_t>(end_bit));
+
+	const size_t num_bytes = (end_bit + 7) / 8;
+	FUZZ_CHECK(px_buffer.size() >= num_bytes);
+	// Bits past the end of the px stream are unspecified
+	FUZZ_CHECK(std::equal(px_buffer.data(), px_buffer.data() + end_bit / 8, reinterpret_cast<const uint8_t*>(words.data())));
+	if (end_bit & 7)
+	{
+		const uint8_t mask = static_cast<uint8_t>((1u << (end_bit & 7)) - 1);
+		FUZZ_CHECK((px_buffer.data()[end_bit / 8] & mask) == (reinterpret_cast<const uint8_t*>(words.data())[end_bit / 8] & mask));
+	}
+
+	// bf_read over the px stream
+	bf_read bf_reader;
+	bf_reader.start_reading(px_buffer.data(), static_cast<int>(num_bytes), start_bit, end_bit);
+	const BitProgram bf_decoded = read_program(bf_reader, program);
+	FUZZ_CHECK(!bf_reader.has_overflown());
+
+	// px_reader over the bf stream
+	bf_read view_source(words.data(), static_cast<int>(num_bytes), end_bit);
+	view_source.seek(start_bit);
+	px::ibitbuf_view view = make_bitbuf_view(view_source);
+	schema::px_reader px_reader(view);
+	const BitProgram px_decoded = read_px(px_reader, program);
+	FUZZ_CHECK(!px_reader.has_overflown());
+
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		FUZZ_CHECK(round_trips(program[i], bf_decoded[i]));
+		FUZZ_CHECK(same_result(bf_decoded[i], px_decoded[i]));
+	}
+
+	return 0;
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+// Data tables of a few TF2 server classes and the delta streams of a replay over them,
+// shared by the FlatSendTable test and benchmark
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <tf2/gameprop/FlatSendTable.hpp>
+
+namespace tf2_tests
+{
+	using namespace tf2;
+
+	struct FixtureProp
+	{
+		Const::PropType	Type;
+		std::string		Name;
+		uint32_t		Flags{ };
+		int				Bits{ };
+		float			LowValue{ };
+		float			HighValue{ };
+		// Array only, the element is the prop right before it
+		int				NumElements{ };
+		// Odds of the prop changing on a tick
+		float			ChangeRate{ 0.02f };
+	};
+
+	struct FixtureClass
+	{
+		int							ClassID;
+		const char*					Name;
+		const char*					TableName;
+		std::vector<FixtureProp>	Props;
+	};
+
+
+	/// <summary>
+	/// A player, a rocket and a sentry gun: the hot props (origin, angles, simulation time) change on most ticks,
+	/// the rest once in a while
+	/// </summary>
+	inline std::vector<FixtureClass> fixture_classes()
+	{
+		namespace PF = Const::PropFlags;
+		using Const::PropType;
+
+		std::vector<FixtureClass> classes;
+
+		classes.push_back({ 0, "CTFPlayer", "DT_TFPlayer", {
+			{ PropType::Vector,	"m_vecOrigin",				PF::CoordMP | PF::ChagesOften, 0, 0.f, 0.f, 0, 0.95f },
+			{ PropType::Float,	"m_angEyeAngles[0]",		PF::ChagesOften, 8, -90.f, 90.f, 0, 0.8f },
+			{ PropType::Float,	"m_angEyeAngles[1]",		PF::ChagesOften, 10, 0.f, 360.f, 0, 0.9f },
+			{ PropType::Int,	"m_flSimulationTime",		PF::Unsigned | PF::ChagesOften, 8, 0.f, 0.f, 0, 1.f },
+			{ PropType::Int,	"m_nTickBase",				PF::ChagesOften, 32, 0.f, 0.f, 0, 0.5f },
+			{ PropType::Float,	"m_vecVelocity[0]",			PF::NoScale, 32, 0.f, 0.f, 0, 0.6f },
+			{ PropType::Float,	"m_vecVelocity[1]",			PF::NoScale, 32, 0.f, 0.f, 0, 0.6f },
+			{ PropType::Float,	"m_vecVelocity[2]",			PF::NoScale, 32, 0.f, 0.f, 0, 0.4f },
+			{ PropType::Float,	"m_vecViewOffset[2]",		PF::Coord, 0, 0.f, 0.f, 0, 0.05f },
+			{ PropType::Int,	"m_iHealth",				0, 10, 0.f, 0.f, 0, 0.1f },
+			{ PropType::Int,	"m_fFlags",					PF::Unsigned, 11, 0.f, 0.f, 0, 0.1f },
+			{ PropType::Int,	"m_nPlayerCond",			PF::Unsigned, 32, 0.f, 0.f, 0, 0.05f },
+			{ PropType::Int,	"m_iClass",					PF::Unsigned, 4, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_hActiveWeapon",			PF::Unsigned, 21, 0.f, 0.f, 0, 0.03f },
+			{ PropType::Int,	"m_iFOV",					PF::Unsigned, 8, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_nWaterLevel",			PF::Unsigned, 2, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Float,	"m_flMaxspeed",				PF::NoScale, 0, 0.f, 0.f, 0, 0.02f },
+			{ PropType::Float,	"m_flDucktime",				0, 12, 0.f, 2048.f, 0, 0.05f },
+			{ PropType::Int,	"m_nDisguiseTeam",			PF::Unsigned, 3, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_iCritMult",				PF::Unsigned, 8, 0.f, 0.f, 0, 0.05f },
+			{ PropType::Int,	"m_iSpawnCounter",			PF::VarInt, 0, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Float,	"m_flChargeMeter",			0, 11, 0.f, 100.f, 0, 0.1f },
+			{ PropType::Int,	"m_iAmmo",					PF::Unsigned | PF::InsideArray, 10 },
+			{ PropType::Array,	"m_iAmmo",					0, 0, 0.f, 0.f, 32, 0.05f },
+			{ PropType::String,	"m_szLastPlaceName",		0, 0, 0.f, 0.f, 0, 0.01f },
+		} });
+
+		classes.push_back({ 1, "CTFProjectile_Rocket", "DT_TFProjectile_Rocket", {
+			{ PropType::Vector,	"m_vecOrigin",				PF::Coord | PF::ChagesOften, 0, 0.f, 0.f, 0, 1.f },
+			{ PropType::Vector,	"m_angRotation",			PF::ChagesOften, 13, 0.f, 360.f, 0, 0.3f },
+			{ PropType::Int,	"m_flSimulationTime",		PF::Unsigned | PF::ChagesOften, 8, 0.f, 0.f, 0, 1.f },
+			{ PropType::Vector,	"m_vInitialVelocity",		PF::NoScale, 0, 0.f, 0.f, 0, 0.02f },
+			{ PropType::Int,	"m_iTeamNum",				0, 6, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_hOwnerEntity",			PF::Unsigned, 21, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_bCritical",				PF::Unsigned, 1, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_nModelIndex",			0, 13, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Vector,	"m_vecMins",				PF::Coord, 0, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Vector,	"m_vecMaxs",				PF::Coord, 0, 0.f, 0.f, 0, 0.01f },
+		} });
+
+		classes.push_back({ 2, "CObjectSentrygun", "DT_ObjectSentrygun", {
+			{ PropType::Int,	"m_iAmmoShells",			PF::Unsigned, 9, 0.f, 0.f, 0, 0.5f },
+			{ PropType::Int,	"m_iAmmoRockets",			PF::Unsigned, 6, 0.f, 0.f, 0, 0.1f },
+			{ PropType::Int,	"m_iState",					PF::Unsigned, 3, 0.f, 0.f, 0, 0.05f },
+			{ PropType::Int,	"m_iUpgradeLevel",			PF::Unsigned, 3, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_iHealth",				0, 13, 0.f, 0.f, 0, 0.2f },
+			{ PropType::Int,	"m_iMaxHealth",				0, 13, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_bBuilding",				PF::Unsigned, 1, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Int,	"m_bDisabled",				PF::Unsigned, 1, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Float,	"m_flPercentageConstructed", 0, 8, 0.f, 1.f, 0, 0.05f },
+			{ PropType::Int,	"m_iKills",					PF::Unsigned | PF::VarInt, 0, 0.f, 0.f, 0, 0.02f },
+			{ PropType::Vector,	"m_vecOrigin",				PF::CoordMP_INT, 0, 0.f, 0.f, 0, 0.01f },
+			{ PropType::Vector,	"m_angRotation",			0, 13, 0.f, 360.f, 0, 0.3f },
+			{ PropType::Float,	"m_flCycle",				PF::Normal, 0, 0.f, 0.f, 0, 0.5f },
+		} });
+
+		return classes;
+	}
+
+
+	/// <summary>
+	/// The payload of a dem_datatables frame describing 'classes'
+	/// </summary>
+	inline void write_datatables(utils::bf_write& writer, const std::vector<FixtureClass>& classes)
+	{
+		for (const auto& server_class : classes)
+		{
+			writer.write_bit(1);
+			writer.write_bit(1);
+			writer.write_string(server_class.TableName);
+			writer.write_ubit(static_cast<uint32_t>(server_class.Props.size()), Const::SendTable_NumPropsBits);
+
+			for (const auto& prop : server_class.Props)
+			{
+				writer.write_ubit(static_cast<uint32_t>(prop.Type), Const::SendTable_PropTypeBits);
+				writer.write_string(prop.Name.c_str());
+				writer.write_ubit(prop.Flags, Const::SendTable_PropFlagsBits);
+
+				if (prop.Type == Const::PropType::Array)
+					writer.write_ubit(prop.NumElements, Const::SendTable_NumElementsBits);
+				else
+				{
+					writer.write_float(prop.LowValue);
+					writer.write_float(prop.HighValue);
+					writer.write_ubit(prop.Bits, Const::SendTable_NumBitsBits);
+				}
+			}
+		}
+		writer.write_bit(0);
+
+		writer.write_short(static_cast<int16_t>(classes.size()));
+		for (const auto& server_class : classes)
+		{
+			writer.write_short(static_cast<int16_t>(server_class.ClassID));
+			writer.write_string(server_class.Name);
+			writer.write_string(server_class.TableName);
+		}
+	}
+
+
+	/// <summary>
+	/// Deltas of one server class over consecutive ticks
+	/// </summary>
+	class DeltaReplay
+	{
+	public:
+		DeltaReplay(const FlatSendTable& flat, const FixtureClass& fixture, int ticks, uint32_t seed = 1)
+		{
+			std::mt19937 rng(seed);
+			std::uniform_real_distribution<float> odds;
+
+			// The flat props are reordered, their rates are looked up by name
+			std::vector<float> rates;
+			for (const auto& prop : flat.props())
+			{
+				float rate = 0.f;
+				for (const auto& fixture_prop : fixture.Props)
+				{
+					if (prop.Prop->Name == fixture_prop.Name && !(fixture_prop.Flags & Const::PropFlags::InsideArray))
+						rate = fixture_prop.ChangeRate;
+				}
+				rates.push_back(rate);
+			}
+
+			utils::bf_write writer(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+			for (int tick = 0; tick < ticks; tick++)
+			{
+				Starts.push_back(writer.bits_written());
+
+				int last = -1;
+				for (size_t i = 0; i < rates.size(); i++)
+				{
+					if (odds(rng) >= rates[i])
+						continue;
+
+					writer.write_bit(1);
+					writer.write_ubit_var(static_cast<uint32_t>(static_cast<int>(i) - last - 1));
+					write_prop(writer, flat.props()[i], rng);
+					last = static_cast<int>(i);
+					NumProps++;
+				}
+				writer.write_bit(0);
+			}
+
+			Bits = writer.bits_written();
+			Overflow = writer.has_overflown();
+		}
+
+		[[nodiscard]] utils::bf_read reader() const { return utils::bf_read(Words.data(), (Bits + 7) >> 3, Bits); }
+		[[nodiscard]] utils::bf_read_buffered buffered_reader() const { return utils::bf_read_buffered(Words.data(), (Bits + 7) >> 3, Bits); }
+
+		[[nodiscard]] const uint32_t* data() const noexcept { return Words.data(); }
+		[[nodiscard]] int bytes() const noexcept { return (Bits + 7) >> 3; }
+		[[nodiscard]] int bits() const noexcept { return Bits; }
+		[[nodiscard]] size_t num_ticks() const noexcept { return Starts.size(); }
+		[[nodiscard]] size_t num_props() const noexcept { return NumProps; }
+		[[nodiscard]] int tick_start(size_t tick) const noexcept { return Starts[tick]; }
+		[[nodiscard]] bool has_overflown() const noexcept { return Overflow; }
+
+	private:
+		static void write_value(utils::bf_write& writer, const FlatPropCodec& codec, std::mt19937& rng)
+		{
+			using Const::FlatPropKind;
+			using Const::FlatFloatKind;
+
+			auto write_float = [&]()
+			{
+				const float value = static_cast<float>(rng() % 200000) / 32.f - 3000.f;
+				switch (codec.FloatKind)
+				{
+				case FlatFloatKind::Coord:			writer.write_coord(value); break;
+				case FlatFloatKind::CoordMP:		writer.write_coord_mp(value, false, false); break;
+				case FlatFloatKind::CoordMP_LP:		writer.write_coord_mp(value, false, true); break;
+				case FlatFloatKind::CoordMP_INT:	writer.write_coord_mp(value, true, false); break;
+				case FlatFloatKind::NoScale:		writer.write_float(value); break;
+				case FlatFloatKind::Normal:			writer.write_normal(static_cast<float>(rng() % 2001) / 1000.f - 1.f); break;
+				default:							writer.write_ubit(static_cast<uint32_t>(rng() & ((uint64_t(1) << codec.Bits) - 1)), codec.Bits); break;
+				}
+			};
+
+			switch (codec.Kind)
+			{
+			case FlatPropKind::UInt:
+			case FlatPropKind::SInt:
+				writer.write_ubit(static_cast<uint32_t>(rng() & ((uint64_t(1) << codec.Bits) - 1)), codec.Bits);
+				break;
+			case FlatPropKind::UVarInt:
+				writer.write_uint32(rng() % 5000);
+				break;
+			case FlatPropKind::SVarInt:
+				writer.write_sint32(static_cast<int32_t>(rng() % 5000) - 2500);
+				break;
+			case FlatPropKind::Float:
+				write_float();
+				break;
+			case FlatPropKind::Vector:
+				write_float();
+				write_float();
+				write_float();
+				break;
+			case FlatPropKind::VectorNormal:
+				write_float();
+				write_float();
+				writer.write_bit(rng() & 1);
+				break;
+			case FlatPropKind::VectorXY:
+				write_float();
+				write_float();
+				break;
+			default:
+				writer.write_ubit(0, Const::SendTable_StringBits);
+				break;
+			}
+		}
+
+		static void write_prop(utils::bf_write& writer, const FlatSendProp& prop, std::mt19937& rng)
+		{
+			if (prop.Codec.Kind == Const::FlatPropKind::Array)
+			{
+				const uint32_t count = rng() % (prop.MaxElements + 1);
+				writer.write_ubit(count, prop.CountBits);
+				for (uint32_t i = 0; i < count; i++)
+					write_value(writer, prop.Element, rng);
+			}
+			else if (prop.Codec.Kind == Const::FlatPropKind::String)
+			{
+				static constexpr char place[] = "BLU Spawn";
+				writer.write_ubit(sizeof(place) - 1, Const::SendTable_StringBits);
+				writer.write_bytes(place, sizeof(place) - 1);
+			}
+			else
+				write_value(writer, prop.Codec, rng);
+		}
+
+	private:
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(1 << 20);
+		std::vector<int>		Starts;
+		size_t					NumProps{ };
+		int						Bits{ };
+		bool					Overflow{ };
+	};
+}
@@ -0,0 +1,150 @@
+#include <cstring>
+
+#include <gtest/gtest.h>
+#include "FlatSendTableFixture.hpp"
+
+using namespace tf2_tests;
+
+namespace
+{
+	struct Tables
+	{
+		explicit Tables(const std::vector<FixtureClass>& classes)
+		{
+			std::vector<uint32_t> words(1 << 14);
+			utils::bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+			write_datatables(writer, classes);
+
+			utils::bf_read reader(words.data(), writer.bytes_written());
+			Valid = !writer.has_overflown() && Set.read_datatables(reader) && Set.flatten();
+		}
+
+		FlatSendTableSet	Set;
+		bool				Valid{ };
+	};
+
+	// Every tick of 'replay', each delta ends where the next one starts and every prop written is read
+	void verify_replay(const FlatSendTable& flat, const DeltaReplay& replay)
+	{
+		FlatEntityState entity;
+		flat.init_state(entity);
+		std::vector<uint16_t> changed;
+
+		utils::bf_read reader = replay.reader();
+		for (size_t i = 0; i < replay.num_ticks(); i++)
+		{
+			ASSERT_EQ(reader.bits_written(), replay.tick_start(i)) << flat.server_class().Name << " tick " << i;
+			ASSERT_TRUE(flat.read_delta(reader, entity, &changed)) << flat.server_class().Name << " tick " << i;
+		}
+		EXPECT_EQ(reader.bits_left(), 0);
+		EXPECT_EQ(changed.size(), replay.num_props());
+	}
+
+	// A prop of every fixed width for the integer, scaled float and vector kinds
+	FixtureClass every_width_class()
+	{
+		namespace PF = Const::PropFlags;
+		using Const::PropType;
+
+		FixtureClass server_class{ 0, "CEveryWidth", "DT_EveryWidth", { } };
+		for (int bits = 1; bits <= 32; bits++)
+		{
+			const std::string suffix = std::to_string(bits);
+			server_class.Props.push_back({ PropType::Int, "uint" + suffix, PF::Unsigned, bits, 0.f, 0.f, 0, 0.5f });
+			server_class.Props.push_back({ PropType::Int, "sint" + suffix, 0, bits, 0.f, 0.f, 0, 0.5f });
+			server_class.Props.push_back({ PropType::Float, "float" + suffix, 0, bits, -1.f, 1.f, 0, 0.5f });
+			server_class.Props.push_back({ PropType::Vector, "vector" + suffix, 0, bits, 0.f, 360.f, 0, 0.5f });
+		}
+		return server_class;
+	}
+}
+
+
+TEST(FlatSendTable, FixtureClassesFlatten)
+{
+	const auto classes = fixture_classes();
+	Tables tables(classes);
+	ASSERT_TRUE(tables.Valid);
+
+	for (const auto& server_class : classes)
+	{
+		const FlatSendTable* flat = tables.Set.find_class(server_class.ClassID);
+		ASSERT_NE(flat, nullptr);
+		EXPECT_EQ(flat->server_class().Name, server_class.Name);
+	}
+}
+
+TEST(FlatSendTable, ReplayEveryClass)
+{
+	const auto classes = fixture_classes();
+	Tables tables(classes);
+	ASSERT_TRUE(tables.Valid);
+
+	for (const auto& server_class : classes)
+	{
+		const FlatSendTable& flat = *tables.Set.find_class(server_class.ClassID);
+		const DeltaReplay replay(flat, server_class, 500);
+		ASSERT_FALSE(replay.has_overflown());
+		verify_replay(flat, replay);
+	}
+}
+
+TEST(FlatSendTable, EveryWidth)
+{
+	const std::vector<FixtureClass> classes{ every_width_class() };
+	Tables tables(classes);
+	ASSERT_TRUE(tables.Valid);
+
+	const FlatSendTable& flat = *tables.Set.find_class(0);
+	for (uint32_t seed : { 1u, 2u, 3u })
+	{
+		const DeltaReplay replay(flat, classes[0], 100, seed);
+		verify_replay(flat, replay);
+	}
+}
+
+TEST(FlatSendTable, ReadersAgree)
+{
+	const auto classes = fixture_classes();
+	Tables tables(classes);
+	ASSERT_TRUE(tables.Valid);
+
+	const FlatSendTable& flat = *tables.Set.find_class(0);
+	const DeltaReplay replay(flat, classes[0], 200);
+
+	FlatEntityState from_bf_read, from_buffered;
+	std::vector<uint16_t> changed_bf_read, changed_buffered;
+	utils::bf_read reader = replay.reader();
+	utils::bf_read_buffered buffered = replay.buffered_reader();
+	for (size_t i = 0; i < replay.num_ticks(); i++)
+	{
+		ASSERT_TRUE(flat.read_delta(reader, from_bf_read, &changed_bf_read));
+		ASSERT_TRUE(flat.read_delta(buffered, from_buffered, &changed_buffered));
+		ASSERT_EQ(reader.bits_written(), buffered.bits_written());
+	}
+
+	EXPECT_EQ(changed_bf_read, changed_buffered);
+	EXPECT_EQ(changed_bf_read.size(), replay.num_props());
+	EXPECT_EQ(0, std::memcmp(from_bf_read.Values.data(), from_buffered.Values.data(), from_bf_read.Values.size() * sizeof(FlatPropValue)));
+	EXPECT_EQ(from_bf_read.Strings, from_buffered.Strings);
+}
+
+TEST(FlatSendTable, TruncatedDelta)
+{
+	const auto classes = fixture_classes();
+	Tables tables(classes);
+	ASSERT_TRUE(tables.Valid);
+
+	const FlatSendTable& flat = *tables.Set.find_class(0);
+	const DeltaReplay replay(flat, classes[0], 20);
+
+	// Cut in the middle of the last tick
+	const int end_bit = (replay.tick_start(replay.num_ticks() - 1) + replay.bits()) / 2;
+	FlatEntityState entity;
+	flat.init_state(entity);
+
+	utils::bf_read reader(replay.data(), (end_bit + 7) >> 3, end_bit);
+	reader.seek(replay.tick_start(replay.num_ticks() - 1));
+	EXPECT_FALSE(flat.read_delta(reader, entity));
+	EXPECT_TRUE(reader.has_overflown());
+}
@@ -0,0 +1,124 @@
+// CRC32_ProcessBuffer must match the byte-table loop on every size and alignment, through slicing-by-16 and PCLMUL alike,
+// and CRC32_Combine must match the CRC of the whole buffer at every split
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/utils/Checksum.hpp>
+
+using namespace tf2;
+using namespace tf2::utils;
+
+namespace
+{
+	// Buffers below this size only go through slicing-by-16, larger ones fold their 16 bytes blocks with PCLMUL when the CPU has it
+	constexpr int PCLMUL_MinSize = 64;
+	constexpr int MaxSize = 4096 + 100;
+	constexpr int MaxOffset = 16;
+
+	std::vector<uint8_t> make_data()
+	{
+		std::mt19937 rng(0xC4C32);
+		std::vector<uint8_t> data(MaxSize + MaxOffset);
+		for (auto& byte : data)
+			byte = static_cast<uint8_t>(rng());
+		return data;
+	}
+
+	CRC32_t reference_crc(CRC32_t crc, const uint8_t* pb, int size)
+	{
+		while (size--)
+			crc = CRC32_GetTableEntry(*pb++ ^ static_cast<uint8_t>(crc)) ^ (crc >> 8);
+		return crc;
+	}
+
+	CRC32_t reference_single(const uint8_t* pb, int size)
+	{
+		CRC32_t crc;
+		CRC32_Init(&crc);
+		crc = reference_crc(crc, pb, size);
+		CRC32_Final(&crc);
+		return crc;
+	}
+}
+
+
+TEST(Checksum, KnownValues)
+{
+	EXPECT_EQ(CRC32_ProcessSingleBuffer("", 0), 0u);
+	EXPECT_EQ(CRC32_ProcessSingleBuffer("123456789", 9), 0xCBF43926u);
+
+	const std::vector<uint8_t> zeros(4096);
+	EXPECT_EQ(CRC32_ProcessSingleBuffer(zeros.data(), static_cast<int>(zeros.size())), reference_single(zeros.data(), 4096));
+
+	// Nothing to process, the state is left as is
+	CRC32_t crc = 0x12345678;
+	CRC32_ProcessBuffer(&crc, zeros.data(), 0);
+	CRC32_ProcessBuffer(&crc, zeros.data(), -1);
+	EXPECT_EQ(crc, 0x12345678u);
+}
+
+TEST(Checksum, EverySizeAndOffset)
+{
+	const auto data = make_data();
+	for (int offset = 0; offset < MaxOffset; offset++)
+	{
+		const uint8_t* pb = data.data() + offset;
+		for (int size = 0; size <= MaxSize; size += size < 2 * PCLMUL_MinSize + 16 ? 1 : 13)
+		{
+			ASSERT_EQ(CRC32_ProcessSingleBuffer(pb, size), reference_single(pb, size)) << "size " << size << ", offset " << offset;
+		}
+	}
+}
+
+TEST(Checksum, IncrementalUpdates)
+{
+	const auto data = make_data();
+
+	// Chunks on both sides of the PCLMUL threshold, each update starts where the last one left the CRC
+	for (int chunk : { 1, 7, 15, 16, 17, 63, 64, 65, 127, 200, 1000 })
+	{
+		CRC32_t crc, expected;
+		CRC32_Init(&crc);
+		CRC32_Init(&expected);
+		for (int start = 0; start < MaxSize; start += chunk)
+		{
+			const int size = std::min(chunk, MaxSize - start);
+			CRC32_ProcessBuffer(&crc, data.data() + start + 3, size);
+			expected = reference_crc(expected, data.data() + start + 3, size);
+		}
+		EXPECT_EQ(crc, expected) << "chunk " << chunk;
+	}
+}
+
+TEST(Checksum, Combine)
+{
+	const auto data = make_data();
+
+	for (int size : { 0, 1, 15, 16, 64, 100, 1500, 4096 })
+	{
+		const CRC32_t whole = CRC32_ProcessSingleBuffer(data.data(), size);
+		for (int split = 0; split <= size; split += size < 100 ? 1 : 37)
+		{
+			const CRC32_t crc1 = CRC32_ProcessSingleBuffer(data.data(), split);
+			const CRC32_t crc2 = CRC32_ProcessSingleBuffer(data.data() + split, size - split);
+			ASSERT_EQ(CRC32_Combine(crc1, crc2, size - split), whole) << "size " << size << ", split " << split;
+		}
+
+		// An empty second buffer leaves the first CRC as is
+		EXPECT_EQ(CRC32_Combine(whole, CRC32_ProcessSingleBuffer(data.data(), 0), 0), whole);
+		EXPECT_EQ(CRC32_Combine(whole, 0, 0), whole);
+	}
+
+	// Combined in a tree, as the parts of a buffer hashed in parallel would be
+	constexpr int part = 1000;
+	CRC32_t crc = CRC32_ProcessSingleBuffer(data.data(), part);
+	for (int start = part; start < MaxSize; start += part)
+	{
+		const int size = std::min(part, MaxSize - start);
+		crc = CRC32_Combine(crc, CRC32_ProcessSingleBuffer(data.data() + start, size), size);
+	}
+	EXPECT_EQ(crc, reference_single(data.data(), MaxSize));
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// Reference for the LZSS codec: a direct port of the engine's CLZSS::Uncompress and the inputs shared by the test and the benchmark
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <tf2/utils/Lzss.hpp>
+
+namespace tf2_tests
+{
+	using namespace tf2::utils;
+
+	/// <summary>
+	/// The engine's decoder, one byte at a time with no bounds check: only run it on valid streams
+	/// and an output with room for the header's size plus Const::LZSS_MaxMatch bytes.
+	/// Returns the header's size, 0 if the decoded size doesn't match it
+	/// </summary>
+	inline size_t engine_lzss_uncompress(const uint8_t* input, uint8_t* output)
+	{
+		uint32_t actual_size;
+		std::memcpy(&actual_size, input + 4, sizeof(actual_size));
+		input += Const::LZSS_HeaderSize;
+
+		size_t total = 0;
+		int cmd_byte = 0, get_cmd_byte = 0;
+		while (true)
+		{
+			if (!get_cmd_byte)
+				cmd_byte = *input++;
+			get_cmd_byte = (get_cmd_byte + 1) & 0x07;
+
+			if (cmd_byte & 0x01)
+			{
+				int position = *input++ << Const::LZSS_LookShift;
+				position |= (*input >> Const::LZSS_LookShift);
+				const int count = (*input++ & 0x0F) + 1;
+				if (count == 1)
+					break;
+
+				const uint8_t* source = output - position - 1;
+				for (int i = 0; i < count; i++)
+					*output++ = *source++;
+				total += count;
+			}
+			else
+			{
+				*output++ = *input++;
+				total++;
+			}
+			cmd_byte >>= 1;
+		}
+
+		return total == actual_size ? actual_size : 0;
+	}
+
+
+	enum class LzssInput
+	{
+		// Incompressible
+		Random,
+		// Paths and names, what string tables carry
+		Text,
+		// Short runs of bytes and noise, entity baselines and the like
+		Mixed,
+		// A single byte repeated, every reference overlaps its output
+		Run
+	};
+
+	inline std::vector<uint8_t> make_lzss_input(LzssInput kind, size_t size, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::vector<uint8_t> data(size);
+		switch (kind)
+		{
+		case LzssInput::Random:
+			for (auto& byte : data)
+				byte = static_cast<uint8_t>(rng());
+			break;
+
+		case LzssInput::Text:
+		{
+			static const char* const words[]{ "models/", "player/", "scout", "soldier", ".mdl", "sound/", "vo/", "_", "weapons/", "c_models/" };
+			std::string text;
+			while (text.size() < size)
+			{
+				text += words[rng() % std::size(words)];
+				if (rng() % 3 == 0)
+					text += std::to_string(rng() % 100);
+			}
+			std::memcpy(data.data(), text.data(), size);
+			break;
+		}
+
+		case LzssInput::Mixed:
+			for (size_t i = 0; i < size; i++)
+				data[i] = i % 37 < 20 ? static_cast<uint8_t>('a' + i % 7) : static_cast<uint8_t>(rng() % 4);
+			break;
+
+		case LzssInput::Run:
+			std::fill(data.begin(), data.end(), static_cast<uint8_t>('z'));
+			break;
+		}
+		return data;
+	}
+}
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "LzssReference.hpp"
+
+using namespace tf2_tests;
+
+namespace
+{
+	/// <summary>
+	/// Writes a stream item by item in the engine's format and keeps the output it decodes to
+	/// </summary>
+	class StreamBuilder
+	{
+	public:
+		StreamBuilder()
+		{
+			Stream.resize(Const::LZSS_HeaderSize);
+		}
+
+		StreamBuilder& literal(uint8_t byte)
+		{
+			next_item(false);
+			Stream.push_back(byte);
+			Output.push_back(byte);
+			return *this;
+		}
+
+		StreamBuilder& literals(std::string_view text)
+		{
+			for (char c : text)
+				literal(static_cast<uint8_t>(c));
+			return *this;
+		}
+
+		// Doesn't check the distance, invalid streams are built with it too
+		StreamBuilder& reference(size_t distance, size_t count)
+		{
+			next_item(true);
+			Stream.push_back(static_cast<uint8_t>((distance - 1) >> Const::LZSS_LookShift));
+			Stream.push_back(static_cast<uint8_t>((((distance - 1) & 0x0F) << Const::LZSS_LookShift) | (count - 1)));
+
+			for (size_t i = 0; i < count && distance <= Output.size(); i++)
+				Output.push_back(Output[Output.size() - distance]);
+			return *this;
+		}
+
+		// The end marker and the header, 'size' overrides the header's size
+		std::vector<uint8_t> finish(size_t size = ~size_t{ })
+		{
+			next_item(true);
+			Stream.push_back(0);
+			Stream.push_back(0);
+
+			const uint32_t header[2]{ Const::LZSS_Id, static_cast<uint32_t>(size == ~size_t{ } ? Output.size() : size) };
+			std::memcpy(Stream.data(), header, sizeof(header));
+			return Stream;
+		}
+
+		[[nodiscard]] const std::vector<uint8_t>& output() const noexcept { return Output; }
+
+	private:
+		void next_item(bool is_reference)
+		{
+			if (CmdBit == 8)
+			{
+				CmdOffset = Stream.size();
+				Stream.push_back(0);
+				CmdBit = 0;
+			}
+			if (is_reference)
+				Stream[CmdOffset] |= 1 << CmdBit;
+			CmdBit++;
+		}
+
+	private:
+		std::vector<uint8_t>	Stream;
+		std::vector<uint8_t>	Output;
+		size_t					CmdOffset{ };
+		int						CmdBit{ 8 };
+	};
+
+
+	struct CorpusEntry
+	{
+		const char*				Name;
+		std::vector<uint8_t>	Stream;
+		std::vector<uint8_t>	Output;
+	};
+
+	CorpusEntry make_entry(const char* name, StreamBuilder& builder)
+	{
+		std::vector<uint8_t> stream = builder.finish();
+		return { name, std::move(stream), builder.output() };
+	}
+
+	/// <summary>
+	/// Valid streams the engine can produce or accept, including what LZSS_Compress never emits
+	/// </summary>
+	std::vector<CorpusEntry> valid_corpus()
+	{
+		std::vector<CorpusEntry> corpus;
+		{
+			StreamBuilder builder;
+			builder.literals("abcdefgh");
+			corpus.push_back(make_entry("all literal group, end marker opens the next group", builder));
+		}
+		{
+			StreamBuilder builder;
+			builder.literal('a').reference(1, 16).reference(1, 16);
+			corpus.push_back(make_entry("run, every reference overlaps its output", builder));
+		}
+		{
+			StreamBuilder builder;
+			builder.literals("ab").reference(2, 2).reference(4, 2);
+			corpus.push_back(make_entry("two bytes references", builder));
+		}
+		{
+			StreamBuilder builder;
+			builder.literals("abc").reference(3, 5).reference(7, 9);
+			corpus.push_back(make_entry("period of 3, 5 and 7 bytes", builder));
+		}
+		{
+			StreamBuilder builder;
+			for (int i = 0; i < static_cast<int>(Const::LZSS_WindowSize); i++)
+				builder.literal(static_cast<uint8_t>(i * 7 + i / 256));
+			builder.reference(Const::LZSS_WindowSize, Const::LZSS_MaxMatch).reference(Const::LZSS_WindowSize, 3);
+			corpus.push_back(make_entry("reference to the start of the window", builder));
+		}
+		{
+			StreamBuilder builder;
+			builder.literals("0123456789abcdef");
+			for (int i = 0; i < 100; i++)
+				builder.reference(16, 16);
+			corpus.push_back(make_entry("full length references", builder));
+		}
+		{
+			StreamBuilder builder;
+			builder.literals("xyz");
+			corpus.push_back(make_entry("shorter than a group", builder));
+		}
+		{
+			// Items at random, long enough for the decoder to run through its whole group path
+			std::mt19937 rng(17);
+			StreamBuilder builder;
+			builder.literals("seed");
+			for (int i = 0; i < 50000; i++)
+			{
+				const size_t written = builder.output().size();
+				if (rng() % 3 == 0)
+					builder.literal(static_cast<uint8_t>(rng()));
+				else
+				{
+					const size_t distance = 1 + rng() % std::min(written, Const::LZSS_WindowSize);
+					builder.reference(distance, 2 + rng() % (Const::LZSS_MaxMatch - 1));
+				}
+			}
+			corpus.push_back(make_entry("random items", builder));
+		}
+		return corpus;
+	}
+}
+
+
+TEST(Lzss, CorpusMatchesEnginePort)
+{
+	for (const auto& entry : valid_corpus())
+	{
+		SCOPED_TRACE(entry.Name);
+		const size_t size = entry.Output.size();
+		ASSERT_EQ(LZSS_GetActualSize(entry.Stream.data(), entry.Stream.size()), size);
+
+		std::vector<uint8_t> engine(size + Const::LZSS_MaxMatch);
+		ASSERT_EQ(engine_lzss_uncompress(entry.Stream.data(), engine.data()), size);
+		engine.resize(size);
+		EXPECT_EQ(engine, entry.Output);
+
+		std::vector<uint8_t> output;
+		ASSERT_TRUE(LZSS_Decompress(entry.Stream, output));
+		EXPECT_EQ(output, entry.Output);
+	}
+}
+
+TEST(Lzss, RoundTripsThroughEnginePort)
+{
+	const LzssInput kinds[]{ LzssInput::Random, LzssInput::Text, LzssInput::Mixed, LzssInput::Run };
+	const size_t sizes[]{ 1, 2, 3, 7, 8, 9, 16, 17, 100, 4095, 4096, 4097, 70000 };
+
+	uint32_t seed = 0;
+	for (LzssInput kind : kinds)
+	{
+		for (size_t size : sizes)
+		{
+			SCOPED_TRACE(testing::Message() << "kind " << static_cast<int>(kind) << " size " << size);
+			const std::vector<uint8_t> input = make_lzss_input(kind, size, seed++);
+
+			std::vector<uint8_t> compressed;
+			ASSERT_TRUE(LZSS_Compress(input, compressed));
+			EXPECT_LE(compressed.size(), LZSS_CompressBound(size));
+
+			std::vector<uint8_t> output;
+			ASSERT_TRUE(LZSS_Decompress(compressed, output));
+			EXPECT_EQ(output, input);
+
+			std::vector<uint8_t> engine(size + Const::LZSS_MaxMatch);
+			ASSERT_EQ(engine_lzss_uncompress(compressed.data(), engine.data()), size);
+			engine.resize(size);
+			EXPECT_EQ(engine, input);
+		}
+	}
+}
+
+TEST(Lzss, CompressesRedundantInput)
+{
+	std::vector<uint8_t> compressed;
+	ASSERT_TRUE(LZSS_Compress(make_lzss_input(LzssInput::Text, 65536, 1), compressed));
+	EXPECT_LT(compressed.size(), 65536u / 2);
+
+	ASSERT_TRUE(LZSS_Compress(make_lzss_input(LzssInput::Run, 65536, 1), compressed));
+	// A reference per Const::LZSS_MaxMatch bytes, 2 bytes and a command bit each
+	EXPECT_LT(compressed.size(), 65536u / 7);
+}
+
+TEST(Lzss, OutputBuffers)
+{
+	const std::vector<uint8_t> input = make_lzss_input(LzssInput::Mixed, 5000, 3);
+	std::vector<uint8_t> compressed;
+	ASSERT_TRUE(LZSS_Compress(input, compressed));
+
+	std::vector<uint8_t> exact(input.size());
+	EXPECT_EQ(LZSS_Decompress(compressed.data(), compressed.size(), exact.data(), exact.size()), input.size());
+	EXPECT_EQ(exact, input);
+	EXPECT_EQ(LZSS_Decompress(compressed.data(), compressed.size(), exact.data(), exact.size() - 1), 0u);
+
+	std::pmr::monotonic_buffer_resource arena;
+	const auto from_arena = LZSS_Decompress(compressed.data(), compressed.size(), &arena);
+	ASSERT_EQ(from_arena.size(), input.size());
+	EXPECT_TRUE(std::equal(from_arena.begin(), from_arena.end(), input.begin()));
+
+	// The compressor reports a buffer too small instead of writing past it
+	std::vector<uint8_t> small(compressed.size() - 1);
+	EXPECT_EQ(LZSS_Compress(input.data(), input.size(), small.data(), small.size()), 0u);
+	std::vector<uint8_t> fits(compressed.size());
+	EXPECT_EQ(LZSS_Compress(input.data(), input.size(), fits.data(), fits.size()), compressed.size());
+}
+
+TEST(Lzss, RejectsInvalidStreams)
+{
+	auto decompress = [](const std::vector<uint8_t>& stream, size_t output_size)
+	{
+		std::vector<uint8_t> output(output_size);
+		return LZSS_Decompress(stream.data(), stream.size(), output.data(), output.size());
+	};
+
+	{
+		StreamBuilder builder;
+		builder.reference(1, 4);
+		EXPECT_EQ(decompress(builder.finish(4), 4), 0u) << "reference before the start";
+	}
+	{
+		StreamBuilder builder;
+		builder.literals("abc").reference(4, 4);
+		EXPECT_EQ(decompress(builder.finish(7), 7), 0u) << "reference one byte too far";
+	}
+	{
+		StreamBuilder builder;
+		builder.literals("abcdefgh");
+		EXPECT_EQ(decompress(builder.finish(10), 10), 0u) << "shorter than its header";
+	}
+	{
+		StreamBuilder builder;
+		builder.literals("abcdefgh").reference(8, 16);
+		EXPECT_EQ(decompress(builder.finish(10), 64), 0u) << "longer than its header";
+	}
+	{
+		StreamBuilder builder;
+		std::vector<uint8_t> stream = builder.literals("abcdefgh").finish();
+		stream[3] = 'X';
+		EXPECT_EQ(decompress(stream, 8), 0u) << "bad magic";
+		EXPECT_FALSE(LZSS_IsCompressed(stream.data(), stream.size()));
+	}
+	{
+		const uint8_t header_only[]{ 'L', 'Z', 'S', 'S' };
+		EXPECT_EQ(LZSS_GetActualSize(header_only, sizeof(header_only)), 0u);
+		EXPECT_EQ(LZSS_GetActualSize(nullptr, 0), 0u);
+	}
+}
+
+TEST(Lzss, TruncatedStreams)
+{
+	for (const auto& entry : valid_corpus())
+	{
+		SCOPED_TRACE(entry.Name);
+		std::vector<uint8_t> output(entry.Output.size());
+
+		// Every cut past the header, the long entries are sampled
+		const size_t step = entry.Stream.size() > 4096 ? 97 : 1;
+		for (size_t size = Const::LZSS_HeaderSize; size < entry.Stream.size(); size += step)
+			ASSERT_EQ(LZSS_Decompress(entry.Stream.data(), size, output.data(), output.size()), 0u) << "cut at " << size;
+	}
+}
+
+TEST(Lzss, CorruptedStreams)
+{
+	std::mt19937 rng(5);
+	for (int i = 0; i < 5000; i++)
+	{
+		const std::vector<uint8_t> input = make_lzss_input(LzssInput::Text, 1 + rng() % 3000, i);
+		std::vector<uint8_t> stream;
+		ASSERT_TRUE(LZSS_Compress(input, stream));
+
+		for (int flips = 1 + rng() % 4; flips; flips--)
+			stream[Const::LZSS_HeaderSize + rng() % (stream.size() - Const::LZSS_HeaderSize)] ^= 1 << (rng() % 8);
+
+		// Either rejected or fully decoded, never more than the header's size
+		std::vector<uint8_t> output(input.size());
+		const size_t size = LZSS_Decompress(stream.data(), stream.size(), output.data(), output.size());
+		ASSERT_TRUE(size == 0 || size == input.size());
+	}
+}
@@ -0,0 +1,173 @@
+// The byte-aligned fast paths of bf_read must decode exactly what the generic paths decode from an unaligned cursor
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/utils/bitbuf.hpp>
+
+using namespace tf2::utils;
+
+namespace
+{
+	/// <summary>
+	/// The same bytes at bit 0, where bf_read takes the aligned paths, and at bit 'offset', where it can't
+	/// </summary>
+	struct AlignedPair
+	{
+		AlignedPair(const std::vector<uint8_t>& bytes, int offset) :
+			Offset(offset)
+		{
+			write(Aligned, bytes, 0);
+			write(Unaligned, bytes, offset);
+		}
+
+		[[nodiscard]] bf_read aligned() const
+		{
+			return bf_read(Aligned.data(), static_cast<int>(Aligned.size()));
+		}
+
+		[[nodiscard]] bf_read unaligned() const
+		{
+			bf_read reader(Unaligned.data(), static_cast<int>(Unaligned.size()));
+			reader.seek(Offset);
+			return reader;
+		}
+
+		int						Offset;
+		std::vector<uint8_t>	Aligned;
+		std::vector<uint8_t>	Unaligned;
+
+	private:
+		static void write(std::vector<uint8_t>& out, const std::vector<uint8_t>& bytes, int offset)
+		{
+			// bf_write works on whole words, the copy is cut to the exact size so the fast paths can't read past the end
+			std::vector<uint32_t> words(bytes.size() / 4 + 2);
+			bf_write writer(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)));
+			writer.write_ubit(0, offset);
+			writer.write_bits(bytes.data(), static_cast<int>(bytes.size() * 8));
+
+			const uint8_t* written = reinterpret_cast<const uint8_t*>(words.data());
+			out.assign(written, written + writer.bytes_written());
+		}
+	};
+
+	std::vector<uint8_t> random_varints(std::mt19937_64& rng, size_t count)
+	{
+		std::vector<uint8_t> bytes;
+		for (size_t i = 0; i < count; i++)
+		{
+			// Over-long encodings every few values
+			const size_t len = rng() % 4 ? 1 + rng() % 10 : 11 + rng() % 4;
+			for (size_t j = 0; j + 1 < len; j++)
+				bytes.push_back(static_cast<uint8_t>(rng() | 0x80));
+			bytes.push_back(static_cast<uint8_t>(rng() & 0x7F));
+		}
+		return bytes;
+	}
+}
+
+
+TEST(bitbuf_aligned, VarintsMatchUnaligned)
+{
+	std::mt19937_64 rng(6);
+	for (int iter = 0; iter < 200; iter++)
+	{
+		const std::vector<uint8_t> bytes = random_varints(rng, 64);
+		const AlignedPair pair(bytes, 1 + iter % 7);
+		const bool wide = iter & 1;
+
+		bf_read aligned = pair.aligned(), unaligned = pair.unaligned();
+		while (!aligned.has_overflown() && aligned.bits_left() > 0)
+		{
+			if (wide)
+				ASSERT_EQ(aligned.read_uint64(), unaligned.read_uint64());
+			else
+				ASSERT_EQ(aligned.read_uint32(), unaligned.read_uint32());
+			ASSERT_EQ(aligned.has_overflown(), unaligned.has_overflown());
+			// Past an overflow the cursors are meaningless
+			if (!aligned.has_overflown())
+				ASSERT_EQ(aligned.bits_written(), unaligned.bits_written() - pair.Offset);
+		}
+	}
+}
+
+TEST(bitbuf_aligned, OverlongVarintsAreCut)
+{
+	const std::vector<uint8_t> bytes(12, 0xFF);
+	const AlignedPair pair(bytes, 3);
+
+	bf_read aligned = pair.aligned(), unaligned = pair.unaligned();
+	EXPECT_EQ(aligned.read_uint32(), 0xFFFFFFFFu);
+	EXPECT_EQ(unaligned.read_uint32(), 0xFFFFFFFFu);
+	EXPECT_EQ(aligned.bits_written(), 5 * 8);
+
+	aligned.seek(0);
+	unaligned.seek(pair.Offset);
+	EXPECT_EQ(aligned.read_uint64(), ~0ull);
+	EXPECT_EQ(unaligned.read_uint64(), ~0ull);
+	EXPECT_EQ(aligned.bits_written(), 10 * 8);
+}
+
+TEST(bitbuf_aligned, StringsMatchUnaligned)
+{
+	std::mt19937_64 rng(7);
+	for (int iter = 0; iter < 200; iter++)
+	{
+		std::vector<uint8_t> bytes;
+		for (int i = 0; i < 16; i++)
+		{
+			const size_t len = rng() % 40;
+			for (size_t j = 0; j < len; j++)
+				bytes.push_back(static_cast<uint8_t>(rng() % 8 ? 'a' + rng() % 26 : '\n'));
+			bytes.push_back(0);
+		}
+		// The last string runs into the end of the buffer half of the time
+		if (iter & 1)
+			bytes.pop_back();
+
+		const AlignedPair pair(bytes, 1 + iter % 7);
+		const bool line = iter & 2;
+		const int max_len = 1 + static_cast<int>(rng() % 48);
+
+		bf_read aligned = pair.aligned(), unaligned = pair.unaligned();
+		while (!aligned.has_overflown() && aligned.bits_left() > 0)
+		{
+			char aligned_text[64], unaligned_text[64];
+			int aligned_chars = -1, unaligned_chars = -1;
+			ASSERT_EQ(aligned.read_string(aligned_text, max_len, line, &aligned_chars), unaligned.read_string(unaligned_text, max_len, line, &unaligned_chars));
+			ASSERT_STREQ(aligned_text, unaligned_text);
+			ASSERT_EQ(aligned_chars, unaligned_chars);
+			ASSERT_EQ(aligned.has_overflown(), unaligned.has_overflown());
+			// Past an overflow the cursors are meaningless
+			if (!aligned.has_overflown())
+				ASSERT_EQ(aligned.bits_written(), unaligned.bits_written() - pair.Offset);
+		}
+	}
+}
+
+TEST(bitbuf_aligned, BytesAndBitsAtBufferTail)
+{
+	std::mt19937_64 rng(8);
+	for (size_t size = 1; size <= 24; size++)
+	{
+		std::vector<uint8_t> bytes(size);
+		for (auto& byte : bytes)
+			byte = static_cast<uint8_t>(rng());
+
+		const AlignedPair pair(bytes, 5);
+		for (int bits = 1; bits <= 32; bits++)
+		{
+			bf_read aligned = pair.aligned(), unaligned = pair.unaligned();
+			while (aligned.bits_left() >= bits)
+				ASSERT_EQ(aligned.read_ubit(bits), unaligned.read_ubit(bits)) << "size " << size << " bits " << bits;
+			EXPECT_FALSE(aligned.has_overflown());
+		}
+
+		bf_read aligned = pair.aligned();
+		std::vector<uint8_t> read(size);
+		EXPECT_TRUE(aligned.read_bytes(read.data(), static_cast<int>(size)));
+		EXPECT_EQ(read, bytes);
+	}
+}
@@ -0,0 +1,162 @@
+// The array codecs of bf_write and bf_read must be bit-for-bit the same as their scalar loops
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/utils/bitbuf.hpp>
+
+using namespace tf2::utils;
+
+namespace
+{
+	constexpr int Array_MaxCount = 67;
+
+	struct Streams
+	{
+		std::vector<uint32_t>	Array = std::vector<uint32_t>(4096);
+		std::vector<uint32_t>	Scalar = std::vector<uint32_t>(4096);
+
+		[[nodiscard]] static bf_write writer(std::vector<uint32_t>& words, int start_bit)
+		{
+			bf_write writer;
+			writer.start_writing(words.data(), static_cast<int>(words.size() * sizeof(uint32_t)), start_bit);
+			return writer;
+		}
+
+		[[nodiscard]] static bf_read reader(const std::vector<uint32_t>& words, const bf_write& writer, int start_bit)
+		{
+			bf_read reader;
+			reader.start_reading(words.data(), writer.bytes_written(), start_bit, writer.bits_written());
+			return reader;
+		}
+	};
+
+	float random_coord(std::mt19937& rng)
+	{
+		// Integral, fractional and zero values, with both signs
+		switch (rng() % 4)
+		{
+		case 0:		return 0.f;
+		case 1:		return static_cast<float>(static_cast<int>(rng() % 32768) - 16384);
+		default:	return static_cast<float>(static_cast<int>(rng() % (1 << 20)) - (1 << 19)) / 32.f;
+		}
+	}
+}
+
+
+TEST(bitbuf_array, UBitArrayMatchesScalar)
+{
+	std::mt19937 rng(8);
+	for (int offset = 0; offset < 32; offset += 3)
+	{
+		for (int bits = 1; bits <= 32; bits++)
+		{
+			const int count = static_cast<int>(rng() % Array_MaxCount);
+			std::vector<uint32_t> values(count);
+			for (auto& value : values)
+				value = static_cast<uint32_t>(rng()) & (~0u >> (32 - bits));
+
+			Streams streams;
+			bf_write array_writer = Streams::writer(streams.Array, offset);
+			bf_write scalar_writer = Streams::writer(streams.Scalar, offset);
+			array_writer.write_ubit_array(values.data(), count, bits);
+			for (uint32_t value : values)
+				scalar_writer.write_ubit(value, bits);
+
+			ASSERT_EQ(array_writer.bits_written(), scalar_writer.bits_written());
+			ASSERT_EQ(streams.Array, streams.Scalar) << "bits " << bits << " offset " << offset;
+
+			bf_read reader = Streams::reader(streams.Array, array_writer, offset);
+			std::vector<uint32_t> read(count);
+			reader.read_ubit_array(read.data(), count, bits);
+			EXPECT_EQ(read, values) << "bits " << bits << " offset " << offset;
+			EXPECT_EQ(reader.bits_written(), array_writer.bits_written());
+		}
+	}
+}
+
+TEST(bitbuf_array, CoordArrayMatchesScalar)
+{
+	std::mt19937 rng(9);
+	for (int offset = 0; offset < 32; offset++)
+	{
+		const int count = 1 + static_cast<int>(rng() % Array_MaxCount);
+		std::vector<float> values(count);
+		for (auto& value : values)
+			value = random_coord(rng);
+
+		Streams streams;
+		bf_write array_writer = Streams::writer(streams.Array, offset);
+		bf_write scalar_writer = Streams::writer(streams.Scalar, offset);
+		array_writer.write_coord_array(values.data(), count);
+		for (float value : values)
+			scalar_writer.write_coord(value);
+
+		ASSERT_EQ(array_writer.bits_written(), scalar_writer.bits_written());
+		ASSERT_EQ(streams.Array, streams.Scalar) << "offset " << offset;
+
+		bf_read array_reader = Streams::reader(streams.Array, array_writer, offset);
+		bf_read scalar_reader = Streams::reader(streams.Array, array_writer, offset);
+		std::vector<float> read(count);
+		array_reader.read_coord_array(read.data(), count);
+		for (int i = 0; i < count; i++)
+		{
+			EXPECT_EQ(read[i], values[i]);
+			EXPECT_EQ(std::bit_cast<uint32_t>(read[i]), std::bit_cast<uint32_t>(scalar_reader.read_coord()));
+		}
+		EXPECT_EQ(array_reader.bits_written(), scalar_reader.bits_written());
+	}
+}
+
+TEST(bitbuf_array, Vec3ArrayMatchesScalar)
+{
+	std::mt19937 rng(10);
+	for (int offset = 0; offset < 32; offset++)
+	{
+		const int count = 1 + static_cast<int>(rng() % Array_MaxCount);
+		std::vector<float> values(count * 3);
+		for (auto& value : values)
+			value = random_coord(rng);
+		const auto* vectors = reinterpret_cast<const float(*)[3]>(values.data());
+
+		Streams streams;
+		bf_write array_writer = Streams::writer(streams.Array, offset);
+		bf_write scalar_writer = Streams::writer(streams.Scalar, offset);
+		array_writer.write_vec3_array(vectors, count);
+		for (int i = 0; i < count; i++)
+			scalar_writer.write_vec3(vectors[i]);
+
+		ASSERT_EQ(array_writer.bits_written(), scalar_writer.bits_written());
+		ASSERT_EQ(streams.Array, streams.Scalar) << "offset " << offset;
+
+		bf_read array_reader = Streams::reader(streams.Array, array_writer, offset);
+		bf_read scalar_reader = Streams::reader(streams.Array, array_writer, offset);
+		std::vector<float> read(count * 3);
+		array_reader.read_vec3_array(reinterpret_cast<float(*)[3]>(read.data()), count);
+		for (int i = 0; i < count; i++)
+		{
+			float vec[3];
+			scalar_reader.read_vec3(vec);
+			EXPECT_EQ(std::memcmp(vec, &read[i * 3], sizeof(vec)), 0) << "vector " << i;
+			EXPECT_EQ(std::memcmp(vec, &values[i * 3], sizeof(vec)), 0) << "vector " << i;
+		}
+		EXPECT_EQ(array_reader.bits_written(), scalar_reader.bits_written());
+	}
+}
+
+TEST(bitbuf_array, TruncatedArrayOverflows)
+{
+	const uint32_t values[]{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	Streams streams;
+	bf_write writer = Streams::writer(streams.Array, 0);
+	writer.write_ubit_array(values, 8, 13);
+
+	bf_read reader(streams.Array.data(), writer.bytes_written(), writer.bits_written() - 1);
+	uint32_t read[8];
+	reader.read_ubit_array(read, 8, 13);
+	EXPECT_TRUE(reader.has_overflown());
+}
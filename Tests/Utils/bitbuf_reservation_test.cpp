@@ -0,0 +1,197 @@
+// bf_write_reservation and bf_read_reservation: the upfront budget check, where commit leaves the parent's cursor,
+// and the bytes around the reservation
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/utils/bitbuf.hpp>
+
+using namespace tf2::utils;
+
+namespace
+{
+	// Filled with a pattern, so bits the scopes must not touch can be told apart from zeros
+	constexpr uint32_t Fill_Pattern = 0xA5A5A5A5;
+
+	struct Stream
+	{
+		explicit Stream(size_t words = 16) : Words(words, Fill_Pattern) { }
+
+		[[nodiscard]] bf_write writer(int start_bit = 0)
+		{
+			bf_write writer;
+			writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)), start_bit);
+			return writer;
+		}
+
+		[[nodiscard]] bf_read reader(int start_bit = 0, int end_bit = -1) const
+		{
+			bf_read reader;
+			reader.start_reading(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)), start_bit, end_bit);
+			return reader;
+		}
+
+		[[nodiscard]] int bit(int index) const
+		{
+			return (Words[index / 32] >> (index % 32)) & 1;
+		}
+
+		std::vector<uint32_t>	Words;
+	};
+}
+
+
+TEST(bitbuf_reservation, WriteFailsUpfront)
+{
+	Stream stream(2);
+	bf_write writer = stream.writer();
+	writer.write_ubit(0b101, 3);
+
+	{
+		bf_write_reservation scope{ writer, 62 };
+		EXPECT_FALSE(scope);
+		// Destroying a failed scope doesn't touch the parent
+	}
+	EXPECT_TRUE(writer.has_overflown());
+	EXPECT_EQ(writer.bits_written(), 3);
+	EXPECT_EQ(stream.Words[1], Fill_Pattern);
+}
+
+TEST(bitbuf_reservation, WriteCommitPlacesCursor)
+{
+	for (int offset = 0; offset < 32; offset++)
+	{
+		Stream stream;
+		bf_write writer = stream.writer();
+		if (offset)
+			writer.write_ubit(0x7FFFFFFF, offset);
+
+		// 10 spare bits past what the scope writes
+		constexpr int written = 6 + 32 + 1;
+		{
+			bf_write_reservation scope{ writer, written + 10 };
+			ASSERT_TRUE(scope);
+			scope.write_ubit(0xFFFFFFFF, 0);
+			scope.write_ubit(0x2A, 6);
+			scope.write_long(-12345);
+			scope.write_bit(1);
+			EXPECT_EQ(scope.bits_written(), offset + written);
+			EXPECT_FALSE(scope.has_overflown());
+		}
+		ASSERT_FALSE(writer.has_overflown());
+		ASSERT_EQ(writer.bits_written(), offset + written) << "offset " << offset;
+
+		// The spare bits keep what was in the buffer
+		for (int i = offset + written; i < offset + written + 10; i++)
+			ASSERT_EQ(stream.bit(i), (Fill_Pattern >> (i % 32)) & 1) << "offset " << offset << " bit " << i;
+
+		writer.write_ubit(0x3, 2);
+		bf_read reader = stream.reader(0, writer.bits_written());
+		EXPECT_EQ(reader.read_ubit(offset), 0x7FFFFFFFu & ((1u << offset) - 1));
+		EXPECT_EQ(reader.read_ubit(6), 0x2Au);
+		EXPECT_EQ(reader.read_long(), -12345);
+		EXPECT_EQ(reader.read_bit(), 1);
+		EXPECT_EQ(reader.read_ubit(2), 0x3u);
+		EXPECT_FALSE(reader.has_overflown());
+	}
+}
+
+TEST(bitbuf_reservation, WriteExplicitCommit)
+{
+	Stream stream;
+	bf_write writer = stream.writer(5);
+
+	bf_write_reservation scope{ writer, 16 };
+	scope.write_word(0xBEEF);
+	scope.commit();
+	EXPECT_FALSE(scope);
+	EXPECT_EQ(writer.bits_written(), 5 + 16);
+
+	// The destructor doesn't seek the parent back once committed
+	writer.write_byte(0x11);
+	scope.commit();
+	EXPECT_EQ(writer.bits_written(), 5 + 16 + 8);
+
+	bf_read reader = stream.reader(5);
+	EXPECT_EQ(reader.read_word(), 0xBEEF);
+	EXPECT_EQ(reader.read_byte(), 0x11);
+}
+
+TEST(bitbuf_reservation, WritePastBudget)
+{
+	Stream stream;
+	bf_write writer = stream.writer(3);
+	{
+		bf_write_reservation scope{ writer, 8 };
+		ASSERT_TRUE(scope);
+		scope.write_long(-1);
+		EXPECT_TRUE(scope.has_overflown());
+	}
+	// The cursor ends at the reservation, nothing past its last byte was written
+	EXPECT_TRUE(writer.has_overflown());
+	EXPECT_EQ(writer.bits_written(), 3 + 8);
+	for (int i = 16; i < 64; i++)
+		ASSERT_EQ(stream.bit(i), (Fill_Pattern >> (i % 32)) & 1) << "bit " << i;
+}
+
+
+TEST(bitbuf_reservation, ReadFailsUpfront)
+{
+	Stream stream(1);
+	bf_read reader = stream.reader(0, 32);
+	(void)reader.read_ubit(20);
+
+	{
+		bf_read_reservation scope{ reader, 13 };
+		EXPECT_FALSE(scope);
+	}
+	EXPECT_TRUE(reader.has_overflown());
+	EXPECT_EQ(reader.bits_written(), 20);
+}
+
+TEST(bitbuf_reservation, ReadCommitPlacesCursor)
+{
+	for (int offset = 0; offset < 32; offset++)
+	{
+		Stream stream;
+		bf_write writer = stream.writer(offset);
+		writer.write_ubit(0x15, 6);
+		writer.write_long(-777);
+		writer.write_bit(0);
+		writer.write_ubit(0x5, 3);
+
+		bf_read reader = stream.reader(offset, writer.bits_written());
+		{
+			bf_read_reservation scope{ reader, 6 + 32 + 1 + 3 };
+			ASSERT_TRUE(scope);
+			EXPECT_EQ(scope.read_ubit(0), 0u);
+			EXPECT_EQ(scope.read_ubit(6), 0x15u);
+			EXPECT_EQ(scope.read_long(), -777);
+			EXPECT_EQ(scope.read_bit(), 0);
+			EXPECT_EQ(scope.bits_left(), 3);
+		}
+		// The 3 bits the scope didn't read are left to the parent
+		ASSERT_FALSE(reader.has_overflown());
+		ASSERT_EQ(reader.bits_written(), offset + 6 + 32 + 1) << "offset " << offset;
+		EXPECT_EQ(reader.read_ubit(3), 0x5u);
+	}
+}
+
+TEST(bitbuf_reservation, ReadPastBudget)
+{
+	Stream stream;
+	bf_write writer = stream.writer();
+	writer.write_long(-1);
+	writer.write_long(-1);
+
+	bf_read reader = stream.reader(0, writer.bits_written());
+	{
+		bf_read_reservation scope{ reader, 16 };
+		ASSERT_TRUE(scope);
+		// Bytes past the reservation read as zeros
+		EXPECT_EQ(scope.read_ubit(24), 0xFFFFu);
+		EXPECT_TRUE(scope.has_overflown());
+	}
+	EXPECT_TRUE(reader.has_overflown());
+	EXPECT_EQ(reader.bits_written(), 16);
+}
@@ -0,0 +1,426 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tf2/utils/bitbuf_schema.hpp>
+
+using namespace tf2::utils;
+
+namespace
+{
+	struct Stream
+	{
+		std::vector<uint32_t>	Words = std::vector<uint32_t>(4096);
+
+		[[nodiscard]] bf_write writer(int start_bit = 0)
+		{
+			bf_write writer;
+			writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)), start_bit);
+			return writer;
+		}
+
+		[[nodiscard]] bf_read reader(const bf_write& writer, int start_bit = 0) const
+		{
+			bf_read reader;
+			reader.start_reading(Words.data(), writer.bytes_written(), start_bit, writer.bits_written());
+			return reader;
+		}
+	};
+
+
+	struct Folded
+	{
+		uint32_t	A{ };
+		int32_t		B{ };
+		bool		C{ };
+		uint32_t	D{ };
+		uint32_t	E{ };
+		char		Name[16]{ };
+		uint32_t	F{ };
+	};
+
+	// A, B, C and D fold into 25 bits, E doesn't fit in the same 32 bits
+	using Folded_Schema = bit_schema<
+		schema::ubit<&Folded::A, 5>,
+		schema::sbit<&Folded::B, 7>,
+		schema::flag<&Folded::C>,
+		schema::ubit<&Folded::D, 12>,
+		schema::ubit<&Folded::E, 10>,
+		schema::string<&Folded::Name>,
+		schema::ubit<&Folded::F, 3>
+	>;
+
+	void write_folded_by_hand(const Folded& value, bf_write& writer)
+	{
+		writer.write_ubit(value.A, 5);
+		writer.write_ubit(static_cast<uint32_t>(value.B) & 0x7f, 7);
+		writer.write_bit(value.C);
+		writer.write_ubit(value.D, 12);
+		writer.write_ubit(value.E, 10);
+		writer.write_string(value.Name);
+		writer.write_ubit(value.F, 3);
+	}
+
+	/// <summary>
+	/// Keeps the width of every write_ubit() a schema makes, -1 for a string
+	/// </summary>
+	struct RecordingWriter
+	{
+		std::vector<int>	Widths;
+
+		void write_bit(int) { Widths.push_back(1); }
+		void write_ubit(uint32_t, int numbits) { Widths.push_back(numbits); }
+		bool write_string(const char*) { Widths.push_back(-1); return true; }
+		[[nodiscard]] bool has_overflown() const noexcept { return false; }
+	};
+
+	struct Named
+	{
+		char		Name[16]{ };
+		uint32_t	Id{ };
+	};
+
+	using Named_Schema = bit_schema<
+		schema::optional<schema::string<&Named::Name>>,
+		schema::optional<schema::ubit<&Named::Id, 32>>
+	>;
+}
+
+
+TEST(bitbuf, UBitEveryWidthAndOffset)
+{
+	std::mt19937 rng(1);
+	for (int offset = 0; offset < 32; offset++)
+	{
+		for (int bits = 1; bits <= 32; bits++)
+		{
+			const uint32_t mask = ~0u >> (32 - bits);
+			const uint32_t values[]{ 0, mask, static_cast<uint32_t>(rng()) & mask, 1u << (bits - 1) };
+
+			Stream stream;
+			bf_write writer = stream.writer(offset);
+			for (uint32_t value : values)
+				writer.write_ubit(value, bits);
+
+			bf_read reader = stream.reader(writer, offset);
+			for (uint32_t value : values)
+				EXPECT_EQ(reader.read_ubit(bits), value) << "bits " << bits << " offset " << offset;
+			EXPECT_FALSE(reader.has_overflown());
+		}
+	}
+}
+
+TEST(bitbuf, SBitEveryWidthAndOffset)
+{
+	for (int offset = 0; offset < 32; offset++)
+	{
+		for (int bits = 1; bits <= 32; bits++)
+		{
+			const int min = bits == 32 ? std::numeric_limits<int>::min() : -(1 << (bits - 1));
+			const int max = bits == 32 ? std::numeric_limits<int>::max() : (1 << (bits - 1)) - 1;
+			const int values[]{ 0, min, max, -1 };
+
+			Stream stream;
+			bf_write writer = stream.writer(offset);
+			for (int value : values)
+				writer.write_sbit(value, bits);
+
+			bf_read reader = stream.reader(writer, offset);
+			for (int value : values)
+				EXPECT_EQ(reader.read_sbit(bits), value) << "bits " << bits << " offset " << offset;
+		}
+	}
+}
+
+TEST(bitbuf, VarintBoundaries)
+{
+	for (int offset : { 0, 1, 7, 8, 13 })
+	{
+		std::vector<uint64_t> values{ 0, std::numeric_limits<uint64_t>::max() };
+		for (int shift = 7; shift < 64; shift += 7)
+		{
+			values.push_back((1ull << shift) - 1);
+			values.push_back(1ull << shift);
+		}
+
+		Stream stream;
+		bf_write writer = stream.writer(offset);
+		for (uint64_t value : values)
+		{
+			writer.write_uint32(static_cast<uint32_t>(value));
+			writer.write_uint64(value);
+			writer.write_sint32(static_cast<int32_t>(value));
+			writer.write_sint64(static_cast<int64_t>(value));
+		}
+
+		bf_read reader = stream.reader(writer, offset);
+		for (uint64_t value : values)
+		{
+			EXPECT_EQ(reader.read_uint32(), static_cast<uint32_t>(value));
+			EXPECT_EQ(reader.read_uint64(), value);
+			EXPECT_EQ(reader.read_int32(), static_cast<int32_t>(value));
+			EXPECT_EQ(reader.read_int64(), static_cast<int64_t>(value));
+		}
+		EXPECT_EQ(reader.bits_written(), writer.bits_written());
+	}
+}
+
+TEST(bitbuf, CoordNegativeFractions)
+{
+	const float values[]{ -145.875f, -0.03125f, -1.5f, -16384.96875f, 0.f, 3.25f, 16384.96875f };
+
+	Stream stream;
+	bf_write writer = stream.writer(3);
+	for (float value : values)
+		writer.write_coord(value);
+	writer.write_vec3(values);
+
+	bf_read reader = stream.reader(writer, 3);
+	for (float value : values)
+		EXPECT_EQ(reader.read_coord(), value);
+
+	float vec[3];
+	reader.read_vec3(vec);
+	EXPECT_EQ(vec[0], values[0]);
+	EXPECT_EQ(vec[1], values[1]);
+	EXPECT_EQ(vec[2], values[2]);
+}
+
+TEST(bitbuf, CoordMatchesSchemaFrontEnd)
+{
+	// schema::px_writer shares bf_write's coord codec
+	px::bitbuf buffer;
+	schema::px_writer writer(buffer);
+	writer.write_coord(-145.875f);
+	writer.write_coord(-0.5f);
+
+	schema::px_reader reader(buffer);
+	EXPECT_EQ(reader.read_coord(), -145.875f);
+	EXPECT_EQ(reader.read_coord(), -0.5f);
+}
+
+TEST(bitbuf, AngleAndStrings)
+{
+	Stream stream;
+	bf_write writer = stream.writer(5);
+	writer.write_angle(90.f, 16);
+	writer.write_string("hello");
+	writer.write_string("");
+
+	bf_read reader = stream.reader(writer, 5);
+	EXPECT_FLOAT_EQ(reader.read_angle(16), 90.f);
+
+	char text[16];
+	EXPECT_TRUE(reader.read_string(text, sizeof(text)));
+	EXPECT_STREQ(text, "hello");
+	EXPECT_TRUE(reader.read_string(text, sizeof(text)));
+	EXPECT_STREQ(text, "");
+}
+
+TEST(bitbuf, BulkBitsEveryOffset)
+{
+	std::vector<uint8_t> bytes(67);
+	for (size_t i = 0; i < bytes.size(); i++)
+		bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+
+	for (int offset = 0; offset < 32; offset++)
+	{
+		Stream stream;
+		bf_write writer = stream.writer(offset);
+		writer.write_bits(bytes.data(), static_cast<int>(bytes.size() * 8));
+
+		bf_read reader = stream.reader(writer, offset);
+		std::vector<uint8_t> read(bytes.size());
+		reader.read_bits(read.data(), static_cast<int>(read.size() * 8));
+		EXPECT_EQ(read, bytes) << "offset " << offset;
+	}
+}
+
+TEST(bitbuf, ReadPastEndOverflows)
+{
+	Stream stream;
+	bf_write writer = stream.writer();
+	writer.write_uint32(300);
+
+	bf_read reader(stream.Words.data(), writer.bytes_written(), writer.bits_written() - 1);
+	(void)reader.read_uint32();
+	EXPECT_TRUE(reader.has_overflown());
+}
+
+TEST(bitbuf, SchemaFoldsAdjacentFields)
+{
+	RecordingWriter recorder;
+	EXPECT_TRUE(Folded_Schema::write(Folded{ }, recorder));
+	EXPECT_EQ(recorder.Widths, (std::vector<int>{ 25, 10, -1, 3 }));
+
+	std::mt19937 rng(9);
+	for (int offset = 0; offset < 32; offset++)
+	{
+		Folded value;
+		value.A = rng() % 32;
+		value.B = static_cast<int32_t>(rng() % 128) - 64;
+		value.C = rng() & 1;
+		value.D = rng() % 4096;
+		value.E = rng() % 1024;
+		std::strcpy(value.Name, offset & 1 ? "folded" : "");
+		value.F = rng() % 8;
+
+		Stream schema_stream, hand_stream;
+		bf_write schema_writer = schema_stream.writer(offset);
+		bf_write hand_writer = hand_stream.writer(offset);
+		ASSERT_TRUE(Folded_Schema::write(value, schema_writer));
+		write_folded_by_hand(value, hand_writer);
+
+		ASSERT_EQ(schema_writer.bits_written(), hand_writer.bits_written()) << "offset " << offset;
+		EXPECT_EQ(std::memcmp(schema_stream.Words.data(), hand_stream.Words.data(), hand_writer.bytes_written()), 0) << "offset " << offset;
+
+		Folded read;
+		bf_read reader = hand_stream.reader(hand_writer, offset);
+		ASSERT_TRUE(Folded_Schema::read(read, reader));
+		EXPECT_EQ(read.A, value.A);
+		EXPECT_EQ(read.B, value.B);
+		EXPECT_EQ(read.C, value.C);
+		EXPECT_EQ(read.D, value.D);
+		EXPECT_EQ(read.E, value.E);
+		EXPECT_STREQ(read.Name, value.Name);
+		EXPECT_EQ(read.F, value.F);
+
+		// px::bitbuf holds the same bits when it starts at the same offset
+		if (!offset)
+		{
+			px::bitbuf buffer;
+			ASSERT_TRUE(Folded_Schema::write(value, buffer));
+			ASSERT_EQ(buffer.write_get(), static_cast<size_t>(hand_writer.bits_written()));
+			EXPECT_EQ(std::memcmp(buffer.data(), hand_stream.Words.data(), hand_writer.bits_written() / 8), 0);
+		}
+	}
+}
+
+TEST(bitbuf, SchemaOptionalString)
+{
+	Named value;
+	value.Id = 77;
+
+	px::bitbuf empty;
+	ASSERT_TRUE(Named_Schema::write(value, empty));
+	EXPECT_EQ(empty.write_get(), 1u + 1 + 32);
+
+	Named read;
+	std::strcpy(read.Name, "stale");
+	ASSERT_TRUE(Named_Schema::read(read, empty));
+	EXPECT_STREQ(read.Name, "");
+	EXPECT_EQ(read.Id, 77u);
+
+	std::strcpy(value.Name, "player");
+	value.Id = 0;
+	px::bitbuf named;
+	ASSERT_TRUE(Named_Schema::write(value, named));
+	EXPECT_EQ(named.write_get(), 1u + 7 * 8 + 1);
+
+	read.Id = 5;
+	ASSERT_TRUE(Named_Schema::read(read, named));
+	EXPECT_STREQ(read.Name, "player");
+	EXPECT_EQ(read.Id, 0u);
+}
+
+TEST(bitbuf, SchemaTruncatedBufferOverflows)
+{
+	Folded value;
+	value.D = 4095;
+	std::strcpy(value.Name, "truncated");
+	value.F = 7;
+
+	px::bitbuf buffer;
+	ASSERT_TRUE(Folded_Schema::write(value, buffer));
+
+	// The same bytes without the last one, a dynamic buffer is bounded by its size like the others
+	px::bitbuf truncated;
+	ASSERT_TRUE(truncated.write_bytes(reinterpret_cast<const unsigned char*>(buffer.data()), buffer.size() - 1));
+
+	Folded read;
+	EXPECT_TRUE(Folded_Schema::read(read, buffer));
+	EXPECT_FALSE(Folded_Schema::read(read, truncated));
+
+	// A fixed-size buffer overflows on write
+	px::static_bitbuf<4> small;
+	EXPECT_FALSE(Folded_Schema::write(value, small));
+}
+
+TEST(bitbuf, PeekEveryWidthAndOffset)
+{
+	std::mt19937 rng(21);
+	std::vector<uint8_t> bytes(24);
+	for (auto& byte : bytes)
+		byte = static_cast<uint8_t>(rng());
+
+	// One bit at a time, zeros from 'end_bit' on
+	auto reference = [&bytes](int pos, int numbits, int end_bit)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < numbits && pos + i < end_bit; i++)
+			value |= static_cast<uint64_t>((bytes[(pos + i) / 8] >> ((pos + i) % 8)) & 1) << i;
+		return value;
+	};
+
+	const int size = static_cast<int>(bytes.size());
+	for (int offset = 0; offset < 64; offset++)
+	{
+		for (int numbits = 1; numbits <= bf_read::max_peek_bits; numbits++)
+		{
+			bf_read reader(bytes.data(), size);
+			reader.seek(offset);
+			const uint64_t peeked = reader.peek_bits(numbits);
+			ASSERT_EQ(peeked, reference(offset, numbits, size * 8)) << "offset " << offset << " bits " << numbits;
+			ASSERT_EQ(reader.peek_ubit(numbits), static_cast<uint32_t>(peeked));
+			ASSERT_EQ(reader.bits_written(), offset);
+
+			// The following read returns the same bits
+			const uint64_t read = numbits > 32 ?
+				reader.read_ubit(32) | static_cast<uint64_t>(reader.read_ubit(numbits - 32)) << 32 :
+				reader.read_ubit(numbits);
+			ASSERT_EQ(read, peeked) << "offset " << offset << " bits " << numbits;
+
+			// bf_read_buffered peeks through its accumulator, up to a refill
+			const int buffered_bits = std::min(numbits, bf_read_buffered::max_read_bits);
+			bf_read_buffered buffered(bytes.data(), size);
+			buffered.seek(offset);
+			ASSERT_EQ(buffered.peek_bits(numbits), peeked);
+			ASSERT_EQ(buffered.peek_ubits(buffered_bits), reference(offset, buffered_bits, size * 8));
+			ASSERT_EQ(buffered.bits_written(), offset);
+			ASSERT_EQ(buffered.read_ubits(buffered_bits), reference(offset, buffered_bits, size * 8));
+		}
+	}
+}
+
+TEST(bitbuf, PeekPastEndReadsZeros)
+{
+	std::vector<uint8_t> bytes(16, 0xFF);
+	const int size = static_cast<int>(bytes.size());
+
+	for (int offset = 0; offset < 40; offset++)
+	{
+		// Ends anywhere in the peeked bits, in and out of a byte
+		for (int end_bit = offset; end_bit <= std::min(offset + bf_read::max_peek_bits, size * 8); end_bit++)
+		{
+			const int left = end_bit - offset;
+			const uint64_t expected = left >= 64 ? ~uint64_t{ } : (uint64_t{ 1 } << left) - 1;
+
+			bf_read reader(bytes.data(), size, end_bit);
+			reader.seek(offset);
+			ASSERT_EQ(reader.peek_bits(bf_read::max_peek_bits), expected) << "offset " << offset << " end " << end_bit;
+			ASSERT_EQ(reader.bits_written(), offset);
+			ASSERT_FALSE(reader.has_overflown());
+
+			bf_read_buffered buffered(bytes.data(), size, end_bit);
+			buffered.seek(offset);
+			ASSERT_EQ(buffered.peek_bits(bf_read::max_peek_bits), expected);
+			ASSERT_EQ(buffered.peek_ubits(bf_read_buffered::max_read_bits), expected & ((uint64_t{ 1 } << bf_read_buffered::max_read_bits) - 1));
+			ASSERT_EQ(buffered.bits_written(), offset);
+			ASSERT_FALSE(buffered.has_overflown());
+		}
+	}
+}
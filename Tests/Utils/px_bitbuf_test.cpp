@@ -0,0 +1,243 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <px/bitbuf.hpp>
+
+namespace
+{
+	/// <summary>
+	/// Counts the allocations made through it, storage comes from new/delete
+	/// </summary>
+	struct CountingResource : std::pmr::memory_resource
+	{
+		size_t Allocations = 0;
+
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			Allocations++;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+		}
+
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+	/// <summary>
+	/// One bit at a time, the encoding px::bitbuf used before the word writes
+	/// </summary>
+	void write_reference(std::vector<uint8_t>& bytes, size_t& pos, uint64_t value, size_t bits)
+	{
+		for (size_t i = 0; i < bits; i++, pos++)
+		{
+			if (bytes.size() * 8 <= pos)
+				bytes.resize(pos / 8 + 1);
+			if ((value >> i) & 1)
+				bytes[pos / 8] |= 1 << (pos % 8);
+			else
+				bytes[pos / 8] &= ~(1 << (pos % 8));
+		}
+	}
+}
+
+
+TEST(px_bitbuf, StreamMatchesBitReference)
+{
+	std::mt19937_64 rng(1);
+	for (int iter = 0; iter < 500; iter++)
+	{
+		px::bitbuf buffer;
+		std::vector<uint8_t> reference;
+		size_t reference_pos = 0;
+
+		std::vector<std::pair<int, uint64_t>> ops;
+		for (int i = 0; i < 50; i++)
+		{
+			const int type = static_cast<int>(rng() % 5);
+			const uint64_t value = rng();
+			ops.emplace_back(type, value);
+
+			switch (type)
+			{
+			case 0: buffer << static_cast<px::bit_type>(value & 1); write_reference(reference, reference_pos, value & 1, 1); break;
+			case 1: buffer << static_cast<int>(value); write_reference(reference, reference_pos, static_cast<uint32_t>(value), 32); break;
+			case 2: buffer << value; write_reference(reference, reference_pos, value, 64); break;
+			case 3: buffer << static_cast<short>(value); write_reference(reference, reference_pos, static_cast<uint16_t>(value), 16); break;
+			case 4:
+			{
+				double real;
+				std::memcpy(&real, &value, sizeof(real));
+				buffer << real;
+				write_reference(reference, reference_pos, value, 64);
+				break;
+			}
+			}
+		}
+
+		ASSERT_EQ(buffer.write_get(), reference_pos);
+		for (size_t i = 0; i < reference_pos; i++)
+			ASSERT_EQ((buffer.get()[i / 8] >> (i % 8)) & 1, (reference[i / 8] >> (i % 8)) & 1) << "bit " << i;
+
+		for (auto [type, value] : ops)
+		{
+			switch (type)
+			{
+			case 0: { px::bit_type bit; buffer >> bit; EXPECT_EQ(static_cast<int>(bit), static_cast<int>(value & 1)); break; }
+			case 1: { int read; buffer >> read; EXPECT_EQ(read, static_cast<int>(value)); break; }
+			case 2: { uint64_t read; buffer >> read; EXPECT_EQ(read, value); break; }
+			case 3: { short read; buffer >> read; EXPECT_EQ(read, static_cast<short>(value)); break; }
+			case 4:
+			{
+				double real;
+				buffer >> real;
+				uint64_t read;
+				std::memcpy(&read, &real, sizeof(read));
+				EXPECT_EQ(read, value);
+				break;
+			}
+			}
+		}
+	}
+}
+
+TEST(px_bitbuf, GrowthIsGeometric)
+{
+	CountingResource counter;
+	px::bitbuf_pmr buffer{ &counter };
+	for (int i = 0; i < 100000; i++)
+		buffer << static_cast<uint8_t>(i) << px::bit_type::one;
+
+	EXPECT_EQ(buffer.write_get(), 100000u * 9);
+	// Doubling from one byte to ~112KB
+	EXPECT_LE(counter.Allocations, 20u);
+}
+
+TEST(px_bitbuf, ReserveBitsAllocatesOnce)
+{
+	CountingResource counter;
+	px::bitbuf_pmr buffer{ &counter };
+	buffer.reserve_bits(4096 * 33);
+	EXPECT_GE(buffer.capacity_bits(), 4096u * 33);
+	EXPECT_EQ(buffer.write_get(), 0u);
+
+	for (int i = 0; i < 4096; i++)
+		buffer << i << px::bit_type::zero;
+	EXPECT_EQ(counter.Allocations, 1u);
+}
+
+TEST(px_bitbuf, ShrinkToFitKeepsContents)
+{
+	px::bitbuf buffer;
+	for (int i = 0; i < 1000; i++)
+		buffer << i << px::bit_type::one;
+
+	buffer.shrink_to_fit();
+	EXPECT_EQ(buffer.capacity_bits(), buffer.size() * 8);
+	EXPECT_GE(buffer.capacity_bits(), buffer.write_get());
+
+	for (int i = 0; i < 1000; i++)
+	{
+		int value;
+		px::bit_type bit;
+		buffer >> value >> bit;
+		EXPECT_EQ(value, i);
+		EXPECT_EQ(bit, px::bit_type::one);
+	}
+}
+
+TEST(px_bitbuf, ArenaBuffers)
+{
+	{
+		auto buffer = px::bitbuf_arena::make(1024);
+		EXPECT_GE(buffer.capacity_bits(), 1024u);
+
+		buffer << 5 << 123456789ull;
+		int value;
+		uint64_t value64;
+		buffer >> value >> value64;
+		EXPECT_EQ(value, 5);
+		EXPECT_EQ(value64, 123456789ull);
+	}
+	px::bitbuf_arena::recycle();
+}
+
+TEST(px_bitbuf, RawAccessStopsAtTheEndOfAView)
+{
+	std::array<std::byte, 4> memory{ };
+	px::bitbuf_view view{ std::span<std::byte>(memory) };
+
+	EXPECT_TRUE(view.write_ubits(0x1234567, 28));
+	EXPECT_FALSE(view.write_ubits(0x1f, 5));
+	EXPECT_EQ(view.write_get(), 28u);
+	EXPECT_TRUE(view.write_ubits(0xf, 4));
+	EXPECT_FALSE(view.write_ubits(0, 1));
+
+	const unsigned char bytes[2]{ 0x01, 0x02 };
+	view.write_set(24);
+	EXPECT_FALSE(view.write_bytes(bytes, 2));
+	EXPECT_EQ(view.write_get(), 24u);
+	EXPECT_TRUE(view.write_bytes(bytes, 1));
+
+	uint64_t value;
+	EXPECT_TRUE(view.read_ubits(value, 32));
+	EXPECT_EQ(value, 0x01234567u);
+	EXPECT_FALSE(view.read_ubits(value, 1));
+	EXPECT_EQ(value, 0u);
+	EXPECT_EQ(view.read_get(), 32u);
+
+	unsigned char read[2]{ };
+	view.read_set(16);
+	EXPECT_FALSE(view.read_bytes(read, 3));
+	EXPECT_EQ(view.read_get(), 16u);
+	EXPECT_TRUE(view.read_bytes(read, 2));
+	EXPECT_EQ(read[0], 0x23);
+	EXPECT_EQ(read[1], 0x01);
+}
+
+TEST(px_bitbuf, RawAccessStopsAtTheEndOfAFixedBuffer)
+{
+	px::static_bitbuf<2> buffer;
+	EXPECT_TRUE(buffer.write_ubits(0x7ff, 11));
+	EXPECT_FALSE(buffer.write_ubits(0x3f, 6));
+	EXPECT_TRUE(buffer.write_ubits(0x1f, 5));
+	EXPECT_FALSE(buffer.write_bytes(std::array<unsigned char, 1>{ 0xff }.data(), 1));
+
+	uint64_t value;
+	EXPECT_TRUE(buffer.read_ubits(value, 16));
+	EXPECT_EQ(value, 0xffffu);
+	EXPECT_FALSE(buffer.read_ubits(value, 1));
+}
+
+TEST(px_bitbuf, RawAccessGrowsADynamicBuffer)
+{
+	px::bitbuf buffer;
+	const unsigned char bytes[3]{ 0xaa, 0xbb, 0xcc };
+	EXPECT_TRUE(buffer.write_ubits(1, 3));
+	EXPECT_TRUE(buffer.write_bytes(bytes, 3));
+	EXPECT_EQ(buffer.size(), 4u);
+
+	uint64_t value;
+	unsigned char read[3]{ };
+	EXPECT_TRUE(buffer.read_ubits(value, 3));
+	EXPECT_EQ(value, 1u);
+	EXPECT_TRUE(buffer.read_bytes(read, 3));
+	EXPECT_EQ(std::memcmp(read, bytes, 3), 0);
+
+	// The 5 bits left in the last block, nothing past them
+	EXPECT_FALSE(buffer.read_ubits(value, 6));
+	EXPECT_TRUE(buffer.read_ubits(value, 5));
+}
@@ -0,0 +1,203 @@
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <tf2/engine/DemoFile.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+static const uint8_t* MapDemoFile(const char* path, size_t& size)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	const uint8_t* view = nullptr;
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+	{
+		// The view keeps the mapping alive, both handles can be closed right away
+		if (HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+		{
+			view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			size = static_cast<size_t>(file_size.QuadPart);
+			CloseHandle(mapping);
+		}
+	}
+
+	CloseHandle(file);
+	return view;
+#else
+	int fd = ::open(path, O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	const uint8_t* view = nullptr;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+	{
+		void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED)
+		{
+			madvise(mapping, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+			view = static_cast<const uint8_t*>(mapping);
+			size = static_cast<size_t>(st.st_size);
+		}
+	}
+
+	::close(fd);
+	return view;
+#endif
+}
+
+static void UnmapDemoFile(const uint8_t* view, size_t size)
+{
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+#else
+	munmap(const_cast<uint8_t*>(view), size);
+#endif
+}
+
+
+bool DemoFile::open(const char* path)
+{
+	close();
+
+	size_t size = 0;
+	const uint8_t* view = MapDemoFile(path, size);
+	if (!view)
+		return false;
+
+	if (!open(view, size))
+	{
+		UnmapDemoFile(view, size);
+		return false;
+	}
+
+	IsMapped = true;
+	return true;
+}
+
+
+bool DemoFile::open(const void* data, size_t size)
+{
+	close();
+
+	if (!data || size < sizeof(DemoHeader))
+		return false;
+
+	std::memcpy(&Header, data, sizeof(DemoHeader));
+	if (std::memcmp(Header.FileStamp, Const::DemoFile_Stamp, sizeof(Header.FileStamp)) != 0 ||
+		Header.DemoProtocol != Const::DemoFile_Protocol)
+		return false;
+
+	View = static_cast<const uint8_t*>(data);
+	ViewSize = size;
+	rewind();
+
+	return true;
+}
+
+
+void DemoFile::close() noexcept
+{
+	if (IsMapped)
+		UnmapDemoFile(View, ViewSize);
+
+	View = nullptr;
+	ViewSize = Offset = 0;
+	IsMapped = IsTruncated = false;
+}
+
+
+bool DemoFile::read_frame(DemoFrame& frame)
+{
+	if (!View)
+		return false;
+
+	auto read_int = [this](int& value)
+	{
+		if (ViewSize - Offset < sizeof(int))
+			return false;
+		std::memcpy(&value, View + Offset, sizeof(int));
+		Offset += sizeof(int);
+		return true;
+	};
+
+	auto read_payload = [this, &read_int, &frame]()
+	{
+		if (!read_int(frame.Size) || frame.Size < 0 || ViewSize - Offset < static_cast<size_t>(frame.Size))
+			return false;
+		frame.Data = View + Offset;
+		Offset += frame.Size;
+		return true;
+	};
+
+	// End of the file, or dem_stop was already read
+	if (Offset == ViewSize)
+		return false;
+
+	frame.Command = static_cast<Const::DemoCommand>(View[Offset++]);
+	frame.Data = nullptr;
+	frame.Size = 0;
+
+	bool valid = read_int(frame.Tick);
+	if (valid)
+	{
+		switch (frame.Command)
+		{
+		case Const::DemoCommand::SignOn:
+		case Const::DemoCommand::Packet:
+		{
+			valid = ViewSize - Offset >= sizeof(DemoCmdInfo);
+			if (valid)
+			{
+				std::memcpy(&frame.CmdInfo, View + Offset, sizeof(DemoCmdInfo));
+				Offset += sizeof(DemoCmdInfo);
+				valid = read_int(frame.SequenceIn) && read_int(frame.SequenceOut) && read_payload();
+			}
+			break;
+		}
+
+		case Const::DemoCommand::SyncTick:
+			break;
+
+		case Const::DemoCommand::UserCmd:
+			valid = read_int(frame.OutgoingSequence) && read_payload();
+			break;
+
+		case Const::DemoCommand::ConsoleCmd:
+		case Const::DemoCommand::DataTables:
+		case Const::DemoCommand::StringTables:
+			valid = read_payload();
+			break;
+
+		case Const::DemoCommand::Stop:
+			Offset = ViewSize;
+			return false;
+
+		default:
+			valid = false;
+			break;
+		}
+	}
+
+	if (!valid)
+	{
+		IsTruncated = true;
+		Offset = ViewSize;
+	}
+	return valid;
+}
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,116 @@
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+
+#include <tf2/engine/DemoPipeline.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+void DemoPipelineBase::run_jobs(
+	std::span<const uint64_t> weights,
+	unsigned num_workers,
+	const std::function<void(unsigned, size_t, std::stop_token)>& job
+)
+{
+	struct queue_type
+	{
+		std::mutex			Lock;
+		std::deque<size_t>	Jobs;
+	};
+
+	num_workers = std::max(num_workers, 1u);
+
+	// Heaviest jobs first, dealt round robin so every worker starts with a similar load
+	std::vector<size_t> order(weights.size());
+	std::iota(order.begin(), order.end(), size_t{ });
+	std::stable_sort(order.begin(), order.end(), [&weights](size_t a, size_t b) { return weights[a] > weights[b]; });
+
+	std::vector<queue_type> queues(num_workers);
+	for (size_t i = 0; i < order.size(); i++)
+		queues[i % num_workers].Jobs.push_back(order[i]);
+
+	std::mutex error_lock;
+	std::exception_ptr error;
+	std::stop_source cancel;
+
+	auto worker = [&](unsigned self)
+	{
+		while (!cancel.stop_requested())
+		{
+			size_t index = 0;
+			bool found = false;
+
+			// Own queue from the front, the heaviest jobs are there
+			{
+				auto& queue = queues[self];
+				std::scoped_lock lock(queue.Lock);
+				if (!queue.Jobs.empty())
+				{
+					index = queue.Jobs.front();
+					queue.Jobs.pop_front();
+					found = true;
+				}
+			}
+
+			// Steal the lightest job of another worker
+			for (unsigned i = 1; !found && i < num_workers; i++)
+			{
+				auto& queue = queues[(self + i) % num_workers];
+				std::scoped_lock lock(queue.Lock);
+				if (!queue.Jobs.empty())
+				{
+					index = queue.Jobs.back();
+					queue.Jobs.pop_back();
+					found = true;
+				}
+			}
+
+			// No job is ever queued once the workers started, nothing left to steal means we're done
+			if (!found)
+				return;
+
+			try
+			{
+				job(self, index, cancel.get_token());
+			}
+			catch (...)
+			{
+				std::scoped_lock lock(error_lock);
+				if (!error)
+				{
+					error = std::current_exception();
+					cancel.request_stop();
+				}
+			}
+		}
+	};
+
+	{
+		std::vector<std::jthread> threads;
+		threads.reserve(num_workers - 1);
+		for (unsigned i = 1; i < num_workers; i++)
+			threads.emplace_back(worker, i);
+
+		worker(0);
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+
+std::vector<uint64_t> DemoPipelineBase::get_file_sizes(std::span<const std::string> files)
+{
+	std::vector<uint64_t> sizes(files.size());
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(files[i], ec);
+		sizes[i] = ec ? 0 : static_cast<uint64_t>(size);
+	}
+	return sizes;
+}
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstring>
+
+#include <tf2/engine/GameEventDecoder.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace game_event_impl
+{
+	// Limits 'message' to its own Length bits, DataIn starts at the payload but spans the whole packet
+	static bool get_payload(const utils::bf_read& data_in, int length, utils::bf_read& payload)
+	{
+		const int start = data_in.bits_written();
+		if (length < 0 || start + length > data_in.max_bits())
+			return false;
+
+		payload = utils::bf_read(data_in.data(), data_in.remaining_bytes(), start + length);
+		return payload.seek(start);
+	}
+}
+
+
+bool GameEventDecoder::read_descriptors(const SVC_GameEventList& message)
+{
+	utils::bf_read payload;
+	if (!game_event_impl::get_payload(message.DataIn, message.Length, payload))
+		return false;
+	return read_descriptors(payload, message.NumEvents);
+}
+
+
+bool GameEventDecoder::read_descriptors(utils::bf_read& buffer, int num_events)
+{
+	clear();
+	Descriptors.resize(Const::GameEvent_MaxEvents);
+
+	char name[Const::GameEvent_MaxStringLength];
+	for (int i = 0; i < num_events; i++)
+	{
+		auto& descriptor = Descriptors[buffer.read_ubit(Const::NetMsg_GameEventsBits)];
+		descriptor.Fields.clear();
+
+		buffer.read_string(name, sizeof(name));
+		descriptor.Name = name;
+
+		for (auto type = static_cast<Const::GameEventKeyType>(buffer.read_ubit(Const::GameEvent_KeyTypeBits));
+			 type != Const::GameEventKeyType::Local && !buffer.has_overflown();
+			 type = static_cast<Const::GameEventKeyType>(buffer.read_ubit(Const::GameEvent_KeyTypeBits)))
+		{
+			buffer.read_string(name, sizeof(name));
+			descriptor.Fields.emplace_back(name, type);
+		}
+
+		if (buffer.has_overflown())
+		{
+			clear();
+			return false;
+		}
+
+		descriptor.EventID = static_cast<int>(&descriptor - Descriptors.data());
+	}
+
+	// Names are stable once every descriptor is read
+	for (auto& descriptor : Descriptors)
+	{
+		if (descriptor.EventID != -1)
+			Index.emplace(descriptor.Name, descriptor.EventID);
+	}
+
+	return true;
+}
+
+
+const GameEventDescriptor* GameEventDecoder::find_descriptor(std::string_view name) const noexcept
+{
+	auto iter = Index.find(name);
+	return iter != Index.end() ? &Descriptors[iter->second] : nullptr;
+}
+
+
+GameEventKey GameEventDecoder::find_key(std::string_view event, std::string_view key) const noexcept
+{
+	auto descriptor = find_descriptor(event);
+	if (!descriptor)
+		return { };
+
+	for (size_t i = 0; i < descriptor->Fields.size(); i++)
+	{
+		if (descriptor->Fields[i].Key == key)
+			return { static_cast<int16_t>(descriptor->EventID), static_cast<uint16_t>(i) };
+	}
+	return { };
+}
+
+
+bool GameEventDecoder::decode(const SVC_GameEvent& message, GameEventRecord& record, std::pmr::memory_resource* resource) const
+{
+	utils::bf_read payload;
+	if (!game_event_impl::get_payload(message.DataIn, message.Length, payload))
+		return false;
+	return decode(payload, record, resource);
+}
+
+
+bool GameEventDecoder::decode(utils::bf_read& buffer, GameEventRecord& record, std::pmr::memory_resource* resource) const
+{
+	auto descriptor = this->descriptor(buffer.read_ubit(Const::NetMsg_GameEventsBits));
+	if (!descriptor || buffer.has_overflown())
+		return false;
+
+	auto values = static_cast<GameEventValue*>(
+		resource->allocate(std::max<size_t>(descriptor->Fields.size(), 1) * sizeof(GameEventValue), alignof(GameEventValue))
+	);
+
+	char str[Const::GameEvent_MaxStringLength];
+	for (size_t i = 0; i < descriptor->Fields.size(); i++)
+	{
+		auto& value = values[i];
+		switch (descriptor->Fields[i].Type)
+		{
+		case Const::GameEventKeyType::String:
+		{
+			buffer.read_string(str, sizeof(str));
+			const size_t length = std::strlen(str);
+
+			auto data = static_cast<char*>(resource->allocate(length + 1, 1));
+			std::memcpy(data, str, length + 1);
+			value.String = { data, static_cast<uint32_t>(length) };
+			break;
+		}
+		case Const::GameEventKeyType::Float:
+			value.Float = buffer.read_float();
+			break;
+		case Const::GameEventKeyType::Long:
+			value.Int = buffer.read_long();
+			break;
+		case Const::GameEventKeyType::Short:
+			value.Int = buffer.read_short();
+			break;
+		case Const::GameEventKeyType::Byte:
+			value.Int = buffer.read_byte();
+			break;
+		case Const::GameEventKeyType::Bool:
+			value.Int = buffer.read_bit();
+			break;
+		case Const::GameEventKeyType::UInt64:
+			value.UInt64 = static_cast<uint64_t>(buffer.read_longlong());
+			break;
+		default:
+			value.UInt64 = 0;
+			break;
+		}
+	}
+
+	if (buffer.has_overflown())
+		return false;
+
+	record.Descriptor = descriptor;
+	record.Values = values;
+	return true;
+}
+
+
+size_t GameEventDecoder::decode_batch(
+	std::span<const SVC_GameEvent* const> messages,
+	std::vector<GameEventRecord>& records,
+	std::pmr::memory_resource* resource
+) const
+{
+	const size_t first = records.size();
+	records.reserve(first + messages.size());
+
+	GameEventRecord record;
+	for (auto message : messages)
+	{
+		if (decode(*message, record, resource))
+			records.push_back(record);
+	}
+	return records.size() - first;
+}
+
+
+void GameEventDecoder::count_events(std::span<const SVC_GameEvent* const> messages, std::span<uint32_t> counts) const noexcept
+{
+	for (auto message : messages)
+	{
+		if (message->Length < static_cast<int>(Const::NetMsg_GameEventsBits))
+			continue;
+
+		const uint32_t event_id = message->DataIn.peek_ubit(Const::NetMsg_GameEventsBits);
+		if (event_id < counts.size() && descriptor(event_id))
+			counts[event_id]++;
+	}
+}
+
+TF2_NAMESPACE_END();
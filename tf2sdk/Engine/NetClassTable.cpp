@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <numeric>
+
+#include <tf2/engine/NetClassTable.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace net_class_impl
+{
+	static constexpr uint64_t hash_name(std::string_view name) noexcept
+	{
+		// FNV-1a
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (char c : name)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	static constexpr uint64_t mix(uint64_t value) noexcept
+	{
+		// splitmix64's finalizer, every bit of the seed reaches the low bits of the slot
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+
+	static size_t bucket_of(uint64_t hash, size_t num_buckets) noexcept
+	{
+		// The slot uses the low bits of the mixed hash, the bucket the high ones
+		return (mix(hash) >> 32) & (num_buckets - 1);
+	}
+
+	static int class_bits(int num_classes) noexcept
+	{
+		return std::max<int>(std::bit_width(static_cast<uint32_t>(std::max(num_classes, 0))), 1);
+	}
+}
+
+
+void NetClassTable::read(const SVC_ServerInfo& message)
+{
+	ClassBits = net_class_impl::class_bits(message.MaxClasses);
+}
+
+
+bool NetClassTable::read(const SVC_ClassInfo& message)
+{
+	begin(message.NumServerClasses);
+	if (message.CreateOnClient)
+		return false;
+
+	for (const auto& svclass : message.Classes)
+		add(svclass.classID, svclass.classname, svclass.datatablename);
+
+	return finish();
+}
+
+
+bool NetClassTable::read(utils::bf_read& buffer)
+{
+	const int num_classes = buffer.read_short();
+	const bool create_on_client = buffer.read_bit() != 0;
+
+	begin(num_classes);
+	if (create_on_client)
+		return false;
+
+	char name[256];
+	char table_name[256];
+	for (int i = 0; i < num_classes && !buffer.has_overflown(); i++)
+	{
+		const int class_id = buffer.read_ubit(ClassBits);
+		buffer.read_string(name, sizeof(name));
+		buffer.read_string(table_name, sizeof(table_name));
+		add(class_id, name, table_name);
+	}
+
+	return finish() && !buffer.has_overflown();
+}
+
+
+int NetClassTable::find_id(std::string_view name) const noexcept
+{
+	if (Slots.empty())
+		return -1;
+
+	const uint64_t hash = net_class_impl::hash_name(name);
+	const int class_id = Slots[slot_of(hash, Seeds[net_class_impl::bucket_of(hash, Seeds.size())])];
+
+	return class_id != -1 && Classes[class_id].Name == name ? class_id : -1;
+}
+
+
+void NetClassTable::clear() noexcept
+{
+	Names.clear();
+	Pending.clear();
+	Classes.clear();
+	Seeds.clear();
+	Slots.clear();
+	NumClasses = 0;
+}
+
+
+void NetClassTable::begin(int max_classes)
+{
+	clear();
+	ClassBits = net_class_impl::class_bits(max_classes);
+
+	Pending.reserve(std::max(max_classes, 0));
+	// Most network names are short, "CTFPlayer" and "DT_TFPlayer"
+	Names.reserve(std::max(max_classes, 0) * 32);
+}
+
+
+void NetClassTable::add(int class_id, std::string_view name, std::string_view table_name)
+{
+	if (class_id < 0 || class_id > INT16_MAX)
+		return;
+
+	auto intern = [this](std::string_view text)
+	{
+		const auto offset = static_cast<uint32_t>(Names.size());
+		Names.insert(Names.end(), text.begin(), text.end());
+		Names.push_back('\0');
+		return offset;
+	};
+
+	Pending.push_back(pending_class{ class_id, intern(name), intern(table_name) });
+}
+
+
+bool NetClassTable::finish()
+{
+	// The arena is complete, the names can point into it
+	int max_id = -1;
+	for (auto& pending : Pending)
+		max_id = std::max(max_id, pending.ClassID);
+
+	Classes.assign(static_cast<size_t>(max_id + 1), NetClassDescriptor{ });
+	for (auto& pending : Pending)
+	{
+		auto& descriptor = Classes[pending.ClassID];
+		if (!descriptor.is_valid())
+			NumClasses++;
+
+		descriptor.ClassID = pending.ClassID;
+		descriptor.Name = std::string_view(Names.data() + pending.Name);
+		descriptor.TableName = std::string_view(Names.data() + pending.TableName);
+	}
+
+	Pending.clear();
+	Pending.shrink_to_fit();
+
+	if (!build_hash())
+	{
+		clear();
+		return false;
+	}
+	return true;
+}
+
+
+bool NetClassTable::build_hash()
+{
+	if (!NumClasses)
+		return true;
+
+	Seeds.assign(std::bit_ceil(std::max<size_t>(NumClasses / Const::NetClass_BucketSize, 1)), 0);
+	// Load factor between 0.25 and 0.5, every bucket finds a seed in a few tries
+	Slots.assign(std::bit_ceil(NumClasses) * 2, -1);
+
+	std::vector<uint64_t> hashes(Classes.size());
+	std::vector<std::vector<int16_t>> buckets(Seeds.size());
+	for (auto& descriptor : Classes)
+	{
+		if (!descriptor.is_valid())
+			continue;
+
+		const uint64_t hash = net_class_impl::hash_name(descriptor.Name);
+		auto& bucket = buckets[net_class_impl::bucket_of(hash, Seeds.size())];
+
+		// Duplicate names resolve to the lowest class id
+		const bool duplicate = std::ranges::any_of(
+			bucket,
+			[&](int16_t other) { return hashes[other] == hash && Classes[other].Name == descriptor.Name; }
+		);
+		if (duplicate)
+			continue;
+
+		hashes[descriptor.ClassID] = hash;
+		bucket.push_back(static_cast<int16_t>(descriptor.ClassID));
+	}
+
+	// Place the largest buckets first, while most slots are still free
+	std::vector<uint32_t> order(buckets.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::ranges::stable_sort(order, [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+	std::vector<size_t> positions;
+	for (uint32_t index : order)
+	{
+		const auto& bucket = buckets[index];
+		if (bucket.empty())
+			break;
+
+		positions.resize(bucket.size());
+
+		uint32_t seed = 0;
+		for (; seed < Const::NetClass_MaxSeeds; seed++)
+		{
+			bool placed = true;
+			for (size_t i = 0; i < bucket.size() && placed; i++)
+			{
+				positions[i] = slot_of(hashes[bucket[i]], seed);
+				placed = Slots[positions[i]] == -1 && std::find(positions.begin(), positions.begin() + i, positions[i]) == positions.begin() + i;
+			}
+
+			if (placed)
+				break;
+		}
+
+		if (seed == Const::NetClass_MaxSeeds)
+			return false;
+
+		Seeds[index] = seed;
+		for (size_t i = 0; i < bucket.size(); i++)
+			Slots[positions[i]] = bucket[i];
+	}
+
+	return true;
+}
+
+
+size_t NetClassTable::slot_of(uint64_t hash, uint32_t seed) const noexcept
+{
+	return net_class_impl::mix(hash + seed * 0x9e3779b97f4a7c15ull) & (Slots.size() - 1);
+}
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <bit>
+
+#include <tf2/engine/NetFragments.hpp>
+#include <tf2/utils/Lzss.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+Const::NetFragStatus NetFragmentStream::read(utils::bf_read& buffer, int protocol)
+{
+	const bool single_block = buffer.read_bit() == 0;
+
+	uint32_t start = 0, count = 0;
+	if (!single_block)
+	{
+		start = buffer.read_ubit(Const::NetFrag_StartFragmentBits);
+		count = buffer.read_ubit(Const::NetFrag_NumFragmentsBits);
+	}
+
+	bool was_complete = is_complete();
+	if (!start)
+	{
+		// First fragment, a new transfer starts and replaces the one in progress
+		if (!read_header(buffer, single_block, protocol))
+			return Const::NetFragStatus::Overflow;
+		if (single_block)
+			count = NumFragments;
+		was_complete = false;
+	}
+	else if (!IsActive)
+		return Const::NetFragStatus::MissingHeader;
+
+	if (start + count > NumFragments)
+		return Const::NetFragStatus::BadFragment;
+
+	const uint32_t offset = start * Const::NetFrag_FragmentSize;
+	uint32_t length = count * Const::NetFrag_FragmentSize;
+
+	// The last fragment is shorter
+	if (start + count == NumFragments)
+		length -= NumFragments * Const::NetFrag_FragmentSize - Bytes;
+
+	if (static_cast<uint64_t>(length) * 8 > static_cast<uint64_t>(buffer.bits_left()))
+	{
+		buffer.mark_as_overflowed();
+		return Const::NetFragStatus::Overflow;
+	}
+
+	if (length)
+		buffer.read_bits(Buffer.data() + offset, static_cast<int>(length * 8));
+
+	ReceivedFragments += mark_received(start, count);
+	if (was_complete || !is_complete())
+		return Const::NetFragStatus::Pending;
+
+	return finish();
+}
+
+
+void NetFragmentStream::reset() noexcept
+{
+	FileName.clear();
+	TransferID = 0;
+	Bytes = UncompressedSize = 0;
+	NumFragments = ReceivedFragments = 0;
+	IsCompressed = IsActive = false;
+}
+
+
+bool NetFragmentStream::read_header(utils::bf_read& buffer, bool single_block, int protocol)
+{
+	reset();
+
+	if (!single_block && buffer.read_bit())
+	{
+		char file_name[Const::NetFrag_MaxPathLength];
+		TransferID = buffer.read_ubit(32);
+		buffer.read_string(file_name, sizeof(file_name));
+		FileName = file_name;
+	}
+
+	if (buffer.read_bit())
+	{
+		IsCompressed = true;
+		UncompressedSize = buffer.read_ubit(Const::NetFrag_MaxFileSizeBits);
+	}
+
+	if (!single_block)
+		Bytes = buffer.read_ubit(Const::NetFrag_MaxFileSizeBits);
+	else if (protocol > Const::NetFrag_Protocol_VarIntSize)
+		Bytes = buffer.read_uint32();
+	else
+		Bytes = buffer.read_ubit(Const::NetFrag_PayloadBits);
+
+	// The varint isn't bounded by its width, a transfer is never larger than a file
+	if (buffer.has_overflown() || Bytes >= (1u << Const::NetFrag_MaxFileSizeBits))
+		return false;
+
+	NumFragments = (Bytes + Const::NetFrag_FragmentSize - 1) / Const::NetFrag_FragmentSize;
+
+	// Only grows, the memory of the previous transfers is reused
+	if (Buffer.size() < Bytes)
+		Buffer.resize(Bytes);
+	Received.assign((NumFragments + 63) / 64, 0);
+
+	IsActive = true;
+	return true;
+}
+
+
+Const::NetFragStatus NetFragmentStream::finish()
+{
+	if (!IsCompressed)
+		return Const::NetFragStatus::Complete;
+
+	if (Decompressed.size() < UncompressedSize)
+		Decompressed.resize(UncompressedSize);
+
+	if (!utils::LZSS_IsCompressed(Buffer.data(), Bytes))
+	{
+		// Sent as is, the engine copies it
+		if (Bytes > UncompressedSize)
+			return Const::NetFragStatus::BadCompression;
+
+		UncompressedSize = Bytes;
+		std::copy_n(Buffer.data(), Bytes, Decompressed.data());
+		return Const::NetFragStatus::Complete;
+	}
+
+	if (utils::LZSS_GetActualSize(Buffer.data(), Bytes) != UncompressedSize ||
+		utils::LZSS_Decompress(Buffer.data(), Bytes, Decompressed.data(), UncompressedSize) != UncompressedSize)
+		return Const::NetFragStatus::BadCompression;
+
+	return Const::NetFragStatus::Complete;
+}
+
+
+uint32_t NetFragmentStream::mark_received(uint32_t start, uint32_t count) noexcept
+{
+	uint32_t added = 0;
+	while (count)
+	{
+		const uint32_t bit = start & 63;
+		const uint32_t num_bits = std::min(count, 64 - bit);
+		const uint64_t mask = (num_bits == 64 ? ~uint64_t{ } : (uint64_t{ 1 } << num_bits) - 1) << bit;
+
+		uint64_t& word = Received[start >> 6];
+		added += std::popcount(mask & ~word);
+		word |= mask;
+
+		start += num_bits;
+		count -= num_bits;
+	}
+	return added;
+}
+
+
+bool NetFragmentAssembler::read_subchannels(utils::bf_read& buffer)
+{
+	std::fill(std::begin(LastStatus), std::end(LastStatus), Const::NetFragStatus::Pending);
+
+	for (size_t i = 0; i < std::size(Streams); i++)
+	{
+		if (!buffer.read_bit())
+			continue;
+
+		LastStatus[i] = Streams[i].read(buffer, Protocol);
+		if (LastStatus[i] != Const::NetFragStatus::Pending && LastStatus[i] != Const::NetFragStatus::Complete)
+			return false;
+	}
+
+	return !buffer.has_overflown();
+}
+
+TF2_NAMESPACE_END();
@@ -1,9 +1,12 @@
 
 #include <algorithm>
+#include <bit>
 #include <cctype>
+#include <cstring>
 #include <vector>
 
 #include <tf2/engine/NetMessages.hpp>
+#include <tf2/utils/bitbuf_schema.hpp>
 
 #include <tf2/utils/KeyValues.hpp>
 
@@ -55,38 +58,54 @@ bool CLC_Move::ReadFromBuffer(utils::bf_read& buffer)
 
 bool CLC_ClientInfo::WriteToBuffer(utils::bf_write& buffer)
 {
-	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+	// Everything is known upfront, reserve the whole message once
+	int nBits = Const::NetMsgType_Bits + 32 + 32 + 1 + 32 + static_cast<int>(std::strlen(FriendsName) + 1) * 8 + 1;
+	for (auto crc : CustomFiles)
+		nBits += crc != 0 ? 1 + 32 : 1;
 
-	buffer.write_long(ServerCount);
-	buffer.write_long(SendTableCRC);
-	buffer.write_bit(IsHLTV ? 1 : 0);
-	buffer.write_long(FriendsID);
-	buffer.write_string(FriendsName);
+	utils::bf_write_reservation scope{ buffer, nBits };
+	if (!scope)
+		return false;
+
+	scope.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	scope.write_long(ServerCount);
+	scope.write_long(SendTableCRC);
+	scope.write_bit(IsHLTV ? 1 : 0);
+	scope.write_long(FriendsID);
+	scope.write_string(FriendsName);
 
 	for (int i = 0; i < std::ssize(CustomFiles); i++)
 	{
 		if (CustomFiles[i] != 0)
 		{
-			buffer.write_bit(1);
-			buffer.write_ubit(CustomFiles[i], 32);
+			scope.write_bit(1);
+			scope.write_ubit(CustomFiles[i], 32);
 		}
 		else
 		{
-			buffer.write_bit(0);
+			scope.write_bit(0);
 		}
 	}
 
-	buffer.write_bit(IsReplay ? 1 : 0);
+	scope.write_bit(IsReplay ? 1 : 0);
+	scope.commit();
 
 	return !buffer.has_overflown();
 }
 
 bool CLC_ClientInfo::ReadFromBuffer(utils::bf_read& buffer)
 {
-	ServerCount = buffer.read_long();
-	SendTableCRC = buffer.read_long();
-	IsHLTV = buffer.read_bit() != 0;
-	FriendsID = buffer.read_long();
+	{
+		utils::bf_read_reservation scope{ buffer, 32 + 32 + 1 + 32 };
+		if (!scope)
+			return false;
+
+		ServerCount = scope.read_long();
+		SendTableCRC = scope.read_long();
+		IsHLTV = scope.read_bit() != 0;
+		FriendsID = scope.read_long();
+	}
 	buffer.read_string(FriendsName, sizeof(FriendsName));
 
 	for (int i = 0; i < std::ssize(CustomFiles); i++)
@@ -106,19 +125,20 @@ bool CLC_ClientInfo::ReadFromBuffer(utils::bf_read& buffer)
 	return !buffer.has_overflown();
 }
 
+using CLC_BaselineAck_Schema = utils::bit_schema<
+	utils::schema::sbit<&CLC_BaselineAck::BaselineTick, 32>,
+	utils::schema::ubit<&CLC_BaselineAck::BaselineNr, 1>
+>;
+
 bool CLC_BaselineAck::WriteToBuffer(utils::bf_write& buffer)
 {
 	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
-	buffer.write_long(BaselineTick);
-	buffer.write_ubit(BaselineNr, 1);
-	return !buffer.has_overflown();
+	return CLC_BaselineAck_Schema::write(*this, buffer);
 }
 
 bool CLC_BaselineAck::ReadFromBuffer(utils::bf_read& buffer)
 {
-	BaselineTick = buffer.read_long();
-	BaselineNr = buffer.read_ubit(1);
-	return !buffer.has_overflown();
+	return CLC_BaselineAck_Schema::read(*this, buffer);
 }
 
 bool CLC_RespondCvarValue::WriteToBuffer(utils::bf_write& buffer)
@@ -164,11 +184,22 @@ constexpr const char* MostCommonPrefixes[] =
 	"scripts"
 };
 
+// _strcmpi is MSVC only, the demo tools also build on Linux
+static bool EqualsNoCase(const char* a, const char* b) noexcept
+{
+	for (; *a && *b; a++, b++)
+	{
+		if (std::tolower(static_cast<unsigned char>(*a)) != std::tolower(static_cast<unsigned char>(*b)))
+			return false;
+	}
+	return *a == *b;
+}
+
 static int FindCommonPathID(const char* pPathID)
 {
 	for (int i = 0; i < std::ssize(MostCommonPathIDs); i++)
 	{
-		if (_strcmpi(pPathID, MostCommonPathIDs[i]) == 0)
+		if (EqualsNoCase(pPathID, MostCommonPathIDs[i]))
 			return i;
 	}
 	return -1;
@@ -395,7 +426,10 @@ bool CLC_CmdKeyValues::WriteToBuffer(utils::bf_write& buffer)
 
 bool CLC_CmdKeyValues::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	const int length = buffer.read_long();
+
+	// The KeyValues payload needs the game's symbol table, skip it
+	return !buffer.has_overflown() && length >= 0 && buffer.seek_relative(length * 8);
 }
 
 SVC_CmdKeyValues::~SVC_CmdKeyValues()
@@ -412,18 +446,24 @@ bool SVC_CmdKeyValues::WriteToBuffer(utils::bf_write& buffer)
 
 bool SVC_CmdKeyValues::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	const int length = buffer.read_long();
+
+	// The KeyValues payload needs the game's symbol table, skip it
+	return !buffer.has_overflown() && length >= 0 && buffer.seek_relative(length * 8);
 }
 
 
 bool SVC_Print::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+	return buffer.write_string(Text ? Text : " svc_print NULL");
 }
 
 bool SVC_Print::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Text = TextBuffer;
+
+	return buffer.read_string(TextBuffer, sizeof(TextBuffer));
 }
 
 
@@ -443,91 +483,222 @@ bool NET_StringCmd::ReadFromBuffer(utils::bf_read& buffer)
 
 bool SVC_ServerInfo::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_short(static_cast<int16_t>(Protocol));
+	buffer.write_long(ServerCount);
+	buffer.write_bit(IsHLTV ? 1 : 0);
+	buffer.write_bit(IsDedicated ? 1 : 0);
+	buffer.write_long(-1);	// Used to be client.dll CRC
+	buffer.write_word(static_cast<uint16_t>(MaxClasses));
+	if (Protocol > Const::NetMsg_Protocol_MapCRC)
+		buffer.write_bytes(MapMD5.bits, MD5_DIGEST_LENGTH);
+	else
+		buffer.write_long(MapCRC);
+	buffer.write_byte(static_cast<uint8_t>(PlayerSlot));
+	buffer.write_byte(static_cast<uint8_t>(MaxClients));
+	buffer.write_float(fTickInterval);
+	buffer.write_char(static_cast<int8_t>(OS));
+	buffer.write_string(GameDir);
+	buffer.write_string(MapName);
+	buffer.write_string(SkyName);
+	buffer.write_string(HostName);
+	buffer.write_bit(IsReplay ? 1 : 0);
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_ServerInfo::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	GameDir = GameDirBuffer;
+	MapName = MapNameBuffer;
+	SkyName = SkyNameBuffer;
+	HostName = HostNameBuffer;
+
+	Protocol = buffer.read_short();
+	ServerCount = buffer.read_long();
+	IsHLTV = buffer.read_bit() != 0;
+	IsDedicated = buffer.read_bit() != 0;
+	[[maybe_unused]] int client_crc = buffer.read_long();
+	MaxClasses = buffer.read_word();
+	if (Protocol > Const::NetMsg_Protocol_MapCRC)
+		buffer.read_bytes(MapMD5.bits, MD5_DIGEST_LENGTH);
+	else
+		MapCRC = buffer.read_long();
+	PlayerSlot = buffer.read_byte();
+	MaxClients = buffer.read_byte();
+	fTickInterval = buffer.read_float();
+	OS = static_cast<OSType>(buffer.read_char());
+	buffer.read_string(GameDirBuffer, sizeof(GameDirBuffer));
+	buffer.read_string(MapNameBuffer, sizeof(MapNameBuffer));
+	buffer.read_string(SkyNameBuffer, sizeof(SkyNameBuffer));
+	buffer.read_string(HostNameBuffer, sizeof(HostNameBuffer));
+	IsReplay = buffer.read_bit() != 0;
+
+	return !buffer.has_overflown();
 }
 
+using NET_SignonState_Schema = utils::bit_schema<
+	utils::schema::ubit<&NET_SignonState::SignonState, 8>,
+	utils::schema::sbit<&NET_SignonState::SpawnCount, 32>
+>;
+
 bool NET_SignonState::WriteToBuffer(utils::bf_write& buffer)
 {
 	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
-	buffer.write_byte(static_cast<uint8_t>(SignonState));
-	buffer.write_long(SpawnCount);
-
-	return !buffer.has_overflown();
+	return NET_SignonState_Schema::write(*this, buffer);
 }
 
 bool NET_SignonState::ReadFromBuffer(utils::bf_read& buffer)
 {
-	SignonState = static_cast<Const::SignonStateType>(buffer.read_byte());
-	SpawnCount = buffer.read_long();
-
-	return !buffer.has_overflown();
+	return NET_SignonState_Schema::read(*this, buffer);
 }
 
 
 bool SVC_BSPDecal::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_vec3(Pos.data());
+	buffer.write_ubit(DecalTextureIndex, Const::NetMsg_DecalIndexBits);
+
+	if (EntityIndex != 0)
+	{
+		buffer.write_bit(1);
+		buffer.write_ubit(EntityIndex, Const::MaxEdicts_Bits);
+		buffer.write_ubit(ModelIndex, Const::NetMsg_ModelIndexBits);
+	}
+	else
+	{
+		buffer.write_bit(0);
+	}
+	buffer.write_bit(LowPriority ? 1 : 0);
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_BSPDecal::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	buffer.read_vec3(Pos.data());
+	DecalTextureIndex = buffer.read_ubit(Const::NetMsg_DecalIndexBits);
+
+	if (buffer.read_bit() != 0)
+	{
+		EntityIndex = buffer.read_ubit(Const::MaxEdicts_Bits);
+		ModelIndex = buffer.read_ubit(Const::NetMsg_ModelIndexBits);
+	}
+	else
+	{
+		EntityIndex = 0;
+		ModelIndex = 0;
+	}
+	LowPriority = buffer.read_bit() != 0;
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_SetView::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+	buffer.write_ubit(EntityIndex, Const::MaxEdicts_Bits);
+	return !buffer.has_overflown();
 }
 
 bool SVC_SetView::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	EntityIndex = buffer.read_ubit(Const::MaxEdicts_Bits);
+	return !buffer.has_overflown();
 }
 
 bool SVC_FixAngle::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_bit(Relative ? 1 : 0);
+	buffer.write_angle(Angle[0], 16);
+	buffer.write_angle(Angle[1], 16);
+	buffer.write_angle(Angle[2], 16);
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_FixAngle::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Relative = buffer.read_bit() != 0;
+	Angle[0] = buffer.read_angle(16);
+	Angle[1] = buffer.read_angle(16);
+	Angle[2] = buffer.read_angle(16);
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_CrosshairAngle::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_angle(Angle[0], 16);
+	buffer.write_angle(Angle[1], 16);
+	buffer.write_angle(Angle[2], 16);
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_CrosshairAngle::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Angle[0] = buffer.read_angle(16);
+	Angle[1] = buffer.read_angle(16);
+	Angle[2] = buffer.read_angle(16);
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_VoiceInit::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_string(VoiceCodec);
+	// v2 packets mark the deprecated quality field with 255 and send the sample rate
+	buffer.write_byte(255);
+	buffer.write_short(static_cast<int16_t>(SampleRate));
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_VoiceInit::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	buffer.read_string(VoiceCodec, sizeof(VoiceCodec));
+
+	if (buffer.read_byte() == 255)
+		SampleRate = buffer.read_word();
+	else
+	{
+		// Legacy packets had the sample rate hard-coded per codec
+		SampleRate = EqualsNoCase(VoiceCodec, "vaudio_celt") ? 22050 : 11025;
+	}
+
+	return !buffer.has_overflown();
 }
 
 
 bool SVC_VoiceData::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_byte(static_cast<uint8_t>(FromClient));
+	buffer.write_byte(Proximity ? 1 : 0);
+	buffer.write_word(static_cast<uint16_t>(Length));
+
+	return buffer.write_bits(DataOut, Length);
 }
 
 bool SVC_VoiceData::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	FromClient = buffer.read_byte();
+	Proximity = buffer.read_byte() != 0;
+	Length = buffer.read_word();
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 #define NET_TICK_SCALEUP	100000.0f
@@ -551,32 +722,51 @@ bool NET_Tick::ReadFromBuffer(utils::bf_read& buffer)
 
 bool SVC_UserMessage::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_byte(static_cast<uint8_t>(MsgType));
+	buffer.write_ubit(Length, Const::NetMsg_LengthBits);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_UserMessage::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	MsgType = buffer.read_byte();
+	Length = buffer.read_ubit(Const::NetMsg_LengthBits);
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_SetPause::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+	buffer.write_bit(Paused ? 1 : 0);
+	return !buffer.has_overflown();
 }
 
 bool SVC_SetPause::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Paused = buffer.read_bit() != 0;
+	return !buffer.has_overflown();
 }
 
 bool SVC_SetPauseTimed::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+	buffer.write_bit(Paused ? 1 : 0);
+	buffer.write_float(ExpireTime);
+	return !buffer.has_overflown();
 }
 
 bool SVC_SetPauseTimed::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Paused = buffer.read_bit() != 0;
+	ExpireTime = buffer.read_float();
+	return !buffer.has_overflown();
 }
 
 bool NET_SetConVar::WriteToBuffer(utils::bf_write& buffer)
@@ -617,103 +807,302 @@ bool NET_SetConVar::ReadFromBuffer(utils::bf_read& buffer)
 
 bool SVC_UpdateStringTable::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_ubit(TableID, Const::NetMsg_MaxTablesBits);
+	if (ChangedEntries != 1)
+	{
+		buffer.write_bit(1);
+		buffer.write_word(static_cast<uint16_t>(ChangedEntries));
+	}
+	else
+	{
+		buffer.write_bit(0);
+	}
+	buffer.write_ubit(Length, Const::NetMsg_DeltaSizeBits);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_UpdateStringTable::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	TableID = buffer.read_ubit(Const::NetMsg_MaxTablesBits);
+	ChangedEntries = buffer.read_bit() != 0 ? buffer.read_word() : 1;
+	Length = buffer.read_ubit(Const::NetMsg_DeltaSizeBits);
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_CreateStringTable::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	if (IsFilenames)
+		buffer.write_byte(':');
+
+	buffer.write_string(TableName);
+	buffer.write_word(static_cast<uint16_t>(MaxEntries));
+	buffer.write_ubit(NumEntries, std::bit_width(static_cast<uint32_t>(MaxEntries)));
+	buffer.write_uint32(Length);
+
+	buffer.write_bit(UserDataFixedSize ? 1 : 0);
+	if (UserDataFixedSize)
+	{
+		buffer.write_ubit(UserDataSize, Const::NetMsg_UserDataBits);
+		buffer.write_ubit(UserDataSizeBits, Const::NetMsg_UserDataSizeBits);
+	}
+	buffer.write_bit(DataCompressed ? 1 : 0);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_CreateStringTable::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	// Tables of filenames are tagged with a leading ':'
+	IsFilenames = buffer.peek_ubit(8) == ':';
+	if (IsFilenames)
+		buffer.seek_relative(8);
+
+	TableName = TableNameBuffer;
+	buffer.read_string(TableNameBuffer, sizeof(TableNameBuffer));
+	MaxEntries = buffer.read_word();
+	NumEntries = buffer.read_ubit(std::bit_width(static_cast<uint32_t>(MaxEntries)));
+	Length = buffer.read_uint32();
+
+	UserDataFixedSize = buffer.read_bit() != 0;
+	if (UserDataFixedSize)
+	{
+		UserDataSize = buffer.read_ubit(Const::NetMsg_UserDataBits);
+		UserDataSizeBits = buffer.read_ubit(Const::NetMsg_UserDataSizeBits);
+	}
+	else
+	{
+		UserDataSize = 0;
+		UserDataSizeBits = 0;
+	}
+	DataCompressed = buffer.read_bit() != 0;
+	DataIn = buffer;
+
+	return !buffer.has_overflown() && buffer.seek_relative(Length);
 }
 
 bool SVC_Sounds::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_bit(ReliableSound ? 1 : 0);
+	if (ReliableSound)
+	{
+		// a reliable message holds a single sound
+		buffer.write_ubit(Length, 8);
+	}
+	else
+	{
+		buffer.write_ubit(NumSounds, 8);
+		buffer.write_ubit(Length, 16);
+	}
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_Sounds::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	ReliableSound = buffer.read_bit() != 0;
+	if (ReliableSound)
+	{
+		NumSounds = 1;
+		Length = buffer.read_ubit(8);
+	}
+	else
+	{
+		NumSounds = buffer.read_ubit(8);
+		Length = buffer.read_ubit(16);
+	}
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_Prefetch::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+	buffer.write_ubit(SoundIndex, Const::NetMsg_SoundIndexBits);
+	return !buffer.has_overflown();
 }
 
 bool SVC_Prefetch::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	// sounds are the only prefetched resources
+	fType = 0;
+	SoundIndex = static_cast<unsigned short>(buffer.read_ubit(Const::NetMsg_SoundIndexBits));
+	return !buffer.has_overflown();
 }
 
 bool SVC_TempEntities::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_ubit(NumEntries, Const::NetMsg_TempEntitiesBits);
+	buffer.write_uint32(Length);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_TempEntities::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	NumEntries = buffer.read_ubit(Const::NetMsg_TempEntitiesBits);
+	Length = buffer.read_uint32();
+	DataIn = buffer;
+
+	return !buffer.has_overflown() && buffer.seek_relative(Length);
 }
 
 bool SVC_ClassInfo::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_short(static_cast<int16_t>(NumServerClasses));
+	buffer.write_bit(CreateOnClient ? 1 : 0);
+
+	if (CreateOnClient)
+		return !buffer.has_overflown();
+
+	const int nServerClassBits = std::max<int>(std::bit_width(static_cast<uint32_t>(NumServerClasses)), 1);
+	for (const auto& svclass : Classes)
+	{
+		buffer.write_ubit(svclass.classID, nServerClassBits);
+		buffer.write_string(svclass.classname);
+		buffer.write_string(svclass.datatablename);
+	}
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_ClassInfo::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Classes.clear();
+
+	NumServerClasses = buffer.read_short();
+	CreateOnClient = buffer.read_bit() != 0;
+
+	if (CreateOnClient)
+		return !buffer.has_overflown();
+
+	const int nServerClassBits = std::max<int>(std::bit_width(static_cast<uint32_t>(NumServerClasses)), 1);
+	for (int i = 0; i < NumServerClasses && !buffer.has_overflown(); i++)
+	{
+		class_t svclass;
+		svclass.classID = buffer.read_ubit(nServerClassBits);
+		buffer.read_string(svclass.classname, sizeof(svclass.classname));
+		buffer.read_string(svclass.datatablename, sizeof(svclass.datatablename));
+		Classes.push_to_tail(svclass);
+	}
+
+	return !buffer.has_overflown();
 }
 
 bool SVC_GameEvent::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_ubit(Length, Const::NetMsg_LengthBits);
 
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_GameEvent::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Length = buffer.read_ubit(Const::NetMsg_LengthBits);
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_SendTable::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_bit(NeedsDecoder ? 1 : 0);
+	buffer.write_short(static_cast<int16_t>(Length));
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_SendTable::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	NeedsDecoder = buffer.read_bit() != 0;
+	Length = buffer.read_short();
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_EntityMessage::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_ubit(EntityIndex, Const::MaxEdicts_Bits);
+	buffer.write_ubit(ClassID, Const::MaxServerClasses_Bits);
+	buffer.write_ubit(Length, Const::NetMsg_LengthBits);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_EntityMessage::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	EntityIndex = buffer.read_ubit(Const::MaxEdicts_Bits);
+	ClassID = buffer.read_ubit(Const::MaxServerClasses_Bits);
+	Length = buffer.read_ubit(Const::NetMsg_LengthBits);
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_PacketEntities::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_ubit(MaxEntries, Const::MaxEdicts_Bits);
+	buffer.write_bit(IsDelta ? 1 : 0);
+	if (IsDelta)
+		buffer.write_long(DeltaFrom);
+	buffer.write_ubit(Baseline, 1);
+	buffer.write_ubit(UpdatedEntries, Const::MaxEdicts_Bits);
+	buffer.write_ubit(Length, Const::NetMsg_DeltaSizeBits);
+	buffer.write_bit(UpdateBaseline ? 1 : 0);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_PacketEntities::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	MaxEntries = buffer.read_ubit(Const::MaxEdicts_Bits);
+	IsDelta = buffer.read_bit() != 0;
+	DeltaFrom = IsDelta ? buffer.read_long() : -1;
+	Baseline = buffer.read_ubit(1);
+	UpdatedEntries = buffer.read_ubit(Const::MaxEdicts_Bits);
+	Length = buffer.read_ubit(Const::NetMsg_DeltaSizeBits);
+	UpdateBaseline = buffer.read_bit() != 0;
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
 }
 
 bool SVC_Menu::WriteToBuffer(utils::bf_write& buffer)
@@ -723,17 +1112,52 @@ bool SVC_Menu::WriteToBuffer(utils::bf_write& buffer)
 
 bool SVC_Menu::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	Type = static_cast<DialogType>(buffer.read_short());
+	iLength = buffer.read_word();
+
+	// The KeyValues payload needs the game's symbol table, skip it
+	return !buffer.has_overflown() && buffer.seek_relative(iLength * 8);
 }
 
 bool SVC_GameEventList::WriteToBuffer(utils::bf_write& buffer)
 {
-	return false;
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	Length = DataOut.bits_written();
+
+	buffer.write_ubit(NumEvents, Const::NetMsg_GameEventsBits);
+	buffer.write_ubit(Length, Const::NetMsg_DeltaSizeBits);
+
+	return buffer.write_bits(DataOut.data(), Length);
 }
 
 bool SVC_GameEventList::ReadFromBuffer(utils::bf_read& buffer)
 {
-	return false;
+	NumEvents = buffer.read_ubit(Const::NetMsg_GameEventsBits);
+	Length = buffer.read_ubit(Const::NetMsg_DeltaSizeBits);
+	DataIn = buffer;
+
+	return buffer.seek_relative(Length);
+}
+
+bool SVC_GetCvarValue::WriteToBuffer(utils::bf_write& buffer)
+{
+	buffer.write_ubit(static_cast<uint32_t>(GetType()), Const::NetMsgType_Bits);
+
+	buffer.write_sbit(Cookie, 32);
+	buffer.write_string(CvarName);
+
+	return !buffer.has_overflown();
+}
+
+bool SVC_GetCvarValue::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Cookie = buffer.read_sbit(32);
+
+	CvarName = CvarNameBuffer;
+	buffer.read_string(CvarNameBuffer, sizeof(CvarNameBuffer));
+
+	return !buffer.has_overflown();
 }
 
 
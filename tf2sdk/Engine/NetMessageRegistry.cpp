@@ -0,0 +1,174 @@
+#include <chrono>
+
+#include <tf2/engine/NetMessageRegistry.hpp>
+#include <tf2/engine/NetMessageStats.hpp>
+#include <tf2/engine/NetMessageTrace.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+void NetMessageHandle::reset() noexcept
+{
+	if (Message)
+		Owner->release(std::exchange(Message, nullptr));
+	Owner = nullptr;
+}
+
+
+NetMessageDecoder::NetMessageDecoder(Const::NetMsgDirection direction) :
+	Direction(direction)
+{
+	register_message<NET_Tick>();
+	register_message<NET_StringCmd>();
+	register_message<NET_SetConVar>();
+	register_message<NET_SignonState>();
+
+	switch (direction)
+	{
+	case Const::NetMsgDirection::ServerToClient:
+	{
+		register_message<SVC_Print>();
+		register_message<SVC_ServerInfo>();
+		register_message<SVC_SendTable>();
+		register_message<SVC_ClassInfo>();
+		register_message<SVC_SetPause>();
+		register_message<SVC_CreateStringTable>();
+		register_message<SVC_UpdateStringTable>();
+		register_message<SVC_VoiceInit>();
+		register_message<SVC_VoiceData>();
+		register_message<SVC_Sounds>();
+		register_message<SVC_SetView>();
+		register_message<SVC_FixAngle>();
+		register_message<SVC_CrosshairAngle>();
+		register_message<SVC_BSPDecal>();
+		register_message<SVC_UserMessage>();
+		register_message<SVC_EntityMessage>();
+		register_message<SVC_GameEvent>();
+		register_message<SVC_PacketEntities>();
+		register_message<SVC_TempEntities>();
+		register_message<SVC_Prefetch>();
+		register_message<SVC_Menu>();
+		register_message<SVC_GameEventList>();
+		register_message<SVC_GetCvarValue>();
+		register_message<SVC_CmdKeyValues>();
+		register_message<SVC_SetPauseTimed>();
+		break;
+	}
+	case Const::NetMsgDirection::ClientToServer:
+	{
+		register_message<CLC_ClientInfo>();
+		register_message<CLC_Move>();
+		register_message<CLC_VoiceData>();
+		register_message<CLC_BaselineAck>();
+		register_message<CLC_RespondCvarValue>();
+		register_message<CLC_FileCRCCheck>();
+		register_message<CLC_CmdKeyValues>();
+		register_message<CLC_FileMD5Check>();
+		break;
+	}
+	}
+}
+
+
+void NetMessageDecoder::register_factory(Const::NetMsgType type, factory_type factory)
+{
+	auto& entry = Entries[static_cast<size_t>(type)];
+	entry.Factory = factory;
+	entry.Free.clear();
+}
+
+
+void NetMessageDecoder::reserve(Const::NetMsgType type, size_t count)
+{
+	auto& entry = Entries[static_cast<size_t>(type)];
+	if (!entry.Factory)
+		return;
+
+	entry.Free.reserve(count);
+	while (entry.Free.size() < count)
+		entry.Free.emplace_back(entry.Factory());
+}
+
+
+Const::NetMsgDecodeStatus NetMessageDecoder::decode(utils::bf_read& buffer, NetMessageHandle& message)
+{
+	message.reset();
+
+	uint32_t type;
+	do
+	{
+		// Anything shorter than a header is the padding of the last byte
+		if (buffer.bits_left() < static_cast<int>(Const::NetMsgType_Bits))
+			return Const::NetMsgDecodeStatus::EndOfStream;
+
+		type = buffer.read_ubit(Const::NetMsgType_Bits);
+	} while (type == static_cast<uint32_t>(Const::NetMsgType::net_Nop));
+
+	const int start_bit = buffer.bits_written() - static_cast<int>(Const::NetMsgType_Bits);
+
+	auto& entry = Entries[type];
+	if (!entry.Factory)
+		return Const::NetMsgDecodeStatus::UnknownType;
+
+	INetMessage* instance;
+	if (entry.Free.empty())
+		instance = entry.Factory();
+	else
+	{
+		instance = entry.Free.back().release();
+		entry.Free.pop_back();
+	}
+
+	message = NetMessageHandle(this, instance);
+
+	// Only timed when someone is collecting
+	std::chrono::steady_clock::time_point start_time;
+	if (Stats)
+		start_time = std::chrono::steady_clock::now();
+
+	if (!instance->ReadFromBuffer(buffer))
+	{
+		message.reset();
+		return Const::NetMsgDecodeStatus::ReadFailed;
+	}
+
+	const uint32_t bits = static_cast<uint32_t>(buffer.bits_written() - start_bit);
+	if (Stats)
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - start_time;
+		Stats->record(*instance, bits, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+	if (type == static_cast<uint32_t>(Const::NetMsgType::net_Tick))
+		Tick = static_cast<const NET_Tick*>(instance)->Tick;
+
+	if (Trace)
+	{
+		Trace->record(*instance, Tick, bits, Direction == Const::NetMsgDirection::ClientToServer);
+	}
+
+	return Const::NetMsgDecodeStatus::Ok;
+}
+
+
+void NetMessageDecoder::release(INetMessage* message) noexcept
+{
+	auto& entry = Entries[static_cast<size_t>(message->GetType())];
+	// The type was unregistered while the message was out
+	if (!entry.Factory)
+	{
+		delete message;
+		return;
+	}
+
+	// Pooling is best effort, an instance the free list can't grow for is dropped
+	try
+	{
+		entry.Free.emplace_back(message);
+	}
+	catch (...)
+	{
+		delete message;
+	}
+}
+
+TF2_NAMESPACE_END();
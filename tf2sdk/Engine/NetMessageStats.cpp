@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include <px/console.hpp>
+#include <tf2/engine/NetMessageStats.hpp>
+#include <tf2/engine/NetMessageTrace.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace net_stats_impl
+{
+	template<typename... _Args>
+	static void append(std::string& output, const char* fmt, _Args... args)
+	{
+		char line[256];
+		const int length = std::snprintf(line, sizeof(line), fmt, args...);
+		if (length > 0)
+			output.append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+	}
+
+	/// <summary>
+	/// Indices of the counters that were hit, most expensive to decode first
+	/// </summary>
+	template<size_t _Size>
+	static std::vector<size_t> sort_by_time(const std::array<NetMessageCounters, _Size>& counters)
+	{
+		std::vector<size_t> indices;
+		for (size_t i = 0; i < _Size; i++)
+		{
+			if (counters[i].Count)
+				indices.push_back(i);
+		}
+
+		std::stable_sort(
+			indices.begin(),
+			indices.end(),
+			[&](size_t a, size_t b) { return counters[a].Nanoseconds > counters[b].Nanoseconds; }
+		);
+		return indices;
+	}
+
+	static void append_row(std::string& output, const char* name, const NetMessageCounters& counters)
+	{
+		append(
+			output,
+			"%-24s %10llu %12llu %10llu %10.3f %8llu %8llu\n",
+			name,
+			static_cast<unsigned long long>(counters.Count),
+			static_cast<unsigned long long>((counters.Bits + 7) / 8),
+			static_cast<unsigned long long>((counters.MaxBits + 7) / 8),
+			static_cast<double>(counters.Nanoseconds) / 1e6,
+			static_cast<unsigned long long>(counters.Nanoseconds / counters.Count),
+			static_cast<unsigned long long>(counters.percentile_nanoseconds(0.99))
+		);
+	}
+
+	static void append_json(std::string& output, const NetMessageCounters& counters)
+	{
+		append(
+			output,
+			"\"count\":%llu,\"bits\":%llu,\"max_bits\":%llu,\"nanoseconds\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"histogram\":[",
+			static_cast<unsigned long long>(counters.Count),
+			static_cast<unsigned long long>(counters.Bits),
+			static_cast<unsigned long long>(counters.MaxBits),
+			static_cast<unsigned long long>(counters.Nanoseconds),
+			static_cast<unsigned long long>(counters.percentile_nanoseconds(0.5)),
+			static_cast<unsigned long long>(counters.percentile_nanoseconds(0.99))
+		);
+
+		for (size_t i = 0; i < std::size(counters.Histogram); i++)
+			append(output, i ? ",%llu" : "%llu", static_cast<unsigned long long>(counters.Histogram[i]));
+		output += ']';
+	}
+}
+
+
+uint64_t NetMessageCounters::percentile_nanoseconds(double fraction) const noexcept
+{
+	if (!Count)
+		return 0;
+
+	const double target = fraction * static_cast<double>(Count);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < std::size(Histogram); i++)
+	{
+		seen += Histogram[i];
+		if (static_cast<double>(seen) >= target)
+			return bucket_upper_bound(i);
+	}
+	return bucket_upper_bound(std::size(Histogram) - 1);
+}
+
+
+std::string NetMessageStatsSnapshot::to_string() const
+{
+	const bool client_to_server = Direction == Const::NetMsgDirection::ClientToServer;
+
+	std::string output;
+	net_stats_impl::append(output, "%-24s %10s %12s %10s %10s %8s %8s\n", "message", "count", "bytes", "max bytes", "total ms", "avg ns", "p99 ns");
+	for (size_t type : net_stats_impl::sort_by_time(Types))
+	{
+		const char* name = NetMessageTrace::type_name(static_cast<Const::NetMsgType>(type), client_to_server);
+		net_stats_impl::append_row(output, *name ? name : "unknown", Types[type]);
+	}
+
+	output += '\n';
+	net_stats_impl::append(output, "%-24s %10s %12s %10s %10s %8s %8s\n", "group", "count", "bytes", "max bytes", "total ms", "avg ns", "p99 ns");
+	for (size_t group : net_stats_impl::sort_by_time(Groups))
+		net_stats_impl::append_row(output, NetMessageTrace::group_name(static_cast<Const::NetMsgGroup>(group)), Groups[group]);
+
+	return output;
+}
+
+
+std::string NetMessageStatsSnapshot::to_json() const
+{
+	const bool client_to_server = Direction == Const::NetMsgDirection::ClientToServer;
+
+	std::string output;
+	output += client_to_server ? "{\"direction\":\"client_to_server\",\"types\":[" : "{\"direction\":\"server_to_client\",\"types\":[";
+
+	bool first = true;
+	for (size_t type = 0; type < Types.size(); type++)
+	{
+		if (!Types[type].Count)
+			continue;
+
+		if (!std::exchange(first, false))
+			output += ',';
+		net_stats_impl::append(
+			output,
+			"{\"type\":%zu,\"name\":\"%s\",",
+			type,
+			NetMessageTrace::type_name(static_cast<Const::NetMsgType>(type), client_to_server)
+		);
+		net_stats_impl::append_json(output, Types[type]);
+		output += '}';
+	}
+
+	output += "],\"groups\":[";
+
+	first = true;
+	for (size_t group = 0; group < Groups.size(); group++)
+	{
+		if (!Groups[group].Count)
+			continue;
+
+		if (!std::exchange(first, false))
+			output += ',';
+		net_stats_impl::append(output, "{\"group\":\"%s\",", NetMessageTrace::group_name(static_cast<Const::NetMsgGroup>(group)));
+		net_stats_impl::append_json(output, Groups[group]);
+		output += '}';
+	}
+
+	output += "]}";
+	return output;
+}
+
+
+void NetMessageStatsSnapshot::print(IConsoleManager& console) const
+{
+	console.Print(to_string());
+}
+
+
+NetMessageStats::NetMessageStats(Const::NetMsgDirection direction) :
+	Direction(direction)
+{ }
+
+
+NetMessageStats::~NetMessageStats()
+{
+	for (auto& slot : Slots)
+		delete slot.load(std::memory_order_relaxed);
+}
+
+
+NetMessageStats::thread_index_type::thread_index_type() noexcept
+{
+	uint64_t free = FreeThreadIndices.load(std::memory_order_relaxed);
+	while (free)
+	{
+		// Acquires the counts the previous owner of the index stored
+		const size_t index = static_cast<size_t>(std::countr_zero(free));
+		if (FreeThreadIndices.compare_exchange_weak(free, free & ~(uint64_t{ 1 } << index), std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			Index = index;
+			IsShared = false;
+			return;
+		}
+	}
+
+	Index = Const::NetStats_MaxThreads;
+	IsShared = true;
+}
+
+
+NetMessageStats::thread_index_type::~thread_index_type()
+{
+	if (!IsShared)
+		FreeThreadIndices.fetch_or(uint64_t{ 1 } << Index, std::memory_order_release);
+}
+
+
+NetMessageStats::slot_type& NetMessageStats::create_slot(size_t index)
+{
+	auto slot = new slot_type;
+
+	// Another thread may have created the shared slot first
+	slot_type* expected = nullptr;
+	if (!Slots[index].compare_exchange_strong(expected, slot, std::memory_order_acq_rel))
+	{
+		delete slot;
+		return *expected;
+	}
+	return *slot;
+}
+
+
+NetMessageStatsSnapshot NetMessageStats::snapshot() const
+{
+	NetMessageStatsSnapshot snapshot;
+	snapshot.Direction = Direction;
+
+	for (auto& slot_ptr : Slots)
+	{
+		auto slot = slot_ptr.load(std::memory_order_acquire);
+		if (!slot)
+			continue;
+
+		for (size_t type = 0; type < Const::NetMsgType_Max; type++)
+		{
+			const auto& counters = slot->Types[type];
+
+			NetMessageCounters merged;
+			merged.Count = counters.Count.load(std::memory_order_relaxed);
+			if (!merged.Count)
+				continue;
+
+			merged.Bits = counters.Bits.load(std::memory_order_relaxed);
+			merged.MaxBits = counters.MaxBits.load(std::memory_order_relaxed);
+			merged.Nanoseconds = counters.Nanoseconds.load(std::memory_order_relaxed);
+			for (size_t i = 0; i < std::size(merged.Histogram); i++)
+				merged.Histogram[i] = counters.Histogram[i].load(std::memory_order_relaxed);
+
+			snapshot.Types[type].merge(merged);
+
+			const size_t group = counters.Group.load(std::memory_order_relaxed);
+			if (group < snapshot.Groups.size())
+				snapshot.Groups[group].merge(merged);
+		}
+	}
+
+	return snapshot;
+}
+
+
+void NetMessageStats::reset() noexcept
+{
+	for (auto& slot_ptr : Slots)
+	{
+		auto slot = slot_ptr.load(std::memory_order_acquire);
+		if (!slot)
+			continue;
+
+		for (auto& counters : slot->Types)
+		{
+			counters.Count.store(0, std::memory_order_relaxed);
+			counters.Bits.store(0, std::memory_order_relaxed);
+			counters.MaxBits.store(0, std::memory_order_relaxed);
+			counters.Nanoseconds.store(0, std::memory_order_relaxed);
+			for (auto& bucket : counters.Histogram)
+				bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+TF2_NAMESPACE_END();
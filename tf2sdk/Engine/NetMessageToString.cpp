@@ -0,0 +1,279 @@
+#include <cstdio>
+
+#include <tf2/engine/NetMessages.hpp>
+#include <tf2/utils/KeyValues.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace net_message_impl
+{
+	/// <summary>
+	/// Formats into a per thread buffer like the engine's s_text, the string is valid until the next ToString() of the thread
+	/// </summary>
+	template<typename... _Args>
+	static const char* format(const char* fmt, _Args... args)
+	{
+		thread_local char text[1024];
+		std::snprintf(text, sizeof(text), fmt, args...);
+		return text;
+	}
+
+	static const char* str(const char* text) noexcept
+	{
+		return text ? text : "";
+	}
+
+	static int bytes(int bits) noexcept
+	{
+		return (bits + 7) / 8;
+	}
+
+	static const char* key_values_name(const KeyValues* kv) noexcept
+	{
+		return kv ? str(kv->GetName()) : "";
+	}
+}
+
+
+const char* NET_SetConVar::ToString() const
+{
+	if (ConVars.is_empty())
+		return net_message_impl::format("%s: 0 cvars", GetName());
+	return net_message_impl::format("%s: %u cvars, \"%s\"=\"%s\"", GetName(), ConVars.size(), ConVars[0].Name, ConVars[0].Value);
+}
+
+const char* NET_StringCmd::ToString() const
+{
+	return net_message_impl::format("%s: \"%s\"", GetName(), net_message_impl::str(Command));
+}
+
+const char* NET_Tick::ToString() const
+{
+	return net_message_impl::format("%s: tick %i", GetName(), Tick);
+}
+
+const char* NET_SignonState::ToString() const
+{
+	return net_message_impl::format("%s: state %i, count %i", GetName(), static_cast<int>(SignonState), SpawnCount);
+}
+
+
+const char* CLC_ClientInfo::ToString() const
+{
+	return net_message_impl::format("%s: SendTableCRC %u, hltv %i, friends \"%s\"", GetName(), SendTableCRC, IsHLTV ? 1 : 0, FriendsName);
+}
+
+const char* CLC_RespondCvarValue::ToString() const
+{
+	return net_message_impl::format(
+		"%s: status: %i, value: %s, cookie: %i",
+		GetName(),
+		static_cast<int>(StatusCode),
+		net_message_impl::str(CvarValue),
+		Cookie
+	);
+}
+
+const char* CLC_Move::ToString() const
+{
+	return net_message_impl::format("%s: backup %i, new %i, bytes %i", GetName(), BackupCommands, NewCommands, net_message_impl::bytes(Length));
+}
+
+const char* CLC_VoiceData::ToString() const
+{
+	return net_message_impl::format("%s: %i bytes", GetName(), net_message_impl::bytes(Length));
+}
+
+const char* CLC_BaselineAck::ToString() const
+{
+	return net_message_impl::format("%s: tick %i, baseline %i", GetName(), BaselineTick, BaselineNr);
+}
+
+const char* CLC_FileCRCCheck::ToString() const
+{
+	return net_message_impl::format("%s: path: %s, file: %s", GetName(), PathID, Filename);
+}
+
+const char* CLC_FileMD5Check::ToString() const
+{
+	return net_message_impl::format("%s: path: %s, file: %s", GetName(), PathID, Filename);
+}
+
+const char* CLC_CmdKeyValues::ToString() const
+{
+	return net_message_impl::format("%s: %s", GetName(), net_message_impl::key_values_name(KV));
+}
+
+
+const char* SVC_CmdKeyValues::ToString() const
+{
+	return net_message_impl::format("%s: %s", GetName(), net_message_impl::key_values_name(KV));
+}
+
+const char* SVC_Print::ToString() const
+{
+	return net_message_impl::format("%s: \"%s\"", GetName(), net_message_impl::str(Text));
+}
+
+const char* SVC_ServerInfo::ToString() const
+{
+	return net_message_impl::format(
+		"%s: game \"%s\", map \"%s\", max %i",
+		GetName(),
+		net_message_impl::str(GameDir),
+		net_message_impl::str(MapName),
+		MaxClients
+	);
+}
+
+const char* SVC_SendTable::ToString() const
+{
+	return net_message_impl::format("%s: NeedsDecoder %s, bytes %i", GetName(), NeedsDecoder ? "yes" : "no", net_message_impl::bytes(Length));
+}
+
+const char* SVC_ClassInfo::ToString() const
+{
+	return net_message_impl::format("%s: num %i, %s", GetName(), NumServerClasses, CreateOnClient ? "use client classes" : "full update");
+}
+
+const char* SVC_SetPause::ToString() const
+{
+	return net_message_impl::format("%s: %s", GetName(), Paused ? "paused" : "unpaused");
+}
+
+const char* SVC_GetCvarValue::ToString() const
+{
+	return net_message_impl::format("%s: %s, cookie: %i", GetName(), net_message_impl::str(CvarName), Cookie);
+}
+
+const char* SVC_SetPauseTimed::ToString() const
+{
+	return net_message_impl::format("%s: %s, expire %.2f", GetName(), Paused ? "paused" : "unpaused", static_cast<double>(ExpireTime));
+}
+
+const char* SVC_CreateStringTable::ToString() const
+{
+	return net_message_impl::format(
+		"%s: table %s, entries %i, bytes %i userdatasize %i userdatabits %i",
+		GetName(),
+		net_message_impl::str(TableName),
+		NumEntries,
+		net_message_impl::bytes(Length),
+		UserDataSize,
+		UserDataSizeBits
+	);
+}
+
+const char* SVC_UpdateStringTable::ToString() const
+{
+	return net_message_impl::format("%s: table %i, changed %i, bytes %i", GetName(), TableID, ChangedEntries, net_message_impl::bytes(Length));
+}
+
+const char* SVC_VoiceInit::ToString() const
+{
+	return net_message_impl::format("%s: codec \"%s\", sample rate %i", GetName(), VoiceCodec, SampleRate);
+}
+
+const char* SVC_VoiceData::ToString() const
+{
+	return net_message_impl::format("%s: client %i, bytes %i", GetName(), FromClient, net_message_impl::bytes(Length));
+}
+
+const char* SVC_Sounds::ToString() const
+{
+	return net_message_impl::format(
+		"%s: number %i,%s bytes %i",
+		GetName(),
+		NumSounds,
+		ReliableSound ? " reliable," : "",
+		net_message_impl::bytes(Length)
+	);
+}
+
+const char* SVC_Prefetch::ToString() const
+{
+	return net_message_impl::format("%s: type %i index %i", GetName(), static_cast<int>(fType), static_cast<int>(SoundIndex));
+}
+
+const char* SVC_SetView::ToString() const
+{
+	return net_message_impl::format("%s: view entity %i", GetName(), EntityIndex);
+}
+
+const char* SVC_FixAngle::ToString() const
+{
+	return net_message_impl::format(
+		"%s: %s %.1f %.1f %.1f",
+		GetName(),
+		Relative ? "relative" : "absolute",
+		static_cast<double>(Angle[0]), static_cast<double>(Angle[1]), static_cast<double>(Angle[2])
+	);
+}
+
+const char* SVC_CrosshairAngle::ToString() const
+{
+	return net_message_impl::format("%s: (%.1f %.1f %.1f)", GetName(), static_cast<double>(Angle[0]), static_cast<double>(Angle[1]), static_cast<double>(Angle[2]));
+}
+
+const char* SVC_BSPDecal::ToString() const
+{
+	return net_message_impl::format(
+		"%s: tex %i, ent %i, mod %i lowpriority %i",
+		GetName(),
+		DecalTextureIndex,
+		EntityIndex,
+		ModelIndex,
+		LowPriority ? 1 : 0
+	);
+}
+
+const char* SVC_GameEvent::ToString() const
+{
+	return net_message_impl::format("%s: bytes %i", GetName(), net_message_impl::bytes(Length));
+}
+
+const char* SVC_UserMessage::ToString() const
+{
+	return net_message_impl::format("%s: type %i, bytes %i", GetName(), MsgType, net_message_impl::bytes(Length));
+}
+
+const char* SVC_EntityMessage::ToString() const
+{
+	return net_message_impl::format("%s: entity %i, class %i, bytes %i", GetName(), EntityIndex, ClassID, net_message_impl::bytes(Length));
+}
+
+const char* SVC_PacketEntities::ToString() const
+{
+	return net_message_impl::format(
+		"%s: delta %i, max %i, changed %i,%s bytes %i",
+		GetName(),
+		IsDelta ? DeltaFrom : -1,
+		MaxEntries,
+		UpdatedEntries,
+		UpdateBaseline ? " BL update," : "",
+		net_message_impl::bytes(Length)
+	);
+}
+
+const char* SVC_TempEntities::ToString() const
+{
+	return net_message_impl::format("%s: number %i, bytes %i", GetName(), NumEntries, net_message_impl::bytes(Length));
+}
+
+const char* SVC_Menu::ToString() const
+{
+	return net_message_impl::format(
+		"%s: %i \"%s\" (len:%i)",
+		GetName(),
+		static_cast<int>(Type),
+		net_message_impl::key_values_name(MenuKeyValues),
+		iLength
+	);
+}
+
+const char* SVC_GameEventList::ToString() const
+{
+	return net_message_impl::format("%s: number %i, bytes %i", GetName(), NumEvents, net_message_impl::bytes(Length));
+}
+
+TF2_NAMESPACE_END();
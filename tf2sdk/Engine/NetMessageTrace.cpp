@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+#include <tf2/engine/NetMessageTrace.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace net_trace_impl
+{
+	// Indexed by message id, net_ messages are shared by both directions
+	static constexpr const char* net_names[]
+	{
+		"net_NOP",
+		"net_Disconnect",
+		"net_File",
+		"net_Tick",
+		"net_StringCmd",
+		"net_SetConVar",
+		"net_SignonState"
+	};
+
+	static constexpr const char* svc_names[]
+	{
+		"svc_Print",
+		"svc_ServerInfo",
+		"svc_SendTable",
+		"svc_ClassInfo",
+		"svc_SetPause",
+		"svc_CreateStringTable",
+		"svc_UpdateStringTable",
+		"svc_VoiceInit",
+		"svc_VoiceData",
+		"",
+		"svc_Sounds",
+		"svc_SetView",
+		"svc_FixAngle",
+		"svc_CrosshairAngle",
+		"svc_BSPDecal",
+		"",
+		"svc_UserMessage",
+		"svc_EntityMessage",
+		"svc_GameEvent",
+		"svc_PacketEntities",
+		"svc_TempEntities",
+		"svc_Prefetch",
+		"svc_Menu",
+		"svc_GameEventList",
+		"svc_GetCvarValue",
+		"svc_CmdKeyValues",
+		"svc_SetPauseTimed"
+	};
+
+	static constexpr const char* clc_names[]
+	{
+		"clc_ClientInfo",
+		"clc_Move",
+		"clc_VoiceData",
+		"clc_BaselineAck",
+		"clc_ListenEvents",
+		"clc_RespondCvarValue",
+		"clc_FileCRCCheck",
+		"clc_SaveReplay",
+		"clc_CmdKeyValues",
+		"clc_FileMD5Check"
+	};
+
+	static constexpr const char* group_names[]
+	{
+		"Generic",
+		"LocalPlayer",
+		"OtherPlayers",
+		"Entities",
+		"Sounds",
+		"Events",
+		"UserMsgs",
+		"EntMsgs",
+		"Voice",
+		"StringTable",
+		"Move",
+		"StringCmd",
+		"Signon"
+	};
+
+	static_assert(std::size(net_names) == static_cast<size_t>(Const::NetMsgType::net_SignonState) + 1);
+	static_assert(std::size(svc_names) == static_cast<size_t>(Const::NetMsgType::svc_SetPauseTimed) - static_cast<size_t>(Const::NetMsgType::svc_Print) + 1);
+	static_assert(std::size(clc_names) == static_cast<size_t>(Const::NetMsgType::clc_FileMD5Check) - static_cast<size_t>(Const::NetMsgType::clc_ClientInfo) + 1);
+	static_assert(std::size(group_names) == static_cast<size_t>(Const::NetMsgGroup::Count));
+}
+
+
+NetMessageTrace::NetMessageTrace(size_t capacity) :
+	Slots(std::make_unique<slot_type[]>(std::bit_ceil(std::max<size_t>(capacity, 1)))),
+	Mask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1)
+{ }
+
+
+size_t NetMessageTrace::snapshot(std::vector<NetTraceEvent>& events) const
+{
+	const uint64_t head = Head.load(std::memory_order_acquire);
+	const uint64_t first = head > capacity() ? head - capacity() : 0;
+
+	events.clear();
+	events.reserve(head - first);
+
+	for (uint64_t index = first; index < head; index++)
+	{
+		const auto& slot = Slots[index & Mask];
+
+		const uint64_t sequence = slot.Sequence.load(std::memory_order_acquire);
+		// Not written yet, being written or already overwritten
+		if (sequence != index * 2 + 2)
+			continue;
+
+		const uint64_t word0 = slot.Words[0].load(std::memory_order_relaxed);
+		const uint64_t word1 = slot.Words[1].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.Sequence.load(std::memory_order_relaxed) != sequence)
+			continue;
+
+		events.push_back(
+			NetTraceEvent{
+				.Tick = static_cast<int32_t>(static_cast<uint32_t>(word0)),
+				.Bits = static_cast<uint32_t>(word0 >> 32),
+				.Type = static_cast<uint8_t>(word1),
+				.Group = static_cast<uint8_t>(word1 >> 8),
+				.Flags = static_cast<uint8_t>(word1 >> 16)
+			}
+		);
+	}
+
+	return events.size();
+}
+
+
+size_t NetMessageTrace::format(const NetTraceEvent& event, char* buffer, size_t size) noexcept
+{
+	const char* name = type_name(event.type(), event.is_client_to_server());
+
+	const int length = std::snprintf(
+		buffer,
+		size,
+		"tick %i %s (%s) %u bits%s",
+		event.Tick,
+		*name ? name : "unknown",
+		group_name(event.group()),
+		event.Bits,
+		event.is_reliable() ? " reliable" : ""
+	);
+
+	if (length < 0 || !size)
+		return 0;
+	return std::min(static_cast<size_t>(length), size - 1);
+}
+
+
+std::string NetMessageTrace::format(std::span<const NetTraceEvent> events)
+{
+	std::string output;
+	output.reserve(events.size() * 64);
+
+	char line[128];
+	for (auto& event : events)
+	{
+		output.append(line, format(event, line, sizeof(line)));
+		output.push_back('\n');
+	}
+	return output;
+}
+
+
+const char* NetMessageTrace::type_name(Const::NetMsgType type, bool client_to_server) noexcept
+{
+	const size_t id = static_cast<size_t>(type);
+	if (id < std::size(net_trace_impl::net_names))
+		return net_trace_impl::net_names[id];
+
+	if (client_to_server)
+	{
+		const size_t offset = id - static_cast<size_t>(Const::NetMsgType::clc_ClientInfo);
+		return offset < std::size(net_trace_impl::clc_names) ? net_trace_impl::clc_names[offset] : "";
+	}
+
+	const size_t offset = id - static_cast<size_t>(Const::NetMsgType::svc_Print);
+	return offset < std::size(net_trace_impl::svc_names) ? net_trace_impl::svc_names[offset] : "";
+}
+
+
+const char* NetMessageTrace::group_name(Const::NetMsgGroup group) noexcept
+{
+	const size_t id = static_cast<size_t>(group);
+	return id < std::size(net_trace_impl::group_names) ? net_trace_impl::group_names[id] : "";
+}
+
+
+size_t NetMessageTrace::dump(NetMessageDecoder& decoder, utils::bf_read& buffer, std::string& output)
+{
+	size_t count = 0;
+	decoder.decode_all(
+		buffer,
+		[&](NetMessageHandle& message)
+		{
+			output.append(message->ToString());
+			output.push_back('\n');
+			count++;
+		}
+	);
+	return count;
+}
+
+TF2_NAMESPACE_END();
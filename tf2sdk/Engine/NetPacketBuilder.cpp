@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <tf2/engine/NetPacketBuilder.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace net_packet_impl
+{
+	static constexpr int align_word(int bit) noexcept
+	{
+		return (bit + 31) & ~31;
+	}
+
+	static int string_bits(const char* text, const char* fallback) noexcept
+	{
+		return static_cast<int>(std::strlen(text ? text : fallback) + 1) * 8;
+	}
+
+	/// <summary>
+	/// Reads 'count' (1 to 32) bits at 'bit' without touching the word past the last one read
+	/// </summary>
+	static uint32_t peek_bits(const uint32_t* words, int bit, int count) noexcept
+	{
+		const int index = bit >> 5;
+		const int shift = bit & 31;
+
+		uint64_t value = words[index];
+		if (shift + count > 32)
+			value |= static_cast<uint64_t>(words[index + 1]) << 32;
+
+		value >>= shift;
+		return static_cast<uint32_t>(count == 32 ? value : value & ((uint64_t{ 1 } << count) - 1));
+	}
+}
+
+
+NetPacketBuilder::NetPacketBuilder(Const::NetMsgDirection direction, int mtu, std::pmr::memory_resource* resource) :
+	Words(resource),
+	Packets(resource),
+	MTU(std::max(mtu, 1)),
+	Direction(direction)
+{
+	grow(MTU * 8);
+}
+
+
+bool NetPacketBuilder::add(INetMessage& message)
+{
+	const int exact_bits = message_bits(message, Direction);
+	const int mtu_bits = MTU * 8;
+	const int batch_end = Writer.bits_written();
+
+	// When the size is known the message goes straight to the packet it belongs to
+	bool new_packet = Packets.empty() || (exact_bits >= 0 && batch_end + exact_bits - Packets.back().StartBit > mtu_bits);
+
+	int start = new_packet ? net_packet_impl::align_word(batch_end) : batch_end;
+	// Keeps enough room to move the message to a word boundary without growing again
+	const int expected_end = start + (exact_bits >= 0 ? exact_bits : Const::NetPacket_WriteSlackBits) + 32;
+	if (expected_end > Writer.max_bits())
+		grow(expected_end);
+
+	Writer.seek(start);
+
+	bool written;
+	for (;;)
+	{
+		written = message.WriteToBuffer(Writer);
+		if (!Writer.has_overflown())
+			break;
+
+		// Larger than any message the engine sends, or a message that never stops writing
+		if (Writer.max_bits() - start >= Const::NetPacket_MaxMessageBits)
+		{
+			written = false;
+			break;
+		}
+
+		grow(Writer.max_bits() * 2);
+		Writer.seek(start);
+	}
+
+	if (!written || Writer.bits_written() - start > Const::NetPacket_MaxMessageBits)
+	{
+		Writer.reset();
+		Writer.seek(batch_end);
+		return false;
+	}
+
+	int end = Writer.bits_written();
+	assert(exact_bits < 0 || end - start == exact_bits);
+
+	// The size wasn't known: the message crossed the MTU, move it to the start of a new packet
+	if (!new_packet && end - Packets.back().StartBit > mtu_bits)
+	{
+		const int to = net_packet_impl::align_word(start);
+		if (end + (to - start) > Writer.max_bits())
+			grow(end + (to - start));
+
+		move_bits(start, to, end - start);
+		end += to - start;
+		start = to;
+		new_packet = true;
+
+		Writer.seek(end);
+	}
+
+	if (new_packet)
+	{
+		Packets.push_back(
+			NetPacketRange{
+				.StartBit = start,
+				.FirstMessage = static_cast<uint32_t>(MessageCount)
+			}
+		);
+	}
+
+	auto& packet = Packets.back();
+	packet.Bits = end - packet.StartBit;
+	packet.NumMessages++;
+
+	MessageCount++;
+	return true;
+}
+
+
+void NetPacketBuilder::clear() noexcept
+{
+	Packets.clear();
+	Writer.reset();
+	MessageCount = 0;
+}
+
+
+void NetPacketBuilder::reserve(int bits)
+{
+	const int cursor = Writer.bits_written();
+	if (cursor + bits > Writer.max_bits())
+	{
+		grow(cursor + bits);
+		Writer.seek(cursor);
+	}
+}
+
+
+int NetPacketBuilder::message_bits(const INetMessage& message, Const::NetMsgDirection direction) noexcept
+{
+	constexpr int header = Const::NetMsgType_Bits;
+
+	switch (message.GetType())
+	{
+	case Const::NetMsgType::net_Tick:
+		return header + 32 + 16 + 16;
+
+	case Const::NetMsgType::net_StringCmd:
+		return header + net_packet_impl::string_bits(static_cast<const NET_StringCmd&>(message).Command, " NET_StringCmd NULL");
+
+	case Const::NetMsgType::net_SignonState:
+		return header + 8 + 32;
+
+	default:
+		break;
+	}
+
+	if (direction == Const::NetMsgDirection::ClientToServer)
+	{
+		switch (message.GetType())
+		{
+		case Const::NetMsgType::clc_Move:
+			return header + Const::NetMsg_NewCommandBits + Const::NetMsg_BackupCommandBits + 16 +
+				static_cast<const CLC_Move&>(message).DataOut.bits_written();
+
+		case Const::NetMsgType::clc_VoiceData:
+			return header + 16 + static_cast<const CLC_VoiceData&>(message).DataOut.bits_written();
+
+		case Const::NetMsgType::clc_BaselineAck:
+			return header + 32 + 1;
+
+		default:
+			return -1;
+		}
+	}
+
+	switch (message.GetType())
+	{
+	case Const::NetMsgType::svc_Print:
+		return header + net_packet_impl::string_bits(static_cast<const SVC_Print&>(message).Text, " svc_print NULL");
+
+	case Const::NetMsgType::svc_SetPause:
+		return header + 1;
+
+	case Const::NetMsgType::svc_SetPauseTimed:
+		return header + 1 + 32;
+
+	case Const::NetMsgType::svc_SetView:
+		return header + Const::MaxEdicts_Bits;
+
+	case Const::NetMsgType::svc_FixAngle:
+		return header + 1 + 16 * 3;
+
+	case Const::NetMsgType::svc_CrosshairAngle:
+		return header + 16 * 3;
+
+	case Const::NetMsgType::svc_Prefetch:
+		return header + Const::NetMsg_SoundIndexBits;
+
+	case Const::NetMsgType::svc_VoiceData:
+		return header + 8 + 8 + 16 + static_cast<const SVC_VoiceData&>(message).Length;
+
+	case Const::NetMsgType::svc_GameEvent:
+		return header + Const::NetMsg_LengthBits + static_cast<const SVC_GameEvent&>(message).DataOut.bits_written();
+
+	case Const::NetMsgType::svc_UserMessage:
+		return header + 8 + Const::NetMsg_LengthBits + static_cast<const SVC_UserMessage&>(message).DataOut.bits_written();
+
+	case Const::NetMsgType::svc_EntityMessage:
+		return header + Const::MaxEdicts_Bits + Const::MaxServerClasses_Bits + Const::NetMsg_LengthBits +
+			static_cast<const SVC_EntityMessage&>(message).DataOut.bits_written();
+
+	case Const::NetMsgType::svc_PacketEntities:
+	{
+		const auto& entities = static_cast<const SVC_PacketEntities&>(message);
+		return header + Const::MaxEdicts_Bits + 1 + (entities.IsDelta ? 32 : 0) + 1 + Const::MaxEdicts_Bits +
+			Const::NetMsg_DeltaSizeBits + 1 + entities.DataOut.bits_written();
+	}
+
+	case Const::NetMsgType::svc_GameEventList:
+		return header + Const::NetMsg_GameEventsBits + Const::NetMsg_DeltaSizeBits +
+			static_cast<const SVC_GameEventList&>(message).DataOut.bits_written();
+
+	default:
+		return -1;
+	}
+}
+
+
+void NetPacketBuilder::grow(int bits)
+{
+	const size_t words = std::max(static_cast<size_t>(net_packet_impl::align_word(bits) / 32), Words.size() * 2);
+	Words.resize(words);
+
+	Writer.start_writing(Words.data(), static_cast<int>(Words.size() * sizeof(uint32_t)));
+}
+
+
+void NetPacketBuilder::move_bits(int from, int to, int bits) noexcept
+{
+	// The destination is past the source and overlaps it, copy the last chunk first
+	for (int offset = (bits - 1) & ~31; offset >= 0; offset -= 32)
+	{
+		const int count = std::min(bits - offset, 32);
+		const uint32_t value = net_packet_impl::peek_bits(Words.data(), from + offset, count);
+
+		Writer.seek(to + offset);
+		Writer.write_ubit(value, count);
+	}
+}
+
+TF2_NAMESPACE_END();
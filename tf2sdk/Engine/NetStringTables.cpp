@@ -0,0 +1,344 @@
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include <tf2/engine/NetStringTables.hpp>
+#include <tf2/utils/Lzss.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+NetStringTable::NetStringTable(
+	std::string_view name,
+	int max_entries,
+	bool user_data_fixed_size,
+	int user_data_size,
+	int user_data_size_bits
+) :
+	Name(name),
+	MaxEntries(std::max(max_entries, 1)),
+	EntryBits(std::max(static_cast<int>(std::bit_width(static_cast<uint32_t>(MaxEntries))) - 1, 1)),
+	UserDataFixedSize(user_data_fixed_size),
+	UserDataSize(user_data_fixed_size ? user_data_size : 0),
+	UserDataSizeBits(user_data_fixed_size ? user_data_size_bits : 0),
+	Buckets(16, -1)
+{
+}
+
+
+Const::StringTableStatus NetStringTable::apply(utils::bf_read& buffer, int num_entries)
+{
+	NetStringTableHistory history;
+	char entry_buffer[Const::StringTable_MaxEntryLength];
+
+	int last_entry = -1;
+	for (int i = 0; i < num_entries; i++)
+	{
+		const int entry_index = buffer.read_bit() ? last_entry + 1 : static_cast<int>(buffer.read_ubit(EntryBits));
+		if (entry_index < 0 || entry_index >= MaxEntries)
+			return Const::StringTableStatus::BadIndex;
+
+		std::string_view str;
+		if (buffer.read_bit())
+		{
+			size_t prefix_length = 0;
+			if (buffer.read_bit())
+			{
+				const size_t history_index = buffer.read_ubit(Const::StringTable_SubstringBits);
+				const size_t bytes_to_copy = buffer.read_ubit(Const::StringTable_SubstringBits);
+				if (history_index >= history.size())
+					return Const::StringTableStatus::BadHistory;
+
+				const auto prefix = history.get(history_index);
+				prefix_length = std::min(prefix.size(), bytes_to_copy);
+				std::copy_n(prefix.data(), prefix_length, entry_buffer);
+			}
+
+			// Longer entries are truncated, the rest of the string is still consumed
+			buffer.read_string(entry_buffer + prefix_length, static_cast<int>(sizeof(entry_buffer) - prefix_length));
+			str = { entry_buffer, prefix_length + std::strlen(entry_buffer + prefix_length) };
+		}
+
+		std::span<const uint8_t> user_data;
+		if (buffer.read_bit())
+		{
+			int num_bits, num_bytes;
+			if (UserDataFixedSize)
+			{
+				num_bits = UserDataSizeBits;
+				num_bytes = UserDataSize;
+			}
+			else
+			{
+				num_bytes = static_cast<int>(buffer.read_ubit(Const::StringTable_MaxUserDataBits));
+				num_bits = num_bytes << 3;
+			}
+
+			// Fixed size user data may not fill its last byte
+			Scratch.assign(std::max(num_bytes, (num_bits + 7) >> 3), 0);
+			buffer.read_bits(Scratch.data(), num_bits);
+			user_data = { Scratch.data(), static_cast<size_t>(num_bytes) };
+		}
+
+		if (buffer.has_overflown())
+			return Const::StringTableStatus::Overflow;
+
+		int index = entry_index;
+		if (entry_index < size())
+			set_user_data(entry_index, user_data);
+		else
+		{
+			// An entry past the end is appended, or updated if its string is already in the table
+			if (size() >= MaxEntries && find(str) == -1)
+				return Const::StringTableStatus::BadIndex;
+			index = add(str, user_data);
+		}
+
+		history.push(string(index));
+		last_entry = entry_index;
+	}
+
+	return Const::StringTableStatus::Ok;
+}
+
+
+int NetStringTable::add(std::string_view str, std::span<const uint8_t> user_data)
+{
+	int index = find(str);
+	if (index != -1)
+	{
+		set_user_data(index, user_data);
+		return index;
+	}
+
+	// 'str' might be a part of an entry, 'append' may move the arena
+	const uint32_t hash = hash_string(str);
+	const uint32_t string_offset = append(str.data(), str.size());
+	Arena.push_back('\0');
+	const uint32_t data_offset = append(user_data.data(), user_data.size());
+
+	index = size();
+	Entries.push_back(entry_type{
+		.StringOffset = string_offset,
+		.StringLength = static_cast<uint32_t>(str.size()),
+		.DataOffset = data_offset,
+		.DataLength = static_cast<uint32_t>(user_data.size()),
+		.Hash = hash
+	});
+
+	if (Entries.size() * 2 > Buckets.size())
+		rehash(Buckets.size() * 2);
+	else
+		insert_hash(index);
+
+	return index;
+}
+
+
+void NetStringTable::set_user_data(int index, std::span<const uint8_t> user_data)
+{
+	auto& entry = Entries[index];
+	if (user_data.size() <= entry.DataLength)
+	{
+		if (!user_data.empty())
+			std::memmove(Arena.data() + entry.DataOffset, user_data.data(), user_data.size());
+		Garbage += entry.DataLength - user_data.size();
+	}
+	else
+	{
+		Garbage += entry.DataLength;
+		entry.DataOffset = append(user_data.data(), user_data.size());
+	}
+	entry.DataLength = static_cast<uint32_t>(user_data.size());
+
+	if (Garbage > 4096 && Garbage * 2 > Arena.size())
+		compact();
+}
+
+
+int NetStringTable::find(std::string_view str) const noexcept
+{
+	const uint32_t hash = hash_string(str);
+	const size_t mask = Buckets.size() - 1;
+	for (size_t i = hash & mask; ; i = (i + 1) & mask)
+	{
+		const int index = Buckets[i];
+		if (index == -1)
+			return -1;
+
+		auto& entry = Entries[index];
+		if (entry.Hash == hash && string(index) == str)
+			return index;
+	}
+}
+
+
+void NetStringTable::clear() noexcept
+{
+	Entries.clear();
+	Arena.clear();
+	Garbage = 0;
+	std::fill(Buckets.begin(), Buckets.end(), -1);
+}
+
+
+uint32_t NetStringTable::hash_string(std::string_view str) noexcept
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for (char c : str)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+
+uint32_t NetStringTable::append(const void* data, size_t size)
+{
+	const size_t offset = Arena.size();
+	if (!size)
+		return static_cast<uint32_t>(offset);
+
+	// The source may live in the arena itself
+	const char* src = static_cast<const char*>(data);
+	const bool is_inner = src >= Arena.data() && src < Arena.data() + Arena.size();
+	const size_t src_offset = is_inner ? static_cast<size_t>(src - Arena.data()) : 0;
+
+	Arena.resize(offset + size);
+	std::memcpy(Arena.data() + offset, is_inner ? Arena.data() + src_offset : src, size);
+	return static_cast<uint32_t>(offset);
+}
+
+
+void NetStringTable::insert_hash(int index)
+{
+	const size_t mask = Buckets.size() - 1;
+	size_t i = Entries[index].Hash & mask;
+	while (Buckets[i] != -1)
+		i = (i + 1) & mask;
+	Buckets[i] = index;
+}
+
+
+void NetStringTable::rehash(size_t num_buckets)
+{
+	Buckets.assign(num_buckets, -1);
+	for (int i = 0; i < size(); i++)
+		insert_hash(i);
+}
+
+
+void NetStringTable::compact()
+{
+	std::vector<char> arena;
+	arena.reserve(Arena.size() - Garbage);
+
+	for (auto& entry : Entries)
+	{
+		const size_t string_offset = arena.size();
+		arena.insert(arena.end(), Arena.data() + entry.StringOffset, Arena.data() + entry.StringOffset + entry.StringLength + 1);
+
+		const size_t data_offset = arena.size();
+		arena.insert(arena.end(), Arena.data() + entry.DataOffset, Arena.data() + entry.DataOffset + entry.DataLength);
+
+		entry.StringOffset = static_cast<uint32_t>(string_offset);
+		entry.DataOffset = static_cast<uint32_t>(data_offset);
+	}
+
+	Arena = std::move(arena);
+	Garbage = 0;
+}
+
+
+NetStringTable* NetStringTableSet::create(
+	std::string_view name,
+	int max_entries,
+	bool user_data_fixed_size,
+	int user_data_size,
+	int user_data_size_bits
+)
+{
+	return Tables.emplace_back(
+		std::make_unique<NetStringTable>(name, max_entries, user_data_fixed_size, user_data_size, user_data_size_bits)
+	).get();
+}
+
+
+Const::StringTableStatus NetStringTableSet::create(const SVC_CreateStringTable& message)
+{
+	auto table = create(
+		message.TableName ? message.TableName : "",
+		message.MaxEntries,
+		message.UserDataFixedSize,
+		message.UserDataSize,
+		message.UserDataSizeBits
+	);
+
+	const int start = message.DataIn.bits_written();
+	if (message.Length < 0 || start + message.Length > message.DataIn.max_bits())
+		return Const::StringTableStatus::Overflow;
+
+	utils::bf_read data(message.DataIn.data(), message.DataIn.remaining_bytes(), start + message.Length);
+	data.seek(start);
+
+	if (!message.DataCompressed)
+		return table->apply(data, message.NumEntries);
+
+	const uint32_t uncompressed_size = static_cast<uint32_t>(data.read_long());
+	const uint32_t compressed_size = static_cast<uint32_t>(data.read_long());
+	if (data.has_overflown() || !compressed_size || compressed_size > static_cast<uint32_t>(data.bytes_left()) ||
+		uncompressed_size >= std::numeric_limits<uint32_t>::max() / 2)
+		return Const::StringTableStatus::BadCompression;
+
+	Scratch.resize(compressed_size);
+	data.read_bytes(Scratch.data(), static_cast<int>(compressed_size));
+
+	if (!utils::LZSS_IsCompressed(Scratch.data(), Scratch.size()))
+	{
+		// Not compressed after all, the engine takes the payload as is
+		utils::bf_read payload(Scratch.data(), static_cast<int>(Scratch.size()));
+		return table->apply(payload, message.NumEntries);
+	}
+
+	const uint32_t actual_size = utils::LZSS_GetActualSize(Scratch.data(), Scratch.size());
+	if (actual_size > uncompressed_size || actual_size > static_cast<uint32_t>(std::numeric_limits<int>::max() >> 3))
+		return Const::StringTableStatus::BadCompression;
+
+	Decompressed.resize(actual_size);
+	if (utils::LZSS_Decompress(Scratch.data(), Scratch.size(), Decompressed.data(), Decompressed.size()) != actual_size)
+		return Const::StringTableStatus::BadCompression;
+
+	utils::bf_read payload(Decompressed.data(), static_cast<int>(Decompressed.size()));
+	return table->apply(payload, message.NumEntries);
+}
+
+
+Const::StringTableStatus NetStringTableSet::update(const SVC_UpdateStringTable& message)
+{
+	auto table = this->table(message.TableID);
+	if (!table)
+		return Const::StringTableStatus::UnknownTable;
+
+	const int start = message.DataIn.bits_written();
+	if (message.Length < 0 || start + message.Length > message.DataIn.max_bits())
+		return Const::StringTableStatus::Overflow;
+
+	utils::bf_read data(message.DataIn.data(), message.DataIn.remaining_bytes(), start + message.Length);
+	data.seek(start);
+
+	return table->apply(data, message.ChangedEntries);
+}
+
+
+NetStringTable* NetStringTableSet::find_table(std::string_view name) noexcept
+{
+	for (auto& table : Tables)
+	{
+		if (table->name() == name)
+			return table.get();
+	}
+	return nullptr;
+}
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,202 @@
+#include <algorithm>
+
+#include <tf2/engine/UserMessages.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+namespace user_message_impl
+{
+	static void read_string(utils::bf_read& buffer, std::string& str)
+	{
+		char tmp[Const::UserMsg_MaxStringLength];
+		buffer.read_string(tmp, sizeof(tmp));
+		str.assign(tmp);
+	}
+
+	static void read_color(utils::bf_read& buffer, uint8_t (&color)[4])
+	{
+		for (auto& c : color)
+			c = buffer.read_byte();
+	}
+}
+
+
+bool UserMsg_SayText::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Client = buffer.read_byte();
+	user_message_impl::read_string(buffer, Text);
+	WantsToChat = buffer.read_byte() != 0;
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_SayText2::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Client = buffer.read_byte();
+	WantsToChat = buffer.read_byte() != 0;
+	user_message_impl::read_string(buffer, Message);
+	for (auto& param : Params)
+		user_message_impl::read_string(buffer, param);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_TextMsg::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Destination = buffer.read_byte();
+	user_message_impl::read_string(buffer, Message);
+	for (auto& param : Params)
+		user_message_impl::read_string(buffer, param);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_HudText::ReadFromBuffer(utils::bf_read& buffer)
+{
+	user_message_impl::read_string(buffer, Text);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_HintText::ReadFromBuffer(utils::bf_read& buffer)
+{
+	user_message_impl::read_string(buffer, Text);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_HudMsg::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Channel = buffer.read_byte();
+	X = buffer.read_float();
+	Y = buffer.read_float();
+	user_message_impl::read_color(buffer, Color1);
+	user_message_impl::read_color(buffer, Color2);
+	Effect = buffer.read_byte();
+	FadeIn = buffer.read_float();
+	FadeOut = buffer.read_float();
+	HoldTime = buffer.read_float();
+	FxTime = buffer.read_float();
+	user_message_impl::read_string(buffer, Text);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_Shake::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Command = buffer.read_byte();
+	Amplitude = buffer.read_float();
+	Frequency = buffer.read_float();
+	Duration = buffer.read_float();
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_Fade::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Duration = buffer.read_word();
+	HoldTime = buffer.read_word();
+	Flags = buffer.read_word();
+	user_message_impl::read_color(buffer, Color);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_VoteStart::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Team = buffer.read_char();
+	VoteIndex = buffer.read_long();
+	Caller = buffer.read_byte();
+	user_message_impl::read_string(buffer, Issue);
+	user_message_impl::read_string(buffer, Details);
+	IsYesNo = buffer.read_bit() != 0;
+	Target = buffer.read_byte();
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_VotePass::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Team = buffer.read_char();
+	VoteIndex = buffer.read_long();
+	user_message_impl::read_string(buffer, Issue);
+	user_message_impl::read_string(buffer, Details);
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_VoteFailed::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Team = buffer.read_char();
+	VoteIndex = buffer.read_long();
+	Reason = buffer.read_byte();
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_CallVoteFailed::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Reason = buffer.read_byte();
+	Time = buffer.read_short();
+	return !buffer.has_overflown();
+}
+
+bool UserMsg_PlayerStatsUpdate::ReadFromBuffer(utils::bf_read& buffer)
+{
+	Class = buffer.read_byte();
+	MsgType = buffer.read_byte();
+	SentStats = static_cast<uint32_t>(buffer.read_long());
+
+	for (size_t i = 0; i < Const::UserMsg_MaxPlayerStats; i++)
+		Stats[i] = (SentStats >> i) & 1 ? buffer.read_long() : 0;
+	return !buffer.has_overflown();
+}
+
+
+UserMessageRegistry::UserMessageRegistry()
+{
+	register_message<UserMsg_SayText>();
+	register_message<UserMsg_SayText2>();
+	register_message<UserMsg_TextMsg>();
+	register_message<UserMsg_HudText>();
+	register_message<UserMsg_HintText>();
+	register_message<UserMsg_HudMsg>();
+	register_message<UserMsg_Shake>();
+	register_message<UserMsg_Fade>();
+	register_message<UserMsg_VoteStart>();
+	register_message<UserMsg_VotePass>();
+	register_message<UserMsg_VoteFailed>();
+	register_message<UserMsg_CallVoteFailed>();
+	register_message<UserMsg_PlayerStatsUpdate>();
+}
+
+
+IUserMessage* UserMessageRegistry::decode(Const::UserMsg type, utils::bf_read& payload)
+{
+	if (!is_registered(type))
+		return nullptr;
+
+	auto& message = Messages[static_cast<size_t>(type)];
+	Generations[static_cast<size_t>(type)]++;
+	return message->ReadFromBuffer(payload) ? message.get() : nullptr;
+}
+
+
+utils::bf_read UserMessageView::payload() const
+{
+	const int start = Message->DataIn.bits_written();
+	const int end = std::min(start + Message->Length, Message->DataIn.max_bits());
+
+	utils::bf_read payload(Message->DataIn.data(), Message->DataIn.remaining_bytes(), end);
+	payload.seek(start);
+	return payload;
+}
+
+
+IUserMessage* UserMessageView::get()
+{
+	// Decoded again if another view overwrote the shared instance
+	if (!IsDecoded || (Decoded && Registry->generation(type()) != Generation))
+	{
+		IsDecoded = true;
+		Decoded = nullptr;
+		if (is_known())
+		{
+			auto data = payload();
+			Decoded = Registry->decode(type(), data);
+			Generation = Registry->generation(type());
+		}
+	}
+	return Decoded;
+}
+
+TF2_NAMESPACE_END();
@@ -0,0 +1,613 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include <tf2/gameprop/FlatSendTable.hpp>
+
+TF2_NAMESPACE_BEGIN();
+
+// Deepest chain of data tables accepted, guards against tables that reference themselves
+static constexpr int MaxDataTableDepth = 64;
+
+
+static bool MakePropCodec(const SendPropInfo& prop, FlatPropCodec& codec)
+{
+	using namespace Const;
+
+	if (prop.Bits < 0 || prop.Bits > 32)
+		return false;
+
+	codec.Bits = static_cast<uint8_t>(prop.Bits);
+	codec.LowValue = prop.LowValue;
+	codec.HighValue = prop.HighValue;
+	codec.Range = static_cast<float>((uint64_t(1) << prop.Bits) - 1);
+
+	if (prop.Flags & PropFlags::Coord)
+		codec.FloatKind = FlatFloatKind::Coord;
+	else if (prop.Flags & PropFlags::CoordMP_INT)
+		codec.FloatKind = FlatFloatKind::CoordMP_INT;
+	else if (prop.Flags & PropFlags::CoordMP_LP)
+		codec.FloatKind = FlatFloatKind::CoordMP_LP;
+	else if (prop.Flags & PropFlags::CoordMP)
+		codec.FloatKind = FlatFloatKind::CoordMP;
+	else if (prop.Flags & PropFlags::NoScale)
+		codec.FloatKind = FlatFloatKind::NoScale;
+	else if (prop.Flags & PropFlags::Normal)
+		codec.FloatKind = FlatFloatKind::Normal;
+	else
+		codec.FloatKind = FlatFloatKind::Scaled;
+
+	switch (prop.Type)
+	{
+	case PropType::Int:
+	{
+		const bool is_unsigned = prop.Flags & PropFlags::Unsigned;
+		if (prop.Flags & PropFlags::VarInt)
+			codec.Kind = is_unsigned ? FlatPropKind::UVarInt : FlatPropKind::SVarInt;
+		else
+			codec.Kind = is_unsigned ? FlatPropKind::UInt : FlatPropKind::SInt;
+		return true;
+	}
+	case PropType::Float:
+		codec.Kind = FlatPropKind::Float;
+		return true;
+	case PropType::Vector:
+		codec.Kind = (prop.Flags & PropFlags::Normal) ? FlatPropKind::VectorNormal : FlatPropKind::Vector;
+		return true;
+	case PropType::VectorXY:
+		codec.Kind = FlatPropKind::VectorXY;
+		return true;
+	case PropType::String:
+		codec.Kind = FlatPropKind::String;
+		return true;
+	case PropType::Array:
+		codec.Kind = FlatPropKind::Array;
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// Builds the flat prop list of a class the same way the engine does:
+// collapsible data tables are merged into their parent's props, the others are appended before them
+//-----------------------------------------------------------------------------
+class SendTableFlattener
+{
+public:
+	using entry_type = std::pair<const SendTableInfo*, const SendPropInfo*>;
+
+	SendTableFlattener(const FlatSendTableSet& set) noexcept : Set(set) { }
+
+	bool run(const SendTableInfo* table)
+	{
+		Excludes.clear();
+		Props.clear();
+		if (!gather_excludes(table, 0) || !flatten(table, 0))
+			return false;
+
+		// Props that change often are moved to the front so they get the smallest indices
+		size_t start = 0;
+		for (size_t i = 0; i < Props.size(); i++)
+		{
+			if (Props[i].second->Flags & Const::PropFlags::ChagesOften)
+			{
+				if (i != start)
+					std::swap(Props[i], Props[start]);
+				start++;
+			}
+		}
+
+		return Props.size() <= Const::SendTable_MaxProps;
+	}
+
+	[[nodiscard]] const std::vector<entry_type>& props() const noexcept { return Props; }
+
+private:
+	bool gather_excludes(const SendTableInfo* table, int depth)
+	{
+		if (depth > MaxDataTableDepth)
+			return false;
+
+		for (auto& prop : table->Props)
+		{
+			if (prop.Flags & Const::PropFlags::Exclude)
+				Excludes.push_back(&prop);
+			else if (prop.Type == Const::PropType::DataTable)
+			{
+				const SendTableInfo* child = Set.find_table(prop.DataTableName);
+				if (!child || !gather_excludes(child, depth + 1))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] bool is_excluded(const SendTableInfo* table, const SendPropInfo& prop) const noexcept
+	{
+		for (auto exclude : Excludes)
+		{
+			if (exclude->DataTableName == table->Name && exclude->Name == prop.Name)
+				return true;
+		}
+		return false;
+	}
+
+	bool flatten(const SendTableInfo* table, int depth)
+	{
+		std::vector<entry_type> pending;
+		if (!iterate_props(table, pending, depth))
+			return false;
+
+		Props.insert(Props.end(), pending.begin(), pending.end());
+		return true;
+	}
+
+	bool iterate_props(const SendTableInfo* table, std::vector<entry_type>& pending, int depth)
+	{
+		if (depth > MaxDataTableDepth)
+			return false;
+
+		for (auto& prop : table->Props)
+		{
+			if ((prop.Flags & (Const::PropFlags::Exclude | Const::PropFlags::InsideArray)) || is_excluded(table, prop))
+				continue;
+
+			if (prop.Type == Const::PropType::DataTable)
+			{
+				const SendTableInfo* child = Set.find_table(prop.DataTableName);
+				if (!child)
+					return false;
+
+				const bool valid = (prop.Flags & Const::PropFlags::Collapsible) ?
+					iterate_props(child, pending, depth + 1) :
+					flatten(child, depth + 1);
+				if (!valid)
+					return false;
+			}
+			else
+				pending.emplace_back(table, &prop);
+		}
+		return true;
+	}
+
+private:
+	const FlatSendTableSet&				Set;
+	std::vector<const SendPropInfo*>	Excludes;
+	std::vector<entry_type>				Props;
+};
+
+
+bool FlatSendTableSet::read_datatables(utils::bf_read& buffer)
+{
+	while (buffer.read_bit())
+	{
+		const bool needs_decoder = buffer.read_bit();
+		if (!read_send_table(buffer, needs_decoder))
+			return false;
+	}
+
+	const int num_classes = buffer.read_short();
+	if (buffer.has_overflown() || num_classes < 0)
+		return false;
+
+	char name[256], table_name[256];
+	for (int i = 0; i < num_classes; i++)
+	{
+		const int class_id = buffer.read_short();
+		if (!buffer.read_string(name, sizeof(name)) || !buffer.read_string(table_name, sizeof(table_name)) ||
+			class_id < 0 || class_id >= num_classes)
+			return false;
+
+		add_class(class_id, name, table_name);
+	}
+
+	return !buffer.has_overflown();
+}
+
+
+bool FlatSendTableSet::read_send_table(utils::bf_read& buffer, bool needs_decoder)
+{
+	char name[256];
+	if (!buffer.read_string(name, sizeof(name)))
+		return false;
+
+	const uint32_t num_props = buffer.read_ubit(Const::SendTable_NumPropsBits);
+	if (buffer.has_overflown())
+		return false;
+
+	SendTableInfo* table = add_table(name);
+	table->NeedsDecoder = needs_decoder;
+	table->Props.resize(num_props);
+
+	for (uint32_t i = 0; i < num_props; i++)
+	{
+		SendPropInfo& prop = table->Props[i];
+		prop.Type = static_cast<Const::PropType>(buffer.read_ubit(Const::SendTable_PropTypeBits));
+		if (!buffer.read_string(name, sizeof(name)))
+			return false;
+
+		prop.Name = name;
+		prop.Flags = buffer.read_ubit(Const::SendTable_PropFlagsBits);
+
+		if (prop.Type == Const::PropType::DataTable || (prop.Flags & Const::PropFlags::Exclude))
+		{
+			if (!buffer.read_string(name, sizeof(name)))
+				return false;
+			prop.DataTableName = name;
+		}
+		else if (prop.Type == Const::PropType::Array)
+		{
+			// The element is sent right before its array
+			prop.NumElements = buffer.read_ubit(Const::SendTable_NumElementsBits);
+			prop.ArrayElement = static_cast<int>(i) - 1;
+		}
+		else
+		{
+			prop.LowValue = buffer.read_float();
+			prop.HighValue = buffer.read_float();
+			prop.Bits = buffer.read_ubit(Const::SendTable_NumBitsBits);
+		}
+	}
+
+	return !buffer.has_overflown();
+}
+
+
+void FlatSendTableSet::add_server_classes(const ServerClass* classes)
+{
+	for (const ServerClass* server_class = classes; server_class; server_class = server_class->NextClass)
+	{
+		if (!server_class->SendTable)
+			continue;
+
+		copy_send_table(server_class->SendTable);
+		add_class(static_cast<int>(server_class->ClassID), server_class->NetworkName, server_class->SendTable->Name);
+	}
+}
+
+
+void FlatSendTableSet::add_class(int class_id, std::string_view name, std::string_view table_name)
+{
+	Flat.clear();
+
+	auto iter = std::find_if(Classes.begin(), Classes.end(), [class_id](const ServerClassInfo& info) { return info.ClassID == class_id; });
+	if (iter == Classes.end())
+		iter = Classes.emplace(Classes.end());
+
+	iter->ClassID = class_id;
+	iter->Name = name;
+	iter->TableName = table_name;
+}
+
+
+bool FlatSendTableSet::flatten()
+{
+	Flat.clear();
+
+	SendTableFlattener flattener(*this);
+	bool valid = true;
+	for (auto& server_class : Classes)
+	{
+		if (server_class.ClassID < 0)
+			continue;
+		if (static_cast<size_t>(server_class.ClassID) >= Flat.size())
+			Flat.resize(static_cast<size_t>(server_class.ClassID) + 1);
+
+		const SendTableInfo* table = find_table(server_class.TableName);
+		if (!table || !flattener.run(table))
+		{
+			valid = false;
+			continue;
+		}
+
+		FlatSendTable flat;
+		flat.Props.reserve(flattener.props().size());
+
+		bool props_valid = true;
+		for (auto [owner, prop] : flattener.props())
+		{
+			FlatSendProp& flat_prop = flat.Props.emplace_back();
+			flat_prop.Prop = prop;
+			flat_prop.Table = owner;
+
+			props_valid = MakePropCodec(*prop, flat_prop.Codec);
+			switch (flat_prop.Codec.Kind)
+			{
+			case Const::FlatPropKind::String:
+				flat_prop.Slot = flat.NumStrings++;
+				break;
+
+			case Const::FlatPropKind::Array:
+			{
+				const int element = prop->ArrayElement;
+				props_valid = props_valid &&
+					element >= 0 && static_cast<size_t>(element) < owner->Props.size() &&
+					MakePropCodec(owner->Props[element], flat_prop.Element) &&
+					flat_prop.Element.Kind != Const::FlatPropKind::Array;
+
+				flat_prop.CountBits = static_cast<uint8_t>(std::bit_width(static_cast<uint32_t>(prop->NumElements)));
+				flat_prop.MaxElements = static_cast<uint16_t>(prop->NumElements);
+				flat_prop.Slot = flat.NumArrays++;
+				break;
+			}
+
+			default:
+				break;
+			}
+
+			if (!props_valid)
+				break;
+		}
+
+		if (!props_valid)
+		{
+			valid = false;
+			continue;
+		}
+
+		flat.Class = server_class;
+		Flat[server_class.ClassID] = std::move(flat);
+	}
+
+	return valid;
+}
+
+
+void FlatSendTableSet::clear() noexcept
+{
+	Flat.clear();
+	Classes.clear();
+	TableIndex.clear();
+	Tables.clear();
+}
+
+
+const SendTableInfo* FlatSendTableSet::find_table(std::string_view name) const noexcept
+{
+	auto iter = TableIndex.find(name);
+	return iter != TableIndex.end() ? iter->second : nullptr;
+}
+
+
+SendTableInfo* FlatSendTableSet::add_table(std::string_view name)
+{
+	Flat.clear();
+
+	// A table sent twice replaces the old one, its storage is reused so the index stays valid
+	if (auto iter = TableIndex.find(name); iter != TableIndex.end())
+	{
+		auto table = const_cast<SendTableInfo*>(iter->second);
+		table->NeedsDecoder = false;
+		table->Props.clear();
+		return table;
+	}
+
+	auto& table = Tables.emplace_back(std::make_unique<SendTableInfo>());
+	table->Name = name;
+	TableIndex.emplace(table->Name, table.get());
+	return table.get();
+}
+
+
+const SendTableInfo* FlatSendTableSet::copy_send_table(const SendTable* table)
+{
+	if (auto found = find_table(table->Name))
+		return found;
+
+	// Registered before its children are copied so tables referencing each other terminate
+	SendTableInfo* info = add_table(table->Name);
+	info->NeedsDecoder = true;
+	info->Props.resize(table->NumProps);
+
+	for (int i = 0; i < table->NumProps; i++)
+	{
+		const SendProp& prop = table->Props[i];
+		SendPropInfo& prop_info = info->Props[i];
+
+		prop_info.Name = prop.Name ? prop.Name : "";
+		prop_info.Type = prop.Type;
+		prop_info.Flags = static_cast<uint32_t>(prop.Flags);
+		prop_info.Bits = prop.Bits;
+		prop_info.NumElements = prop.NumElements;
+		prop_info.LowValue = prop.LowValue;
+		prop_info.HighValue = prop.HighValue;
+
+		if (prop.Type == Const::PropType::DataTable)
+		{
+			if (prop.DataTable)
+			{
+				prop_info.DataTableName = prop.DataTable->Name;
+				copy_send_table(prop.DataTable);
+			}
+		}
+		else if (prop.Flags & Const::PropFlags::Exclude)
+			prop_info.DataTableName = prop.ExcludeName ? prop.ExcludeName : "";
+		else if (prop.Type == Const::PropType::Array)
+		{
+			const bool is_local = prop.ArrayProp >= table->Props && prop.ArrayProp < table->Props + table->NumProps;
+			prop_info.ArrayElement = is_local ? static_cast<int>(prop.ArrayProp - table->Props) : i - 1;
+		}
+	}
+
+	return info;
+}
+
+
+//-----------------------------------------------------------------------------
+// Delta decoding
+//-----------------------------------------------------------------------------
+template<typename _ReaderTy>
+static float ReadFlatFloat(_ReaderTy& buffer, const FlatPropCodec& codec)
+{
+	switch (codec.FloatKind)
+	{
+	case Const::FlatFloatKind::Coord:
+		return buffer.read_coord();
+	case Const::FlatFloatKind::CoordMP:
+		return buffer.read_coord_mp(false, false);
+	case Const::FlatFloatKind::CoordMP_LP:
+		return buffer.read_coord_mp(false, true);
+	case Const::FlatFloatKind::CoordMP_INT:
+		return buffer.read_coord_mp(true, false);
+	case Const::FlatFloatKind::NoScale:
+		return buffer.read_float();
+	case Const::FlatFloatKind::Normal:
+		return buffer.read_normal();
+	default:
+	{
+		const float fraction = static_cast<float>(buffer.read_ubit(codec.Bits)) / codec.Range;
+		return codec.LowValue + (codec.HighValue - codec.LowValue) * fraction;
+	}
+	}
+}
+
+
+template<typename _ReaderTy>
+static void ReadFlatValue(_ReaderTy& buffer, const FlatPropCodec& codec, FlatPropValue& value)
+{
+	switch (codec.Kind)
+	{
+	case Const::FlatPropKind::UInt:
+		value.Int = static_cast<int>(buffer.read_ubit(codec.Bits));
+		break;
+	case Const::FlatPropKind::SInt:
+		value.Int = buffer.read_sbit(codec.Bits);
+		break;
+	case Const::FlatPropKind::UVarInt:
+		value.Int = static_cast<int>(buffer.read_uint32());
+		break;
+	case Const::FlatPropKind::SVarInt:
+		value.Int = buffer.read_int32();
+		break;
+
+	case Const::FlatPropKind::Float:
+		value.Float = ReadFlatFloat(buffer, codec);
+		break;
+
+	case Const::FlatPropKind::Vector:
+		value.Vector[0] = ReadFlatFloat(buffer, codec);
+		value.Vector[1] = ReadFlatFloat(buffer, codec);
+		value.Vector[2] = ReadFlatFloat(buffer, codec);
+		break;
+
+	case Const::FlatPropKind::VectorNormal:
+	{
+		value.Vector[0] = ReadFlatFloat(buffer, codec);
+		value.Vector[1] = ReadFlatFloat(buffer, codec);
+
+		// z is rebuilt from the unit length, only its sign is sent
+		const int signbit = buffer.read_bit();
+		const float length_sqr = value.Vector[0] * value.Vector[0] + value.Vector[1] * value.Vector[1];
+		value.Vector[2] = length_sqr < 1.f ? std::sqrt(1.f - length_sqr) : 0.f;
+		if (signbit)
+			value.Vector[2] = -value.Vector[2];
+		break;
+	}
+
+	case Const::FlatPropKind::VectorXY:
+		value.Vector[0] = ReadFlatFloat(buffer, codec);
+		value.Vector[1] = ReadFlatFloat(buffer, codec);
+		break;
+
+	// Only reached for array elements
+	default:
+	{
+		value = { };
+		const int length = static_cast<int>(buffer.read_ubit(Const::SendTable_StringBits));
+		buffer.seek_relative(length << 3);
+		break;
+	}
+	}
+}
+
+
+template<typename _ReaderTy>
+static bool ReadFlatDelta(
+	std::span<const FlatSendProp> props,
+	_ReaderTy& buffer,
+	FlatEntityState& state,
+	std::vector<uint16_t>* changed
+)
+{
+	// Starts at -1, the first delta is relative to it
+	uint64_t index = ~uint64_t{ };
+	while (buffer.read_bit())
+	{
+		index += uint64_t{ 1 } + buffer.read_ubit_var();
+		if (index >= props.size() || buffer.has_overflown())
+			return false;
+
+		const FlatSendProp& prop = props[index];
+		switch (prop.Codec.Kind)
+		{
+		case Const::FlatPropKind::String:
+		{
+			auto& str = state.Strings[prop.Slot];
+			str.resize(buffer.read_ubit(Const::SendTable_StringBits));
+			buffer.read_bytes(str.data(), static_cast<int>(str.size()));
+			break;
+		}
+
+		case Const::FlatPropKind::Array:
+		{
+			const uint32_t count = buffer.read_ubit(prop.CountBits);
+			if (count > prop.MaxElements)
+				return false;
+
+			auto& values = state.Arrays[prop.Slot];
+			values.resize(count);
+			for (auto& value : values)
+				ReadFlatValue(buffer, prop.Element, value);
+			break;
+		}
+
+		default:
+			ReadFlatValue(buffer, prop.Codec, state.Values[index]);
+			break;
+		}
+
+		if (changed)
+			changed->push_back(static_cast<uint16_t>(index));
+	}
+
+	return !buffer.has_overflown();
+}
+
+
+int FlatSendTable::find_prop(std::string_view name, std::string_view table) const noexcept
+{
+	for (size_t i = 0; i < Props.size(); i++)
+	{
+		if (Props[i].Prop->Name == name && (table.empty() || Props[i].Table->Name == table))
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+
+void FlatSendTable::init_state(FlatEntityState& state) const
+{
+	state.Values.assign(Props.size(), FlatPropValue{ });
+	state.Strings.assign(NumStrings, std::string{ });
+	state.Arrays.assign(NumArrays, std::vector<FlatPropValue>{ });
+}
+
+
+bool FlatSendTable::read_delta(utils::bf_read& buffer, FlatEntityState& state, std::vector<uint16_t>* changed) const
+{
+	if (state.Values.size() != Props.size())
+		init_state(state);
+	return ReadFlatDelta(Props, buffer, state, changed);
+}
+
+
+bool FlatSendTable::read_delta(utils::bf_read_buffered& buffer, FlatEntityState& state, std::vector<uint16_t>* changed) const
+{
+	if (state.Values.size() != Props.size())
+		init_state(state);
+	return ReadFlatDelta(Props, buffer, state, changed);
+}
+
+TF2_NAMESPACE_END();
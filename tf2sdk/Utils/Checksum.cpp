@@ -1,4 +1,20 @@
 
+#include <array>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TF2_CRC32_PCLMUL
+#include <immintrin.h>
+#include <asmjit/core/cpuinfo.h>
+
+// gcc and clang only emit the intrinsics in functions built for the instruction sets, msvc always does
+#if defined(__GNUC__) || defined(__clang__)
+#define TF2_CRC32_PCLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+#else
+#define TF2_CRC32_PCLMUL_TARGET
+#endif
+#endif
+
 #include <tf2/utils/Checksum.hpp>
 
 TF2_NAMESPACE_BEGIN(::utils);
@@ -71,6 +87,26 @@ constexpr CRC32_t pulCRCTable[]{
 };
 static_assert(std::extent_v<decltype(pulCRCTable)> == 256);
 
+// Tables for slicing-by-16: Table[k][b] is the CRC of byte b followed by k zero bytes
+static constexpr auto CRCSlicingTables = []
+{
+    std::array<std::array<CRC32_t, 256>, 16> tables{ };
+    for (size_t i = 0; i < 256; i++)
+        tables[0][i] = pulCRCTable[i];
+
+    for (size_t k = 1; k < tables.size(); k++)
+    {
+        for (size_t i = 0; i < 256; i++)
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+    }
+    return tables;
+}();
+
+// Reflected polynomial of pulCRCTable
+static constexpr CRC32_t CRCPolynomial = 0xedb88320;
+static_assert(pulCRCTable[128] == CRCPolynomial);
+
+
 void CRC32_Init(CRC32_t* pulCRC)
 {
     *pulCRC = 0xFFFFFFFFUL;
@@ -87,88 +123,186 @@ CRC32_t	CRC32_GetTableEntry(size_t slot)
 }
 
 
-void CRC32_ProcessBuffer(CRC32_t* pulCRC, const void* pBuffer, int nBuffer)
+namespace crc32_impl
 {
-    CRC32_t ulCrc = *pulCRC;
-    const uint8_t* pb = static_cast<const uint8_t*>(pBuffer);
+    static CRC32_t process_bytes(CRC32_t crc, const uint8_t* pb, size_t size) noexcept
+    {
+        while (size--)
+            crc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(crc)] ^ (crc >> 8);
+        return crc;
+    }
+
+    static CRC32_t process_slicing16(CRC32_t crc, const uint8_t* pb, size_t size) noexcept
+    {
+        const auto& table = CRCSlicingTables;
 
-JustAfew:
+        for (; size >= 16; size -= 16, pb += 16)
+        {
+            uint32_t words[4];
+            std::memcpy(words, pb, sizeof(words));
+
+            const uint32_t first = words[0] ^ crc;
+            crc =
+                table[15][first & 0xFF] ^ table[14][(first >> 8) & 0xFF] ^ table[13][(first >> 16) & 0xFF] ^ table[12][first >> 24] ^
+                table[11][words[1] & 0xFF] ^ table[10][(words[1] >> 8) & 0xFF] ^ table[9][(words[1] >> 16) & 0xFF] ^ table[8][words[1] >> 24] ^
+                table[7][words[2] & 0xFF] ^ table[6][(words[2] >> 8) & 0xFF] ^ table[5][(words[2] >> 16) & 0xFF] ^ table[4][words[2] >> 24] ^
+                table[3][words[3] & 0xFF] ^ table[2][(words[3] >> 8) & 0xFF] ^ table[1][(words[3] >> 16) & 0xFF] ^ table[0][words[3] >> 24];
+        }
 
-    switch (nBuffer)
+        return process_bytes(crc, pb, size);
+    }
+
+#ifdef TF2_CRC32_PCLMUL
+    // Smallest buffer worth the setup of the folding, 4 blocks of 16 bytes are folded at once
+    static constexpr size_t PCLMUL_MinSize = 64;
+
+    // Helpers instead of lambdas, a lambda doesn't inherit the target of its function on gcc and clang
+    TF2_CRC32_PCLMUL_TARGET static __m128i pclmul_load(const uint8_t* p) noexcept
     {
-    case 7:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
-
-    case 6:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
-
-    case 5:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
-
-    case 4:
-        ulCrc ^= *reinterpret_cast<const CRC32_t*>(pb);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        *pulCRC = ulCrc;
-        return;
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
 
-    case 3:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
+    // x * k folded 128 bits ahead, added to 'data'
+    TF2_CRC32_PCLMUL_TARGET static __m128i pclmul_fold(__m128i x, __m128i k, __m128i data) noexcept
+    {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00)), data);
+    }
 
-    case 2:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
+    /// <summary>
+    /// Folds 'size' bytes, a multiple of 16 and at least PCLMUL_MinSize, with carry-less multiplications then reduces the remainder to 32 bits.
+    /// Constants and steps of Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", for the reflected polynomial 0xedb88320
+    /// </summary>
+    TF2_CRC32_PCLMUL_TARGET static CRC32_t process_pclmul(CRC32_t crc, const uint8_t* pb, size_t size) noexcept
+    {
+        alignas(16) static constexpr uint64_t k1k2[]{ 0x0154442bd4, 0x01c6e41596 };
+        alignas(16) static constexpr uint64_t k3k4[]{ 0x01751997d0, 0x00ccaa009e };
+        alignas(16) static constexpr uint64_t k5k0[]{ 0x0163cd6124, 0x0000000000 };
+        alignas(16) static constexpr uint64_t poly[]{ 0x01db710641, 0x01f7011641 };
+
+        __m128i x1 = _mm_xor_si128(pclmul_load(pb), _mm_cvtsi32_si128(static_cast<int>(crc)));
+        __m128i x2 = pclmul_load(pb + 16);
+        __m128i x3 = pclmul_load(pb + 32);
+        __m128i x4 = pclmul_load(pb + 48);
+        pb += 64;
+        size -= 64;
+
+        // Fold 4 blocks at once, the multiplications of each block are independent
+        __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+        for (; size >= 64; size -= 64, pb += 64)
+        {
+            x1 = pclmul_fold(x1, k, pclmul_load(pb));
+            x2 = pclmul_fold(x2, k, pclmul_load(pb + 16));
+            x3 = pclmul_fold(x3, k, pclmul_load(pb + 32));
+            x4 = pclmul_fold(x4, k, pclmul_load(pb + 48));
+        }
 
-    case 1:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
+        // Fold into a single block
+        k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+        x1 = pclmul_fold(x1, k, x2);
+        x1 = pclmul_fold(x1, k, x3);
+        x1 = pclmul_fold(x1, k, x4);
 
-    case 0:
-        *pulCRC = ulCrc;
-        return;
+        for (; size >= 16; size -= 16, pb += 16)
+            x1 = pclmul_fold(x1, k, pclmul_load(pb));
+
+        // Fold 128 bits to 64 bits
+        const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+        x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+        x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+        k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+        x2 = _mm_srli_si128(x1, 4);
+        x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        // Barrett reduction to 32 bits
+        k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+        x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+        x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+        x1 = _mm_xor_si128(x1, x2);
+
+        return static_cast<CRC32_t>(_mm_extract_epi32(x1, 1));
     }
 
-    uint32_t nFront = (reinterpret_cast<uint32_t>(pb)) & 3;
-    nBuffer -= nFront;
-    switch (nFront)
+    static bool has_pclmul() noexcept
     {
-    case 3:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
+        static const bool supported = []
+        {
+            const auto& cpu = asmjit::CpuInfo::host();
+            return cpu.hasFeature(asmjit::CpuFeatures::X86::kPCLMULQDQ) && cpu.hasFeature(asmjit::CpuFeatures::X86::kSSE4_1);
+        }();
+        return supported;
+    }
+#endif
 
-    case 2:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        [[fallthrough]];
+    // (a * b) mod P, bit 31 holds x^0
+    static constexpr CRC32_t multiply_mod(CRC32_t a, CRC32_t b) noexcept
+    {
+        CRC32_t product = 0;
+        for (CRC32_t mask = 1u << 31; mask; mask >>= 1)
+        {
+            if (a & mask)
+            {
+                product ^= b;
+                if (!(a & (mask - 1)))
+                    break;
+            }
+            b = b & 1 ? (b >> 1) ^ CRCPolynomial : b >> 1;
+        }
+        return product;
+    }
 
-    case 1:
-        ulCrc = pulCRCTable[*pb++ ^ static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
+    // x^(2^n) mod P
+    static constexpr auto PowersOfX = []
+    {
+        std::array<CRC32_t, 32> powers{ };
+        // x^1
+        powers[0] = 1u << 30;
+        for (size_t n = 1; n < powers.size(); n++)
+            powers[n] = multiply_mod(powers[n - 1], powers[n - 1]);
+        return powers;
+    }();
+
+    // x^(8 * size) mod P, the shift of a CRC over 'size' zero bytes
+    static constexpr CRC32_t shift_bytes(uint64_t size) noexcept
+    {
+        CRC32_t result = 1u << 31;
+        for (size_t n = 3; size; size >>= 1, n++)
+        {
+            if (size & 1)
+                result = multiply_mod(PowersOfX[n & 31], result);
+        }
+        return result;
     }
+}
+
 
-    int nMain = nBuffer >> 3;
-    while (nMain--)
+void CRC32_ProcessBuffer(CRC32_t* pulCRC, const void* pBuffer, int nBuffer)
+{
+    if (nBuffer <= 0)
+        return;
+
+    CRC32_t ulCrc = *pulCRC;
+    const uint8_t* pb = static_cast<const uint8_t*>(pBuffer);
+    size_t size = static_cast<size_t>(nBuffer);
+
+#ifdef TF2_CRC32_PCLMUL
+    if (size >= crc32_impl::PCLMUL_MinSize && crc32_impl::has_pclmul())
     {
-        ulCrc ^= *reinterpret_cast<const CRC32_t*>(pb);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-
-        ulCrc ^= *reinterpret_cast<const CRC32_t*>(pb + 4);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        ulCrc = pulCRCTable[static_cast<uint8_t>(ulCrc)] ^ (ulCrc >> 8);
-        pb += 8;
+        const size_t folded = size & ~size_t{ 15 };
+        ulCrc = crc32_impl::process_pclmul(ulCrc, pb, folded);
+        pb += folded;
+        size -= folded;
     }
+#endif
+
+    *pulCRC = crc32_impl::process_slicing16(ulCrc, pb, size);
+}
+
 
-    nBuffer &= 7;
-    goto JustAfew;
+CRC32_t CRC32_Combine(CRC32_t crc1, CRC32_t crc2, uint64_t len2)
+{
+    return crc32_impl::multiply_mod(crc32_impl::shift_bytes(len2), crc1) ^ crc2;
 }
 
 
@@ -922,28 +922,4 @@ void KeyValues::CopySubkeys(KeyValues* pParent) const
 }
 
 
-KeyValues::~KeyValues()
-{
-	KeyValues* dat;
-	KeyValues* datNext = NULL;
-	for (dat = SubKV; dat; dat = datNext)
-	{
-		datNext = dat->PeerKV;
-		dat->PeerKV = nullptr;
-		delete dat;
-	}
-
-	for (dat = PeerKV; dat && dat != this; dat = datNext)
-	{
-		datNext = dat->PeerKV;
-		dat->PeerKV = nullptr;
-		delete dat;
-	}
-
-	delete[] StringValue;
-	StringValue = NULL;
-	delete[] WStringValue;
-	WStringValue = NULL;
-}
-
 TF2_NAMESPACE_END();
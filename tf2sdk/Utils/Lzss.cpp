@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <tf2/utils/Lzss.hpp>
+
+TF2_NAMESPACE_BEGIN(::utils);
+
+namespace lzss_impl
+{
+	// Largest input and output of a command byte and its 8 items
+	static constexpr size_t group_input_size = 1 + 8 * 2;
+	static constexpr size_t group_output_size = 8 * Const::LZSS_MaxMatch;
+
+	static constexpr int hash_bits = 13;
+	static constexpr int max_chain = 32;
+
+	static uint32_t read_le32(const uint8_t* data) noexcept
+	{
+		return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	static void write_le32(uint8_t* data, uint32_t value) noexcept
+	{
+		data[0] = static_cast<uint8_t>(value);
+		data[1] = static_cast<uint8_t>(value >> 8);
+		data[2] = static_cast<uint8_t>(value >> 16);
+		data[3] = static_cast<uint8_t>(value >> 24);
+	}
+
+	/// <summary>
+	/// Copies a back-reference, the output has room for Const::LZSS_MaxMatch bytes.
+	/// References 8 bytes or more away are copied with two 8 bytes moves, the bytes written past 'count' are overwritten by the next items.
+	/// Closer ones repeat a pattern shorter than a move: a run is a fill, the others a fixed length byte loop
+	/// </summary>
+	static void copy_match_wide(uint8_t* out, size_t distance, size_t count) noexcept
+	{
+		const uint8_t* src = out - distance;
+		if (distance >= 8)
+		{
+			std::memcpy(out, src, 8);
+			if (count > 8)
+				std::memcpy(out + 8, src + 8, 8);
+		}
+		else if (distance == 1)
+			std::memset(out, *src, Const::LZSS_MaxMatch);
+		else
+		{
+			for (size_t i = 0; i < Const::LZSS_MaxMatch; i++)
+				out[i] = src[i];
+		}
+	}
+
+	static uint32_t hash3(const uint8_t* data) noexcept
+	{
+		const uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+		return (value * 2654435761u) >> (32 - hash_bits);
+	}
+}
+
+
+uint32_t LZSS_GetActualSize(const void* data, size_t size) noexcept
+{
+	if (!data || size < Const::LZSS_HeaderSize)
+		return 0;
+
+	const auto bytes = static_cast<const uint8_t*>(data);
+	if (lzss_impl::read_le32(bytes) != Const::LZSS_Id)
+		return 0;
+	return lzss_impl::read_le32(bytes + 4);
+}
+
+
+size_t LZSS_Decompress(const void* input, size_t input_size, void* output, size_t output_size) noexcept
+{
+	const uint32_t actual_size = LZSS_GetActualSize(input, input_size);
+	if (!actual_size || actual_size > output_size)
+		return 0;
+
+	const uint8_t* in = static_cast<const uint8_t*>(input) + Const::LZSS_HeaderSize;
+	const uint8_t* const in_end = static_cast<const uint8_t*>(input) + input_size;
+	uint8_t* const out_begin = static_cast<uint8_t*>(output);
+	uint8_t* const out_end = out_begin + actual_size;
+	uint8_t* out = out_begin;
+
+	while (true)
+	{
+		// A whole group fits in both buffers, only the references are checked
+		if (static_cast<size_t>(in_end - in) >= lzss_impl::group_input_size &&
+			static_cast<size_t>(out_end - out) >= lzss_impl::group_output_size)
+		{
+			uint32_t cmd = *in++;
+			if (!cmd)
+			{
+				std::memcpy(out, in, 8);
+				in += 8;
+				out += 8;
+				continue;
+			}
+
+			for (int i = 0; i < 8; i++, cmd >>= 1)
+			{
+				if (!(cmd & 1))
+				{
+					*out++ = *in++;
+					continue;
+				}
+
+				const size_t distance = ((in[0] << Const::LZSS_LookShift) | (in[1] >> Const::LZSS_LookShift)) + 1;
+				const size_t count = (in[1] & 0x0F) + 1;
+				in += 2;
+
+				// A reference of a single byte marks the end of the stream
+				if (count == 1)
+					return out == out_end ? actual_size : 0;
+				if (distance > static_cast<size_t>(out - out_begin))
+					return 0;
+
+				lzss_impl::copy_match_wide(out, distance, count);
+				out += count;
+			}
+			continue;
+		}
+
+		if (in == in_end)
+			return 0;
+
+		uint32_t cmd = *in++;
+		for (int i = 0; i < 8; i++, cmd >>= 1)
+		{
+			if (!(cmd & 1))
+			{
+				if (in == in_end || out == out_end)
+					return 0;
+				*out++ = *in++;
+				continue;
+			}
+
+			if (in_end - in < 2)
+				return 0;
+
+			const size_t distance = ((in[0] << Const::LZSS_LookShift) | (in[1] >> Const::LZSS_LookShift)) + 1;
+			const size_t count = (in[1] & 0x0F) + 1;
+			in += 2;
+
+			if (count == 1)
+				return out == out_end ? actual_size : 0;
+			if (distance > static_cast<size_t>(out - out_begin) || count > static_cast<size_t>(out_end - out))
+				return 0;
+
+			if (static_cast<size_t>(out_end - out) >= Const::LZSS_MaxMatch)
+				lzss_impl::copy_match_wide(out, distance, count);
+			else
+			{
+				for (size_t j = 0; j < count; j++)
+					out[j] = out[j - distance];
+			}
+			out += count;
+		}
+	}
+}
+
+
+std::span<uint8_t> LZSS_Decompress(const void* input, size_t input_size, std::pmr::memory_resource* resource)
+{
+	const uint32_t actual_size = LZSS_GetActualSize(input, input_size);
+	if (!actual_size)
+		return { };
+
+	auto output = static_cast<uint8_t*>(resource->allocate(actual_size, 1));
+	if (LZSS_Decompress(input, input_size, output, actual_size) != actual_size)
+	{
+		resource->deallocate(output, actual_size, 1);
+		return { };
+	}
+	return { output, actual_size };
+}
+
+
+size_t LZSS_Compress(const void* input, size_t input_size, void* output, size_t output_size) noexcept
+{
+	if (input_size > std::numeric_limits<uint32_t>::max() || output_size < Const::LZSS_HeaderSize)
+		return 0;
+
+	const uint8_t* const in = static_cast<const uint8_t*>(input);
+	uint8_t* const out_begin = static_cast<uint8_t*>(output);
+	uint8_t* const out_end = out_begin + output_size;
+
+	lzss_impl::write_le32(out_begin, Const::LZSS_Id);
+	lzss_impl::write_le32(out_begin + 4, static_cast<uint32_t>(input_size));
+	uint8_t* out = out_begin + Const::LZSS_HeaderSize;
+
+	// Most recent position of a 3 bytes prefix, and the previous position with the same hash for every position of the window
+	int32_t head[1 << lzss_impl::hash_bits];
+	int32_t prev[Const::LZSS_WindowSize];
+	std::fill(std::begin(head), std::end(head), -1);
+
+	auto insert = [&](size_t pos)
+	{
+		if (pos + Const::LZSS_MinMatch > input_size)
+			return;
+		auto& bucket = head[lzss_impl::hash3(in + pos)];
+		prev[pos & (Const::LZSS_WindowSize - 1)] = bucket;
+		bucket = static_cast<int32_t>(pos);
+	};
+
+	uint8_t* cmd = nullptr;
+	int cmd_bit = 8;
+
+	size_t pos = 0;
+	while (true)
+	{
+		// Room for a new command byte and a reference, a literal or the end marker
+		if (out_end - out < (cmd_bit == 8 ? 3 : 2))
+			return 0;
+
+		if (cmd_bit == 8)
+		{
+			cmd = out++;
+			*cmd = 0;
+			cmd_bit = 0;
+		}
+
+		if (pos == input_size)
+		{
+			*cmd |= 1 << cmd_bit;
+			*out++ = 0;
+			*out++ = 0;
+			return out - out_begin;
+		}
+
+		size_t best_length = 0, best_distance = 0;
+		const size_t max_length = std::min(Const::LZSS_MaxMatch, input_size - pos);
+		if (max_length >= Const::LZSS_MinMatch)
+		{
+			int32_t candidate = head[lzss_impl::hash3(in + pos)];
+			for (int depth = 0; candidate != -1 && depth < lzss_impl::max_chain; depth++)
+			{
+				const size_t distance = pos - candidate;
+				if (distance > Const::LZSS_WindowSize)
+					break;
+
+				size_t length = 0;
+				while (length < max_length && in[candidate + length] == in[pos + length])
+					length++;
+
+				if (length > best_length)
+				{
+					best_length = length;
+					best_distance = distance;
+					if (length == max_length)
+						break;
+				}
+
+				const int32_t next = prev[candidate & (Const::LZSS_WindowSize - 1)];
+				if (next >= candidate)
+					break;
+				candidate = next;
+			}
+		}
+
+		if (best_length >= Const::LZSS_MinMatch)
+		{
+			*cmd |= 1 << cmd_bit;
+			*out++ = static_cast<uint8_t>((best_distance - 1) >> Const::LZSS_LookShift);
+			*out++ = static_cast<uint8_t>((((best_distance - 1) & 0x0F) << Const::LZSS_LookShift) | (best_length - 1));
+
+			for (size_t i = 0; i < best_length; i++)
+				insert(pos + i);
+			pos += best_length;
+		}
+		else
+		{
+			*out++ = in[pos];
+			insert(pos);
+			pos++;
+		}
+		cmd_bit++;
+	}
+}
+
+TF2_NAMESPACE_END();
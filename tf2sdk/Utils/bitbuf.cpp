@@ -1,87 +1,16 @@
 #pragma once
 
-#include <tf2/utils/bitbuf.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <tf2/utils/bitbuf_impl.hpp>
 
-TF2_NAMESPACE_BEGIN(::utils)
-
-struct bit_buffer_constants
-{
-	static constexpr int maxbytes_var_int32 = 5;
-	static constexpr int max_var = 10;
-
-	static constexpr int coord_int = 14;
-	static constexpr int coord_fraction = 5;
-	static constexpr int coord_denominator = 1 << coord_fraction;
-	static constexpr float coord_resolution = 1.f / (1 << 5);
-
-	static constexpr uint32_t enconde_zigzag(int32_t v) { return (v << 1) ^ (v >> 31); }
-	static constexpr uint64_t enconde_zigzag(int64_t v) { return (v << 1) ^ (v >> 63); }
-
-	static constexpr uint32_t deconde_zigzag(uint32_t v) { return (v >> 1) ^ -static_cast<int32_t>(v & 1); }
-	static constexpr uint64_t deconde_zigzag(uint64_t v) { return (v >> 1) ^ -static_cast<int64_t>(v & 1); }
-
-	static constexpr uint32_t bit_for_bitnum(int bit)
-	{
-		constexpr uint32_t bitsForBitnum[]
-		{
-			(1 << 0),
-			(1 << 1),
-			(1 << 2),
-			(1 << 3),
-			(1 << 4),
-			(1 << 5),
-			(1 << 6),
-			(1 << 7),
-			(1 << 8),
-			(1 << 9),
-			(1 << 10),
-			(1 << 11),
-			(1 << 12),
-			(1 << 13),
-			(1 << 14),
-			(1 << 15),
-			(1 << 16),
-			(1 << 17),
-			(1 << 18),
-			(1 << 19),
-			(1 << 20),
-			(1 << 21),
-			(1 << 22),
-			(1 << 23),
-			(1 << 24),
-			(1 << 25),
-			(1 << 26),
-			(1 << 27),
-			(1 << 28),
-			(1 << 29),
-			(1 << 30),
-			(1 << 31),
-		};
-		static_assert(std::extent_v<decltype(bitsForBitnum)> == 32);
-		return bitsForBitnum[bit & 31];
-	}
-
-	uint32_t bit_write_bitmask[32][33]{ };
-	uint32_t bit_write_littlemask[32]{ };
-
-	constexpr bit_buffer_constants()
-	{
-		for (int i = 0; i < 32; i++)
-		{
-			for (int j = 0; j < 33; j++)
-			{
-				unsigned int k = i + j;
-
-				bit_write_bitmask[i][j] = bit_for_bitnum(i) - 1;
-				if (k < 32)
-					bit_write_bitmask[i][j] |= ~(bit_for_bitnum(k) - 1);
-			}
-		}
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
-		for (size_t i = 0; i < 32; i++)
-			bit_write_littlemask[i] = 1u << i;
-	}
-};
+TF2_NAMESPACE_BEGIN(::utils)
 
 static constexpr bit_buffer_constants bit_buffer_c;
 
@@ -141,10 +70,10 @@ void bf_write::write_ubit(unsigned int curData, int numbits)
 	CurBit += numbits;
 
 	// Mask in a dword.
-	unsigned long* pOut = &Data[val];
+	uint32_t* pOut = &Data[val];
 
 	// Rotate data into dword alignment
-	curData = (curData << mask) | (curData >> (32 - mask));
+	curData = std::rotl(curData, mask);
 
 	// Calculate bitmasks for first and second word
 	unsigned int temp = 1 << (numbits - 1);
@@ -153,8 +82,8 @@ void bf_write::write_ubit(unsigned int curData, int numbits)
 
 	// Only look beyond current word if necessary (avoid access violation)
 	int i = mask2 & 1;
-	unsigned long dword1 = pOut[0];
-	unsigned long dword2 = pOut[i];
+	uint32_t dword1 = pOut[0];
+	uint32_t dword2 = pOut[i];
 
 	// Drop bits into place
 	dword1 ^= (mask1 & (curData ^ dword1));
@@ -168,14 +97,7 @@ void bf_write::write_ubit(unsigned int curData, int numbits)
 
 void bf_write::write_sbit(int data, int numbits)
 {
-	// Force the sign-extension bit to be correct even in the case of overflow.
-	int nValue = data;
-	int nPreserveBits = (0x7FFFFFFF >> (32 - numbits));
-	int nSignExtension = (nValue >> 31) & ~nPreserveBits;
-	nValue &= nPreserveBits;
-	nValue |= nSignExtension;
-
-	write_ubit(nValue, numbits);
+	bit_writer_impl::write_sbit(*this, data, numbits);
 }
 
 
@@ -232,12 +154,7 @@ void bf_write::write_uint32(uint32_t data)
 	}
 	else // Slow path
 	{
-		while (data > 0x7F)
-		{
-			write_ubit((data & 0x7F) | 0x80, 8);
-			data >>= 7;
-		}
-		write_ubit(data & 0x7F, 8);
+		bit_writer_impl::write_varint(*this, data);
 	}
 }
 
@@ -345,12 +262,7 @@ void bf_write::write_uint64(uint64_t data)
 	}
 	else // slow path
 	{
-		while (data > 0x7F)
-		{
-			write_ubit((data & 0x7F) | 0x80, 8);
-			data >>= 7;
-		}
-		write_ubit(data & 0x7F, 8);
+		bit_writer_impl::write_varint(*this, data);
 	}
 }
 
@@ -378,7 +290,7 @@ bool bf_write::write_bits(const void* in_data, int numbits)
 		return false;
 
 	// Align output to dword boundary
-	while (((unsigned long)pOut & 3) != 0 && bits_left >= 8)
+	while (((size_t)pOut & 3) != 0 && bits_left >= 8)
 	{
 		write_ubit(*pOut, 8);
 		++pOut;
@@ -399,18 +311,18 @@ bool bf_write::write_bits(const void* in_data, int numbits)
 
 	if (bits_left >= 32)
 	{
-		unsigned long iBitsRight = (CurBit & 31);
-		unsigned long iBitsLeft = 32 - iBitsRight;
-		unsigned long bitMaskLeft = bit_buffer_c.bit_write_bitmask[iBitsRight][32];
-		unsigned long bitMaskRight = bit_buffer_c.bit_write_bitmask[0][iBitsRight];
+		uint32_t iBitsRight = (CurBit & 31);
+		uint32_t iBitsLeft = 32 - iBitsRight;
+		uint32_t bitMaskLeft = bit_buffer_c.bit_write_bitmask[iBitsRight][32];
+		uint32_t bitMaskRight = bit_buffer_c.bit_write_bitmask[0][iBitsRight];
 
-		unsigned long* pData = &Data[CurBit >> 5];
+		uint32_t* pData = &Data[CurBit >> 5];
 
 		// Read dwords.
 		while (bits_left >= 32)
 		{
-			unsigned long curData = *reinterpret_cast<const unsigned long*>(pOut);
-			pOut += sizeof(unsigned long);
+			uint32_t curData = *reinterpret_cast<const uint32_t*>(pOut);
+			pOut += sizeof(uint32_t);
 
 			*pData &= bitMaskLeft;
 			*pData |= curData << iBitsRight;
@@ -442,66 +354,89 @@ bool bf_write::write_bits(const void* in_data, int numbits)
 	if (bits_left)
 		write_ubit(*pOut, bits_left);
 
-	return has_overflown();
+	return !has_overflown();
 }
 
 
 void bf_write::write_angle(float fAngle, int numbits)
 {
-	uint32_t shift = bit_buffer_constants::bit_for_bitnum(numbits);
-	uint32_t mask = shift - 1;
+	bit_writer_impl::write_angle(*this, fAngle, numbits);
+}
 
-	uint32_t d = static_cast<uint32_t>((fAngle / 360.0) * shift) & mask;
 
-	write_ubit(d, numbits);
+void bf_write::write_coord(const float f)
+{
+	bit_writer_impl::write_coord(*this, f);
 }
 
 
-void bf_write::write_coord(const float f)
+void bf_write::write_coord_mp(const float f, bool integral, bool low_precision)
 {
-	int	signbit = (f <= -bit_buffer_constants::coord_resolution);
-	int	intval = static_cast<int>(abs(f));
-	int	fractval = abs(static_cast<int>((f * bit_buffer_constants::coord_denominator)) & (bit_buffer_constants::coord_denominator - 1));
+	bit_writer_impl::write_coord_mp(*this, f, integral, low_precision);
+}
 
-	// Send the bit flags that indicate whether we have an integer part and/or a fraction part.
-	write_bit(intval);
-	write_bit(fractval);
 
-	if (intval || fractval)
-	{
-		// Send the sign bit
-		write_bit(signbit);
+void bf_write::write_normal(const float f)
+{
+	bit_writer_impl::write_normal(*this, f);
+}
 
-		// Send the integer if we have one.
-		if (intval)
-		{
-			// Adjust the integers from [1..MAX_COORD_VALUE] to [0..MAX_COORD_VALUE-1]
-			intval--;
-			write_ubit(static_cast<uint32_t>(intval), bit_buffer_constants::coord_int);
-		}
 
-		// Send the fraction if we have one
-		if (fractval)
-		{
-			write_ubit(static_cast<uint32_t>(fractval), bit_buffer_constants::coord_int);
-		}
-	}
+void bf_write::write_ubit_var(uint32_t data)
+{
+	bit_writer_impl::write_ubit_var(*this, data);
 }
 
 
 void bf_write::write_vec3(const float fa[3])
 {
-	int xflag = (fa[0] >= bit_buffer_constants::coord_resolution) || (fa[0] <= -bit_buffer_constants::coord_resolution);
-	int yflag = (fa[1] >= bit_buffer_constants::coord_resolution) || (fa[1] <= -bit_buffer_constants::coord_resolution);
-	int zflag = (fa[2] >= bit_buffer_constants::coord_resolution) || (fa[2] <= -bit_buffer_constants::coord_resolution);
+	bit_writer_impl::write_vec3(*this, fa);
+}
+
+
+void bf_write::write_ubit_array(const uint32_t* in, int count, int numbits)
+{
+	// Not enough room for the whole run, write what fits and overflow like write_ubit does
+	if (bits_left() < count * numbits)
+	{
+		for (int i = 0; i < count; i++)
+			write_ubit(in[i], numbits);
+		return;
+	}
 
-	write_bit(xflag);
-	write_bit(yflag);
-	write_bit(zflag);
+	bf_write_reservation scope{ *this, count * numbits };
+	for (int i = 0; i < count; i++)
+		scope.write_ubit(in[i], numbits);
+}
 
-	if (xflag)	write_coord(fa[0]);
-	if (yflag)	write_coord(fa[1]);
-	if (zflag)	write_coord(fa[2]);
+
+void bf_write::write_coord_array(const float* in, int count)
+{
+	if (bits_left() < count * bit_buffer_constants::coord_max_bits)
+	{
+		for (int i = 0; i < count; i++)
+			write_coord(in[i]);
+		return;
+	}
+
+	bf_write_reservation scope{ *this, count * bit_buffer_constants::coord_max_bits };
+	for (int i = 0; i < count; i++)
+		scope.write_coord(in[i]);
+}
+
+
+void bf_write::write_vec3_array(const float (*in)[3], int count)
+{
+	if (bits_left() < count * bit_buffer_constants::vec3_max_bits)
+	{
+		for (int i = 0; i < count; i++)
+			write_vec3(in[i]);
+		return;
+	}
+
+	bf_write_reservation scope{ *this, count * bit_buffer_constants::vec3_max_bits };
+	for (int i = 0; i < count; i++)
+		scope.write_vec3(in[i]);
 }
 
 
@@ -537,33 +472,18 @@ void bf_write::write_long(int32_t val)
 
 void bf_write::write_longlong(int64_t val)
 {
-	uint32_t* longs = reinterpret_cast<uint32_t*>(&val);
-
-	// Insert the two DWORDS according to network endian
-	const short endianIndex = 0x0100;
-	const int8_t* idx = reinterpret_cast<const int8_t*>(&endianIndex);
-	write_ubit(longs[*idx++], sizeof(int32_t) << 3);
-	write_ubit(longs[*idx], sizeof(int32_t) << 3);
+	bit_writer_impl::write_longlong(*this, val);
 }
 
 
 bool bf_write::write_string(const char* str)
 {
-	if (str)
-	{
-		do
-		{
-			write_char(*str);
-			++str;
-		} while (*(str - 1) != 0);
-	}
-	else
-		write_char(0);
-
-	return has_overflown();
+	bit_writer_impl::write_string(*this, str);
+	return !has_overflown();
 }
 
 
+
 void bf_read::start_reading(const void* pData, int nBytes, int iStartBit, int nBits)
 {
 	assert(pData);
@@ -590,7 +510,7 @@ int bf_read::read_bit()
 		return 0;
 	}
 
-	unsigned int value = ((unsigned long*)Data)[CurBit >> 5] >> (CurBit & 31);
+	unsigned int value = Data[CurBit >> 3] >> (CurBit & 7);
 	++CurBit;
 	return value & 1;
 }
@@ -603,6 +523,16 @@ void bf_read::read_bits(void* data, int nBits)
 	int8_t* pOut = static_cast<int8_t*>(data);
 	int nBitsLeft = nBits;
 
+	// Byte-aligned, copy the whole bytes at once
+	if ((CurBit & 7) == 0 && nBits <= bits_left())
+	{
+		const int nBytes = nBits >> 3;
+		std::memcpy(pOut, Data + (CurBit >> 3), nBytes);
+		CurBit += nBytes << 3;
+		pOut += nBytes;
+		nBitsLeft &= 7;
+	}
+
 	// align output to dword boundary
 	while (((size_t)pOut & 3) != 0 && nBitsLeft >= 8)
 	{
@@ -614,8 +544,8 @@ void bf_read::read_bits(void* data, int nBits)
 	// read dwords
 	while (nBitsLeft >= 32)
 	{
-		*((unsigned long*)pOut) = read_ubit(32);
-		pOut += sizeof(unsigned long);
+		*((uint32_t*)pOut) = read_ubit(32);
+		pOut += sizeof(uint32_t);
 		nBitsLeft -= 32;
 	}
 
@@ -635,28 +565,13 @@ void bf_read::read_bits(void* data, int nBits)
 
 float bf_read::read_angle(int numbits)
 {
-	float shift = static_cast<float>((bit_buffer_constants::bit_for_bitnum(numbits)));
-	return static_cast<float>(read_ubit(numbits)) * (360.0f / shift);
+	return bit_reader_impl::read_angle(*this, numbits);
 }
 
 
-unsigned int bf_read::peek_ubit(int numbits)
+uint64_t bf_read::peek_bits(int numbits) const
 {
-	bf_read savebf = *this;
-
-	uint32_t r = 0;
-	for (int i = 0; i < numbits; i++)
-	{
-		int val = read_bit();
-
-		// Append to current stream
-		if (val)
-			r |= bit_buffer_constants::bit_for_bitnum(i);
-	}
-
-	*this = savebf;
-
-	return r;
+	return bit_reader_impl::peek_bits(Data, DataBytes, CurBit, bits_left(), numbits);
 }
 
 
@@ -669,73 +584,42 @@ uint32_t bf_read::read_ubit(int numbits)
 		return 0;
 	}
 
-	unsigned int iStartBit = CurBit & 31u;
-	int iLastBit = CurBit + numbits - 1;
-	unsigned int iWordOffset1 = CurBit >> 5;
-	unsigned int iWordOffset2 = iLastBit >> 5;
-
+	const uint32_t value = bit_reader_impl::load_bits(Data, DataBytes, CurBit, numbits);
 	CurBit += numbits;
-
-	unsigned int bitmask = (2 << (numbits - 1)) - 1;
-
-	unsigned int dw1 = Data[iWordOffset1] >> iStartBit;
-	unsigned int dw2 = Data[iWordOffset2] << (32 - iStartBit);
-
-	return (dw1 | dw2) & bitmask;
+	return value;
 }
 
 
 // Append numbits least significant bits from data to the current bit stream
 int32_t bf_read::read_sbit(int numbits)
 {
-	uint32_t r = read_ubit(numbits);
-	uint32_t s = 1 << (numbits - 1);
-	if (r >= s)
-	{
-		// sign-extend by removing sign bit and then subtracting sign bit again
-		r = r - s - s;
-	}
-	return r;
+	return bit_reader_impl::read_sbit(*this, numbits);
 }
 
 
 uint32_t bf_read::read_uint32()
 {
-	uint32_t result = 0;
-	int count = 0;
-	uint32_t b;
-
-	do
+	// Check if aligned and we have room, slow path if not
+	if ((CurBit & 7) == 0 && CurBit + static_cast<int>(sizeof(uint64_t) * 8) <= DataBits)
 	{
-		if (count == bit_buffer_constants::maxbytes_var_int32)
-			return result;
-
-		b = read_ubit(8);
-		result |= (b & 0x7F) << (7 * count);
-		++count;
-	} while (b & 0x80);
-
-	return result;
+		uint32_t result;
+		CurBit += bit_reader_impl::decode_uint32(Data + (CurBit >> 3), result) << 3;
+		return result;
+	}
+	return bit_reader_impl::read_uint32(*this);
 }
 
 
 uint64_t bf_read::read_uint64()
 {
-	uint64_t result = 0;
-	int count = 0;
-	uint64_t b;
-
-	do
+	// Check if aligned and we have room, slow path if not
+	if ((CurBit & 7) == 0 && CurBit + bit_buffer_constants::max_var * 8 <= DataBits)
 	{
-		if (count == bit_buffer_constants::max_var)
-			return result;
-
-		b = read_ubit(8);
-		result |= static_cast<uint64_t>(b & 0x7F) << (7 * count);
-		++count;
-	} while (b & 0x80);
-
-	return result;
+		uint64_t result;
+		CurBit += bit_reader_impl::decode_uint64(Data + (CurBit >> 3), result) << 3;
+		return result;
+	}
+	return bit_reader_impl::read_uint64(*this);
 }
 
 
@@ -753,99 +637,608 @@ int64_t bf_read::read_int64()
 }
 
 
-// Basic Coordinate Routines (these contain bit-field size AND fixed point scaling constants)
 float bf_read::read_coord()
 {
-	float value = 0.0;
+	return bit_reader_impl::read_coord(*this);
+}
 
-	// Read the required integer and fraction flags
-	int intval = read_bit();
-	int fractval = read_bit();
 
-	// If we got either parse them, otherwise it's a zero.
-	if (intval || fractval)
-	{
-		// Read the sign bit
-		int signbit = read_bit();
+float bf_read::read_coord_mp(bool integral, bool low_precision)
+{
+	return bit_reader_impl::read_coord_mp(*this, integral, low_precision);
+}
+
+
+float bf_read::read_normal()
+{
+	return bit_reader_impl::read_normal(*this);
+}
+
+
+uint32_t bf_read::read_ubit_var()
+{
+	return bit_reader_impl::read_ubit_var(*this);
+}
 
-		// If there's an integer, read it in
-		// Adjust the integers from [0..MAX_COORD_VALUE-1] to [1..MAX_COORD_VALUE]
-		if (intval)
-			intval = read_ubit(bit_buffer_constants::coord_int) + 1;
 
-		// If there's a fraction, read it in
-		if (fractval)
-			fractval = read_ubit(bit_buffer_constants::coord_fraction);
+void bf_read::read_vec3(float fa[3])
+{
+	bit_reader_impl::read_vec3(*this, fa);
+}
 
-		// Calculate the correct floating point value
-		value = intval + ((float)fractval * bit_buffer_constants::coord_resolution);
 
-		// Fixup the sign if negative.
-		if (signbit)
-			value = -value;
+void bf_read::read_ubit_array(uint32_t* out, int count, int numbits)
+{
+	assert((out || !count) && numbits > 0 && numbits <= 32);
+
+	// Read the fields that fit, the rest overflows the same way read_ubit does
+	const int nFit = std::min(count, bits_left() / numbits);
+	int i = 0;
+
+#if defined(__AVX2__)
+	// 8 fields at once: a field of up to 25 bits plus its offset in the first byte fits a dword,
+	// gather the dword of each lane from its byte offset and shift it by the lane's own bit offset
+	if (numbits <= 25)
+	{
+		const __m256i lane_bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(numbits));
+		const __m256i bitmask = _mm256_set1_epi32((1 << numbits) - 1);
+		const __m256i bytemask = _mm256_set1_epi32(7);
+
+		for (; i + 8 <= nFit && ((CurBit + (i + 7) * numbits) >> 3) + 4 <= DataBytes; i += 8)
+		{
+			const __m256i pos = _mm256_add_epi32(_mm256_set1_epi32(CurBit + i * numbits), lane_bits);
+			const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(Data), _mm256_srli_epi32(pos, 3), 1);
+			const __m256i values = _mm256_and_si256(_mm256_srlv_epi32(words, _mm256_and_si256(pos, bytemask)), bitmask);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), values);
+		}
 	}
+#endif
 
-	return value;
+	for (; i < nFit; i++)
+		out[i] = bit_reader_impl::load_bits(Data, DataBytes, CurBit + i * numbits, numbits);
+	CurBit += nFit * numbits;
+
+	if (nFit < count)
+	{
+		std::fill(out + nFit, out + count, 0);
+		CurBit = DataBits;
+		mark_as_overflowed();
+	}
 }
 
 
-void bf_read::read_vec3(float fa[3])
+void bf_read::read_coord_array(float* out, int count)
 {
-	int xflag = read_bit();
-	int yflag = read_bit();
-	int zflag = read_bit();
+	// Variable width fields, decode the run from an accumulator rather than re-addressing the buffer for every bit
+	bf_read_buffered stream(Data, DataBytes, DataBits);
+	stream.seek(CurBit);
 
-	fa[0] = xflag ? read_coord() : 0.f;
-	fa[1] = yflag ? read_coord() : 0.f;
-	fa[2] = zflag ? read_coord() : 0.f;
+	for (int i = 0; i < count; i++)
+		out[i] = stream.read_coord();
+
+	CurBit = stream.bits_written();
+	if (stream.has_overflown())
+		mark_as_overflowed();
 }
 
 
-int64_t bf_read::read_longlong()
+void bf_read::read_vec3_array(float (*out)[3], int count)
 {
-	int64_t ret;
-	uint32_t* longs = (uint32_t*)&ret;
+	bf_read_buffered stream(Data, DataBytes, DataBits);
+	stream.seek(CurBit);
 
-	// Read the two DWORDs according to network endian
-	const short endianIndex = 0x0100;
-	const int8_t* idx = reinterpret_cast<const int8_t*>(&endianIndex);
-	longs[*idx++] = read_ubit(sizeof(int32_t) << 3);
-	longs[*idx] = read_ubit(sizeof(int32_t) << 3);
+	for (int i = 0; i < count; i++)
+		stream.read_vec3(out[i]);
 
-	return ret;
+	CurBit = stream.bits_written();
+	if (stream.has_overflown())
+		mark_as_overflowed();
 }
 
 
-bool bf_read::read_string(char* str, int maxLen, bool bLine, int* pOutNumChars)
+int64_t bf_read::read_longlong()
 {
-	bool bTooSmall = false;
-	int i = 0;
+	return bit_reader_impl::read_longlong(*this);
+}
 
-	while (1)
-	{
-		char val = read_char();
-		if (val == 0)
-			break;
-		else if (bLine && val == '\n')
-			break;
 
-		if (i < (maxLen - 1))
+bool bf_read::read_string(char* str, int maxLen, bool bLine, int* pOutNumChars)
+{
+	if ((CurBit & 7) == 0)
+	{
+		bool bTooSmall;
+		const int consumed = bit_reader_impl::scan_string(Data + (CurBit >> 3), bits_left() >> 3, str, maxLen, bLine, bTooSmall, pOutNumChars);
+		if (consumed < 0)
 		{
-			str[i] = val;
-			++i;
+			CurBit = DataBits;
+			mark_as_overflowed();
 		}
 		else
+			CurBit += consumed << 3;
+
+		return !has_overflown() && !bTooSmall;
+	}
+	return bit_reader_impl::read_string(*this, str, maxLen, bLine, pOutNumChars);
+}
+
+
+
+void bf_read_buffered::start_reading(const void* pData, int nBytes, int iStartBit, int nBits)
+{
+	assert(pData);
+
+	Data = static_cast<const uint8_t*>(pData);
+	DataBytes = nBytes;
+
+	if (nBits == -1)
+		DataBits = DataBytes << 3;
+	else
+		DataBits = nBits;
+
+	IsOverflow = false;
+	seek(iStartBit);
+}
+
+
+bool bf_read_buffered::seek(int bitPos)
+{
+	if (bitPos < 0 || bitPos > DataBits)
+		return false;
+
+	CurBit = bitPos;
+	Next = Data + (bitPos >> 3);
+	Accum = 0;
+	AccumBits = 0;
+
+	if (int skip = bitPos & 7)
+	{
+		refill();
+		Accum >>= skip;
+		AccumBits -= skip;
+	}
+	return true;
+}
+
+
+void bf_read_buffered::refill_tail() noexcept
+{
+	const uint8_t* end = Data + DataBytes;
+	while (AccumBits <= 56 && Next < end)
+	{
+		Accum |= static_cast<uint64_t>(*Next++) << AccumBits;
+		AccumBits += 8;
+	}
+
+	// Past the end of the buffer the stream reads as zeros, overflow is tracked through CurBit
+	if (Next >= end && AccumBits < 56)
+		AccumBits = 56;
+}
+
+
+void bf_read_buffered::read_bits(void* data, int nBits)
+{
+	assert(data);
+
+	uint8_t* pOut = static_cast<uint8_t*>(data);
+	if (bits_left() < nBits)
+	{
+		std::fill_n(pOut, (nBits + 7) >> 3, 0);
+		CurBit = DataBits;
+		mark_as_overflowed();
+		return;
+	}
+
+	// Byte-aligned: copy straight from the buffer and resync the accumulator
+	if (!(CurBit & 7))
+	{
+		const int nBytes = nBits >> 3;
+		std::copy_n(Data + (CurBit >> 3), nBytes, pOut);
+		seek(CurBit + (nBytes << 3));
+		pOut += nBytes;
+		nBits &= 7;
+	}
+
+	constexpr int chunk_bytes = max_read_bits / 8;
+	while (nBits >= 8)
+	{
+		const int nBytes = std::min(nBits >> 3, chunk_bytes);
+		const uint64_t value = read_ubits(nBytes << 3);
+		for (int i = 0; i < nBytes; i++)
+			pOut[i] = static_cast<uint8_t>(value >> (i << 3));
+		pOut += nBytes;
+		nBits -= nBytes << 3;
+	}
+
+	if (nBits)
+		*pOut = static_cast<uint8_t>(read_ubits(nBits));
+}
+
+
+uint64_t bf_read_buffered::peek_bits(int numbits) const
+{
+	return bit_reader_impl::peek_bits(Data, DataBytes, CurBit, bits_left(), numbits);
+}
+
+
+float bf_read_buffered::read_angle(int numbits)
+{
+	return bit_reader_impl::read_angle(*this, numbits);
+}
+
+
+int32_t bf_read_buffered::read_sbit(int numbits)
+{
+	return bit_reader_impl::read_sbit(*this, numbits);
+}
+
+
+uint32_t bf_read_buffered::read_uint32()
+{
+	return bit_reader_impl::read_uint32(*this);
+}
+
+
+uint64_t bf_read_buffered::read_uint64()
+{
+	return bit_reader_impl::read_uint64(*this);
+}
+
+
+int32_t bf_read_buffered::read_int32()
+{
+	return bit_buffer_constants::deconde_zigzag(read_uint32());
+}
+
+
+int64_t bf_read_buffered::read_int64()
+{
+	return bit_buffer_constants::deconde_zigzag(read_uint64());
+}
+
+
+float bf_read_buffered::read_coord()
+{
+	return bit_reader_impl::read_coord(*this);
+}
+
+
+float bf_read_buffered::read_coord_mp(bool integral, bool low_precision)
+{
+	return bit_reader_impl::read_coord_mp(*this, integral, low_precision);
+}
+
+
+float bf_read_buffered::read_normal()
+{
+	return bit_reader_impl::read_normal(*this);
+}
+
+
+uint32_t bf_read_buffered::read_ubit_var()
+{
+	return bit_reader_impl::read_ubit_var(*this);
+}
+
+
+void bf_read_buffered::read_vec3(float fa[3])
+{
+	bit_reader_impl::read_vec3(*this, fa);
+}
+
+
+int64_t bf_read_buffered::read_longlong()
+{
+	return bit_reader_impl::read_longlong(*this);
+}
+
+
+bool bf_read_buffered::read_string(char* str, int maxLen, bool bLine, int* pOutNumChars)
+{
+	if ((CurBit & 7) == 0)
+	{
+		bool bTooSmall;
+		const int consumed = bit_reader_impl::scan_string(Data + (CurBit >> 3), bits_left() >> 3, str, maxLen, bLine, bTooSmall, pOutNumChars);
+		if (consumed < 0)
 		{
-			bTooSmall = true;
+			seek(DataBits);
+			mark_as_overflowed();
 		}
+		else
+			seek(CurBit + (consumed << 3));
+
+		return !has_overflown() && !bTooSmall;
+	}
+	return bit_reader_impl::read_string(*this, str, maxLen, bLine, pOutNumChars);
+}
+
+
+
+bf_write_reservation::bf_write_reservation(bf_write& writer, int nBits)
+{
+	if (writer.check_for_overflow(nBits))
+		return;
+
+	Parent = &writer;
+	Data = writer.data();
+	CurBit = writer.bits_written();
+	EndBit = CurBit + nBits;
+
+	NextByte = CurBit >> 3;
+	EndByte = (EndBit + 7) >> 3;
+
+	// Keep the bits already written in the current byte
+	AccumBits = CurBit & 7;
+	if (AccumBits)
+		Accum = Data[NextByte] & ((1u << AccumBits) - 1);
+}
+
+
+void bf_write_reservation::flush_word() noexcept
+{
+	if (NextByte + static_cast<int>(sizeof(uint32_t)) <= EndByte)
+	{
+		const uint32_t word = static_cast<uint32_t>(Accum);
+		std::memcpy(Data + NextByte, &word, sizeof(word));
+	}
+	else
+	{
+		for (int i = 0; i < static_cast<int>(sizeof(uint32_t)) && NextByte + i < EndByte; i++)
+			Data[NextByte + i] = static_cast<uint8_t>(Accum >> (i << 3));
+	}
+
+	NextByte += sizeof(uint32_t);
+	Accum >>= 32;
+	AccumBits -= 32;
+}
+
+
+void bf_write_reservation::commit()
+{
+	if (!Parent)
+		return;
+
+	// Whole bytes, then merge the last partial byte with what's already in the buffer
+	for (; AccumBits >= 8 && NextByte < EndByte; AccumBits -= 8, Accum >>= 8)
+		Data[NextByte++] = static_cast<uint8_t>(Accum);
+
+	if (AccumBits > 0 && AccumBits < 8 && NextByte < EndByte)
+	{
+		const uint8_t mask = static_cast<uint8_t>((1u << AccumBits) - 1);
+		Data[NextByte] = static_cast<uint8_t>((Data[NextByte] & ~mask) | (Accum & mask));
+	}
+
+	if (has_overflown())
+	{
+		Parent->seek(EndBit);
+		Parent->mark_as_overflowed();
+	}
+	else
+		Parent->seek(CurBit);
+	Parent = nullptr;
+}
+
+
+void bf_write_reservation::write_sbit(int data, int numbits)
+{
+	bit_writer_impl::write_sbit(*this, data, numbits);
+}
+
+
+void bf_write_reservation::write_bits(const void* in_data, int numbits)
+{
+	const uint8_t* pIn = static_cast<const uint8_t*>(in_data);
+	for (; numbits >= 32; numbits -= 32, pIn += sizeof(uint32_t))
+	{
+		uint32_t word;
+		std::memcpy(&word, pIn, sizeof(word));
+		write_ubit(word, 32);
+	}
+
+	for (; numbits >= 8; numbits -= 8)
+		write_ubit(*pIn++, 8);
+
+	if (numbits)
+		write_ubit(*pIn, numbits);
+}
+
+
+void bf_write_reservation::write_uint32(uint32_t data)
+{
+	bit_writer_impl::write_varint(*this, data);
+}
+
+
+void bf_write_reservation::write_uint64(uint64_t data)
+{
+	bit_writer_impl::write_varint(*this, data);
+}
+
+
+void bf_write_reservation::write_sint32(int32_t data)
+{
+	write_uint32(bit_buffer_constants::enconde_zigzag(data));
+}
+
+
+void bf_write_reservation::write_sint64(int64_t data)
+{
+	write_uint64(bit_buffer_constants::enconde_zigzag(data));
+}
+
+
+void bf_write_reservation::write_angle(float fAngle, int numbits)
+{
+	bit_writer_impl::write_angle(*this, fAngle, numbits);
+}
+
+
+void bf_write_reservation::write_coord(const float f)
+{
+	bit_writer_impl::write_coord(*this, f);
+}
+
+
+void bf_write_reservation::write_coord_mp(const float f, bool integral, bool low_precision)
+{
+	bit_writer_impl::write_coord_mp(*this, f, integral, low_precision);
+}
+
+
+void bf_write_reservation::write_normal(const float f)
+{
+	bit_writer_impl::write_normal(*this, f);
+}
+
+
+void bf_write_reservation::write_ubit_var(uint32_t data)
+{
+	bit_writer_impl::write_ubit_var(*this, data);
+}
+
+
+void bf_write_reservation::write_vec3(const float fa[3])
+{
+	bit_writer_impl::write_vec3(*this, fa);
+}
+
+
+void bf_write_reservation::write_longlong(int64_t val)
+{
+	bit_writer_impl::write_longlong(*this, val);
+}
+
+
+void bf_write_reservation::write_string(const char* str)
+{
+	bit_writer_impl::write_string(*this, str);
+}
+
+
+
+bf_read_reservation::bf_read_reservation(bf_read& reader, int nBits)
+{
+	if (reader.check_for_overflow(nBits))
+		return;
+
+	Parent = &reader;
+
+	// The stream ends with the reservation, anything past it reads as zeros
+	const int iEndBit = reader.bits_written() + nBits;
+	Stream.start_reading(reader.data(), (iEndBit + 7) >> 3, reader.bits_written(), iEndBit);
+}
+
+
+void bf_read_reservation::commit()
+{
+	if (!Parent)
+		return;
+
+	if (has_overflown())
+	{
+		Parent->seek(Stream.max_bits());
+		Parent->mark_as_overflowed();
+	}
+	else
+		Parent->seek(Stream.bits_written());
+	Parent = nullptr;
+}
+
+
+void bf_read_reservation::read_bits(void* data, int nBits)
+{
+	uint8_t* pOut = static_cast<uint8_t*>(data);
+
+	constexpr int chunk_bytes = bf_read_buffered::max_read_bits / 8;
+	while (nBits >= 8)
+	{
+		const int nBytes = std::min(nBits >> 3, chunk_bytes);
+		const uint64_t value = Stream.read_ubits_nocheck(nBytes << 3);
+		for (int i = 0; i < nBytes; i++)
+			pOut[i] = static_cast<uint8_t>(value >> (i << 3));
+		pOut += nBytes;
+		nBits -= nBytes << 3;
 	}
 
-	str[i] = 0;
+	if (nBits)
+		*pOut = static_cast<uint8_t>(Stream.read_ubits_nocheck(nBits));
+}
+
+
+float bf_read_reservation::read_angle(int numbits)
+{
+	return bit_reader_impl::read_angle(*this, numbits);
+}
+
+
+int32_t bf_read_reservation::read_sbit(int numbits)
+{
+	return bit_reader_impl::read_sbit(*this, numbits);
+}
+
+
+uint32_t bf_read_reservation::read_uint32()
+{
+	return bit_reader_impl::read_uint32(*this);
+}
+
+
+uint64_t bf_read_reservation::read_uint64()
+{
+	return bit_reader_impl::read_uint64(*this);
+}
+
+
+int32_t bf_read_reservation::read_int32()
+{
+	return bit_buffer_constants::deconde_zigzag(read_uint32());
+}
+
+
+int64_t bf_read_reservation::read_int64()
+{
+	return bit_buffer_constants::deconde_zigzag(read_uint64());
+}
 
-	if (pOutNumChars)
-		*pOutNumChars = i;
 
-	return !has_overflown() && !bTooSmall;
+float bf_read_reservation::read_coord()
+{
+	return bit_reader_impl::read_coord(*this);
+}
+
+
+float bf_read_reservation::read_coord_mp(bool integral, bool low_precision)
+{
+	return bit_reader_impl::read_coord_mp(*this, integral, low_precision);
+}
+
+
+float bf_read_reservation::read_normal()
+{
+	return bit_reader_impl::read_normal(*this);
+}
+
+
+uint32_t bf_read_reservation::read_ubit_var()
+{
+	return bit_reader_impl::read_ubit_var(*this);
+}
+
+
+void bf_read_reservation::read_vec3(float fa[3])
+{
+	bit_reader_impl::read_vec3(*this, fa);
+}
+
+
+int64_t bf_read_reservation::read_longlong()
+{
+	return bit_reader_impl::read_longlong(*this);
+}
+
+
+bool bf_read_reservation::read_string(char* str, int maxLen, bool bLine, int* pOutNumChars)
+{
+	return bit_reader_impl::read_string(*this, str, maxLen, bLine, pOutNumChars);
 }
 
-TF2_NAMESPACE_END();
+TF2_NAMESPACE_END();
\ No newline at end of file